@@ -7,6 +7,9 @@ setlocal enabledelayedexpansion
 REM Path to dxc.exe (relative to project root)
 set "DXC=External\DXC\bin\x64\dxc.exe"
 
+REM Otherwise the dxc of the Windows SDK, on the PATH of a developer command prompt
+if not exist "%DXC%" set "DXC=dxc"
+
 REM Source and output folders
 set "SRC=Source\Assets\Shaders"
 set "OUT=Temp\Shaders"
@@ -0,0 +1,665 @@
+#include "Engine/AabbTree.h"
+
+#include <chrono>
+#include <random>
+
+#include "Engine/Camera.h"
+#include "Engine/Culling.h"
+#include "Engine/VectorStreams.h"
+
+namespace
+{
+    constexpr uint32 s_SahBins = 16;
+
+    // Fat boxes are also stretched along the displacement, times this factor
+    constexpr float s_DisplacementMultiplier = 2.0f;
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    float3 Center(const Aabb& box)
+    {
+        return (box.Min + box.Max) * 0.5f;
+    }
+
+    float Component(const float3& v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+}
+
+DynamicAabbTree::DynamicAabbTree(float fatMargin)
+    : m_FatMargin(fatMargin)
+{
+}
+
+Aabb DynamicAabbTree::Fatten(const Aabb& bounds) const
+{
+    const float3 margin{ m_FatMargin, m_FatMargin, m_FatMargin };
+    return Aabb{ bounds.Min - margin, bounds.Max + margin };
+}
+
+uint32 DynamicAabbTree::AllocateNode()
+{
+    if (m_FreeList == s_NullNode)
+    {
+        m_Nodes.emplace_back();
+        return static_cast<uint32>(m_Nodes.size() - 1);
+    }
+
+    const uint32 node = m_FreeList;
+    m_FreeList = m_Nodes[node].Parent;
+    m_Nodes[node] = Node{};
+    return node;
+}
+
+void DynamicAabbTree::FreeNode(uint32 node)
+{
+    m_Nodes[node].Parent = m_FreeList;
+    m_Nodes[node].Height = -1;
+    m_Nodes[node].UserData = nullptr;
+    m_FreeList = node;
+}
+
+uint32 DynamicAabbTree::CreateProxy(const Aabb& bounds, void* userData)
+{
+    const uint32 proxy = AllocateNode();
+    Node& node = m_Nodes[proxy];
+    node.Bounds = Fatten(bounds);
+    node.UserData = userData;
+    node.Height = 0;
+
+    InsertLeaf(proxy);
+    m_ProxyCount++;
+    return proxy;
+}
+
+void DynamicAabbTree::DestroyProxy(uint32 proxy)
+{
+    if (proxy >= m_Nodes.size() || !m_Nodes[proxy].IsLeaf() || m_Nodes[proxy].Height != 0)
+        throw std::invalid_argument("DynamicAabbTree::DestroyProxy: not a proxy");
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_ProxyCount--;
+}
+
+bool DynamicAabbTree::MoveProxy(uint32 proxy, const Aabb& bounds, const float3& displacement)
+{
+    if (Contains(m_Nodes[proxy].Bounds, bounds))
+        return false;
+
+    RemoveLeaf(proxy);
+
+    Aabb fat = Fatten(bounds);
+    const float3 stretch = displacement * s_DisplacementMultiplier;
+    (stretch.x < 0.0f ? fat.Min.x : fat.Max.x) += stretch.x;
+    (stretch.y < 0.0f ? fat.Min.y : fat.Max.y) += stretch.y;
+    (stretch.z < 0.0f ? fat.Min.z : fat.Max.z) += stretch.z;
+    m_Nodes[proxy].Bounds = fat;
+
+    InsertLeaf(proxy);
+    return true;
+}
+
+void DynamicAabbTree::UpdateProxies(Span<const uint32> proxies, Span<const Aabb> bounds)
+{
+    if (proxies.size() != bounds.size())
+        throw std::invalid_argument("DynamicAabbTree::UpdateProxies: spans differ in length");
+
+    for (size_t i = 0; i < proxies.size(); ++i)
+    {
+        Node& node = m_Nodes[proxies[i]];
+        if (!Contains(node.Bounds, bounds[i]))
+            node.Bounds = Fatten(bounds[i]);
+    }
+}
+
+void DynamicAabbTree::Refit()
+{
+    if (m_Root == s_NullNode)
+        return;
+
+    // Reversed pre-order visits every child before its parent
+    Vector<uint32> order;
+    order.reserve(m_Nodes.size());
+    Vector<uint32> stack{ m_Root };
+    while (!stack.empty())
+    {
+        const uint32 index = stack.back();
+        stack.pop_back();
+        if (m_Nodes[index].IsLeaf())
+            continue;
+        order.push_back(index);
+        stack.push_back(m_Nodes[index].Child1);
+        stack.push_back(m_Nodes[index].Child2);
+    }
+
+    for (auto it = order.rbegin(); it != order.rend(); ++it)
+    {
+        Node& node = m_Nodes[*it];
+        node.Bounds = Union(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+    }
+}
+
+void DynamicAabbTree::Rebuild()
+{
+    Vector<uint32> leaves;
+    leaves.reserve(m_ProxyCount);
+    for (uint32 index = 0; index < m_Nodes.size(); ++index)
+    {
+        if (m_Nodes[index].Height == 0)
+            leaves.push_back(index);
+        else if (m_Nodes[index].Height > 0)
+            FreeNode(index);
+    }
+
+    m_Root = leaves.empty() ? s_NullNode : BuildRange(leaves.data(), leaves.size());
+    if (m_Root != s_NullNode)
+        m_Nodes[m_Root].Parent = s_NullNode;
+}
+
+uint32 DynamicAabbTree::BuildRange(uint32* leaves, size_t count)
+{
+    if (count == 1)
+        return leaves[0];
+
+    Aabb centroids{ Center(m_Nodes[leaves[0]].Bounds), Center(m_Nodes[leaves[0]].Bounds) };
+    for (size_t i = 1; i < count; ++i)
+    {
+        const float3 c = Center(m_Nodes[leaves[i]].Bounds);
+        centroids = Union(centroids, Aabb{ c, c });
+    }
+
+    const float3 extent = centroids.Max - centroids.Min;
+    const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+    const float axisMin = Component(centroids.Min, axis);
+    const float axisExtent = Component(extent, axis);
+
+    size_t mid = count / 2;
+    if (axisExtent > 0.0f)
+    {
+        auto binOf = [&](uint32 leaf)
+        {
+            const float c = Component(Center(m_Nodes[leaf].Bounds), axis);
+            return std::min(s_SahBins - 1, static_cast<uint32>((c - axisMin) / axisExtent * s_SahBins));
+        };
+
+        Aabb binBounds[s_SahBins];
+        uint32 binCounts[s_SahBins] = {};
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint32 bin = binOf(leaves[i]);
+            binBounds[bin] = binCounts[bin] ? Union(binBounds[bin], m_Nodes[leaves[i]].Bounds) : m_Nodes[leaves[i]].Bounds;
+            binCounts[bin]++;
+        }
+
+        // Right-to-left sweep for the right side costs, then left-to-right to pick the split
+        float rightArea[s_SahBins] = {};
+        uint32 rightCount[s_SahBins] = {};
+        Aabb accumulated;
+        uint32 accumulatedCount = 0;
+        for (uint32 bin = s_SahBins - 1; bin > 0; --bin)
+        {
+            if (binCounts[bin])
+                accumulated = accumulatedCount ? Union(accumulated, binBounds[bin]) : binBounds[bin];
+            accumulatedCount += binCounts[bin];
+            rightArea[bin] = accumulatedCount ? SurfaceArea(accumulated) : 0.0f;
+            rightCount[bin] = accumulatedCount;
+        }
+
+        float bestCost = std::numeric_limits<float>::max();
+        uint32 bestSplit = 0;
+        accumulatedCount = 0;
+        for (uint32 split = 1; split < s_SahBins; ++split)
+        {
+            if (binCounts[split - 1])
+                accumulated = accumulatedCount ? Union(accumulated, binBounds[split - 1]) : binBounds[split - 1];
+            accumulatedCount += binCounts[split - 1];
+            if (accumulatedCount == 0 || rightCount[split] == 0)
+                continue;
+
+            const float cost = SurfaceArea(accumulated) * accumulatedCount + rightArea[split] * rightCount[split];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = split;
+            }
+        }
+
+        if (bestSplit > 0)
+            mid = std::partition(leaves, leaves + count, [&](uint32 leaf) { return binOf(leaf) < bestSplit; }) - leaves;
+    }
+
+    // All centroids in one bin: split in the middle of the sorted order
+    if (mid == 0 || mid == count)
+    {
+        mid = count / 2;
+        std::nth_element(leaves, leaves + mid, leaves + count, [&](uint32 a, uint32 b)
+        {
+            return Component(Center(m_Nodes[a].Bounds), axis) < Component(Center(m_Nodes[b].Bounds), axis);
+        });
+    }
+
+    const uint32 child1 = BuildRange(leaves, mid);
+    const uint32 child2 = BuildRange(leaves + mid, count - mid);
+
+    const uint32 index = AllocateNode();
+    Node& node = m_Nodes[index];
+    node.Child1 = child1;
+    node.Child2 = child2;
+    node.Bounds = Union(m_Nodes[child1].Bounds, m_Nodes[child2].Bounds);
+    node.Height = 1 + std::max(m_Nodes[child1].Height, m_Nodes[child2].Height);
+    m_Nodes[child1].Parent = index;
+    m_Nodes[child2].Parent = index;
+    return index;
+}
+
+void DynamicAabbTree::InsertLeaf(uint32 leaf)
+{
+    if (m_Root == s_NullNode)
+    {
+        m_Root = leaf;
+        m_Nodes[leaf].Parent = s_NullNode;
+        return;
+    }
+
+    // Descend towards the sibling with the smallest total area increase, counting the growth every ancestor inherits
+    const Aabb leafBounds = m_Nodes[leaf].Bounds;
+    uint32 index = m_Root;
+    while (!m_Nodes[index].IsLeaf())
+    {
+        const Node& node = m_Nodes[index];
+        const float area = SurfaceArea(node.Bounds);
+        const float combinedArea = SurfaceArea(Union(node.Bounds, leafBounds));
+
+        // Cost of making a new parent for this node and the leaf
+        const float cost = 2.0f * combinedArea;
+        const float inheritedCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](uint32 child)
+        {
+            const Aabb& childBounds = m_Nodes[child].Bounds;
+            const float childCombined = SurfaceArea(Union(childBounds, leafBounds));
+            return (m_Nodes[child].IsLeaf() ? childCombined : childCombined - SurfaceArea(childBounds)) + inheritedCost;
+        };
+        const float cost1 = descendCost(node.Child1);
+        const float cost2 = descendCost(node.Child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.Child1 : node.Child2;
+    }
+
+    const uint32 sibling = index;
+    const uint32 oldParent = m_Nodes[sibling].Parent;
+    const uint32 newParent = AllocateNode();
+    {
+        Node& parent = m_Nodes[newParent];
+        parent.Parent = oldParent;
+        parent.Bounds = Union(leafBounds, m_Nodes[sibling].Bounds);
+        parent.Height = m_Nodes[sibling].Height + 1;
+        parent.Child1 = sibling;
+        parent.Child2 = leaf;
+    }
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    if (oldParent == s_NullNode)
+        m_Root = newParent;
+    else if (m_Nodes[oldParent].Child1 == sibling)
+        m_Nodes[oldParent].Child1 = newParent;
+    else
+        m_Nodes[oldParent].Child2 = newParent;
+
+    RefitAncestors(m_Nodes[leaf].Parent);
+}
+
+void DynamicAabbTree::RemoveLeaf(uint32 leaf)
+{
+    if (leaf == m_Root)
+    {
+        m_Root = s_NullNode;
+        return;
+    }
+
+    const uint32 parent = m_Nodes[leaf].Parent;
+    const uint32 grandParent = m_Nodes[parent].Parent;
+    const uint32 sibling = m_Nodes[parent].Child1 == leaf ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+    if (grandParent == s_NullNode)
+    {
+        m_Root = sibling;
+        m_Nodes[sibling].Parent = s_NullNode;
+        FreeNode(parent);
+        return;
+    }
+
+    if (m_Nodes[grandParent].Child1 == parent)
+        m_Nodes[grandParent].Child1 = sibling;
+    else
+        m_Nodes[grandParent].Child2 = sibling;
+    m_Nodes[sibling].Parent = grandParent;
+    FreeNode(parent);
+
+    RefitAncestors(grandParent);
+}
+
+void DynamicAabbTree::RefitAncestors(uint32 index)
+{
+    while (index != s_NullNode)
+    {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        node.Height = 1 + std::max(m_Nodes[node.Child1].Height, m_Nodes[node.Child2].Height);
+        node.Bounds = Union(m_Nodes[node.Child1].Bounds, m_Nodes[node.Child2].Bounds);
+        index = node.Parent;
+    }
+}
+
+uint32 DynamicAabbTree::Balance(uint32 iA)
+{
+    Node& a = m_Nodes[iA];
+    if (a.IsLeaf() || a.Height < 2)
+        return iA;
+
+    const uint32 iB = a.Child1;
+    const uint32 iC = a.Child2;
+    Node& b = m_Nodes[iB];
+    Node& c = m_Nodes[iC];
+    const int32 balance = c.Height - b.Height;
+
+    // Rotates child iUp above iA. iUp's taller child stays with it, the shorter one moves under iA in iUp's place
+    auto rotateUp = [&](uint32 iUp, uint32& slotInA, const Node& other)
+    {
+        Node& up = m_Nodes[iUp];
+        const uint32 iF = up.Child1;
+        const uint32 iG = up.Child2;
+        Node& f = m_Nodes[iF];
+        Node& g = m_Nodes[iG];
+
+        up.Child1 = iA;
+        up.Parent = a.Parent;
+        a.Parent = iUp;
+
+        if (up.Parent == s_NullNode)
+            m_Root = iUp;
+        else if (m_Nodes[up.Parent].Child1 == iA)
+            m_Nodes[up.Parent].Child1 = iUp;
+        else
+            m_Nodes[up.Parent].Child2 = iUp;
+
+        const bool keepF = f.Height > g.Height;
+        const uint32 iKeep = keepF ? iF : iG;
+        const uint32 iMove = keepF ? iG : iF;
+        Node& keep = m_Nodes[iKeep];
+        Node& move = m_Nodes[iMove];
+
+        up.Child2 = iKeep;
+        slotInA = iMove;
+        move.Parent = iA;
+
+        a.Bounds = Union(other.Bounds, move.Bounds);
+        a.Height = 1 + std::max(other.Height, move.Height);
+        up.Bounds = Union(a.Bounds, keep.Bounds);
+        up.Height = 1 + std::max(a.Height, keep.Height);
+    };
+
+    if (balance > 1)
+    {
+        rotateUp(iC, a.Child2, b);
+        return iC;
+    }
+    if (balance < -1)
+    {
+        rotateUp(iB, a.Child1, c);
+        return iB;
+    }
+    return iA;
+}
+
+void DynamicAabbTree::QueryFrustum(Span<const float4, 6> planes, Vector<uint32>& proxies) const
+{
+    if (m_Root == s_NullNode)
+        return;
+
+    // Each entry carries the planes its box still straddles, boxes fully inside all of them take the whole subtree
+    struct Entry
+    {
+        uint32 Node;
+        uint32 PlaneMask;
+    };
+    Vector<Entry> stack;
+    stack.reserve(64);
+    stack.push_back(Entry{ m_Root, 0x3F });
+
+    Vector<uint32> subtree;
+    while (!stack.empty())
+    {
+        Entry entry = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_Nodes[entry.Node];
+        const float3 center = Center(node.Bounds);
+        const float3 extent = (node.Bounds.Max - node.Bounds.Min) * 0.5f;
+
+        bool outside = false;
+        for (uint32 p = 0; p < 6 && !outside; ++p)
+        {
+            if (!(entry.PlaneMask & (1u << p)))
+                continue;
+
+            const float4& plane = planes[p];
+            const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+            const float radius = std::abs(plane.x) * extent.x + std::abs(plane.y) * extent.y + std::abs(plane.z) * extent.z;
+            if (distance + radius < 0.0f)
+                outside = true;
+            else if (distance - radius >= 0.0f)
+                entry.PlaneMask &= ~(1u << p);
+        }
+        if (outside)
+            continue;
+
+        if (node.IsLeaf())
+        {
+            proxies.push_back(entry.Node);
+        }
+        else if (entry.PlaneMask == 0)
+        {
+            subtree.push_back(entry.Node);
+            while (!subtree.empty())
+            {
+                const uint32 index = subtree.back();
+                subtree.pop_back();
+                if (m_Nodes[index].IsLeaf())
+                {
+                    proxies.push_back(index);
+                    continue;
+                }
+                subtree.push_back(m_Nodes[index].Child1);
+                subtree.push_back(m_Nodes[index].Child2);
+            }
+        }
+        else
+        {
+            stack.push_back(Entry{ node.Child1, entry.PlaneMask });
+            stack.push_back(Entry{ node.Child2, entry.PlaneMask });
+        }
+    }
+}
+
+void DynamicAabbTree::QueryOverlap(const Aabb& bounds, Vector<uint32>& proxies) const
+{
+    if (m_Root == s_NullNode)
+        return;
+
+    Vector<uint32> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+        const uint32 index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_Nodes[index];
+        if (!Overlaps(node.Bounds, bounds))
+            continue;
+
+        if (node.IsLeaf())
+        {
+            proxies.push_back(index);
+            continue;
+        }
+        stack.push_back(node.Child1);
+        stack.push_back(node.Child2);
+    }
+}
+
+float DynamicAabbTree::ComputeSahCost() const
+{
+    if (m_Root == s_NullNode)
+        return 0.0f;
+
+    const float rootArea = SurfaceArea(m_Nodes[m_Root].Bounds);
+    if (rootArea <= 0.0f)
+        return 0.0f;
+
+    double total = 0.0;
+    for (const Node& node : m_Nodes)
+    {
+        if (node.Height > 0)
+            total += SurfaceArea(node.Bounds);
+    }
+    return static_cast<float>(total / rootArea);
+}
+
+AabbTreeBenchmarkReport RunAabbTreeBenchmark(size_t objectCount, uint32 queryCount)
+{
+    AabbTreeBenchmarkReport report;
+    report.ObjectCount = objectCount;
+
+    // About one object per 64 cubic units, whatever the count
+    const float worldSize = 4.0f * std::cbrt(float(objectCount));
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-0.5f * worldSize, 0.5f * worldSize);
+    std::uniform_real_distribution<float> size(0.25f, 1.0f);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+    Vector<Aabb> boxes(objectCount);
+    for (Aabb& box : boxes)
+    {
+        const float3 center{ position(random), position(random), position(random) };
+        const float3 halfSize{ size(random), size(random), size(random) };
+        box = Aabb{ center - halfSize, center + halfSize };
+    }
+
+    DynamicAabbTree tree;
+    Vector<uint32> proxies(objectCount);
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < objectCount; ++i)
+        proxies[i] = tree.CreateProxy(boxes[i], &boxes[i]);
+    report.InsertMilliseconds = MillisecondsSince(start);
+    report.SahCostIncremental = tree.ComputeSahCost();
+
+    // Incremental moves, far enough to leave the fat boxes
+    const size_t movedCount = objectCount / 10;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < movedCount; ++i)
+    {
+        const float3 displacement{ unit(random) * 0.5f, unit(random) * 0.5f, unit(random) * 0.5f };
+        boxes[i] = Aabb{ boxes[i].Min + displacement, boxes[i].Max + displacement };
+        tree.MoveProxy(proxies[i], boxes[i], displacement);
+    }
+    report.MoveMilliseconds = MillisecondsSince(start);
+
+    // Batch moves of another 10%
+    for (size_t i = movedCount; i < 2 * movedCount; ++i)
+    {
+        const float3 displacement{ unit(random) * 0.5f, unit(random) * 0.5f, unit(random) * 0.5f };
+        boxes[i] = Aabb{ boxes[i].Min + displacement, boxes[i].Max + displacement };
+    }
+    start = std::chrono::steady_clock::now();
+    tree.UpdateProxies(Span<const uint32>(proxies.data() + movedCount, movedCount), Span<const Aabb>(boxes.data() + movedCount, movedCount));
+    tree.Refit();
+    report.RefitMilliseconds = MillisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    tree.Rebuild();
+    report.RebuildMilliseconds = MillisecondsSince(start);
+    report.SahCostRebuilt = tree.ComputeSahCost();
+    report.Height = tree.GetHeight();
+    report.MemoryBytes = tree.GetMemoryBytes();
+
+    // Frustum queries from random positions, against a linear pass over the same boxes
+    Float3Stream centers(objectCount), extents(objectCount);
+    {
+        const Float3SoA c = centers.View(), e = extents.View();
+        for (size_t i = 0; i < objectCount; ++i)
+        {
+            const Aabb fat = tree.GetFatBounds(proxies[i]);
+            const float3 center = Center(fat), extent = (fat.Max - fat.Min) * 0.5f;
+            c.X[i] = center.x; c.Y[i] = center.y; c.Z[i] = center.z;
+            e.X[i] = extent.x; e.Y[i] = extent.y; e.Z[i] = extent.z;
+        }
+    }
+
+    Vector<std::array<float4, 6>> frusta(queryCount);
+    for (auto& planes : frusta)
+    {
+        Camera camera;
+        camera.SetPosition(float3{ position(random), position(random), position(random) });
+        camera.SetForward(Normalize(float3{ unit(random), 0.5f * unit(random), unit(random) }));
+        camera.SetPerspective(90.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+        planes = camera.GetFrustumPlanes();
+    }
+
+    Vector<uint32> hits;
+    size_t totalHits = 0;
+    start = std::chrono::steady_clock::now();
+    for (const auto& planes : frusta)
+    {
+        hits.clear();
+        tree.QueryFrustum(planes, hits);
+        totalHits += hits.size();
+    }
+    report.FrustumQueryMilliseconds = MillisecondsSince(start) / std::max(queryCount, 1u);
+    report.FrustumHits = totalHits / std::max(queryCount, 1u);
+
+    start = std::chrono::steady_clock::now();
+    for (const auto& planes : frusta)
+    {
+        hits.clear();
+        CullBoxes(planes, centers.View(), extents.View(), hits);
+    }
+    report.LinearFrustumMilliseconds = MillisecondsSince(start) / std::max(queryCount, 1u);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32 q = 0; q < queryCount; ++q)
+    {
+        const float3 center{ position(random), position(random), position(random) };
+        hits.clear();
+        tree.QueryOverlap(Aabb{ center - float3{ 5.0f, 5.0f, 5.0f }, center + float3{ 5.0f, 5.0f, 5.0f } }, hits);
+    }
+    report.OverlapQueryMilliseconds = MillisecondsSince(start) / std::max(queryCount, 1u);
+
+    // Closest hit against the exact boxes kept as user data
+    start = std::chrono::steady_clock::now();
+    for (uint32 q = 0; q < queryCount; ++q)
+    {
+        const float3 origin{ position(random), position(random), position(random) };
+        const float3 direction = Normalize(float3{ unit(random), unit(random), unit(random) });
+        const float3 invDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+        tree.RayCast(origin, direction, worldSize, [&](uint32 proxy, float maxDistance)
+        {
+            const Aabb& box = *static_cast<const Aabb*>(tree.GetUserData(proxy));
+            const float distance = IntersectRay(box, origin, invDirection, maxDistance);
+            return distance >= 0.0f ? std::max(distance, 1e-6f) : maxDistance;
+        });
+    }
+    report.RayCastMilliseconds = MillisecondsSince(start) / std::max(queryCount, 1u);
+
+    return report;
+}
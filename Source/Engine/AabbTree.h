@@ -0,0 +1,190 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+struct Aabb
+{
+    float3 Min = { 0.0f, 0.0f, 0.0f };
+    float3 Max = { 0.0f, 0.0f, 0.0f };
+};
+
+inline Aabb Union(const Aabb& a, const Aabb& b) noexcept
+{
+    return Aabb{
+        float3{ std::min(a.Min.x, b.Min.x), std::min(a.Min.y, b.Min.y), std::min(a.Min.z, b.Min.z) },
+        float3{ std::max(a.Max.x, b.Max.x), std::max(a.Max.y, b.Max.y), std::max(a.Max.z, b.Max.z) } };
+}
+
+inline float SurfaceArea(const Aabb& a) noexcept
+{
+    const float3 d = a.Max - a.Min;
+    return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+inline bool Contains(const Aabb& outer, const Aabb& inner) noexcept
+{
+    return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z
+        && outer.Max.x >= inner.Max.x && outer.Max.y >= inner.Max.y && outer.Max.z >= inner.Max.z;
+}
+
+inline bool Overlaps(const Aabb& a, const Aabb& b) noexcept
+{
+    return a.Min.x <= b.Max.x && a.Max.x >= b.Min.x && a.Min.y <= b.Max.y && a.Max.y >= b.Min.y && a.Min.z <= b.Max.z && a.Max.z >= b.Min.z;
+}
+
+// Slab test, invDirection = 1 / direction per component. Returns the entry distance or -1 on a miss
+inline float IntersectRay(const Aabb& box, const float3& origin, const float3& invDirection, float maxDistance) noexcept
+{
+    const float tx0 = (box.Min.x - origin.x) * invDirection.x, tx1 = (box.Max.x - origin.x) * invDirection.x;
+    const float ty0 = (box.Min.y - origin.y) * invDirection.y, ty1 = (box.Max.y - origin.y) * invDirection.y;
+    const float tz0 = (box.Min.z - origin.z) * invDirection.z, tz1 = (box.Max.z - origin.z) * invDirection.z;
+    const float enter = std::max({ std::min(tx0, tx1), std::min(ty0, ty1), std::min(tz0, tz1), 0.0f });
+    const float exit = std::min({ std::max(tx0, tx1), std::max(ty0, ty1), std::max(tz0, tz1), maxDistance });
+    return enter <= exit ? enter : -1.0f;
+}
+
+// Dynamic bounding volume hierarchy over proxies with user data, in the style of the Box2D/Bullet dynamic trees.
+// Leaves store a fattened box so small movements do not touch the tree. Insertion descends by the increase in
+// surface area (SAH cost) and keeps the tree balanced with AVL rotations. Many moves at once go through
+// UpdateProxies and one Refit, and Rebuild rebuilds the whole tree top-down with binned SAH.
+// Proxies are node indices and stay valid until removed, including across Rebuild
+class DynamicAabbTree
+{
+public:
+    static constexpr uint32 s_NullNode = ~0u;
+
+    explicit DynamicAabbTree(float fatMargin = 0.1f);
+
+    uint32 CreateProxy(const Aabb& bounds, void* userData);
+    void DestroyProxy(uint32 proxy);
+
+    // Reinserts the proxy if bounds left its fat box and returns true in that case. The fat box is stretched along
+    // displacement, the expected movement until the next update
+    bool MoveProxy(uint32 proxy, const Aabb& bounds, const float3& displacement = { 0.0f, 0.0f, 0.0f });
+
+    // Batch update: refattens the leaves whose bounds left their fat box without touching the structure.
+    // Call Refit afterwards, and Rebuild once the tree quality has degraded
+    void UpdateProxies(Span<const uint32> proxies, Span<const Aabb> bounds);
+
+    // Recomputes every internal box bottom-up
+    void Refit();
+
+    // Rebuilds the hierarchy over the current leaves with binned SAH
+    void Rebuild();
+
+    void* GetUserData(uint32 proxy) const { return m_Nodes[proxy].UserData; }
+    const Aabb& GetFatBounds(uint32 proxy) const { return m_Nodes[proxy].Bounds; }
+
+    // Appends proxies whose fat box is not fully outside one of the planes (inside when dot(xyz, p) + w >= 0)
+    void QueryFrustum(Span<const float4, 6> planes, Vector<uint32>& proxies) const;
+
+    // Appends proxies whose fat box overlaps bounds
+    void QueryOverlap(const Aabb& bounds, Vector<uint32>& proxies) const;
+
+    // Calls callback(proxy, maxDistance) for every proxy whose fat box the ray hits within maxDistance, nearest subtrees
+    // first. The callback returns the new maximum distance (e.g. its exact hit distance, or maxDistance to keep going),
+    // 0 to stop. direction does not need to be normalized, distances are in units of its length
+    template<class Callback>
+    void RayCast(const float3& origin, const float3& direction, float maxDistance, Callback&& callback) const;
+
+    size_t GetProxyCount() const { return m_ProxyCount; }
+    int32 GetHeight() const { return m_Root == s_NullNode ? 0 : m_Nodes[m_Root].Height; }
+    size_t GetMemoryBytes() const { return m_Nodes.capacity() * sizeof(Node); }
+
+    // Sum of internal node surface areas relative to the root's, lower is better. Tracks quality for deciding on Rebuild
+    float ComputeSahCost() const;
+
+private:
+    struct Node
+    {
+        Aabb Bounds;
+        void* UserData = nullptr;
+        uint32 Parent = s_NullNode;     // Next free node while on the free list
+        uint32 Child1 = s_NullNode;
+        uint32 Child2 = s_NullNode;
+        int32 Height = -1;              // 0 for leaves, -1 while free
+
+        bool IsLeaf() const { return Child1 == s_NullNode; }
+    };
+
+    uint32 AllocateNode();
+    void FreeNode(uint32 node);
+    void InsertLeaf(uint32 leaf);
+    void RemoveLeaf(uint32 leaf);
+    uint32 Balance(uint32 node);
+    void RefitAncestors(uint32 node);
+    uint32 BuildRange(uint32* leaves, size_t count);
+    Aabb Fatten(const Aabb& bounds) const;
+
+    Vector<Node> m_Nodes;
+    uint32 m_Root = s_NullNode;
+    uint32 m_FreeList = s_NullNode;
+    size_t m_ProxyCount = 0;
+    float m_FatMargin = 0.1f;
+};
+
+template<class Callback>
+void DynamicAabbTree::RayCast(const float3& origin, const float3& direction, float maxDistance, Callback&& callback) const
+{
+    if (m_Root == s_NullNode)
+        return;
+
+    const float3 invDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+    if (IntersectRay(m_Nodes[m_Root].Bounds, origin, invDirection, maxDistance) < 0.0f)
+        return;
+
+    Vector<uint32> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+        const uint32 index = stack.back();
+        stack.pop_back();
+
+        const Node& node = m_Nodes[index];
+        if (node.IsLeaf())
+        {
+            // The box was hit when pushed, but maxDistance may have shrunk since
+            if (IntersectRay(node.Bounds, origin, invDirection, maxDistance) < 0.0f)
+                continue;
+            maxDistance = callback(index, maxDistance);
+            if (maxDistance <= 0.0f)
+                return;
+            continue;
+        }
+
+        const float t1 = IntersectRay(m_Nodes[node.Child1].Bounds, origin, invDirection, maxDistance);
+        const float t2 = IntersectRay(m_Nodes[node.Child2].Bounds, origin, invDirection, maxDistance);
+
+        // Push the farther child first so the nearer one is visited next
+        if (t1 >= 0.0f && t2 >= 0.0f)
+        {
+            stack.push_back(t1 <= t2 ? node.Child2 : node.Child1);
+            stack.push_back(t1 <= t2 ? node.Child1 : node.Child2);
+        }
+        else if (t1 >= 0.0f)
+            stack.push_back(node.Child1);
+        else if (t2 >= 0.0f)
+            stack.push_back(node.Child2);
+    }
+}
+
+struct AabbTreeBenchmarkReport
+{
+    size_t ObjectCount = 0;
+    double InsertMilliseconds = 0.0;        // Incremental CreateProxy of every object
+    double RebuildMilliseconds = 0.0;
+    double MoveMilliseconds = 0.0;          // MoveProxy of 10% of the objects
+    double RefitMilliseconds = 0.0;         // UpdateProxies of 10% of the objects plus Refit
+    double FrustumQueryMilliseconds = 0.0;  // Averages per query
+    double LinearFrustumMilliseconds = 0.0; // Same frustum through CullBoxes in Engine/Culling.h over all objects
+    double OverlapQueryMilliseconds = 0.0;
+    double RayCastMilliseconds = 0.0;       // Closest hit
+    size_t FrustumHits = 0;                 // Average proxies returned
+    size_t MemoryBytes = 0;
+    int32 Height = 0;
+    float SahCostIncremental = 0.0f;
+    float SahCostRebuilt = 0.0f;
+};
+
+// Headless benchmark over random boxes at constant density, e.g. for 10k to 1M objects
+AabbTreeBenchmarkReport RunAabbTreeBenchmark(size_t objectCount, uint32 queryCount = 100);
@@ -6,10 +6,16 @@
 #include <numeric>
 #include <memory>
 #include <vector>
+#include <span>
 #include <unordered_map>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <limits>
+#include <array>
+#include <type_traits>
+
+#include <immintrin.h>
 
 #include <wrl/client.h>
 
@@ -27,6 +33,9 @@ using HashMap = std::unordered_map<_Kty, _Ty, _Hasher, _Keyeq, _Alloc>;
 
 using String = std::string;
 
+template <class _Ty, size_t _Extent = std::dynamic_extent>
+using Span = std::span<_Ty, _Extent>;
+
 // Pointer types
 template<class T>
 using SharedPtr = std::shared_ptr<T>;
@@ -95,146 +104,229 @@ constexpr float QUARTER_PI = XM_PIDIV4;
 constexpr float DEG_TO_RAD = XM_PI / 180.0f;
 constexpr float RAD_TO_DEG = 180.0f / XM_PI;
 
+// ---------- Compile-time math ------------
+// <cmath> is not constexpr before C++26. These run in double precision and are only meant for
+// constant evaluation; Sqrt/Sin/Cos below select them with std::is_constant_evaluated()
+constexpr float ConstexprSqrt(float x) noexcept
+{
+    if (!(x > 0.0f) || x == std::numeric_limits<float>::infinity())
+        return x == 0.0f || x == std::numeric_limits<float>::infinity() ? x : std::numeric_limits<float>::quiet_NaN();
+
+    // Newton iteration from above converges monotonically
+    double value = x;
+    double estimate = x >= 1.0f ? value : 1.0;
+    for (int i = 0; i < 128; ++i)
+    {
+        const double next = 0.5 * (estimate + value / estimate);
+        if (next >= estimate)
+            break;
+        estimate = next;
+    }
+    return static_cast<float>(estimate);
+}
+
+// sin(x) for x in [-pi/2, pi/2], Taylor series to well below double precision
+constexpr double ConstexprSinReduced(double x) noexcept
+{
+    const double x2 = x * x;
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 14; ++n)
+    {
+        term *= -x2 / ((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double ConstexprSinDouble(double x) noexcept
+{
+    // Reduce to [-pi, pi], then fold into [-pi/2, pi/2] with sin(pi - x) = sin(x)
+    constexpr double pi = std::numbers::pi;
+    const double turns = x / (2.0 * pi);
+    const double whole = static_cast<double>(static_cast<int64_t>(turns + (turns >= 0.0 ? 0.5 : -0.5)));
+    double r = x - whole * 2.0 * pi;
+    if (r > 0.5 * pi)
+        r = pi - r;
+    else if (r < -0.5 * pi)
+        r = -pi - r;
+    return ConstexprSinReduced(r);
+}
+
+constexpr float ConstexprSin(float x) noexcept
+{
+    return static_cast<float>(ConstexprSinDouble(x));
+}
+
+constexpr float ConstexprCos(float x) noexcept
+{
+    return static_cast<float>(ConstexprSinDouble(static_cast<double>(x) + std::numbers::pi / 2.0));
+}
+
+constexpr float Sqrt(float x) noexcept
+{
+    if (std::is_constant_evaluated())
+        return ConstexprSqrt(x);
+    return std::sqrt(x);
+}
+
+constexpr float InvSqrt(float x) noexcept
+{
+    return 1.0f / Sqrt(x);
+}
+
 // ---------- Helper functions ------------
 // float2 operators
-inline float2 operator+(const float2& a, const float2& b) noexcept
+constexpr float2 operator+(const float2& a, const float2& b) noexcept
 {
     return float2{ a.x + b.x, a.y + b.y };
 }
 
-inline float2 operator-(const float2& a, const float2& b) noexcept
+constexpr float2 operator-(const float2& a, const float2& b) noexcept
 {
     return float2{ a.x - b.x, a.y - b.y };
 }
 
-inline float2 operator-(const float2& v) noexcept
+constexpr float2 operator-(const float2& v) noexcept
 {
     return float2{ -v.x, -v.y };
 }
 
-inline float2 operator*(const float2& v, float s) noexcept
+constexpr float2 operator*(const float2& v, float s) noexcept
 {
     return float2{ v.x * s, v.y * s };
 }
 
-inline float2 operator*(float s, const float2& v) noexcept
+constexpr float2 operator*(float s, const float2& v) noexcept
 {
     return v * s;
 }
 
-inline float2 operator*(const float2& a, const float2& b) noexcept
+constexpr float2 operator*(const float2& a, const float2& b) noexcept
 {
     return float2{ a.x * b.x, a.y * b.y };
 }
 
-inline float2 operator/(const float2& a, const float2& b) noexcept
+constexpr float2 operator/(const float2& a, const float2& b) noexcept
 {
     return float2{ a.x / b.x, a.y / b.y };
 }
 
-inline float2 operator/(const float2& v, float s) noexcept
+constexpr float2 operator/(const float2& v, float s) noexcept
 {
     return float2{ v.x / s, v.y / s };
 }
 
-inline float2 operator/(float s, const float2& v) noexcept
+constexpr float2 operator/(float s, const float2& v) noexcept
 {
     return float2{ s / v.x, s / v.y };
 }
 // float3 operators
-inline float3 operator+(const float3& a, const float3& b) noexcept
+constexpr float3 operator+(const float3& a, const float3& b) noexcept
 {
     return float3{ a.x + b.x, a.y + b.y, a.z + b.z };
 }
 
-inline float3 operator-(const float3& a, const float3& b) noexcept
+constexpr float3 operator-(const float3& a, const float3& b) noexcept
 {
     return float3{ a.x - b.x, a.y - b.y, a.z - b.z };
 }
 
-inline float3 operator-(const float3& v) noexcept
+constexpr float3 operator-(const float3& v) noexcept
 {
     return float3{ -v.x, -v.y, -v.z };
 }
 
-inline float3 operator*(const float3& v, float s) noexcept
+constexpr float3 operator*(const float3& v, float s) noexcept
 {
     return float3{ v.x * s, v.y * s, v.z * s };
 }
 
-inline float3 operator*(float s, const float3& v) noexcept
+constexpr float3 operator*(float s, const float3& v) noexcept
 {
     return v * s;
 }
 
-inline float3 operator*(const float3& a, const float3& b) noexcept
+constexpr float3 operator*(const float3& a, const float3& b) noexcept
 {
     return float3{ a.x * b.x, a.y * b.y, a.z * b.z };
 }
 
-inline float3 operator/(const float3& a, const float3& b) noexcept
+constexpr float3 operator/(const float3& a, const float3& b) noexcept
 {
     return float3{ a.x / b.x, a.y / b.y, a.z / b.z };
 }
 
-inline float3 operator/(const float3& v, float s) noexcept
+constexpr float3 operator/(const float3& v, float s) noexcept
 {
     return float3{ v.x / s, v.y / s, v.z / s };
 }
 
-inline float3 operator/(float s, const float3& v) noexcept
+constexpr float3 operator/(float s, const float3& v) noexcept
 {
     return float3{ s / v.x, s / v.y, s / v.z };
 }
 
 // float4 operators
-inline float4 operator+(const float4& a, const float4& b) noexcept
+constexpr float4 operator+(const float4& a, const float4& b) noexcept
 {
     return float4{ a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
 }
 
-inline float4 operator-(const float4& a, const float4& b) noexcept
+constexpr float4 operator-(const float4& a, const float4& b) noexcept
 {
     return float4{ a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w };
 }
 
-inline float4 operator-(const float4& v) noexcept
+constexpr float4 operator-(const float4& v) noexcept
 {
     return float4{ -v.x, -v.y, -v.z, -v.w };
 }
 
-inline float4 operator*(const float4& v, float s) noexcept
+constexpr float4 operator*(const float4& v, float s) noexcept
 {
     return float4{ v.x * s, v.y * s, v.z * s, v.w * s };
 }
 
-inline float4 operator*(float s, const float4& v) noexcept
+constexpr float4 operator*(float s, const float4& v) noexcept
 {
     return v * s;
 }
 
-inline float4 operator*(const float4& a, const float4& b) noexcept
+constexpr float4 operator*(const float4& a, const float4& b) noexcept
 {
     return float4{ a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w };
 }
 
-inline float4 operator/(const float4& a, const float4& b) noexcept
+constexpr float4 operator/(const float4& a, const float4& b) noexcept
 {
     return float4{ a.x / b.x, a.y / b.y, a.z / b.z, a.w / b.w };
 }
 
-inline float4 operator/(const float4& v, float s) noexcept
+constexpr float4 operator/(const float4& v, float s) noexcept
 {
     return float4{ v.x / s, v.y / s, v.z / s, v.w / s };
 }
 
-inline float4 operator/(float s, const float4& v) noexcept
+constexpr float4 operator/(float s, const float4& v) noexcept
 {
     return float4{ s / v.x, s / v.y, s / v.z, s / v.w };
 }
 
 // matrix operators
-inline float3 operator*(const float3x3& m, const float3& v) noexcept
+// Named-member row access; constant evaluation may only read the union member the constructor initialized
+constexpr float4 GetRow(const float4x4& m, size_t row) noexcept
+{
+    switch (row)
+    {
+    case 0: return float4{ m._11, m._12, m._13, m._14 };
+    case 1: return float4{ m._21, m._22, m._23, m._24 };
+    case 2: return float4{ m._31, m._32, m._33, m._34 };
+    default: return float4{ m._41, m._42, m._43, m._44 };
+    }
+}
+
+constexpr float3 operator*(const float3x3& m, const float3& v) noexcept
 {
     return float3{
         m._11 * v.x + m._12 * v.y + m._13 * v.z,
@@ -243,7 +335,7 @@ inline float3 operator*(const float3x3& m, const float3& v) noexcept
     };
 }
 
-inline float3 operator*(const float4x3& m, const float3& v) noexcept
+constexpr float3 operator*(const float4x3& m, const float3& v) noexcept
 {
     return float3{
         m._11 * v.x + m._12 * v.y + m._13 * v.z,
@@ -252,7 +344,7 @@ inline float3 operator*(const float4x3& m, const float3& v) noexcept
     };
 }
 
-inline float4 operator*(const float4x4& m, const float4& v) noexcept
+constexpr float4 operator*(const float4x4& m, const float4& v) noexcept
 {
     return float4{
         m._11 * v.x + m._12 * v.y + m._13 * v.z + m._14 * v.w,
@@ -262,7 +354,7 @@ inline float4 operator*(const float4x4& m, const float4& v) noexcept
     };
 }
 
-inline float3 operator*(const float3x4& m, const float4& v) noexcept
+constexpr float3 operator*(const float3x4& m, const float4& v) noexcept
 {
     return float3{
         m._11 * v.x + m._12 * v.y + m._13 * v.z + m._14 * v.w,
@@ -271,41 +363,88 @@ inline float3 operator*(const float3x4& m, const float4& v) noexcept
     };
 }
 
-inline float4x4 operator*(const float4x4& a, const float4x4& b) noexcept
+// Each result row is a linear combination of the rows of b (SSE is baseline on x64).
+// Batched versions with AVX2 dispatch live in Engine/MatrixBatch.h
+constexpr float4x4 operator*(const float4x4& a, const float4x4& b) noexcept
 {
+    if (std::is_constant_evaluated())
+    {
+        const float4 a0 = GetRow(a, 0), a1 = GetRow(a, 1), a2 = GetRow(a, 2), a3 = GetRow(a, 3);
+        const float4 b0 = GetRow(b, 0), b1 = GetRow(b, 1), b2 = GetRow(b, 2), b3 = GetRow(b, 3);
+        const float4 r0 = a0.x * b0 + a0.y * b1 + a0.z * b2 + a0.w * b3;
+        const float4 r1 = a1.x * b0 + a1.y * b1 + a1.z * b2 + a1.w * b3;
+        const float4 r2 = a2.x * b0 + a2.y * b1 + a2.z * b2 + a2.w * b3;
+        const float4 r3 = a3.x * b0 + a3.y * b1 + a3.z * b2 + a3.w * b3;
+        return float4x4{
+            r0.x, r0.y, r0.z, r0.w,
+            r1.x, r1.y, r1.z, r1.w,
+            r2.x, r2.y, r2.z, r2.w,
+            r3.x, r3.y, r3.z, r3.w
+        };
+    }
+
+    const __m128 b0 = _mm_loadu_ps(b.m[0]);
+    const __m128 b1 = _mm_loadu_ps(b.m[1]);
+    const __m128 b2 = _mm_loadu_ps(b.m[2]);
+    const __m128 b3 = _mm_loadu_ps(b.m[3]);
+
     float4x4 result;
     for (size_t row = 0; row < 4; ++row)
     {
-        for (size_t col = 0; col < 4; ++col)
-        {
-            result(row, col) =
-                a(row, 0) * b(0, col) +
-                a(row, 1) * b(1, col) +
-                a(row, 2) * b(2, col) +
-                a(row, 3) * b(3, col);
-        }
+        __m128 r = _mm_mul_ps(_mm_set1_ps(a.m[row][0]), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][1]), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][2]), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][3]), b3));
+        _mm_storeu_ps(result.m[row], r);
     }
     return result;
 }
 
-inline float4x3 operator*(const float4x4& a, const float4x3& b) noexcept
+constexpr float4x3 operator*(const float4x4& a, const float4x3& b) noexcept
 {
-    float4x3 result;
+    if (std::is_constant_evaluated())
+    {
+        const float4 a0 = GetRow(a, 0), a1 = GetRow(a, 1), a2 = GetRow(a, 2), a3 = GetRow(a, 3);
+        const float3 b0{ b._11, b._12, b._13 }, b1{ b._21, b._22, b._23 }, b2{ b._31, b._32, b._33 }, b3{ b._41, b._42, b._43 };
+        const float3 r0 = a0.x * b0 + a0.y * b1 + a0.z * b2 + a0.w * b3;
+        const float3 r1 = a1.x * b0 + a1.y * b1 + a1.z * b2 + a1.w * b3;
+        const float3 r2 = a2.x * b0 + a2.y * b1 + a2.z * b2 + a2.w * b3;
+        const float3 r3 = a3.x * b0 + a3.y * b1 + a3.z * b2 + a3.w * b3;
+        return float4x3{
+            r0.x, r0.y, r0.z,
+            r1.x, r1.y, r1.z,
+            r2.x, r2.y, r2.z,
+            r3.x, r3.y, r3.z
+        };
+    }
+
+    // Rows of b are 3 floats wide, the 4th lane of each load is ignored.
+    // The last row is loaded one float early and rotated so we never read past b.
+    const __m128 b0 = _mm_loadu_ps(b.m[0]);
+    const __m128 b1 = _mm_loadu_ps(b.m[1]);
+    const __m128 b2 = _mm_loadu_ps(b.m[2]);
+    const __m128 b3Shifted = _mm_loadu_ps(&b.m[2][2]);
+    const __m128 b3 = _mm_shuffle_ps(b3Shifted, b3Shifted, _MM_SHUFFLE(0, 3, 2, 1));
+
+    float rows[4][4];
     for (size_t row = 0; row < 4; ++row)
     {
-        for (size_t col = 0; col < 3; ++col)
-        {
-            result(row, col) =
-                a(row, 0) * b(0, col) +
-                a(row, 1) * b(1, col) +
-                a(row, 2) * b(2, col) +
-                a(row, 3) * b(3, col);
-        }
+        __m128 r = _mm_mul_ps(_mm_set1_ps(a.m[row][0]), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][1]), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][2]), b2));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(a.m[row][3]), b3));
+        _mm_storeu_ps(rows[row], r);
     }
-    return result;
+
+    return float4x3{
+        rows[0][0], rows[0][1], rows[0][2],
+        rows[1][0], rows[1][1], rows[1][2],
+        rows[2][0], rows[2][1], rows[2][2],
+        rows[3][0], rows[3][1], rows[3][2]
+    };
 }
 
-inline float4x4 Transpose(const float4x4& m) noexcept
+constexpr float4x4 Transpose(const float4x4& m) noexcept
 {
     return float4x4{
         m._11, m._21, m._31, m._41,
@@ -315,7 +454,7 @@ inline float4x4 Transpose(const float4x4& m) noexcept
     };
 }
 
-inline float3 Cross(const float3& a, const float3& b) noexcept
+constexpr float3 Cross(const float3& a, const float3& b) noexcept
 {
     return float3{
         a.y * b.z - a.z * b.y,
@@ -324,7 +463,7 @@ inline float3 Cross(const float3& a, const float3& b) noexcept
     };
 }
 
-inline float4 Cross(const float4& a, const float4& b) noexcept
+constexpr float4 Cross(const float4& a, const float4& b) noexcept
 {
     return float4{
         a.y * b.z - a.z * b.y,
@@ -334,39 +473,39 @@ inline float4 Cross(const float4& a, const float4& b) noexcept
     };
 }
 
-inline float Dot(const float2& a, const float2& b) noexcept
+constexpr float Dot(const float2& a, const float2& b) noexcept
 {
     return a.x * b.x + a.y * b.y;
 }
 
-inline float Dot(const float3& a, const float3& b) noexcept
+constexpr float Dot(const float3& a, const float3& b) noexcept
 {
     return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
-inline float Dot(const float4& a, const float4& b) noexcept
+constexpr float Dot(const float4& a, const float4& b) noexcept
 {
     return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
 
-inline float Length(const float2& v) noexcept
+constexpr float Length(const float2& v) noexcept
 {
-    return sqrt(Dot(v, v));
+    return Sqrt(Dot(v, v));
 }
 
-inline float Length(const float3& v) noexcept
+constexpr float Length(const float3& v) noexcept
 {
-    return sqrt(Dot(v, v));
+    return Sqrt(Dot(v, v));
 }
 
-inline float Length(const float4& v) noexcept
+constexpr float Length(const float4& v) noexcept
 {
-    return sqrt(Dot(v, v));
+    return Sqrt(Dot(v, v));
 }
 
-inline float2 Normalize(const float2& v) noexcept
+constexpr float2 Normalize(const float2& v) noexcept
 {
-    float len = std::sqrt(Dot(v, v));
+    float len = Length(v);
     if (len > 0.0f)
     {
         float invLen = 1.0f / len;
@@ -375,7 +514,7 @@ inline float2 Normalize(const float2& v) noexcept
     return v;
 }
 
-inline float3 Normalize(const float3& v) noexcept
+constexpr float3 Normalize(const float3& v) noexcept
 {
     float len = Length(v);
     if (len > 0.0f)
@@ -386,7 +525,7 @@ inline float3 Normalize(const float3& v) noexcept
     return v;
 }
 
-inline float4 Normalize(const float4& v) noexcept
+constexpr float4 Normalize(const float4& v) noexcept
 {
     float len = Length(v);
     if (len > 0.0f)
@@ -397,12 +536,12 @@ inline float4 Normalize(const float4& v) noexcept
     return v;
 }
 
-inline float Clamp(const float& v, float minVal, float maxVal) noexcept
+constexpr float Clamp(const float& v, float minVal, float maxVal) noexcept
 {
     return std::clamp(v, minVal, maxVal);
 }
 
-inline float2 Clamp(const float2& v, float minVal, float maxVal) noexcept
+constexpr float2 Clamp(const float2& v, float minVal, float maxVal) noexcept
 {
     return float2{
         Clamp(v.x, minVal, maxVal),
@@ -410,7 +549,7 @@ inline float2 Clamp(const float2& v, float minVal, float maxVal) noexcept
     };
 }
 
-inline float3 Clamp(const float3& v, float minVal, float maxVal) noexcept
+constexpr float3 Clamp(const float3& v, float minVal, float maxVal) noexcept
 {
     return float3{
         Clamp(v.x, minVal, maxVal),
@@ -419,7 +558,7 @@ inline float3 Clamp(const float3& v, float minVal, float maxVal) noexcept
     };
 }
 
-inline float4 Clamp(const float4& v, float minVal, float maxVal) noexcept
+constexpr float4 Clamp(const float4& v, float minVal, float maxVal) noexcept
 {
     return float4{
         Clamp(v.x, minVal, maxVal),
@@ -429,32 +568,35 @@ inline float4 Clamp(const float4& v, float minVal, float maxVal) noexcept
     };
 }
 
-inline float Saturate(float value) noexcept
+constexpr float Saturate(float value) noexcept
 {
     return Clamp(value, 0.0f, 1.0f);
 }
 
-inline float2 Saturate(const float2& v) noexcept
+constexpr float2 Saturate(const float2& v) noexcept
 {
     return Clamp(v, 0.0f, 1.0f);
 }
 
-inline float3 Saturate(const float3& v) noexcept
+constexpr float3 Saturate(const float3& v) noexcept
 {
     return Clamp(v, 0.0f, 1.0f);
 }
 
-inline float4 Saturate(const float4& v) noexcept
+constexpr float4 Saturate(const float4& v) noexcept
 {
     return Clamp(v, 0.0f, 1.0f);
 }
 
-inline float Lerp(float a, float b, float t) noexcept
+constexpr float Lerp(float a, float b, float t) noexcept
 {
+    // std::lerp is not constexpr, the compile-time path is exact at t = 0 and t = 1 like std::lerp
+    if (std::is_constant_evaluated())
+        return t == 1.0f ? b : a + t * (b - a);
     return std::lerp(a, b, t);
 }
 
-inline float2 Lerp(const float2& a, const float2& b, float t) noexcept
+constexpr float2 Lerp(const float2& a, const float2& b, float t) noexcept
 {
     return float2{
         Lerp(a.x, b.x, t),
@@ -462,7 +604,7 @@ inline float2 Lerp(const float2& a, const float2& b, float t) noexcept
     };
 }
 
-inline float3 Lerp(const float3& a, const float3& b, float t) noexcept
+constexpr float3 Lerp(const float3& a, const float3& b, float t) noexcept
 {
     return float3{
         Lerp(a.x, b.x, t),
@@ -471,7 +613,7 @@ inline float3 Lerp(const float3& a, const float3& b, float t) noexcept
     };
 }
 
-inline float4 Lerp(const float4& a, const float4& b, float t) noexcept
+constexpr float4 Lerp(const float4& a, const float4& b, float t) noexcept
 {
     return float4{
         Lerp(a.x, b.x, t),
@@ -481,53 +623,53 @@ inline float4 Lerp(const float4& a, const float4& b, float t) noexcept
     };
 }
 
-inline float Radians(float degrees) noexcept
+constexpr float Radians(float degrees) noexcept
 {
     return degrees * (std::numbers::pi_v<float> / 180.0f);
 }
 
-inline float2 Radians(float2& degrees) noexcept
+constexpr float2 Radians(float2& degrees) noexcept
 {
     return degrees * (std::numbers::pi_v<float> / 180.0f);
 }
 
-inline float3 Radians(float3& degrees) noexcept
+constexpr float3 Radians(float3& degrees) noexcept
 {
     return degrees * (std::numbers::pi_v<float> / 180.0f);
 }
 
-inline float4 Radians(float4& degrees) noexcept
+constexpr float4 Radians(float4& degrees) noexcept
 {
     return degrees * (std::numbers::pi_v<float> / 180.0f);
 }
 
-inline float Degrees(float radians) noexcept
+constexpr float Degrees(float radians) noexcept
 {
     return radians * (180.0f / std::numbers::pi_v<float>);
 }
 
-inline float2 Degrees(float2& radians) noexcept
+constexpr float2 Degrees(float2& radians) noexcept
 {
     return radians * (180.0f / std::numbers::pi_v<float>);
 }
 
-inline float3 Degrees(float3& radians) noexcept
+constexpr float3 Degrees(float3& radians) noexcept
 {
     return radians * (180.0f / std::numbers::pi_v<float>);
 }
 
-inline float4 Degrees(float4& radians) noexcept
+constexpr float4 Degrees(float4& radians) noexcept
 {
     return radians * (180.0f / std::numbers::pi_v<float>);
 }
 
-inline float Smoothstep(float a, float b, float x) noexcept
+constexpr float Smoothstep(float a, float b, float x) noexcept
 {
     x = Saturate((x - a) / (b - a));
     return x * x * (3 - 2 * x);
 }
 
-inline float2 Smoothstep(float a, float b, const float2& x) noexcept
+constexpr float2 Smoothstep(float a, float b, const float2& x) noexcept
 {
     return float2{
         Smoothstep(a, b, x.x),
@@ -535,7 +677,7 @@ inline float2 Smoothstep(float a, float b, const float2& x) noexcept
     };
 }
 
-inline float3 Smoothstep(float a, float b, const float3& x) noexcept
+constexpr float3 Smoothstep(float a, float b, const float3& x) noexcept
 {
     return float3{
         Smoothstep(a, b, x.x),
@@ -544,7 +686,7 @@ inline float3 Smoothstep(float a, float b, const float3& x) noexcept
     };
 }
 
-inline float4 Smoothstep(float a, float b, const float4& x) noexcept
+constexpr float4 Smoothstep(float a, float b, const float4& x) noexcept
 {
     return float4{
         Smoothstep(a, b, x.x),
@@ -555,14 +697,14 @@ inline float4 Smoothstep(float a, float b, const float4& x) noexcept
 }
 
 // Reflect incident vector i around normal n
-inline float3 Reflect(const float3& i, const float3& n) noexcept
+constexpr float3 Reflect(const float3& i, const float3& n) noexcept
 {
     return i - 2.0f * Dot(n, i) * n;
 }
 
 // Reflect incident vector i around normal n
 // n.w remains unchanged
-inline float4 Reflect(const float4& i, const float4& n) noexcept
+constexpr float4 Reflect(const float4& i, const float4& n) noexcept
 {
     float4 result = i - 2.0f * Dot(n, i) * n;
     result.w = n.w;
@@ -570,9 +712,25 @@ inline float4 Reflect(const float4& i, const float4& n) noexcept
 }
 
 
+#ifdef THOR_FAST_MATH
+// Defined in Engine/FastMath.h, which is included at the end of this file
+inline float FastSin(float x) noexcept;
+inline float FastCos(float x) noexcept;
+inline float FastAtan(float x) noexcept;
+inline float FastExp(float x) noexcept;
+inline float FastLog(float x) noexcept;
+inline float FastPow(float x, float y) noexcept;
+#endif
+
+// Sin, Cos, Atan, Exp, Log and Pow use the polynomial approximations from Engine/FastMath.h when THOR_FAST_MATH is defined.
+// Pow keeps std::pow for x <= 0 and y == 0, where FastPow is not defined
 inline float Atan(float y) noexcept
 {
+#ifdef THOR_FAST_MATH
+    return FastAtan(y);
+#else
     return std::atan(y);
+#endif
 }
 inline float Atan2(float y, float x) noexcept
 {
@@ -586,13 +744,25 @@ inline float Asin(float x) noexcept
 {
     return std::asin(x);
 }
-inline float Cos(float x) noexcept
+constexpr float Cos(float x) noexcept
 {
+    if (std::is_constant_evaluated())
+        return ConstexprCos(x);
+#ifdef THOR_FAST_MATH
+    return FastCos(x);
+#else
     return std::cos(x);
+#endif
 }
-inline float Sin(float x) noexcept
+constexpr float Sin(float x) noexcept
 {
+    if (std::is_constant_evaluated())
+        return ConstexprSin(x);
+#ifdef THOR_FAST_MATH
+    return FastSin(x);
+#else
     return std::sin(x);
+#endif
 }
 inline float Tan(float x) noexcept
 {
@@ -600,28 +770,38 @@ inline float Tan(float x) noexcept
 }
 inline float Exp(float x) noexcept
 {
+#ifdef THOR_FAST_MATH
+    return FastExp(x);
+#else
     return std::exp(x);
+#endif
 }
 inline float Log(float x) noexcept
 {
+#ifdef THOR_FAST_MATH
+    return FastLog(x);
+#else
     return std::log(x);
+#endif
 }
 inline float Pow(float x, float y) noexcept
 {
+#ifdef THOR_FAST_MATH
+    // FastPow goes through Log(x), which has no answer for these. std::pow handles 0^0 and negative bases with integral y
+    if (x <= 0.0f || y == 0.0f)
+        return std::pow(x, y);
+    return FastPow(x, y);
+#else
     return std::pow(x, y);
-}
-inline float Sqrt(float x) noexcept
-{
-    return std::sqrt(x);
-}
-
-inline float InvSqrt(float x) noexcept
-{
-    return 1.0f / std::sqrt(x);
+#endif
 }
 
 // Align 'size' up to the nearest multiple of 'alignment' (which must be a power of two)
 constexpr size_t AlignUp(size_t size, size_t alignment) noexcept
 {
     return (size + alignment - 1) & ~(alignment - 1);
-}
\ No newline at end of file
+}
+
+#ifdef THOR_FAST_MATH
+#include "Engine/FastMath.h"
+#endif
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/BaseTypes.h"
+#include "Engine/Culling.h"
 
 class Camera
 {
@@ -56,6 +57,14 @@ public:
         return GetViewMatrix() * GetProjectionMatrix();
     }
 
+    // World-space planes in FrustumPlane order, inside when dot(xyz, p) + w >= 0
+    inline std::array<float4, 6> GetFrustumPlanes() const
+    {
+        float4x4 viewProjection;
+        XMStoreFloat4x4(&viewProjection, GetViewProjectionMatrix());
+        return ExtractFrustumPlanes(viewProjection);
+    }
+
 private:
     float3 m_Position;
     float3 m_Forward;
@@ -0,0 +1,109 @@
+#include "Engine/CpuFeatures.h"
+#include "Engine/BaseTypes.h"
+
+#include <atomic>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace
+{
+    void QueryCpuid(int leaf, int subLeaf, int info[4])
+    {
+#ifdef _MSC_VER
+        __cpuidex(info, leaf, subLeaf);
+#else
+        __cpuid_count(leaf, subLeaf, info[0], info[1], info[2], info[3]);
+#endif
+    }
+
+    uint64 QueryXcr0()
+    {
+#ifdef _MSC_VER
+        return _xgetbv(0);
+#else
+        uint32 eax = 0, edx = 0;
+        __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+        return (static_cast<uint64>(edx) << 32) | eax;
+#endif
+    }
+
+    CpuFeatures DetectCpuFeatures()
+    {
+        CpuFeatures features;
+        int info[4] = {};
+
+        QueryCpuid(0, 0, info);
+        const int maxLeaf = info[0];
+        if (maxLeaf < 1)
+            return features;
+
+        QueryCpuid(1, 0, info);
+        const bool osXsave = (info[2] & (1 << 27)) != 0;
+        features.Sse41 = (info[2] & (1 << 19)) != 0;
+
+        // AVX state must also be saved by the OS, otherwise the upper register halves are lost on context switch
+        const uint64 xcr0 = osXsave ? QueryXcr0() : 0;
+        const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+        const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+        features.Avx = ymmEnabled && (info[2] & (1 << 28)) != 0;
+        features.Fma = features.Avx && (info[2] & (1 << 12)) != 0;
+
+        if (maxLeaf >= 7)
+        {
+            QueryCpuid(7, 0, info);
+            features.Avx2 = features.Avx && (info[1] & (1 << 5)) != 0;
+            features.Avx512F = zmmEnabled && (info[1] & (1 << 16)) != 0;
+        }
+        return features;
+    }
+
+    // Read by the batch kernels on worker threads
+    std::atomic<SimdLevel> g_MaxSimdLevel{ SimdLevel::Avx512 };
+}
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures s_Features = DetectCpuFeatures();
+    return s_Features;
+}
+
+SimdLevel GetSimdLevel()
+{
+    static const SimdLevel s_Supported = []
+    {
+        const CpuFeatures& features = GetCpuFeatures();
+        if (features.Avx512F && features.Avx2 && features.Fma)
+            return SimdLevel::Avx512;
+        if (features.Avx2 && features.Fma)
+            return SimdLevel::Avx2;
+        return SimdLevel::Sse;
+    }();
+    return std::min(s_Supported, g_MaxSimdLevel.load(std::memory_order_relaxed));
+}
+
+SimdLevel GetMaxSimdLevel()
+{
+    return g_MaxSimdLevel.load(std::memory_order_relaxed);
+}
+
+void SetMaxSimdLevel(SimdLevel level)
+{
+    g_MaxSimdLevel.store(level, std::memory_order_relaxed);
+}
+
+const char* GetSimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::Scalar: return "Scalar";
+    case SimdLevel::Sse: return "SSE";
+    case SimdLevel::Avx2: return "AVX2";
+    case SimdLevel::Avx512: return "AVX-512";
+    }
+    return "Unknown";
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+
+// Only standard headers here: BaseTypes.h pulls this in through FastMath.h when THOR_FAST_MATH is defined
+
+// Instruction set extensions reported by the host CPU and enabled by the OS
+struct CpuFeatures
+{
+    bool Sse41 = false;
+    bool Avx = false;
+    bool Avx2 = false;
+    bool Fma = false;
+    bool Avx512F = false;
+};
+
+// Widest SIMD path a batch kernel is allowed to take
+enum class SimdLevel : uint8_t
+{
+    Scalar,
+    Sse,
+    Avx2,
+    Avx512
+};
+
+// Queried once on first use
+const CpuFeatures& GetCpuFeatures();
+
+// Best level supported by the CPU, capped by SetMaxSimdLevel
+SimdLevel GetSimdLevel();
+
+// Cap the dispatch level, e.g. to compare kernels against the scalar fallback. Safe to call while other threads dispatch
+SimdLevel GetMaxSimdLevel();
+void SetMaxSimdLevel(SimdLevel level);
+
+const char* GetSimdLevelName(SimdLevel level);
@@ -0,0 +1,165 @@
+#include "Engine/Culling.h"
+#include "Engine/SimdLanes.h"
+
+namespace
+{
+    struct PlaneSet
+    {
+        float X[6], Y[6], Z[6], W[6];
+        float AbsX[6], AbsY[6], AbsZ[6];
+    };
+
+    PlaneSet MakePlaneSet(Span<const float4, 6> planes)
+    {
+        PlaneSet set;
+        for (size_t p = 0; p < 6; ++p)
+        {
+            set.X[p] = planes[p].x;
+            set.Y[p] = planes[p].y;
+            set.Z[p] = planes[p].z;
+            set.W[p] = planes[p].w;
+            set.AbsX[p] = std::abs(planes[p].x);
+            set.AbsY[p] = std::abs(planes[p].y);
+            set.AbsZ[p] = std::abs(planes[p].z);
+        }
+        return set;
+    }
+
+    // Writes the indices of the set bits of a lane mask, lowest first
+    inline void AppendLanes(uint32 mask, uint32 first, uint32* out, size_t& written)
+    {
+        while (mask)
+        {
+            out[written++] = first + static_cast<uint32>(std::countr_zero(mask));
+            mask &= mask - 1;
+        }
+    }
+
+    // Both kernels track the smallest signed distance of the volume's nearest point over all planes,
+    // a block element is outside when that distance is negative
+    template<class L>
+    struct SphereCullKernel
+    {
+        static void Run(const PlaneSet& planes, const ConstFloat4SoA& spheres, uint32* out, size_t& written)
+        {
+            ForEachBlock<L>(spheres.Size(), [&]<class B>(size_t i)
+            {
+                const auto x = B::Load(spheres.X.data() + i);
+                const auto y = B::Load(spheres.Y.data() + i);
+                const auto z = B::Load(spheres.Z.data() + i);
+                const auto r = B::Load(spheres.W.data() + i);
+
+                auto distance = B::Set1(std::numeric_limits<float>::infinity());
+                for (size_t p = 0; p < 6; ++p)
+                {
+                    auto d = B::MulAdd(x, B::Set1(planes.X[p]), B::Add(r, B::Set1(planes.W[p])));
+                    d = B::MulAdd(y, B::Set1(planes.Y[p]), d);
+                    d = B::MulAdd(z, B::Set1(planes.Z[p]), d);
+                    distance = B::Min(distance, d);
+                }
+
+                const uint32 laneBits = (1u << B::Width) - 1;
+                const uint32 outside = B::MoveMask(B::CmpLt(distance, B::Set1(0.0f)));
+                AppendLanes(~outside & laneBits, static_cast<uint32>(i), out, written);
+            });
+        }
+    };
+
+    template<class L>
+    struct BoxCullKernel
+    {
+        static void Run(const PlaneSet& planes, const ConstFloat3SoA& centers, const ConstFloat3SoA& extents, uint32* out, size_t& written)
+        {
+            ForEachBlock<L>(centers.Size(), [&]<class B>(size_t i)
+            {
+                const auto cx = B::Load(centers.X.data() + i);
+                const auto cy = B::Load(centers.Y.data() + i);
+                const auto cz = B::Load(centers.Z.data() + i);
+                const auto ex = B::Load(extents.X.data() + i);
+                const auto ey = B::Load(extents.Y.data() + i);
+                const auto ez = B::Load(extents.Z.data() + i);
+
+                auto distance = B::Set1(std::numeric_limits<float>::infinity());
+                for (size_t p = 0; p < 6; ++p)
+                {
+                    // Signed distance of the center plus the projected half extent along the plane normal
+                    auto d = B::MulAdd(cx, B::Set1(planes.X[p]), B::Set1(planes.W[p]));
+                    d = B::MulAdd(cy, B::Set1(planes.Y[p]), d);
+                    d = B::MulAdd(cz, B::Set1(planes.Z[p]), d);
+                    d = B::MulAdd(ex, B::Set1(planes.AbsX[p]), d);
+                    d = B::MulAdd(ey, B::Set1(planes.AbsY[p]), d);
+                    d = B::MulAdd(ez, B::Set1(planes.AbsZ[p]), d);
+                    distance = B::Min(distance, d);
+                }
+
+                const uint32 laneBits = (1u << B::Width) - 1;
+                const uint32 outside = B::MoveMask(B::CmpLt(distance, B::Set1(0.0f)));
+                AppendLanes(~outside & laneBits, static_cast<uint32>(i), out, written);
+            });
+        }
+    };
+
+    void CheckSize(size_t expected, size_t actual)
+    {
+        if (expected != actual)
+            throw std::invalid_argument("Culling: bounding volume components differ in length");
+    }
+}
+
+std::array<float4, 6> ExtractFrustumPlanes(const float4x4& m) noexcept
+{
+    // Clip coordinates are p * m, so each clip component is the dot product with one column
+    auto column = [&](size_t c) { return float4{ m(0, c), m(1, c), m(2, c), m(3, c) }; };
+    const float4 x = column(0), y = column(1), z = column(2), w = column(3);
+
+    std::array<float4, 6> planes = {
+        w + x,      // Left:   -w <= x
+        w - x,      // Right:   x <= w
+        w + y,      // Bottom: -w <= y
+        w - y,      // Top:     y <= w
+        z,          // Near:    0 <= z
+        w - z,      // Far:     z <= w
+    };
+
+    for (float4& plane : planes)
+    {
+        const float length = Length(float3{ plane.x, plane.y, plane.z });
+        if (length > 0.0f)
+            plane = plane * (1.0f / length);
+    }
+    return planes;
+}
+
+CullStats CullSpheres(Span<const float4, 6> planes, ConstFloat4SoA spheres, Vector<uint32>& visible)
+{
+    const size_t count = spheres.Size();
+    CheckSize(count, spheres.Y.size());
+    CheckSize(count, spheres.Z.size());
+    CheckSize(count, spheres.W.size());
+
+    const size_t first = visible.size();
+    visible.resize(first + count);
+    size_t written = 0;
+    DispatchSimd<SphereCullKernel>(MakePlaneSet(planes), spheres, visible.data() + first, written);
+    visible.resize(first + written);
+
+    return CullStats{ count, written };
+}
+
+CullStats CullBoxes(Span<const float4, 6> planes, ConstFloat3SoA centers, ConstFloat3SoA extents, Vector<uint32>& visible)
+{
+    const size_t count = centers.Size();
+    CheckSize(count, centers.Y.size());
+    CheckSize(count, centers.Z.size());
+    CheckSize(count, extents.X.size());
+    CheckSize(count, extents.Y.size());
+    CheckSize(count, extents.Z.size());
+
+    const size_t first = visible.size();
+    visible.resize(first + count);
+    size_t written = 0;
+    DispatchSimd<BoxCullKernel>(MakePlaneSet(planes), centers, extents, visible.data() + first, written);
+    visible.resize(first + written);
+
+    return CullStats{ count, written };
+}
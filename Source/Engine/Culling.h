@@ -0,0 +1,31 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/VectorStreams.h"
+
+// Order of the planes returned by ExtractFrustumPlanes
+enum class FrustumPlane : uint8
+{
+    Left,
+    Right,
+    Bottom,
+    Top,
+    Near,
+    Far,
+};
+
+// Gribb-Hartmann extraction from a row-vector view-projection matrix with D3D clip depth [0, w]. The planes are
+// normalized with xyz pointing inward, a point p is inside when dot(xyz, p) + w >= 0
+std::array<float4, 6> ExtractFrustumPlanes(const float4x4& viewProjection) noexcept;
+
+struct CullStats
+{
+    size_t Tested = 0;
+    size_t Visible = 0;
+};
+
+// Appends the index of every sphere (xyz center, w radius) that is not fully outside one of the planes to visible,
+// in ascending order. Vectorized 4/8/16 wide depending on GetSimdLevel(). NaN bounds are kept
+CullStats CullSpheres(Span<const float4, 6> planes, ConstFloat4SoA spheres, Vector<uint32>& visible);
+
+// Same for axis-aligned boxes given as centers and half extents
+CullStats CullBoxes(Span<const float4, 6> planes, ConstFloat3SoA centers, ConstFloat3SoA extents, Vector<uint32>& visible);
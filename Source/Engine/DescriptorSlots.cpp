@@ -0,0 +1,227 @@
+#include "DescriptorSlots.h"
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+void DescriptorFreeList::Reset(uint32 capacity)
+{
+    if (capacity == s_InvalidIndex)
+    {
+        throw std::invalid_argument("Descriptor free list capacity is too large");
+    }
+
+    m_Capacity = capacity;
+    m_Next = std::make_unique<std::atomic<uint32>[]>(capacity);
+    for (uint32 i = 0; i < capacity; ++i)
+        m_Next[i].store(i + 1 < capacity ? i + 1 : s_InvalidIndex, std::memory_order_relaxed);
+    m_Head.store(capacity > 0 ? 0 : s_InvalidIndex, std::memory_order_release);
+    m_AllocatedCount.store(0, std::memory_order_relaxed);
+    m_Deferred.clear();
+    m_Retired.clear();
+}
+
+uint32 DescriptorFreeList::Allocate()
+{
+    uint64 head = m_Head.load(std::memory_order_acquire);
+    for (;;)
+    {
+        const uint32 index = static_cast<uint32>(head);
+        if (index == s_InvalidIndex)
+            return s_InvalidIndex;
+
+        // May read the link of a slot another thread just took, the counter in the head then fails the exchange
+        const uint32 next = m_Next[index].load(std::memory_order_relaxed);
+        if (m_Head.compare_exchange_weak(head, MakeHead(head, next), std::memory_order_acquire, std::memory_order_acquire))
+        {
+            m_AllocatedCount.fetch_add(1, std::memory_order_relaxed);
+            return index;
+        }
+    }
+}
+
+void DescriptorFreeList::Free(uint32 index)
+{
+    if (index >= m_Capacity)
+    {
+        throw std::out_of_range("Descriptor slot is out of range");
+    }
+
+    uint64 head = m_Head.load(std::memory_order_relaxed);
+    do
+    {
+        m_Next[index].store(static_cast<uint32>(head), std::memory_order_relaxed);
+    } while (!m_Head.compare_exchange_weak(head, MakeHead(head, index), std::memory_order_release, std::memory_order_relaxed));
+    m_AllocatedCount.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void DescriptorFreeList::FreeDeferred(uint32 index)
+{
+    if (index >= m_Capacity)
+    {
+        throw std::out_of_range("Descriptor slot is out of range");
+    }
+
+    std::lock_guard lock(m_DeferredMutex);
+    m_Deferred.push_back(index);
+}
+
+void DescriptorFreeList::FinishFrame(uint64 fenceValue)
+{
+    if (!m_Retired.empty() && fenceValue < m_Retired.back().FenceValue)
+    {
+        throw std::invalid_argument("Descriptor free list fence values must not decrease");
+    }
+
+    std::lock_guard lock(m_DeferredMutex);
+    for (uint32 index : m_Deferred)
+        m_Retired.push_back(RetiredSlot{ fenceValue, index });
+    m_Deferred.clear();
+}
+
+void DescriptorFreeList::Reclaim(uint64 completedFenceValue)
+{
+    size_t completed = 0;
+    while (completed < m_Retired.size() && m_Retired[completed].FenceValue <= completedFenceValue)
+    {
+        Free(m_Retired[completed].Index);
+        ++completed;
+    }
+    m_Retired.erase(m_Retired.begin(), m_Retired.begin() + completed);
+}
+
+void DescriptorRing::Reset(uint32 capacity)
+{
+    m_Capacity = capacity;
+    m_Head.store(0, std::memory_order_relaxed);
+    m_Tail = 0;
+    m_Frames.clear();
+}
+
+uint32 DescriptorRing::Allocate(uint32 count)
+{
+    if (count == 0 || count > m_Capacity)
+        return s_InvalidIndex;
+
+    uint64 head = m_Head.load(std::memory_order_relaxed);
+    uint64 start = 0;
+    do
+    {
+        // Skip to the start of the next lap when the range would straddle the end
+        const uint64 offset = head % m_Capacity;
+        start = offset + count > m_Capacity ? head + (m_Capacity - offset) : head;
+        if (start + count - m_Tail > m_Capacity)
+            return s_InvalidIndex;
+    } while (!m_Head.compare_exchange_weak(head, start + count, std::memory_order_relaxed));
+
+    return static_cast<uint32>(start % m_Capacity);
+}
+
+void DescriptorRing::FinishFrame(uint64 fenceValue)
+{
+    if (!m_Frames.empty() && fenceValue < m_Frames.back().FenceValue)
+    {
+        throw std::invalid_argument("Descriptor ring fence values must not decrease");
+    }
+    m_Frames.push_back(FrameMark{ fenceValue, m_Head.load(std::memory_order_relaxed) });
+}
+
+void DescriptorRing::Reclaim(uint64 completedFenceValue)
+{
+    size_t completed = 0;
+    while (completed < m_Frames.size() && m_Frames[completed].FenceValue <= completedFenceValue)
+    {
+        m_Tail = m_Frames[completed].End;
+        ++completed;
+    }
+    m_Frames.erase(m_Frames.begin(), m_Frames.begin() + completed);
+}
+
+DescriptorContentionReport RunDescriptorContentionBenchmark(uint32 threadCount, uint32 operationsPerThread)
+{
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint32 s_BatchSize = 16;
+    static constexpr uint32 s_MaxRangeSize = 8;
+
+    DescriptorContentionReport report;
+    report.ThreadCount = std::max(1u, threadCount);
+    report.Operations = uint64(report.ThreadCount) * operationsPerThread;
+    const uint32 capacity = report.ThreadCount * s_BatchSize;
+    std::atomic<uint64> failed{ 0 };
+
+    auto measure = [&](auto&& perThread)
+    {
+        // Dedicated threads, the ParallelFor pool may have fewer than threadCount
+        const auto start = Clock::now();
+        Vector<std::thread> threads;
+        threads.reserve(report.ThreadCount);
+        for (uint32 t = 0; t < report.ThreadCount; ++t)
+            threads.emplace_back(perThread, size_t(t));
+        for (std::thread& thread : threads)
+            thread.join();
+        return report.Operations / std::chrono::duration<double>(Clock::now() - start).count();
+    };
+
+    // Each thread holds at most one batch, so the list never runs dry
+    DescriptorFreeList freeList;
+    freeList.Reset(capacity);
+    report.PersistentOperationsPerSecond = measure([&](size_t)
+    {
+        uint32 slots[s_BatchSize];
+        for (uint32 done = 0; done < operationsPerThread; done += s_BatchSize)
+        {
+            const uint32 batch = std::min(s_BatchSize, operationsPerThread - done);
+            for (uint32 i = 0; i < batch; ++i)
+            {
+                slots[i] = freeList.Allocate();
+                if (slots[i] == DescriptorFreeList::s_InvalidIndex)
+                    failed.fetch_add(1, std::memory_order_relaxed);
+            }
+            for (uint32 i = 0; i < batch; ++i)
+            {
+                if (slots[i] != DescriptorFreeList::s_InvalidIndex)
+                    freeList.Free(slots[i]);
+            }
+        }
+    });
+
+    Vector<uint32> lockedSlots(capacity);
+    for (uint32 i = 0; i < capacity; ++i)
+        lockedSlots[i] = i;
+    std::mutex lockedMutex;
+    report.LockedOperationsPerSecond = measure([&](size_t)
+    {
+        uint32 slots[s_BatchSize];
+        for (uint32 done = 0; done < operationsPerThread; done += s_BatchSize)
+        {
+            const uint32 batch = std::min(s_BatchSize, operationsPerThread - done);
+            for (uint32 i = 0; i < batch; ++i)
+            {
+                std::lock_guard lock(lockedMutex);
+                slots[i] = lockedSlots.back();
+                lockedSlots.pop_back();
+            }
+            for (uint32 i = 0; i < batch; ++i)
+            {
+                std::lock_guard lock(lockedMutex);
+                lockedSlots.push_back(slots[i]);
+            }
+        }
+    });
+
+    // One frame holding every range
+    DescriptorRing ring;
+    ring.Reset(static_cast<uint32>(std::min<uint64>(report.Operations * s_MaxRangeSize, DescriptorRing::s_InvalidIndex - 1)));
+    report.TransientAllocationsPerSecond = measure([&](size_t thread)
+    {
+        for (uint32 i = 0; i < operationsPerThread; ++i)
+        {
+            if (ring.Allocate(1 + (uint32(thread) + i) % s_MaxRangeSize) == DescriptorRing::s_InvalidIndex)
+                failed.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    report.FailedAllocations = failed.load();
+    return report;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "Engine/BaseTypes.h"
+
+// Persistent descriptor slots [0, capacity) in a lock-free stack, so any recording thread may allocate and free.
+// The head carries a counter bumped by every change, so a pop racing with a pop and push of the same slot fails
+// its exchange instead of linking a stale next slot (ABA)
+class DescriptorFreeList
+{
+public:
+    static constexpr uint32 s_InvalidIndex = ~0u;
+
+    // Not thread safe, every slot becomes free and queued frees are dropped
+    void Reset(uint32 capacity);
+
+    // s_InvalidIndex when every slot is taken
+    uint32 Allocate();
+    // index must be allocated, freeing it twice corrupts the list
+    void Free(uint32 index);
+
+    // Frees index once the GPU finished the frame being recorded, for slots the frames in flight may still read.
+    // Any thread, behind a mutex since frees are rare. FinishFrame and Reclaim run on the frame thread
+    void FreeDeferred(uint32 index);
+    void FinishFrame(uint64 fenceValue);
+    void Reclaim(uint64 completedFenceValue);
+
+    uint32 GetCapacity() const { return m_Capacity; }
+    // Includes the slots waiting for their frame
+    uint32 GetAllocatedCount() const { return m_AllocatedCount.load(std::memory_order_relaxed); }
+
+private:
+    struct RetiredSlot
+    {
+        uint64 FenceValue = 0;
+        uint32 Index = 0;
+    };
+
+    static uint64 MakeHead(uint64 previousHead, uint32 index) { return (((previousHead >> 32) + 1) << 32) | index; }
+
+    std::atomic<uint64> m_Head{ s_InvalidIndex };
+    std::unique_ptr<std::atomic<uint32>[]> m_Next;
+    uint32 m_Capacity = 0;
+    std::atomic<uint32> m_AllocatedCount{ 0 };
+
+    std::mutex m_DeferredMutex;
+    Vector<uint32> m_Deferred;          // Freed while recording the current frame
+    Vector<RetiredSlot> m_Retired;      // Of the finished frames, in fence order
+};
+
+// Transient descriptor ranges of the frames in flight, like UploadRing but in slots and with a lock-free Allocate
+// for the recording threads. A range never straddles the end of the ring. FinishFrame and Reclaim run on the frame
+// thread while no other thread allocates
+class DescriptorRing
+{
+public:
+    static constexpr uint32 s_InvalidIndex = ~0u;
+
+    // Not thread safe, capacity 0 disables transient ranges
+    void Reset(uint32 capacity);
+
+    // First slot of count contiguous slots, s_InvalidIndex when the frames in flight fill the ring
+    uint32 Allocate(uint32 count);
+
+    void FinishFrame(uint64 fenceValue);
+    void Reclaim(uint64 completedFenceValue);
+
+    uint32 GetCapacity() const { return m_Capacity; }
+    // Slots in flight, including the ones skipped at the end of the ring
+    uint64 GetUsedCount() const { return m_Head.load(std::memory_order_relaxed) - m_Tail; }
+
+private:
+    struct FrameMark
+    {
+        uint64 FenceValue = 0;
+        uint64 End = 0;
+    };
+
+    // Head and tail count slots since the start, indices into the ring are modulo the capacity
+    uint32 m_Capacity = 0;
+    std::atomic<uint64> m_Head{ 0 };
+    uint64 m_Tail = 0;
+    Vector<FrameMark> m_Frames;
+};
+
+struct DescriptorContentionReport
+{
+    uint32 ThreadCount = 0;
+    uint64 Operations = 0;
+    double PersistentOperationsPerSecond = 0.0;     // Allocate plus Free of the lock-free list
+    double LockedOperationsPerSecond = 0.0;         // The same on a mutex guarded stack, for comparison
+    double TransientAllocationsPerSecond = 0.0;
+    uint64 FailedAllocations = 0;                   // Should stay 0, the benchmark never exhausts either
+};
+
+// Headless benchmark: threadCount threads each allocate and free operationsPerThread persistent slots in batches of
+// 16 and allocate as many transient ranges of 1 to 8 slots
+DescriptorContentionReport RunDescriptorContentionBenchmark(uint32 threadCount, uint32 operationsPerThread = 100000);
@@ -0,0 +1,104 @@
+#include "DrawList.h"
+
+#include <chrono>
+
+#include "Engine/Object.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/MeshPipeline.h"
+#include "Graphics/UploadRingBuffer.h"
+
+void DrawList::Begin(float nearZ, float farZ)
+{
+    if (!(farZ > nearZ))
+        throw std::invalid_argument("DrawList::Begin: farZ must be greater than nearZ");
+
+    m_Items.clear();
+    m_Order.clear();
+    m_PipelineIds.clear();
+    m_MeshIds.clear();
+    m_NearZ = nearZ;
+    m_DepthScale = float((1u << DrawSortKey::s_DepthBits) - 1) / (farZ - nearZ);
+}
+
+void DrawList::Add(Object& object, const MeshPipeline& pipeline, float viewDepth)
+{
+    if (!object.IsDrawable())
+        return;
+
+    const Mesh* mesh = object.GetMesh().get();
+    const uint32 depth = static_cast<uint32>(Clamp((viewDepth - m_NearZ) * m_DepthScale, 0.0f, float((1u << DrawSortKey::s_DepthBits) - 1)));
+    const uint64 key = DrawSortKey::Make(GetId(m_PipelineIds, &pipeline), mesh->GetMaterialIndex(), GetId(m_MeshIds, mesh), depth);
+
+    m_Order.push_back(RadixSortItem{ key, static_cast<uint32>(m_Items.size()) });
+    m_Items.push_back(DrawItem{ key, &object, &pipeline });
+}
+
+void DrawList::Sort()
+{
+    m_Stats.Unsorted = CountStateChanges(m_Items, m_Order);
+
+    const auto start = std::chrono::steady_clock::now();
+    RadixSort(m_Order, m_SortScratch);
+    m_Stats.SortMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    m_Stats.Sorted = CountStateChanges(m_Items, m_Order);
+}
+
+void DrawList::Submit(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS frameDataAddress, UploadRingBuffer& uploadRing,
+    const MaterialTable& materials) const
+{
+    const MeshPipeline* pipeline = nullptr;
+    const Mesh* buffers = nullptr;
+    for (const RadixSortItem& entry : m_Order)
+    {
+        const DrawItem& item = m_Items[entry.Value];
+        const Mesh& mesh = *item.Object->GetMesh();
+
+        // Setting the root signature clears all root bindings
+        if (item.Pipeline != pipeline)
+        {
+            pipeline = item.Pipeline;
+            pipeline->Bind(commandList);
+            commandList->SetGraphicsRootConstantBufferView(0, frameDataAddress);
+            materials.Bind(commandList);
+        }
+        if (&mesh != buffers)
+        {
+            buffers = &mesh;
+            mesh.BindBuffers(commandList);
+        }
+
+        item.Object->BindConstants(commandList, uploadRing);
+        mesh.DrawIndexed(commandList);
+    }
+}
+
+DrawStateStats DrawList::CountStateChanges(Span<const DrawItem> items, Span<const RadixSortItem> order)
+{
+    DrawStateStats stats;
+    const MeshPipeline* pipeline = nullptr;
+    const Mesh* buffers = nullptr;
+    for (const RadixSortItem& entry : order)
+    {
+        const DrawItem& item = items[entry.Value];
+        const Mesh* mesh = item.Object->GetMesh().get();
+        stats.Draws++;
+        if (item.Pipeline != pipeline)
+        {
+            pipeline = item.Pipeline;
+            stats.PipelineChanges++;
+        }
+        if (mesh != buffers)
+        {
+            buffers = mesh;
+            stats.VertexBufferChanges++;
+        }
+    }
+    return stats;
+}
+
+uint32 DrawList::GetId(HashMap<const void*, uint32>& ids, const void* key)
+{
+    return ids.emplace(key, static_cast<uint32>(ids.size())).first->second;
+}
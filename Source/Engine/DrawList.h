@@ -0,0 +1,94 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/RadixSort.h"
+
+class Object;
+class Mesh;
+class MaterialTable;
+class MeshPipeline;
+class UploadRingBuffer;
+
+// 64-bit draw order, most significant first: pipeline, material, mesh, then quantized view depth front to back.
+// The material field is the MaterialTable index, which binds nothing but keeps draws sharing textures together.
+// Pipeline and mesh ids are handed out per frame in the order DrawList first sees them, so destroyed objects never
+// leave stale ids behind. They wrap when a field overflows, which only costs batching since submission compares the
+// real objects
+namespace DrawSortKey
+{
+    constexpr uint32 s_PipelineBits = 8;
+    constexpr uint32 s_MaterialBits = 16;
+    constexpr uint32 s_MeshBits = 16;
+    constexpr uint32 s_DepthBits = 24;
+    static_assert(s_PipelineBits + s_MaterialBits + s_MeshBits + s_DepthBits == 64, "Sort key fields must fill 64 bits");
+
+    constexpr uint64 Make(uint32 pipeline, uint32 material, uint32 mesh, uint32 depth) noexcept
+    {
+        return (uint64(pipeline & ((1u << s_PipelineBits) - 1)) << (s_MaterialBits + s_MeshBits + s_DepthBits))
+            | (uint64(material & ((1u << s_MaterialBits) - 1)) << (s_MeshBits + s_DepthBits))
+            | (uint64(mesh & ((1u << s_MeshBits) - 1)) << s_DepthBits)
+            | uint64(depth & ((1u << s_DepthBits) - 1));
+    }
+}
+
+struct DrawItem
+{
+    uint64 SortKey = 0;
+    ::Object* Object = nullptr;
+    const MeshPipeline* Pipeline = nullptr;
+};
+
+// Binds a submission order would issue, each counted only when the state differs from the previous draw
+struct DrawStateStats
+{
+    uint32 Draws = 0;
+    uint32 PipelineChanges = 0;         // SetPipelineState, with the root signature, frame constants and material table
+    uint32 VertexBufferChanges = 0;     // IASetVertexBuffers and IASetIndexBuffer
+};
+
+struct DrawListStats
+{
+    DrawStateStats Unsorted;            // In the order the items were added
+    DrawStateStats Sorted;
+    double SortMilliseconds = 0.0;
+};
+
+// Per-frame list of draws submitted in sort key order, so pipeline and vertex buffer binds are only issued when they
+// change. Typical frame: Begin, Add every visible object, Sort, Submit
+class DrawList
+{
+public:
+    // Clears the items and the sort key ids. Depth is quantized linearly over [nearZ, farZ]
+    void Begin(float nearZ, float farZ);
+
+    // viewDepth is the distance along the view direction. Objects that cannot draw are skipped
+    void Add(Object& object, const MeshPipeline& pipeline, float viewDepth);
+
+    // Parallel LSD radix sort of the keys, also fills the state change counters for both orders
+    void Sort();
+
+    // Draws in sorted order. After each pipeline bind the frame constants (b0) are bound from frameDataAddress along with
+    // the material table, the object constants (b1) are written into uploadRing
+    void Submit(ID3D12GraphicsCommandList* commandList, D3D12_GPU_VIRTUAL_ADDRESS frameDataAddress, UploadRingBuffer& uploadRing,
+        const MaterialTable& materials) const;
+
+    size_t GetItemCount() const { return m_Items.size(); }
+    const DrawItem& GetSortedItem(size_t i) const { return m_Items[m_Order[i].Value]; }
+    const DrawListStats& GetStats() const { return m_Stats; }
+
+    static DrawStateStats CountStateChanges(Span<const DrawItem> items, Span<const RadixSortItem> order);
+
+private:
+    uint32 GetId(HashMap<const void*, uint32>& ids, const void* key);
+
+    Vector<DrawItem> m_Items;
+    Vector<RadixSortItem> m_Order;
+    Vector<RadixSortItem> m_SortScratch;
+    // Keyed by address, only valid for the frame: a new object may reuse a destroyed one's address
+    HashMap<const void*, uint32> m_PipelineIds;
+    HashMap<const void*, uint32> m_MeshIds;
+    float m_NearZ = 0.0f;
+    float m_DepthScale = 0.0f;
+    DrawListStats m_Stats;
+};
@@ -0,0 +1,147 @@
+#include "Engine/FastMath.h"
+
+#include <chrono>
+
+namespace
+{
+    enum class UnaryOp
+    {
+        Sin,
+        Cos,
+        Atan,
+        Exp,
+        Log
+    };
+
+    template<class L>
+    struct UnaryKernel
+    {
+        static void Run(UnaryOp op, const float* x, float* out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                const typename B::Reg v = B::Load(x + i);
+                switch (op)
+                {
+                case UnaryOp::Sin: B::Store(out + i, FastSinCosImpl<B>(v, 0)); break;
+                case UnaryOp::Cos: B::Store(out + i, FastSinCosImpl<B>(v, 1)); break;
+                case UnaryOp::Atan: B::Store(out + i, FastAtanImpl<B>(v)); break;
+                case UnaryOp::Exp: B::Store(out + i, FastExpImpl<B>(v)); break;
+                case UnaryOp::Log: B::Store(out + i, FastLogImpl<B>(v)); break;
+                }
+            });
+        }
+    };
+
+    template<class L>
+    struct PowKernel
+    {
+        static void Run(const float* x, const float* y, float* out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                B::Store(out + i, FastPowImpl<B>(B::Load(x + i), B::Load(y + i)));
+            });
+        }
+    };
+
+    void RunUnary(UnaryOp op, Span<const float> x, Span<float> out)
+    {
+        if (x.size() != out.size())
+            throw std::invalid_argument("FastMath: input and output spans differ in length");
+        DispatchSimd<UnaryKernel>(op, x.data(), out.data(), out.size());
+    }
+}
+
+void FastSinN(Span<const float> x, Span<float> out)
+{
+    RunUnary(UnaryOp::Sin, x, out);
+}
+
+void FastCosN(Span<const float> x, Span<float> out)
+{
+    RunUnary(UnaryOp::Cos, x, out);
+}
+
+void FastAtanN(Span<const float> x, Span<float> out)
+{
+    RunUnary(UnaryOp::Atan, x, out);
+}
+
+void FastExpN(Span<const float> x, Span<float> out)
+{
+    RunUnary(UnaryOp::Exp, x, out);
+}
+
+void FastLogN(Span<const float> x, Span<float> out)
+{
+    RunUnary(UnaryOp::Log, x, out);
+}
+
+void FastPowN(Span<const float> x, Span<const float> y, Span<float> out)
+{
+    if (x.size() != out.size() || y.size() != out.size())
+        throw std::invalid_argument("FastMath: input and output spans differ in length");
+    DispatchSimd<PowKernel>(x.data(), y.data(), out.data(), out.size());
+}
+
+FastMathBenchmarkReport RunFastMathBenchmark(uint32 valueCount, uint32 iterations)
+{
+    FastMathBenchmarkReport report;
+    report.ValueCount = valueCount;
+    report.Level = GetSimdLevel();
+    if (valueCount == 0 || iterations == 0)
+        return report;
+
+    // Angles within +-8 pi, a wide atan range, exp without overflow and positive inputs for log and pow
+    Vector<float> angles(valueCount), wide(valueCount), exponents(valueCount), positive(valueCount), powers(valueCount);
+    Vector<float> out(valueCount);
+    for (uint32 i = 0; i < valueCount; ++i)
+    {
+        const float t = float(i) / float(valueCount);
+        angles[i] = (t - 0.5f) * 16.0f * PI;
+        wide[i] = (t - 0.5f) * 200.0f;
+        exponents[i] = (t - 0.5f) * 160.0f;
+        positive[i] = 1e-3f + t * 1000.0f;
+        powers[i] = 0.5f + t * 2.0f;
+    }
+
+    auto measure = [&](auto&& pass)
+    {
+        pass();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            pass();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? double(valueCount) * iterations / seconds : 0.0;
+    };
+    auto unary = [&](FastMathBenchmarkReport::Function& function, const char* name, const Vector<float>& x,
+        float (*reference)(float), void (*batch)(Span<const float>, Span<float>))
+    {
+        function.Name = name;
+        function.StdValuesPerSecond = measure([&]
+        {
+            for (uint32 i = 0; i < valueCount; ++i)
+                out[i] = reference(x[i]);
+        });
+        function.FastValuesPerSecond = measure([&] { batch(x, out); });
+    };
+
+    unary(report.Functions[0], "Sin", angles, [](float v) { return std::sin(v); }, FastSinN);
+    unary(report.Functions[1], "Cos", angles, [](float v) { return std::cos(v); }, FastCosN);
+    unary(report.Functions[2], "Atan", wide, [](float v) { return std::atan(v); }, FastAtanN);
+    unary(report.Functions[3], "Exp", exponents, [](float v) { return std::exp(v); }, FastExpN);
+    unary(report.Functions[4], "Log", positive, [](float v) { return std::log(v); }, FastLogN);
+
+    FastMathBenchmarkReport::Function& pow = report.Functions[5];
+    pow.Name = "Pow";
+    pow.StdValuesPerSecond = measure([&]
+    {
+        for (uint32 i = 0; i < valueCount; ++i)
+            out[i] = std::pow(positive[i], powers[i]);
+    });
+    pow.FastValuesPerSecond = measure([&] { FastPowN(positive, powers, out); });
+    return report;
+}
@@ -0,0 +1,197 @@
+#pragma once
+#include <limits>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/SimdLanes.h"
+
+// Polynomial approximations of the transcendental functions in BaseTypes.h.
+// Every function has a scalar, 4-wide (SSE) and 8-wide (AVX2, caller checks GetSimdLevel()) form plus a dispatched batch version over spans.
+// Build with THOR_FAST_MATH to route Sin/Cos/Atan/Exp/Log/Pow in BaseTypes.h through the scalar forms.
+//
+// Max error against a double precision reference, in float ULPs (measured over dense sweeps of each range):
+//   FastSin, FastCos   1.5 ULP for |x| <= pi (FastCos for |x| <= 1.5, away from its zeros). Up to |x| = 8192 the error
+//                      stays below 1.6 ULP of max(|result|, 0.5)
+//   FastAtan           2.7 ULP over all finite x
+//   FastExp            1 ULP for x in [-87.3, 88.7]; returns 0 below (denormals are flushed) and +inf above
+//   FastLog            1 ULP for normal positive x; -inf for 0, +inf for +inf, NaN for negative x and NaN. Denormal
+//                      inputs are not supported
+//   FastPow            Exp(y * Log(x)), so the error grows by about 1.6 ULP per unit of |y * log(x)|: 10 ULP up to 6,
+//                      25 ULP at 16, 145 ULP near the float limits. Only defined for x >= 0, unlike std::pow which accepts
+//                      negative x with integral y
+// SIMD forms return the same results as the scalar ones up to FMA contraction, which FastPow amplifies like its error.
+// Tests/FastMathTests.cpp checks this table.
+
+// ---------- Generic bodies over SimdLanes ------------
+template<class L>
+inline typename L::Reg FastSinCosImpl(typename L::Reg x, int32 quadrantOffset)
+{
+    // Reduce to r in [-pi/4, pi/4] with x = r + k * pi/2, pi/2 split in three parts (Cody-Waite) to keep r exact
+    const typename L::IReg k = L::ToIntRound(L::Mul(x, L::Set1(0.636619772f)));
+    const typename L::Reg kf = L::ToFloat(k);
+    typename L::Reg r = L::MulAdd(kf, L::Set1(-1.5703125f), x);
+    r = L::MulAdd(kf, L::Set1(-4.837512969970703125e-4f), r);
+    r = L::MulAdd(kf, L::Set1(-7.54978995489188216e-8f), r);
+    const typename L::Reg r2 = L::Mul(r, r);
+
+    // Minimax polynomials on [-pi/4, pi/4] (Cephes)
+    typename L::Reg sinPoly = L::MulAdd(r2, L::Set1(-1.9515295891e-4f), L::Set1(8.3321608736e-3f));
+    sinPoly = L::MulAdd(sinPoly, r2, L::Set1(-1.6666654611e-1f));
+    sinPoly = L::MulAdd(L::Mul(sinPoly, r2), r, r);
+
+    typename L::Reg cosPoly = L::MulAdd(r2, L::Set1(2.443315711809948e-5f), L::Set1(-1.388731625493765e-3f));
+    cosPoly = L::MulAdd(cosPoly, r2, L::Set1(4.166664568298827e-2f));
+    cosPoly = L::MulAdd(L::Mul(cosPoly, r2), r2, L::MulAdd(r2, L::Set1(-0.5f), L::Set1(1.0f)));
+
+    // Odd quadrants swap sin and cos, quadrants 2 and 3 flip the sign
+    const typename L::IReg quadrant = L::IAdd(k, L::ISet1(quadrantOffset));
+    const typename L::Reg result = L::Select(L::TestBits(quadrant, 1), cosPoly, sinPoly);
+    const typename L::Reg sign = L::AsFloat(L::ShiftLeft(L::IAnd(quadrant, L::ISet1(2)), 30));
+    return L::Xor(result, sign);
+}
+
+template<class L>
+inline typename L::Reg FastAtanImpl(typename L::Reg x)
+{
+    const typename L::Reg sign = L::And(x, L::Set1(-0.0f));
+    const typename L::Reg ax = L::Abs(x);
+
+    // atan(x) = pi/2 + atan(-1/x) above tan(3pi/8), pi/4 + atan((x-1)/(x+1)) above tan(pi/8)
+    const typename L::Mask large = L::CmpGt(ax, L::Set1(2.414213562373095f));
+    const typename L::Mask medium = L::CmpGt(ax, L::Set1(0.4142135623730950f));
+    const typename L::Reg one = L::Set1(1.0f);
+    const typename L::Reg numerator = L::Select(large, L::Set1(-1.0f), L::Select(medium, L::Sub(ax, one), ax));
+    const typename L::Reg denominator = L::Select(large, ax, L::Select(medium, L::Add(ax, one), one));
+    const typename L::Reg offset = L::Select(large, L::Set1(HALF_PI), L::Select(medium, L::Set1(QUARTER_PI), L::Set1(0.0f)));
+
+    const typename L::Reg t = L::Div(numerator, denominator);
+    const typename L::Reg z = L::Mul(t, t);
+    typename L::Reg poly = L::MulAdd(z, L::Set1(8.05374449538e-2f), L::Set1(-1.38776856032e-1f));
+    poly = L::MulAdd(poly, z, L::Set1(1.99777106478e-1f));
+    poly = L::MulAdd(poly, z, L::Set1(-3.33329491539e-1f));
+    poly = L::MulAdd(L::Mul(poly, z), t, t);
+
+    return L::Xor(L::Add(offset, poly), sign);
+}
+
+template<class L>
+inline typename L::Reg FastExpImpl(typename L::Reg x)
+{
+    // e^x = 2^n * e^r with n = round(x / ln2), r in [-ln2/2, ln2/2]; 2^n is built directly in the exponent bits
+    const typename L::Reg clamped = L::Min(L::Max(x, L::Set1(-87.3f)), L::Set1(88.72283f));
+    const typename L::IReg n = L::ToIntRound(L::Mul(clamped, L::Set1(1.44269504089f)));
+    const typename L::Reg nf = L::ToFloat(n);
+    typename L::Reg r = L::MulAdd(nf, L::Set1(-0.693359375f), clamped);
+    r = L::MulAdd(nf, L::Set1(2.12194440e-4f), r);
+
+    typename L::Reg poly = L::MulAdd(r, L::Set1(1.9875691500e-4f), L::Set1(1.3981999507e-3f));
+    poly = L::MulAdd(poly, r, L::Set1(8.3334519073e-3f));
+    poly = L::MulAdd(poly, r, L::Set1(4.1665795894e-2f));
+    poly = L::MulAdd(poly, r, L::Set1(1.6666665459e-1f));
+    poly = L::MulAdd(poly, r, L::Set1(5.0000001201e-1f));
+    poly = L::Add(L::MulAdd(poly, L::Mul(r, r), r), L::Set1(1.0f));
+
+    // n reaches 128 at the top of the range, so 2^n is applied as two halves that are always representable
+    const typename L::IReg nLow = L::ToIntRound(L::Mul(nf, L::Set1(0.5f)));
+    const typename L::IReg nHigh = L::ISub(n, nLow);
+    const typename L::Reg scaleLow = L::AsFloat(L::ShiftLeft(L::IAdd(nLow, L::ISet1(127)), 23));
+    const typename L::Reg scaleHigh = L::AsFloat(L::ShiftLeft(L::IAdd(nHigh, L::ISet1(127)), 23));
+    typename L::Reg result = L::Mul(L::Mul(poly, scaleLow), scaleHigh);
+
+    // Outside the clamp range the result saturates to the IEEE limits, denormal results are flushed to 0
+    result = L::Select(L::CmpLt(x, L::Set1(-87.3f)), L::Set1(0.0f), result);
+    result = L::Select(L::CmpGt(x, L::Set1(88.72283f)), L::Set1(std::numeric_limits<float>::infinity()), result);
+    return result;
+}
+
+template<class L>
+inline typename L::Reg FastLogImpl(typename L::Reg x)
+{
+    // x = m * 2^e with m in [sqrt(0.5), sqrt(2)), log(x) = e * ln2 + log(m)
+    const typename L::IReg bits = L::AsInt(x);
+    typename L::IReg exponent = L::ISub(L::ShiftRight(bits, 23), L::ISet1(126));
+    typename L::Reg m = L::AsFloat(L::IOr(L::IAnd(bits, L::ISet1(0x007FFFFF)), L::ISet1(0x3F000000)));
+
+    const typename L::Mask belowSqrtHalf = L::CmpLt(m, L::Set1(0.707106781186547524f));
+    const typename L::Reg e = L::Sub(L::ToFloat(exponent), L::Select(belowSqrtHalf, L::Set1(1.0f), L::Set1(0.0f)));
+    const typename L::Reg f = L::Sub(L::Add(m, L::Select(belowSqrtHalf, m, L::Set1(0.0f))), L::Set1(1.0f));
+    const typename L::Reg z = L::Mul(f, f);
+
+    // Minimax polynomial for log(1 + f) (Cephes)
+    typename L::Reg poly = L::MulAdd(f, L::Set1(7.0376836292e-2f), L::Set1(-1.1514610310e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(1.1676998740e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(-1.2420140846e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(1.4249322787e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(-1.6668057665e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(2.0000714765e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(-2.4999993993e-1f));
+    poly = L::MulAdd(poly, f, L::Set1(3.3333331174e-1f));
+    poly = L::Mul(L::Mul(poly, f), z);
+
+    poly = L::MulAdd(e, L::Set1(-2.12194440e-4f), poly);
+    poly = L::MulAdd(z, L::Set1(-0.5f), poly);
+    typename L::Reg result = L::Add(f, poly);
+    result = L::MulAdd(e, L::Set1(0.693359375f), result);
+
+    // +inf maps to itself. Adding x to -inf keeps -inf for zero and propagates NaN, which both compares reject
+    result = L::Select(L::CmpGt(x, L::Set1(std::numeric_limits<float>::max())), x, result);
+    const typename L::Reg invalid = L::Select(L::CmpLt(x, L::Set1(0.0f)),
+        L::Set1(std::numeric_limits<float>::quiet_NaN()),
+        L::Add(L::Set1(-std::numeric_limits<float>::infinity()), x));
+    return L::Select(L::CmpGt(x, L::Set1(0.0f)), result, invalid);
+}
+
+template<class L>
+inline typename L::Reg FastPowImpl(typename L::Reg x, typename L::Reg y)
+{
+    return FastExpImpl<L>(L::Mul(y, FastLogImpl<L>(x)));
+}
+
+// ---------- Scalar ------------
+inline float FastSin(float x) noexcept { return FastSinCosImpl<ScalarLanes>(x, 0); }
+inline float FastCos(float x) noexcept { return FastSinCosImpl<ScalarLanes>(x, 1); }
+inline float FastAtan(float x) noexcept { return FastAtanImpl<ScalarLanes>(x); }
+inline float FastExp(float x) noexcept { return FastExpImpl<ScalarLanes>(x); }
+inline float FastLog(float x) noexcept { return FastLogImpl<ScalarLanes>(x); }
+inline float FastPow(float x, float y) noexcept { return FastPowImpl<ScalarLanes>(x, y); }
+
+// ---------- 4-wide ------------
+inline __m128 FastSin(__m128 x) noexcept { return FastSinCosImpl<SseLanes>(x, 0); }
+inline __m128 FastCos(__m128 x) noexcept { return FastSinCosImpl<SseLanes>(x, 1); }
+inline __m128 FastAtan(__m128 x) noexcept { return FastAtanImpl<SseLanes>(x); }
+inline __m128 FastExp(__m128 x) noexcept { return FastExpImpl<SseLanes>(x); }
+inline __m128 FastLog(__m128 x) noexcept { return FastLogImpl<SseLanes>(x); }
+inline __m128 FastPow(__m128 x, __m128 y) noexcept { return FastPowImpl<SseLanes>(x, y); }
+
+// ---------- 8-wide, AVX2 + FMA only ------------
+inline __m256 FastSin(__m256 x) noexcept { return FastSinCosImpl<Avx2Lanes>(x, 0); }
+inline __m256 FastCos(__m256 x) noexcept { return FastSinCosImpl<Avx2Lanes>(x, 1); }
+inline __m256 FastAtan(__m256 x) noexcept { return FastAtanImpl<Avx2Lanes>(x); }
+inline __m256 FastExp(__m256 x) noexcept { return FastExpImpl<Avx2Lanes>(x); }
+inline __m256 FastLog(__m256 x) noexcept { return FastLogImpl<Avx2Lanes>(x); }
+inline __m256 FastPow(__m256 x, __m256 y) noexcept { return FastPowImpl<Avx2Lanes>(x, y); }
+
+// ---------- Batches, dispatched on GetSimdLevel(). out may alias the inputs ------------
+void FastSinN(Span<const float> x, Span<float> out);
+void FastCosN(Span<const float> x, Span<float> out);
+void FastAtanN(Span<const float> x, Span<float> out);
+void FastExpN(Span<const float> x, Span<float> out);
+void FastLogN(Span<const float> x, Span<float> out);
+void FastPowN(Span<const float> x, Span<const float> y, Span<float> out);
+
+struct FastMathBenchmarkReport
+{
+    struct Function
+    {
+        const char* Name = "";
+        double StdValuesPerSecond = 0.0;        // std:: function in a scalar loop
+        double FastValuesPerSecond = 0.0;       // Batch form at the dispatched level
+    };
+
+    uint32 ValueCount = 0;
+    SimdLevel Level = SimdLevel::Scalar;        // Level the dispatch picks on this CPU
+    Function Functions[6];                      // Sin, Cos, Atan, Exp, Log, Pow
+};
+
+// Headless benchmark: iterations passes of each batch function over valueCount inputs in its accurate range, against
+// the matching std:: function
+FastMathBenchmarkReport RunFastMathBenchmark(uint32 valueCount = 1 << 20, uint32 iterations = 20);
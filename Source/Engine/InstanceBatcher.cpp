@@ -0,0 +1,70 @@
+#include "InstanceBatcher.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+void InstanceBatcher::Build(Span<const Mesh* const> meshes, Span<const VertexFormat> formats, Span<const ObjectData> instances)
+{
+    if (meshes.size() != instances.size() || formats.size() != instances.size())
+    {
+        throw std::invalid_argument("InstanceBatcher::Build: every instance needs a mesh and a vertex format");
+    }
+
+    m_Batches.clear();
+    m_BatchIndices.clear();
+    m_InstanceBatch.resize(meshes.size());
+
+    // Count the instances per mesh, batches numbered by first appearance
+    for (size_t i = 0; i < meshes.size(); ++i)
+    {
+        const auto [it, inserted] = m_BatchIndices.try_emplace(meshes[i], static_cast<uint32>(m_Batches.size()));
+        if (inserted)
+            m_Batches.push_back(InstanceBatch{ meshes[i], formats[i], 0, 0 });
+        else if (m_Batches[it->second].Format != formats[i])
+            throw std::invalid_argument("Instances of the same mesh must have the same vertex format");
+        m_Batches[it->second].InstanceCount++;
+        m_InstanceBatch[i] = it->second;
+    }
+
+    // Formats ranked by first appearance, batches stably grouped by format
+    uint32 formatRanks[256];
+    std::fill(std::begin(formatRanks), std::end(formatRanks), ~0u);
+    m_Stats = {};
+    for (const InstanceBatch& batch : m_Batches)
+    {
+        uint32& rank = formatRanks[static_cast<uint8>(batch.Format)];
+        if (rank == ~0u)
+            rank = m_Stats.Formats++;
+    }
+    m_BatchOrder.resize(m_Batches.size());
+    for (uint32 i = 0; i < m_BatchOrder.size(); ++i)
+        m_BatchOrder[i] = i;
+    std::stable_sort(m_BatchOrder.begin(), m_BatchOrder.end(), [&](uint32 a, uint32 b)
+    {
+        return formatRanks[static_cast<uint8>(m_Batches[a].Format)] < formatRanks[static_cast<uint8>(m_Batches[b].Format)];
+    });
+
+    // Prefix sum into the first instances in sorted order, the counts are rebuilt as write cursors
+    uint32 first = 0;
+    for (uint32 index : m_BatchOrder)
+    {
+        InstanceBatch& batch = m_Batches[index];
+        m_Stats.LargestBatch = std::max(m_Stats.LargestBatch, batch.InstanceCount);
+        batch.FirstInstance = first;
+        first += batch.InstanceCount;
+        batch.InstanceCount = 0;
+    }
+
+    m_Instances.resize(instances.size());
+    for (size_t i = 0; i < instances.size(); ++i)
+    {
+        InstanceBatch& batch = m_Batches[m_InstanceBatch[i]];
+        m_Instances[batch.FirstInstance + batch.InstanceCount++] = instances[i];
+    }
+
+    // Batches in draw order
+    std::sort(m_Batches.begin(), m_Batches.end(), [](const InstanceBatch& a, const InstanceBatch& b) { return a.FirstInstance < b.FirstInstance; });
+
+    m_Stats.Objects = static_cast<uint32>(instances.size());
+    m_Stats.Batches = static_cast<uint32>(m_Batches.size());
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/ObjectData.h"
+
+class Mesh;
+enum class VertexFormat : uint8;
+
+// One instanced draw: InstanceCount consecutive elements of the instance list, starting at FirstInstance
+struct InstanceBatch
+{
+    const ::Mesh* Mesh = nullptr;
+    VertexFormat Format{};
+    uint32 FirstInstance = 0;
+    uint32 InstanceCount = 0;
+};
+
+struct InstanceBatchStats
+{
+    uint32 Objects = 0;
+    uint32 Batches = 0;
+    uint32 LargestBatch = 0;
+    uint32 Formats = 0;         // Pipeline binds needed, one per vertex format drawn
+};
+
+// Groups instances that draw the same mesh, and with it the same material, into one instanced draw each and packs
+// their constants into one contiguous list for the instance buffer. CPU only, Graphics/InstanceBuffer.h uploads and
+// draws the result. Batches of the same vertex format are adjacent so each format binds its pipeline once; formats
+// come in the order of their first instance, the batches of a format in the order of their first instance, and a
+// batch keeps the order of its instances
+class InstanceBatcher
+{
+public:
+    // meshes[i], of vertex format formats[i], draws instances[i]. The mesh pointers are only compared, never
+    // dereferenced
+    void Build(Span<const Mesh* const> meshes, Span<const VertexFormat> formats, Span<const ObjectData> instances);
+
+    const Vector<InstanceBatch>& GetBatches() const { return m_Batches; }
+    const Vector<ObjectData>& GetInstances() const { return m_Instances; }
+    const InstanceBatchStats& GetStats() const { return m_Stats; }
+
+private:
+    Vector<InstanceBatch> m_Batches;
+    Vector<ObjectData> m_Instances;
+    Vector<uint32> m_InstanceBatch;
+    Vector<uint32> m_BatchOrder;
+    HashMap<const Mesh*, uint32> m_BatchIndices;
+    InstanceBatchStats m_Stats;
+};
@@ -0,0 +1,45 @@
+#include "LodSelection.h"
+#include "Engine/Object.h"
+
+LodSelectionStats SelectLods(Span<Object* const> objects, const Camera& camera, float viewportHeight, const LodSelectionSettings& settings)
+{
+    LodSelectionStats stats;
+    const float3& eye = camera.GetPosition();
+
+    for (Object* object : objects)
+    {
+        const SharedPtr<const LodSet>& lodSet = object->GetLodSet();
+        if (!lodSet || lodSet->GetLevelCount() == 0)
+            continue;
+
+        const Vector<LodLevel>& levels = lodSet->GetLevels();
+        const Transform& transform = object->GetTransform();
+        const float scale = std::max({ std::abs(transform.Scale.x), std::abs(transform.Scale.y), std::abs(transform.Scale.z) });
+        const float3 center = transform.Translation + QuaternionRotate(transform.Rotation, lodSet->GetBoundsCenter() * transform.Scale);
+        const float distance = Length(center - eye) - lodSet->GetBoundsRadius() * scale;
+
+        // Pixels per object-space unit of error at the nearest point of the bounding sphere
+        const float pixelsPerUnit = ProjectLodError(camera, viewportHeight, scale, distance);
+
+        const uint32 selected = SelectLodLevel(levels, object->GetLodLevel(), pixelsPerUnit, settings);
+
+        // Uploads over the staging budget take several frames, draw a level that is already there meanwhile
+        const uint32 level = FindResidentLevel(static_cast<uint32>(levels.size()), selected,
+            [&](uint32 l) { return levels[l].Mesh && levels[l].Mesh->IsResident(); });
+        if (level != selected)
+            stats.NonResidentFallbacks++;
+
+        if (level != object->GetLodLevel())
+        {
+            object->SetLodLevel(level);
+            stats.LevelChanges++;
+        }
+
+        stats.ObjectCount++;
+        stats.TrianglesFull += levels.front().TriangleCount;
+        stats.TrianglesSelected += levels[level].TriangleCount;
+    }
+
+    stats.TrianglesSaved = stats.TrianglesFull - stats.TrianglesSelected;
+    return stats;
+}
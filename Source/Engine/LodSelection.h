@@ -0,0 +1,70 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/Camera.h"
+#include "Graphics/LodSet.h"
+
+class Object;
+
+struct LodSelectionSettings
+{
+    float MaxPixelError = 1.0f;     // Coarsest level whose projected error stays below this many pixels is chosen
+    float Hysteresis = 0.25f;       // A coarser level is only taken once its error is this fraction below MaxPixelError
+};
+
+struct LodSelectionStats
+{
+    size_t ObjectCount = 0;         // Objects with a LOD set
+    size_t LevelChanges = 0;
+    uint64 TrianglesFull = 0;       // Triangles had every object drawn its finest level
+    uint64 TrianglesSelected = 0;
+    uint64 TrianglesSaved = 0;
+    size_t NonResidentFallbacks = 0; // Objects drawing another level while the selected one waits for its upload
+};
+
+// Screen-space error of an object-space error at the given distance, in pixels of a viewport viewportHeight pixels tall
+inline float ProjectLodError(const Camera& camera, float viewportHeight, float error, float distance)
+{
+    const float focalLength = viewportHeight / (2.0f * Tan(camera.GetFovY() * 0.5f));
+    return error * focalLength / std::max(distance, camera.GetNearZ());
+}
+
+// Level to draw when one object-space unit of error projects to pixelsPerUnit pixels, starting from the current one.
+// Going finer happens as soon as the current level exceeds MaxPixelError, going coarser only below the hysteresis band
+inline uint32 SelectLodLevel(Span<const LodLevel> levels, uint32 current, float pixelsPerUnit, const LodSelectionSettings& settings = {})
+{
+    if (levels.empty())
+        return 0;
+
+    const float coarserThreshold = settings.MaxPixelError * (1.0f - Clamp(settings.Hysteresis, 0.0f, 1.0f));
+    uint32 level = std::min(current, static_cast<uint32>(levels.size()) - 1);
+    while (level > 0 && levels[level].Error * pixelsPerUnit > settings.MaxPixelError)
+        level--;
+    while (level + 1 < levels.size() && levels[level + 1].Error * pixelsPerUnit <= coarserThreshold)
+        level++;
+    return level;
+}
+
+// Level drawn instead of level while its mesh is not resident: the nearest coarser resident one, else the nearest finer
+// one, else level itself, which the draw then skips. isResident(l) tells whether level l can be drawn
+template<class IsResident>
+uint32 FindResidentLevel(uint32 levelCount, uint32 level, IsResident&& isResident)
+{
+    if (level >= levelCount || isResident(level))
+        return level;
+    for (uint32 coarser = level + 1; coarser < levelCount; ++coarser)
+    {
+        if (isResident(coarser))
+            return coarser;
+    }
+    for (uint32 finer = level; finer-- > 0;)
+    {
+        if (isResident(finer))
+            return finer;
+    }
+    return level;
+}
+
+// Picks the level of every object with a LOD set with SelectLodLevel, from the distance to its bounding sphere clamped
+// to the near plane, falling back with FindResidentLevel while its mesh waits for a staging upload. Objects without a
+// LOD set are skipped. Run once per frame before drawing
+LodSelectionStats SelectLods(Span<Object* const> objects, const Camera& camera, float viewportHeight, const LodSelectionSettings& settings = {});
@@ -0,0 +1,280 @@
+#include "Engine/MatrixBatch.h"
+
+#include <chrono>
+
+namespace
+{
+    // ---------- Scalar ------------
+    void MultiplyScalar(const float4x4& a, const float4x4& b, float4x4& out)
+    {
+        float4x4 result;
+        for (size_t row = 0; row < 4; ++row)
+        {
+            for (size_t col = 0; col < 4; ++col)
+            {
+                result(row, col) =
+                    a(row, 0) * b(0, col) +
+                    a(row, 1) * b(1, col) +
+                    a(row, 2) * b(2, col) +
+                    a(row, 3) * b(3, col);
+            }
+        }
+        out = result;
+    }
+
+    void MultiplyScalar(const float4x4& a, const float4x3& b, float4x3& out)
+    {
+        float4x3 result;
+        for (size_t row = 0; row < 4; ++row)
+        {
+            for (size_t col = 0; col < 3; ++col)
+            {
+                result(row, col) =
+                    a(row, 0) * b(0, col) +
+                    a(row, 1) * b(1, col) +
+                    a(row, 2) * b(2, col) +
+                    a(row, 3) * b(3, col);
+            }
+        }
+        out = result;
+    }
+
+    // ---------- AVX2 / FMA ------------
+    // Two result rows per 256-bit register: lanes [0..3] hold row n, lanes [4..7] row n + 1.
+    // permute_ps broadcasts element k of each row within its own 128-bit half.
+    struct Avx2Rows
+    {
+        __m256 B0, B1, B2, B3;
+    };
+
+    inline Avx2Rows LoadRowsAvx2(const float4x4& b)
+    {
+        return Avx2Rows{
+            _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[0])),
+            _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[1])),
+            _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[2])),
+            _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b.m[3]))
+        };
+    }
+
+    inline __m256 CombineRowsAvx2(__m256 aRows, const Avx2Rows& b)
+    {
+        __m256 r = _mm256_mul_ps(_mm256_permute_ps(aRows, 0x00), b.B0);
+        r = _mm256_fmadd_ps(_mm256_permute_ps(aRows, 0x55), b.B1, r);
+        r = _mm256_fmadd_ps(_mm256_permute_ps(aRows, 0xAA), b.B2, r);
+        r = _mm256_fmadd_ps(_mm256_permute_ps(aRows, 0xFF), b.B3, r);
+        return r;
+    }
+
+    inline void MultiplyAvx2(const float* a, const Avx2Rows& b, float* out)
+    {
+        const __m256 a01 = _mm256_loadu_ps(a);
+        const __m256 a23 = _mm256_loadu_ps(a + 8);
+        _mm256_storeu_ps(out, CombineRowsAvx2(a01, b));
+        _mm256_storeu_ps(out + 8, CombineRowsAvx2(a23, b));
+    }
+
+    void MultiplyBatchAvx2(const float4x4* a, const float4x4& b, float4x4* out, size_t count)
+    {
+        const Avx2Rows rows = LoadRowsAvx2(b);
+        for (size_t i = 0; i < count; ++i)
+        {
+            MultiplyAvx2(&a[i].m[0][0], rows, &out[i].m[0][0]);
+        }
+        _mm256_zeroupper();
+    }
+
+    void MultiplyBatchAvx2(const float4x4& a, const float4x4* b, float4x4* out, size_t count)
+    {
+        // Rows of a are fixed, so the per-row broadcasts are hoisted out of the loop
+        const __m256 a01 = _mm256_loadu_ps(&a.m[0][0]);
+        const __m256 a23 = _mm256_loadu_ps(&a.m[2][0]);
+        const __m256 a01x = _mm256_permute_ps(a01, 0x00), a01y = _mm256_permute_ps(a01, 0x55);
+        const __m256 a01z = _mm256_permute_ps(a01, 0xAA), a01w = _mm256_permute_ps(a01, 0xFF);
+        const __m256 a23x = _mm256_permute_ps(a23, 0x00), a23y = _mm256_permute_ps(a23, 0x55);
+        const __m256 a23z = _mm256_permute_ps(a23, 0xAA), a23w = _mm256_permute_ps(a23, 0xFF);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Avx2Rows rows = LoadRowsAvx2(b[i]);
+
+            __m256 r01 = _mm256_mul_ps(a01x, rows.B0);
+            r01 = _mm256_fmadd_ps(a01y, rows.B1, r01);
+            r01 = _mm256_fmadd_ps(a01z, rows.B2, r01);
+            r01 = _mm256_fmadd_ps(a01w, rows.B3, r01);
+
+            __m256 r23 = _mm256_mul_ps(a23x, rows.B0);
+            r23 = _mm256_fmadd_ps(a23y, rows.B1, r23);
+            r23 = _mm256_fmadd_ps(a23z, rows.B2, r23);
+            r23 = _mm256_fmadd_ps(a23w, rows.B3, r23);
+
+            _mm256_storeu_ps(&out[i].m[0][0], r01);
+            _mm256_storeu_ps(&out[i].m[2][0], r23);
+        }
+        _mm256_zeroupper();
+    }
+
+    void MultiplyBatchAvx2(const float4x4* a, const float4x4* b, float4x4* out, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Avx2Rows rows = LoadRowsAvx2(b[i]);
+            MultiplyAvx2(&a[i].m[0][0], rows, &out[i].m[0][0]);
+        }
+        _mm256_zeroupper();
+    }
+
+    void MultiplyBatchAvx2(const float4x4* a, const float4x3& b, float4x3* out, size_t count)
+    {
+        // Pad the 3-wide rows of b with a zero lane so each product row is [x, y, z, 0]
+        const Avx2Rows rows{
+            _mm256_setr_ps(b._11, b._12, b._13, 0.0f, b._11, b._12, b._13, 0.0f),
+            _mm256_setr_ps(b._21, b._22, b._23, 0.0f, b._21, b._22, b._23, 0.0f),
+            _mm256_setr_ps(b._31, b._32, b._33, 0.0f, b._31, b._32, b._33, 0.0f),
+            _mm256_setr_ps(b._41, b._42, b._43, 0.0f, b._41, b._42, b._43, 0.0f)
+        };
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const __m256 r01 = CombineRowsAvx2(_mm256_loadu_ps(&a[i].m[0][0]), rows);
+            const __m256 r23 = CombineRowsAvx2(_mm256_loadu_ps(&a[i].m[2][0]), rows);
+
+            // Rows are 12 bytes apart: each 16-byte store spills into the next row, which the following store overwrites
+            float* dst = &out[i].m[0][0];
+            _mm_storeu_ps(dst + 0, _mm256_castps256_ps128(r01));
+            _mm_storeu_ps(dst + 3, _mm256_extractf128_ps(r01, 1));
+            _mm_storeu_ps(dst + 6, _mm256_castps256_ps128(r23));
+            const __m128 row3 = _mm256_extractf128_ps(r23, 1);
+            _mm_storel_pi(reinterpret_cast<__m64*>(dst + 9), row3);
+            _mm_store_ss(dst + 11, _mm_movehl_ps(row3, row3));
+        }
+        _mm256_zeroupper();
+    }
+
+    void CheckSpans(size_t inputCount, size_t outputCount)
+    {
+        if (inputCount != outputCount)
+            throw std::invalid_argument("MultiplyMatrices: input and output spans differ in length");
+    }
+}
+
+void MultiplyMatrices(Span<const float4x4> a, const float4x4& b, Span<float4x4> out)
+{
+    CheckSpans(a.size(), out.size());
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        for (size_t i = 0; i < a.size(); ++i)
+            MultiplyScalar(a[i], b, out[i]);
+        break;
+    case SimdLevel::Sse:
+        for (size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b;
+        break;
+    default:
+        MultiplyBatchAvx2(a.data(), b, out.data(), a.size());
+        break;
+    }
+}
+
+void MultiplyMatrices(const float4x4& a, Span<const float4x4> b, Span<float4x4> out)
+{
+    CheckSpans(b.size(), out.size());
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        for (size_t i = 0; i < b.size(); ++i)
+            MultiplyScalar(a, b[i], out[i]);
+        break;
+    case SimdLevel::Sse:
+        for (size_t i = 0; i < b.size(); ++i)
+            out[i] = a * b[i];
+        break;
+    default:
+        MultiplyBatchAvx2(a, b.data(), out.data(), b.size());
+        break;
+    }
+}
+
+void MultiplyMatrices(Span<const float4x4> a, Span<const float4x4> b, Span<float4x4> out)
+{
+    CheckSpans(a.size(), out.size());
+    CheckSpans(b.size(), out.size());
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        for (size_t i = 0; i < a.size(); ++i)
+            MultiplyScalar(a[i], b[i], out[i]);
+        break;
+    case SimdLevel::Sse:
+        for (size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b[i];
+        break;
+    default:
+        MultiplyBatchAvx2(a.data(), b.data(), out.data(), a.size());
+        break;
+    }
+}
+
+void MultiplyMatrices(Span<const float4x4> a, const float4x3& b, Span<float4x3> out)
+{
+    CheckSpans(a.size(), out.size());
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        for (size_t i = 0; i < a.size(); ++i)
+            MultiplyScalar(a[i], b, out[i]);
+        break;
+    case SimdLevel::Sse:
+        for (size_t i = 0; i < a.size(); ++i)
+            out[i] = a[i] * b;
+        break;
+    default:
+        MultiplyBatchAvx2(a.data(), b, out.data(), a.size());
+        break;
+    }
+}
+
+MatrixBatchBenchmarkReport RunMatrixBatchBenchmark(uint32 matrixCount, uint32 iterations)
+{
+    MatrixBatchBenchmarkReport report;
+    report.MatrixCount = matrixCount;
+    report.Level = GetSimdLevel();
+
+    Vector<float4x4> world(matrixCount);
+    Vector<float4x4> out(matrixCount);
+    for (uint32 i = 0; i < matrixCount; ++i)
+    {
+        const float f = float(i % 97) * 0.01f;
+        world[i] = float4x4(1.0f + f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, f, 0.0f, 0.0f, -f, 1.0f, 0.0f, f, 2.0f * f, 3.0f, 1.0f);
+    }
+    const float4x4 viewProjection(1.2f, 0.0f, 0.0f, 0.0f, 0.0f, 1.6f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, -0.1f, 0.0f);
+
+    auto run = [&](SimdLevel level)
+    {
+        SetMaxSimdLevel(level);
+        MultiplyMatrices(world, viewProjection, out);
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            MultiplyMatrices(world, viewProjection, out);
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? double(matrixCount) * iterations / seconds : 0.0;
+    };
+
+    if (matrixCount == 0 || iterations == 0)
+        return report;
+
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    report.ScalarMatricesPerSecond = run(SimdLevel::Scalar);
+    report.SseMatricesPerSecond = run(SimdLevel::Sse);
+    if (report.Level >= SimdLevel::Avx2)
+        report.Avx2MatricesPerSecond = run(SimdLevel::Avx2);
+    SetMaxSimdLevel(previousCap);
+
+    const double best = report.Level >= SimdLevel::Avx2 ? report.Avx2MatricesPerSecond
+        : report.Level == SimdLevel::Sse ? report.SseMatricesPerSecond : report.ScalarMatricesPerSecond;
+    report.Speedup = report.ScalarMatricesPerSecond > 0.0 ? best / report.ScalarMatricesPerSecond : 0.0;
+    return report;
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/CpuFeatures.h"
+
+// Batched matrix products over spans. Dispatches at runtime to AVX2/FMA, SSE or scalar kernels (see Engine/CpuFeatures.h).
+// All spans must have the same length. Row-vector convention, matching the operators in BaseTypes.h
+
+// out[i] = a[i] * b, e.g. world matrices times one view-projection. out may alias a
+void MultiplyMatrices(Span<const float4x4> a, const float4x4& b, Span<float4x4> out);
+
+// out[i] = a * b[i]. out may alias b
+void MultiplyMatrices(const float4x4& a, Span<const float4x4> b, Span<float4x4> out);
+
+// out[i] = a[i] * b[i]. out may alias a or b
+void MultiplyMatrices(Span<const float4x4> a, Span<const float4x4> b, Span<float4x4> out);
+
+// out[i] = a[i] * b
+void MultiplyMatrices(Span<const float4x4> a, const float4x3& b, Span<float4x3> out);
+
+struct MatrixBatchBenchmarkReport
+{
+    uint32 MatrixCount = 0;
+    SimdLevel Level = SimdLevel::Scalar;        // Level the dispatch picks on this CPU
+    double ScalarMatricesPerSecond = 0.0;       // The triple loop, forced with SetMaxSimdLevel(SimdLevel::Scalar)
+    double SseMatricesPerSecond = 0.0;
+    double Avx2MatricesPerSecond = 0.0;         // 0 when the CPU has no AVX2 and FMA
+    double Speedup = 0.0;                       // Level over scalar
+};
+
+// Headless benchmark: iterations passes of matrixCount world matrices times one view-projection, once per SIMD level
+// the CPU supports. Restores the previous SetMaxSimdLevel cap
+MatrixBatchBenchmarkReport RunMatrixBatchBenchmark(uint32 matrixCount = 10000, uint32 iterations = 200);
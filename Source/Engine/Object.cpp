@@ -1,161 +1,228 @@
 #include "Object.h"
+#include "../Graphics/MaterialTable.h"
 #include "../Graphics/Mesh.h"
+#include "../Graphics/VertexCompression.h"
 #include "directx/d3dx12.h"
 #include <stdexcept>
-#include "Simulation.h"
+#include "../Graphics/UploadRingBuffer.h"
+
+const float3& Object::GetRotation() const
+{
+    if (m_RotationStale)
+    {
+        m_Rotation = QuaternionToEuler(m_Transform.Rotation);
+        m_RotationStale = false;
+    }
+    return m_Rotation;
+}
+
+float4 Object::GetWorldBoundingSphere() const
+{
+    if (!m_Mesh)
+    {
+        return float4{ m_Transform.Translation.x, m_Transform.Translation.y, m_Transform.Translation.z, -std::numeric_limits<float>::infinity() };
+    }
+
+    const float4& local = m_Mesh->GetBoundingSphere();
+    const float3& scale = m_Transform.Scale;
+    const float3 center = m_Transform.Translation + QuaternionRotate(m_Transform.Rotation, float3{ local.x, local.y, local.z } * scale);
+    const float maxScale = std::max({ std::abs(scale.x), std::abs(scale.y), std::abs(scale.z) });
+    return float4{ center.x, center.y, center.z, local.w * maxScale };
+}
+
+Aabb Object::GetWorldBounds() const
+{
+    const float4 sphere = GetWorldBoundingSphere();
+    const float3 center{ sphere.x, sphere.y, sphere.z };
+    const float radius = std::max(sphere.w, 0.0f);
+    const float3 extent{ radius, radius, radius };
+    return Aabb{ center - extent, center + extent };
+}
+
+void Object::AddToScene(DynamicAabbTree& sceneTree)
+{
+    RemoveFromScene();
+    m_SceneTree = &sceneTree;
+    m_SceneProxy = sceneTree.CreateProxy(GetWorldBounds(), this);
+}
+
+void Object::RemoveFromScene()
+{
+    if (!m_SceneTree)
+        return;
+
+    m_SceneTree->DestroyProxy(m_SceneProxy);
+    m_SceneTree = nullptr;
+    m_SceneProxy = DynamicAabbTree::s_NullNode;
+}
+
+void Object::UpdateSceneProxy()
+{
+    if (m_SceneTree)
+    {
+        m_SceneTree->MoveProxy(m_SceneProxy, GetWorldBounds());
+    }
+}
 
 void Object::SetPosition(const float3& position)
 {
-    m_Position = position;
+    m_Transform.Translation = position;
     UpdateWorldMatrix();
 }
 
 void Object::SetRotation(const float3& rotation)
 {
     m_Rotation = rotation;
+    m_RotationStale = false;
+    m_Transform.Rotation = QuaternionFromEuler(rotation);
+    UpdateWorldMatrix();
+}
+
+void Object::SetOrientation(const float4& orientation)
+{
+    m_Transform.Rotation = QuaternionNormalize(orientation);
+    m_RotationStale = true;
     UpdateWorldMatrix();
 }
 
 void Object::SetScale(const float3& scale)
 {
-    m_Scale = scale;
+    m_Transform.Scale = scale;
     UpdateWorldMatrix();
 }
 
-void Object::SetUvOffset(const float2& uvOffset)
+void Object::SetTransform(const Transform& transform)
 {
-    m_UvOffset = uvOffset;
-    m_ConstantBufferDirty = 2;
+    m_Transform = transform;
+    m_Transform.Rotation = QuaternionNormalize(transform.Rotation);
+    m_RotationStale = true;
+    UpdateWorldMatrix();
 }
 
-void Object::SetUvScale(const float2& uvScale)
+void Object::SetTransforms(Span<Object* const> objects, Span<const Transform> transforms)
 {
-    m_UvScale = uvScale;
-    m_ConstantBufferDirty = 2;
-}
-
-void Object::Initialize(ID3D12Device* device)
-{
-    // Create constant buffer for ObjectData
-    D3D12_HEAP_PROPERTIES heapProps = {};
-    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    heapProps.CreationNodeMask = 1;
-    heapProps.VisibleNodeMask = 1;
-
-    D3D12_RESOURCE_DESC resourceDesc = {};
-    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    resourceDesc.Alignment = 0;
-    m_ObjectDataBufferSize = AlignUp(sizeof(ObjectData), 256);
-    resourceDesc.Width = m_ObjectDataBufferSize * Simulation::s_FrameCount;
-    resourceDesc.Height = 1;
-    resourceDesc.DepthOrArraySize = 1;
-    resourceDesc.MipLevels = 1;
-    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-    resourceDesc.SampleDesc.Count = 1;
-    resourceDesc.SampleDesc.Quality = 0;
-    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-
-    if (FAILED(device->CreateCommittedResource(
-        &heapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&m_ObjectDataBuffer))))
+    if (objects.size() != transforms.size())
+        throw std::invalid_argument("Object::SetTransforms: spans differ in length");
+
+    for (size_t i = 0; i < objects.size(); ++i)
     {
-        throw std::runtime_error("Failed to create object constant buffer");
+        Object& object = *objects[i];
+        object.m_Transform = transforms[i];
+        object.m_Transform.Rotation = QuaternionNormalize(transforms[i].Rotation);
+        object.m_RotationStale = true;
+        ComposeTransform(object.m_Transform, object.m_WorldMatrix, object.m_NormalMatrix);
+        object.UpdateSceneProxy();
     }
+}
 
+void Object::GatherBoundingSpheres(Span<Object* const> objects, Float4SoA out)
+{
+    if (objects.size() != out.Size() || objects.size() != out.Y.size() || objects.size() != out.Z.size() || objects.size() != out.W.size())
+        throw std::invalid_argument("Object::GatherBoundingSpheres: spans differ in length");
 
-    // Map the buffer and keep it mapped for the lifetime of the resource
-    if (FAILED(m_ObjectDataBuffer->Map(0, nullptr, reinterpret_cast<void**>(&m_MappedObjectData))))
+    for (size_t i = 0; i < objects.size(); ++i)
     {
-        throw std::runtime_error("Failed to map object data buffer");
+        const float4 sphere = objects[i]->GetWorldBoundingSphere();
+        out.X[i] = sphere.x;
+        out.Y[i] = sphere.y;
+        out.Z[i] = sphere.z;
+        out.W[i] = sphere.w;
     }
+}
 
-    UpdateWorldMatrix();
+void Object::SetUvOffset(const float2& uvOffset)
+{
+    m_UvOffset = uvOffset;
+}
 
-    m_ConstantBufferDirty = 2;
+void Object::SetUvScale(const float2& uvScale)
+{
+    m_UvScale = uvScale;
 }
 
-void Object::Release()
+void Object::SetMesh(SharedPtr<Mesh> mesh)
 {
-    if (m_ObjectDataBuffer)
-    {
-        m_ObjectDataBuffer->Unmap(0, nullptr);
-        m_MappedObjectData = nullptr;
-        m_ObjectDataBuffer.Reset();
-    }
-    m_Mesh.reset();
+    m_Mesh = mesh;
+    m_LodSet.reset();
+    m_LodLevel = 0;
+    UpdateSceneProxy();
 }
 
-void Object::UpdateConstantBuffer()
+void Object::SetLodSet(SharedPtr<const LodSet> lodSet)
 {
-    if (!m_ObjectDataBuffer || m_ConstantBufferDirty == 0)
-    {
+    if (lodSet && lodSet->GetLevelCount() == 0)
+        throw std::invalid_argument("Object::SetLodSet: LOD set has no levels");
+
+    m_LodSet = lodSet;
+    m_LodLevel = 0;
+    m_Mesh = m_LodSet ? m_LodSet->GetLevel(0).Mesh : nullptr;
+    UpdateSceneProxy();
+}
+
+void Object::SetLodLevel(uint32 level)
+{
+    if (!m_LodSet)
+        throw std::runtime_error("Object::SetLodLevel: object has no LOD set");
+    if (level >= m_LodSet->GetLevelCount())
+        throw std::out_of_range("Object::SetLodLevel: level out of range");
+
+    if (level == m_LodLevel)
         return;
-    }
 
-    // Prepare object data
+    m_LodLevel = level;
+    m_Mesh = m_LodSet->GetLevel(level).Mesh;
+    UpdateSceneProxy();
+}
+
+void Object::Initialize()
+{
+    UpdateWorldMatrix();
+}
+
+void Object::Release()
+{
+    RemoveFromScene();
+    m_Mesh.reset();
+    m_LodSet.reset();
+    m_OccluderMesh.reset();
+}
+
+ObjectData Object::GetObjectData() const
+{
     ObjectData objectData{};
     objectData.Model = m_WorldMatrix;
+    if (m_Mesh && m_Mesh->GetVertexFormat() != VertexFormat::Float32)
+    {
+        objectData.Model = ApplyDequantization(m_WorldMatrix, m_Mesh->GetPositionDequantization());
+    }
     objectData.UvOffset = m_UvOffset;
     objectData.UvScale = m_UvScale;
     objectData.Normal = m_NormalMatrix;
-
-    // Copy data to the buffer
-    static constexpr size_t dataSize = sizeof(ObjectData);
-    size_t offset = m_CurrentFrameIndex * m_ObjectDataBufferSize;
-    memcpy(m_MappedObjectData + offset, &objectData, dataSize);
-
-    m_ConstantBufferDirty--;
+    objectData.MaterialIndex = m_Mesh ? m_Mesh->GetMaterialIndex() : MaterialTable::s_DefaultMaterial;
+    return objectData;
 }
 
 void Object::UpdateWorldMatrix()
 {
-    // Create transformation matrices
-    XMMATRIX translation = XMMatrixTranslation(m_Position.x, m_Position.y, m_Position.z);
-    XMMATRIX rotation = XMMatrixRotationRollPitchYaw(m_Rotation.x, m_Rotation.y, m_Rotation.z);
-    XMMATRIX scale = XMMatrixScaling(m_Scale.x, m_Scale.y, m_Scale.z);
-
-    // Combine transformations in SRT order
-    XMMATRIX worldMatrix = scale * rotation * translation;
-
-    // Remove the transpose here - let the shader handle it
-    XMStoreFloat4x4(&m_WorldMatrix, XMMatrixTranspose(worldMatrix));
+    // Closed-form SRT: the world matrix is stored transposed for the shader and the normal
+    // matrix is the rotation transposed with reciprocal scale, no general 4x4 inverse needed
+    ComposeTransform(m_Transform, m_WorldMatrix, m_NormalMatrix);
 
-    // Compute normal matrix: inverse transpose of the 3x3 part (no extra transpose needed)
-    XMMATRIX upperLeft3x3 = XMMatrixSet(
-        XMVectorGetX(worldMatrix.r[0]), XMVectorGetY(worldMatrix.r[0]), XMVectorGetZ(worldMatrix.r[0]), 0,
-        XMVectorGetX(worldMatrix.r[1]), XMVectorGetY(worldMatrix.r[1]), XMVectorGetZ(worldMatrix.r[1]), 0,
-        XMVectorGetX(worldMatrix.r[2]), XMVectorGetY(worldMatrix.r[2]), XMVectorGetZ(worldMatrix.r[2]), 0,
-        0, 0, 0, 1
-    );
-    
-    XMMATRIX normalMatrix = XMMatrixInverse(nullptr, upperLeft3x3);
-    XMStoreFloat4x4(&m_NormalMatrix, normalMatrix);
-
-    m_ConstantBufferDirty = 2;
+    UpdateSceneProxy();
 }
 
-void Object::Draw(ID3D12GraphicsCommandList* commandList)
+void Object::Draw(ID3D12GraphicsCommandList* commandList, UploadRingBuffer& uploadRing)
 {
-    if (m_Mesh && m_ObjectDataBuffer)
+    if (IsDrawable())
     {
-        // Advance to the next frame index
-        m_CurrentFrameIndex = (m_CurrentFrameIndex + 1) % Simulation::s_FrameCount;
-
-        // Update constant buffer if needed
-        UpdateConstantBuffer();
-
-        D3D12_GPU_VIRTUAL_ADDRESS bufferAddress = m_ObjectDataBuffer->GetGPUVirtualAddress() + m_CurrentFrameIndex * m_ObjectDataBufferSize;
-        commandList->SetGraphicsRootConstantBufferView(1, bufferAddress);
+        BindConstants(commandList, uploadRing);
 
         // Draw the mesh
         m_Mesh->Draw(commandList);
     }
-}
\ No newline at end of file
+}
+
+void Object::BindConstants(ID3D12GraphicsCommandList* commandList, UploadRingBuffer& uploadRing) const
+{
+    commandList->SetGraphicsRootConstantBufferView(1, uploadRing.UploadConstants(GetObjectData()));
+}
@@ -2,50 +2,91 @@
 
 #include <memory>
 
+#include "Engine/AabbTree.h"
 #include "Engine/BaseTypes.h"
+#include "Engine/ObjectData.h"
+#include "Engine/Transform.h"
+#include "Engine/VectorStreams.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/LodSet.h"
 #include "Graphics/MeshPipeline.h"
 
+class UploadRingBuffer;
+
 class Object {
 public:
+    Object() = default;
+    // Leaves the scene index, which holds a pointer to the object
+    ~Object() { RemoveFromScene(); }
+
+    // The scene proxy belongs to one object
+    Object(const Object&) = delete;
+    Object& operator=(const Object&) = delete;
 
-    const float3& GetPosition() const { return m_Position; }
-    const float3& GetRotation() const { return m_Rotation; }
-    const float3& GetScale() const { return m_Scale; }
+    const float3& GetPosition() const { return m_Transform.Translation; }
+    const float3& GetRotation() const;
+    const float4& GetOrientation() const { return m_Transform.Rotation; }
+    const float3& GetScale() const { return m_Transform.Scale; }
+    const Transform& GetTransform() const { return m_Transform; }
     const float4x4& GetWorldMatrix() const { return m_WorldMatrix; }
     const float2& GetUvOffset() const { return m_UvOffset; }
     const float2& GetUvScale() const { return m_UvScale; }
     const SharedPtr<Mesh>& GetMesh() const { return m_Mesh; }
+    const SharedPtr<const LodSet>& GetLodSet() const { return m_LodSet; }
+    uint32 GetLodLevel() const { return m_LodLevel; }
+    const SharedPtr<const MeshTemplate>& GetOccluderMesh() const { return m_OccluderMesh; }
+    // Bounding sphere of the current mesh in world space (xyz center, w radius), w = -infinity without a mesh
+    float4 GetWorldBoundingSphere() const;
+    // Box around the world bounding sphere, a point at the position without a mesh
+    Aabb GetWorldBounds() const;
+    uint32 GetSceneProxy() const { return m_SceneProxy; }
+    const float4x4& GetNormalMatrix() const { return m_NormalMatrix; }
+    // Shader constants for the current state, with the mesh dequantization folded into Model
+    ObjectData GetObjectData() const;
 
     void SetPosition(const float3& position);
     void SetRotation(const float3& rotation);
+    void SetOrientation(const float4& orientation);
     void SetScale(const float3& scale);
+    void SetTransform(const Transform& transform);
     void SetUvOffset(const float2& uvOffset);
     void SetUvScale(const float2& uvScale);
-    void SetMesh(SharedPtr<Mesh> mesh) { m_Mesh = mesh; }
+    // Drops the LOD set, the object keeps drawing this mesh
+    void SetMesh(SharedPtr<Mesh> mesh);
+    // Draws level 0 until SelectLods (Engine/LodSelection.h) picks another one
+    void SetLodSet(SharedPtr<const LodSet> lodSet);
+    void SetLodLevel(uint32 level);
+    // Flags the object as an occluder for OcclusionCuller (Engine/OcclusionCulling.h). The mesh must lie inside the drawn one
+    void SetOccluderMesh(SharedPtr<const MeshTemplate> occluderMesh) { m_OccluderMesh = occluderMesh; }
+
+    // Registers the object in a scene index with itself as user data. Transform and mesh changes move its proxy
+    void AddToScene(DynamicAabbTree& sceneTree);
+    void RemoveFromScene();
 
-    void Initialize(ID3D12Device* device);
+    void Initialize();
     void Release();
-    void Draw(ID3D12GraphicsCommandList* commandList);
+    void Draw(ID3D12GraphicsCommandList* commandList, UploadRingBuffer& uploadRing);
+    // Writes the object constants into the upload ring and binds them (b1), for callers that bind and draw the mesh
+    // themselves
+    void BindConstants(ID3D12GraphicsCommandList* commandList, UploadRingBuffer& uploadRing) const;
+    // False while the mesh still waits for its staging upload
+    bool IsDrawable() const { return m_Mesh && m_Mesh->IsResident(); }
 
     void UpdateWorldMatrix();
 
-private:
-    void UpdateConstantBuffer();
+    // Assigns transforms[i] to objects[i] and recomposes their matrices in one pass
+    static void SetTransforms(Span<Object* const> objects, Span<const Transform> transforms);
 
-    // Object transformation data matching ObjectData cbuffer in shader
-    struct ObjectData
-    {
-        float4x4 Model;
-        float4x4 Normal;
-        float2 UvOffset;
-        float2 UvScale;
-    };
-    static_assert(sizeof(ObjectData) % 16 == 0, "ObjectData must be 16-byte aligned");
+    // GetWorldBoundingSphere of every object into a stream for the culling kernels (Engine/Culling.h)
+    static void GatherBoundingSpheres(Span<Object* const> objects, Float4SoA out);
 
-    float3 m_Position = {0.0f, 0.0f, 0.0f};
-    float3 m_Rotation = {0.0f, 0.0f, 0.0f}; // In radians
-    float3 m_Scale = {1.0f, 1.0f, 1.0f};
+private:
+    void UpdateSceneProxy();
+
+    Transform m_Transform;
+    // Euler angles of m_Transform.Rotation in radians, recovered on demand after quaternion writes
+    mutable float3 m_Rotation = {0.0f, 0.0f, 0.0f};
+    mutable bool m_RotationStale = false;
     float4x4 m_WorldMatrix = {};
     float4x4 m_NormalMatrix = {};
     
@@ -53,14 +94,10 @@ private:
     float2 m_UvScale = {1.0f, 1.0f};
     
     SharedPtr<Mesh> m_Mesh;
-    
-    // D3D12 constant buffer
-    ComPtr<ID3D12Resource> m_ObjectDataBuffer = nullptr;
-    size_t m_ObjectDataBufferSize = 0;
-    uint8* m_MappedObjectData = nullptr;
+    SharedPtr<const LodSet> m_LodSet;
+    uint32 m_LodLevel = 0;
+    SharedPtr<const MeshTemplate> m_OccluderMesh;
 
-    int m_CurrentFrameIndex = 0;
-
-    int m_ConstantBufferDirty = 2;
+    DynamicAabbTree* m_SceneTree = nullptr;
+    uint32 m_SceneProxy = DynamicAabbTree::s_NullNode;
 };
-
@@ -0,0 +1,15 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+// Object transformation data matching the ObjectData cbuffer in the shaders, and one element of the instance buffer
+// (StructuredBuffer at t0) in their instanced variants. MaterialIndex selects the entry of the MaterialTable
+struct ObjectData
+{
+    float4x4 Model;
+    float4x4 Normal;
+    float2 UvOffset;
+    float2 UvScale;
+    uint32 MaterialIndex;
+    uint32 Padding[3];
+};
+static_assert(sizeof(ObjectData) % 16 == 0, "ObjectData must be 16-byte aligned");
@@ -0,0 +1,421 @@
+#include "Engine/OcclusionCulling.h"
+
+#include <chrono>
+
+#include "Engine/Camera.h"
+#include "Engine/Culling.h"
+#include "Engine/Object.h"
+#include "Engine/Parallel.h"
+#include "Engine/SimdLanes.h"
+#include "Graphics/HelperFunctions.h"
+
+namespace
+{
+    // Rows per raster job, small enough to balance a few large occluders over the workers
+    constexpr uint32 s_BandHeight = 8;
+
+    // Pixel centers relative to the first pixel of a SIMD block
+    alignas(64) constexpr float s_PixelCenters[16] = { 0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f, 8.5f, 9.5f, 10.5f, 11.5f, 12.5f, 13.5f, 14.5f, 15.5f };
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Row-vector p * m
+    float4 TransformPoint(const float3& p, const float4x4& m)
+    {
+        return float4{
+            p.x * m(0, 0) + p.y * m(1, 0) + p.z * m(2, 0) + m(3, 0),
+            p.x * m(0, 1) + p.y * m(1, 1) + p.z * m(2, 1) + m(3, 1),
+            p.x * m(0, 2) + p.y * m(1, 2) + p.z * m(2, 2) + m(3, 2),
+            p.x * m(0, 3) + p.y * m(1, 3) + p.z * m(2, 3) + m(3, 3),
+        };
+    }
+
+    template<class L>
+    struct RasterKernel
+    {
+        template<class Triangle>
+        static void Run(const Vector<Vector<Triangle>>& occluders, float* depth, uint32 width, uint32 firstRow, uint32 lastRow)
+        {
+            for (const Vector<Triangle>& triangles : occluders)
+            {
+                for (const Triangle& t : triangles)
+                {
+                    if (t.MaxY < int32(firstRow) || t.MinY > int32(lastRow))
+                        continue;
+
+                    const int32 y0 = std::max(t.MinY, int32(firstRow));
+                    const int32 y1 = std::min(t.MaxY, int32(lastRow));
+                    for (int32 y = y0; y <= y1; ++y)
+                    {
+                        const float py = float(y) + 0.5f;
+                        float rowEdge[3];
+                        float left = float(t.MinX), right = float(t.MaxX);
+                        for (int k = 0; k < 3; ++k)
+                        {
+                            rowEdge[k] = t.EdgeB[k] * py + t.EdgeC[k];
+
+                            // Narrow the span to where this edge is non-negative, one pixel generous as the mask below is exact
+                            if (t.EdgeA[k] > 0.0f)
+                                left = std::max(left, std::floor(-rowEdge[k] / t.EdgeA[k] - 0.5f));
+                            else if (t.EdgeA[k] < 0.0f)
+                                right = std::min(right, std::ceil(-rowEdge[k] / t.EdgeA[k] - 0.5f));
+                            else if (rowEdge[k] < 0.0f)
+                                right = left - 1.0f;
+                        }
+                        if (left > right)
+                            continue;
+
+                        const int32 x0 = int32(left);
+                        const size_t count = size_t(int32(right) - x0 + 1);
+                        const float rowDepth = t.DepthB * py + t.DepthC;
+                        float* row = depth + size_t(y) * width + x0;
+
+                        ForEachBlock<L>(count, [&]<class B>(size_t i)
+                        {
+                            const auto px = B::Add(B::Load(s_PixelCenters), B::Set1(float(x0 + int32(i))));
+                            const auto e0 = B::MulAdd(px, B::Set1(t.EdgeA[0]), B::Set1(rowEdge[0]));
+                            const auto e1 = B::MulAdd(px, B::Set1(t.EdgeA[1]), B::Set1(rowEdge[1]));
+                            const auto e2 = B::MulAdd(px, B::Set1(t.EdgeA[2]), B::Set1(rowEdge[2]));
+                            const auto inside = B::Min(e0, B::Min(e1, e2));
+
+                            // Uncovered lanes write the clear depth, which the min leaves unchanged
+                            auto z = B::MulAdd(px, B::Set1(t.DepthA), B::Set1(rowDepth));
+                            z = B::Select(B::CmpLt(inside, B::Set1(0.0f)), B::Set1(1.0f), z);
+                            B::Store(row + i, B::Min(B::Load(row + i), z));
+                        });
+                    }
+                }
+            }
+        }
+    };
+}
+
+OcclusionCuller::OcclusionCuller(uint32 width, uint32 height)
+{
+    Resize(width, height);
+}
+
+void OcclusionCuller::Resize(uint32 width, uint32 height)
+{
+    if (width == 0 || height == 0)
+        throw std::invalid_argument("OcclusionCuller::Resize: resolution must not be zero");
+
+    m_Width = width;
+    m_Height = height;
+    m_DepthLevels.clear();
+    m_LevelSizes.clear();
+
+    uint2 size{ width, height };
+    while (true)
+    {
+        m_LevelSizes.push_back(size);
+        m_DepthLevels.emplace_back(size_t(size.x) * size.y, 1.0f);
+        if (size.x == 1 && size.y == 1)
+            break;
+        size = uint2{ (size.x + 1) / 2, (size.y + 1) / 2 };
+    }
+}
+
+void OcclusionCuller::BeginFrame(const float4x4& viewProjection)
+{
+    m_ViewProjection = viewProjection;
+    m_Occluders.clear();
+    m_RasterStats = {};
+    std::fill(m_DepthLevels.front().begin(), m_DepthLevels.front().end(), 1.0f);
+}
+
+void OcclusionCuller::AddOccluder(const MeshTemplate& mesh, const float4x4& world)
+{
+    m_Occluders.push_back(Occluder{ &mesh, world * m_ViewProjection });
+}
+
+void OcclusionCuller::AddOccluders(Span<Object* const> objects)
+{
+    for (const Object* object : objects)
+    {
+        if (const SharedPtr<const MeshTemplate>& occluder = object->GetOccluderMesh())
+        {
+            // The object keeps its world matrix transposed for the shaders
+            AddOccluder(*occluder, Transpose(object->GetWorldMatrix()));
+        }
+    }
+}
+
+void OcclusionCuller::SetupTriangles(const Occluder& occluder, Vector<ScreenTriangle>& triangles) const
+{
+    const MeshTemplate& mesh = *occluder.Mesh;
+    const Vector<MeshVertex>& vertices = mesh.GetVertices();
+
+    Vector<float4> clip(vertices.size());
+    for (size_t v = 0; v < vertices.size(); ++v)
+        clip[v] = TransformPoint(vertices[v].Position, occluder.WorldViewProjection);
+
+    Vector<Submesh> ranges = mesh.GetSubmeshes();
+    if (ranges.empty())
+        ranges.push_back(Submesh{ 0, static_cast<uint32>(mesh.GetIndexCount()), 0 });
+
+    const float width = float(m_Width), height = float(m_Height);
+    triangles.clear();
+    triangles.reserve(mesh.GetIndexCount() / 3);
+    for (const Submesh& range : ranges)
+    {
+        for (uint32 i = range.IndexOffset; i + 2 < range.IndexOffset + range.IndexCount; i += 3)
+        {
+            float3 screen[3];
+            bool nearClipped = false;
+            for (uint32 k = 0; k < 3; ++k)
+            {
+                const float4& c = clip[mesh.GetIndex(i + k) + range.BaseVertex];
+
+                // Triangles crossing the near plane are dropped rather than clipped, losing occlusion but never adding any
+                if (c.z < 0.0f || c.w <= 0.0f)
+                {
+                    nearClipped = true;
+                    break;
+                }
+                const float invW = 1.0f / c.w;
+                screen[k] = float3{ (c.x * invW * 0.5f + 0.5f) * width, (0.5f - c.y * invW * 0.5f) * height, c.z * invW };
+            }
+            if (nearClipped)
+                continue;
+
+            const float3& a = screen[0];
+            const float3& b = screen[1];
+            const float3& c = screen[2];
+            const float area = (b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y);
+            if (std::abs(area) < 1e-8f)
+                continue;
+
+            ScreenTriangle t;
+            t.MinX = std::max(int32(std::floor(std::min({ a.x, b.x, c.x }) - 0.5f)), 0);
+            t.MaxX = std::min(int32(std::ceil(std::max({ a.x, b.x, c.x }) - 0.5f)), int32(m_Width) - 1);
+            t.MinY = std::max(int32(std::floor(std::min({ a.y, b.y, c.y }) - 0.5f)), 0);
+            t.MaxY = std::min(int32(std::ceil(std::max({ a.y, b.y, c.y }) - 0.5f)), int32(m_Height) - 1);
+            if (t.MinX > t.MaxX || t.MinY > t.MaxY)
+                continue;
+
+            // Edge k runs from screen[k] to screen[k + 1], flipped for negative area so both windings rasterize
+            const float sign = area > 0.0f ? 1.0f : -1.0f;
+            for (int k = 0; k < 3; ++k)
+            {
+                const float3& from = screen[k];
+                const float3& to = screen[(k + 1) % 3];
+                t.EdgeA[k] = -(to.y - from.y) * sign;
+                t.EdgeB[k] = (to.x - from.x) * sign;
+                t.EdgeC[k] = -(t.EdgeA[k] * from.x + t.EdgeB[k] * from.y);
+            }
+
+            t.DepthA = ((b.z - a.z) * (c.y - a.y) - (c.z - a.z) * (b.y - a.y)) / area;
+            t.DepthB = ((c.z - a.z) * (b.x - a.x) - (b.z - a.z) * (c.x - a.x)) / area;
+            t.DepthC = a.z - t.DepthA * a.x - t.DepthB * a.y;
+            triangles.push_back(t);
+        }
+    }
+}
+
+void OcclusionCuller::RasterizeBand(uint32 firstRow, uint32 lastRow)
+{
+    DispatchSimd<RasterKernel>(m_Triangles, m_DepthLevels.front().data(), m_Width, firstRow, lastRow);
+}
+
+void OcclusionCuller::BuildDepthHierarchy()
+{
+    for (size_t level = 1; level < m_DepthLevels.size(); ++level)
+    {
+        const Vector<float>& source = m_DepthLevels[level - 1];
+        const uint2 sourceSize = m_LevelSizes[level - 1];
+        Vector<float>& target = m_DepthLevels[level];
+        const uint2 size = m_LevelSizes[level];
+
+        for (uint32 y = 0; y < size.y; ++y)
+        {
+            const uint32 y0 = y * 2, y1 = std::min(y * 2 + 1, sourceSize.y - 1);
+            for (uint32 x = 0; x < size.x; ++x)
+            {
+                const uint32 x0 = x * 2, x1 = std::min(x * 2 + 1, sourceSize.x - 1);
+                target[size_t(y) * size.x + x] = std::max(
+                    std::max(source[size_t(y0) * sourceSize.x + x0], source[size_t(y0) * sourceSize.x + x1]),
+                    std::max(source[size_t(y1) * sourceSize.x + x0], source[size_t(y1) * sourceSize.x + x1]));
+            }
+        }
+    }
+}
+
+void OcclusionCuller::RenderOccluders()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    m_Triangles.resize(m_Occluders.size());
+    ParallelFor(m_Occluders.size(), [&](size_t o)
+    {
+        SetupTriangles(m_Occluders[o], m_Triangles[o]);
+    });
+
+    m_RasterStats.OccluderCount = m_Occluders.size();
+    m_RasterStats.TrianglesSubmitted = 0;
+    m_RasterStats.TrianglesRasterized = 0;
+    for (size_t o = 0; o < m_Occluders.size(); ++o)
+    {
+        m_RasterStats.TrianglesSubmitted += m_Occluders[o].Mesh->GetIndexCount() / 3;
+        m_RasterStats.TrianglesRasterized += m_Triangles[o].size();
+    }
+    m_RasterStats.SetupMilliseconds = MillisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    const uint32 bandCount = (m_Height + s_BandHeight - 1) / s_BandHeight;
+    ParallelFor(bandCount, [&](size_t band)
+    {
+        const uint32 firstRow = uint32(band) * s_BandHeight;
+        RasterizeBand(firstRow, std::min(firstRow + s_BandHeight, m_Height) - 1);
+    });
+    BuildDepthHierarchy();
+    m_RasterStats.RasterMilliseconds = MillisecondsSince(start);
+}
+
+bool OcclusionCuller::IsOccluded(const float3& boundsMin, const float3& boundsMax) const
+{
+    float minX = std::numeric_limits<float>::max(), minY = minX, minZ = minX;
+    float maxX = -minX, maxY = -minX;
+    for (uint32 corner = 0; corner < 8; ++corner)
+    {
+        const float3 p{ corner & 1 ? boundsMax.x : boundsMin.x, corner & 2 ? boundsMax.y : boundsMin.y, corner & 4 ? boundsMax.z : boundsMin.z };
+        const float4 c = TransformPoint(p, m_ViewProjection);
+        if (!(c.z >= 0.0f && c.w > 0.0f))
+            return false;
+
+        const float invW = 1.0f / c.w;
+        const float x = (c.x * invW * 0.5f + 0.5f) * float(m_Width);
+        const float y = (0.5f - c.y * invW * 0.5f) * float(m_Height);
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        minZ = std::min(minZ, c.z * invW);
+    }
+
+    // Off screen is left to the frustum test
+    if (!(maxX >= 0.0f && maxY >= 0.0f && minX <= float(m_Width) && minY <= float(m_Height)))
+        return false;
+
+    // Clamped in float, a tiny positive w projects far past what a uint32 holds
+    const float lastX = float(m_Width - 1);
+    const float lastY = float(m_Height - 1);
+    const uint32 x0 = uint32(Clamp(minX, 0.0f, lastX));
+    const uint32 y0 = uint32(Clamp(minY, 0.0f, lastY));
+    const uint32 x1 = uint32(Clamp(maxX, 0.0f, lastX));
+    const uint32 y1 = uint32(Clamp(maxY, 0.0f, lastY));
+
+    // Coarsest level where the rectangle spans at most 2x2 texels
+    size_t level = 0;
+    while (level + 1 < m_DepthLevels.size() && ((x1 >> level) - (x0 >> level) > 1 || (y1 >> level) - (y0 >> level) > 1))
+        level++;
+
+    const Vector<float>& depth = m_DepthLevels[level];
+    const uint32 levelWidth = m_LevelSizes[level].x;
+    for (uint32 y = y0 >> level; y <= y1 >> level; ++y)
+    {
+        for (uint32 x = x0 >> level; x <= x1 >> level; ++x)
+        {
+            if (minZ <= depth[size_t(y) * levelWidth + x])
+                return false;
+        }
+    }
+    return true;
+}
+
+OcclusionTestStats OcclusionCuller::CullSpheres(ConstFloat4SoA spheres, Span<const uint32> candidates, Vector<uint32>& visible) const
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    OcclusionTestStats stats;
+    stats.Tested = candidates.size();
+    for (uint32 index : candidates)
+    {
+        const float3 center{ spheres.X[index], spheres.Y[index], spheres.Z[index] };
+        const float radius = spheres.W[index];
+        if (radius >= 0.0f && IsOccluded(center - float3{ radius, radius, radius }, center + float3{ radius, radius, radius }))
+        {
+            stats.Occluded++;
+            continue;
+        }
+        visible.push_back(index);
+    }
+
+    stats.RejectionRate = stats.Tested ? float(stats.Occluded) / float(stats.Tested) : 0.0f;
+    stats.TestMilliseconds = MillisecondsSince(start);
+    return stats;
+}
+
+OcclusionBenchmarkReport RunOcclusionBenchmark(uint32 iterations, uint32 width, uint32 height)
+{
+    Camera camera;
+    camera.SetPosition(float3{ 0.0f, 2.0f, -5.0f });
+    camera.SetPerspective(90.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+
+    float4x4 viewProjection;
+    XMStoreFloat4x4(&viewProjection, camera.GetViewProjectionMatrix());
+
+    // Four walls side by side, leaving gaps to see through
+    const MeshTemplate wall = CreateCubeMesh(1.0f);
+    Vector<float4x4> wallWorlds;
+    for (int32 i = 0; i < 4; ++i)
+    {
+        wallWorlds.push_back(float4x4{
+            7.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 8.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 0.5f, 0.0f,
+            -12.0f + 8.0f * float(i), 2.0f, 8.0f, 1.0f });
+    }
+
+    // Field of small occludees behind the walls
+    constexpr uint32 s_CountX = 48, s_CountY = 8, s_CountZ = 24;
+    Float4Stream spheres(s_CountX * s_CountY * s_CountZ);
+    {
+        const Float4SoA view = spheres.View();
+        size_t i = 0;
+        for (uint32 z = 0; z < s_CountZ; ++z)
+        {
+            for (uint32 y = 0; y < s_CountY; ++y)
+            {
+                for (uint32 x = 0; x < s_CountX; ++x, ++i)
+                {
+                    view.X[i] = -24.0f + float(x);
+                    view.Y[i] = -1.0f + float(y) * 0.75f;
+                    view.Z[i] = 12.0f + float(z) * 1.5f;
+                    view.W[i] = 0.4f;
+                }
+            }
+        }
+    }
+
+    Vector<uint32> inFrustum;
+    CullSpheres(camera.GetFrustumPlanes(), spheres.View(), inFrustum);
+
+    OcclusionBenchmarkReport report;
+    report.Iterations = iterations;
+    OcclusionCuller culler(width, height);
+    Vector<uint32> visible;
+    for (uint32 iteration = 0; iteration < iterations; ++iteration)
+    {
+        culler.BeginFrame(viewProjection);
+        for (const float4x4& world : wallWorlds)
+            culler.AddOccluder(wall, world);
+        culler.RenderOccluders();
+
+        visible.clear();
+        report.Test = culler.CullSpheres(spheres.View(), inFrustum, visible);
+        report.Raster = culler.GetRasterStats();
+        report.AverageRasterMilliseconds += report.Raster.SetupMilliseconds + report.Raster.RasterMilliseconds;
+        report.AverageTestMilliseconds += report.Test.TestMilliseconds;
+    }
+
+    if (iterations > 0)
+    {
+        report.AverageRasterMilliseconds /= iterations;
+        report.AverageTestMilliseconds /= iterations;
+    }
+    return report;
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/VectorStreams.h"
+#include "Graphics/Mesh.h"
+
+class Object;
+
+struct OcclusionRasterStats
+{
+    size_t OccluderCount = 0;
+    size_t TrianglesSubmitted = 0;
+    size_t TrianglesRasterized = 0;     // After near-plane rejection and zero-area removal
+    double SetupMilliseconds = 0.0;     // Transform and triangle setup
+    double RasterMilliseconds = 0.0;    // Rasterization and the hierarchical depth build
+};
+
+struct OcclusionTestStats
+{
+    size_t Tested = 0;
+    size_t Occluded = 0;
+    float RejectionRate = 0.0f;         // Occluded / tested
+    double TestMilliseconds = 0.0;
+};
+
+// CPU occlusion culling: occluder meshes are rasterized into a small depth buffer, from which a max-depth mip chain
+// is built. Bounds are then tested against the coarsest level where they cover at most 2x2 texels.
+// Depth follows D3D, 0 at the near plane and 1 (cleared) at the far plane. Rasterization runs in horizontal bands on the
+// worker threads, eight pixels at a time with AVX2 (see Engine/SimdLanes.h). Everything is headless, no device needed.
+// Occluders must lie inside the geometry they stand for, e.g. the coarse sphere CreateSphereMesh builds, since the
+// buffer records the nearest occluder depth per pixel center
+class OcclusionCuller
+{
+public:
+    static constexpr uint32 s_DefaultWidth = 320;
+    static constexpr uint32 s_DefaultHeight = 192;
+
+    explicit OcclusionCuller(uint32 width = s_DefaultWidth, uint32 height = s_DefaultHeight);
+
+    void Resize(uint32 width, uint32 height);
+
+    // Clears the depth buffer and the occluder queue. viewProjection uses the row-vector convention
+    void BeginFrame(const float4x4& viewProjection);
+
+    // world is the row-vector object-to-world matrix. The template must stay alive until RenderOccluders returns
+    void AddOccluder(const MeshTemplate& mesh, const float4x4& world);
+
+    // Queues every object that has an occluder mesh
+    void AddOccluders(Span<Object* const> objects);
+
+    void RenderOccluders();
+
+    // World-space AABB against the hierarchical depth. Bounds crossing the near plane or off screen are never occluded
+    bool IsOccluded(const float3& boundsMin, const float3& boundsMax) const;
+
+    // Tests the spheres (xyz center, w radius) selected by candidates, e.g. the output of CullSpheres in Engine/Culling.h,
+    // and appends the visible ones to visible
+    OcclusionTestStats CullSpheres(ConstFloat4SoA spheres, Span<const uint32> candidates, Vector<uint32>& visible) const;
+
+    uint32 GetWidth() const { return m_Width; }
+    uint32 GetHeight() const { return m_Height; }
+    // Full resolution depth, row-major with y down
+    Span<const float> GetDepthBuffer() const { return m_DepthLevels.front(); }
+    const OcclusionRasterStats& GetRasterStats() const { return m_RasterStats; }
+
+private:
+    struct Occluder
+    {
+        const MeshTemplate* Mesh = nullptr;
+        float4x4 WorldViewProjection;
+    };
+
+    // Edge functions are set up so inside is >= 0 for both windings, depth is a plane in screen space
+    struct ScreenTriangle
+    {
+        float EdgeA[3];
+        float EdgeB[3];
+        float EdgeC[3];
+        float DepthA, DepthB, DepthC;
+        int32 MinX, MaxX, MinY, MaxY;
+    };
+
+    void SetupTriangles(const Occluder& occluder, Vector<ScreenTriangle>& triangles) const;
+    void RasterizeBand(uint32 firstRow, uint32 lastRow);
+    void BuildDepthHierarchy();
+
+    uint32 m_Width = 0;
+    uint32 m_Height = 0;
+    float4x4 m_ViewProjection = {};
+
+    Vector<Occluder> m_Occluders;
+    Vector<Vector<ScreenTriangle>> m_Triangles;     // Per occluder
+
+    // Level 0 is the depth buffer, each further level holds the max of 2x2 texels of the one below
+    Vector<Vector<float>> m_DepthLevels;
+    Vector<uint2> m_LevelSizes;
+
+    OcclusionRasterStats m_RasterStats;
+};
+
+struct OcclusionBenchmarkReport
+{
+    uint32 Iterations = 0;
+    OcclusionRasterStats Raster;        // Of the last iteration
+    OcclusionTestStats Test;            // Of the last iteration
+    double AverageRasterMilliseconds = 0.0;     // Setup and raster
+    double AverageTestMilliseconds = 0.0;
+};
+
+// Headless benchmark on a synthetic scene: a row of large walls in front of a field of small spheres, most of them
+// hidden. Reports the occluder raster time and the fraction of frustum-visible occludees rejected
+OcclusionBenchmarkReport RunOcclusionBenchmark(uint32 iterations = 100, uint32 width = OcclusionCuller::s_DefaultWidth,
+    uint32 height = OcclusionCuller::s_DefaultHeight);
@@ -0,0 +1,160 @@
+#include "Engine/Parallel.h"
+
+#include <condition_variable>
+#include <mutex>
+
+namespace
+{
+    // Set on pool threads and on the thread running a job, so nested calls do not wait for themselves
+    thread_local bool t_InsideJob = false;
+
+    // 0 when not overridden
+    std::atomic<uint32> s_WorkerCountOverride{ 0 };
+
+    class WorkerPool
+    {
+    public:
+        ~WorkerPool()
+        {
+            StopThreads();
+        }
+
+        // Resizes the pool to GetWorkerCount() - 1 threads first. Without any, the calling thread runs every item
+        void Run(ParallelJob& job, size_t helperCount)
+        {
+            std::lock_guard dispatchLock(m_DispatchMutex);
+            const uint32 threadCount = GetWorkerCount() - 1;
+            if (threadCount != m_Threads.size())
+            {
+                StopThreads();
+                m_Stop = false;
+                m_Threads.reserve(threadCount);
+                for (uint32 i = 0; i < threadCount; ++i)
+                    m_Threads.emplace_back([this]() { WorkerLoop(); });
+            }
+
+            {
+                std::lock_guard lock(m_Mutex);
+                m_Job = &job;
+                m_Error = nullptr;
+                m_FreeSlots = static_cast<uint32>(std::min<size_t>(helperCount, m_Threads.size()));
+                ++m_Generation;
+            }
+            m_WakeCondition.notify_all();
+
+            t_InsideJob = true;
+            RunItems(job);
+            t_InsideJob = false;
+
+            std::exception_ptr error;
+            {
+                // Threads that have not joined yet no longer can, the ones inside finish their current item
+                std::unique_lock lock(m_Mutex);
+                m_Job = nullptr;
+                m_FreeSlots = 0;
+                m_DoneCondition.wait(lock, [this]() { return m_RunningThreads == 0; });
+                error = m_Error;
+                m_Error = nullptr;
+            }
+            if (error)
+                std::rethrow_exception(error);
+        }
+
+    private:
+        // With m_DispatchMutex held or from the destructor, so no job is running
+        void StopThreads()
+        {
+            {
+                std::lock_guard lock(m_Mutex);
+                m_Stop = true;
+            }
+            m_WakeCondition.notify_all();
+            for (std::thread& thread : m_Threads)
+                thread.join();
+            m_Threads.clear();
+        }
+
+        void WorkerLoop()
+        {
+            t_InsideJob = true;
+            uint64 seenGeneration = 0;
+            std::unique_lock lock(m_Mutex);
+            while (true)
+            {
+                m_WakeCondition.wait(lock, [&]() { return m_Stop || (m_Job && m_FreeSlots > 0 && m_Generation != seenGeneration); });
+                if (m_Stop)
+                    return;
+
+                seenGeneration = m_Generation;
+                ParallelJob& job = *m_Job;
+                --m_FreeSlots;
+                ++m_RunningThreads;
+
+                lock.unlock();
+                RunItems(job);
+                lock.lock();
+
+                if (--m_RunningThreads == 0)
+                    m_DoneCondition.notify_all();
+            }
+        }
+
+        void RunItems(ParallelJob& job)
+        {
+            for (size_t i = job.Next.fetch_add(1, std::memory_order_relaxed); i < job.Count; i = job.Next.fetch_add(1, std::memory_order_relaxed))
+            {
+                try
+                {
+                    job.Invoke(job.Context, i);
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(m_Mutex);
+                    if (!m_Error)
+                        m_Error = std::current_exception();
+                    job.Next.store(job.Count, std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::mutex m_DispatchMutex;
+
+        // Guards everything below
+        std::mutex m_Mutex;
+        std::condition_variable m_WakeCondition;
+        std::condition_variable m_DoneCondition;
+        ParallelJob* m_Job = nullptr;
+        std::exception_ptr m_Error;
+        uint64 m_Generation = 0;
+        uint32 m_FreeSlots = 0;
+        uint32 m_RunningThreads = 0;
+        bool m_Stop = false;
+
+        Vector<std::thread> m_Threads;
+    };
+}
+
+uint32 GetWorkerCount() noexcept
+{
+    const uint32 workerCount = s_WorkerCountOverride.load(std::memory_order_relaxed);
+    return workerCount ? workerCount : std::max(1u, std::thread::hardware_concurrency());
+}
+
+void SetWorkerCount(uint32 count) noexcept
+{
+    s_WorkerCountOverride.store(count, std::memory_order_relaxed);
+}
+
+void RunParallelJob(ParallelJob& job, size_t threadCount)
+{
+    static WorkerPool s_Pool;
+
+    if (t_InsideJob || threadCount <= 1)
+    {
+        for (size_t i = 0; i < job.Count; ++i)
+            job.Invoke(job.Context, i);
+        return;
+    }
+
+    s_Pool.Run(job, threadCount - 1);
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <thread>
+#include <exception>
+
+#include "Engine/BaseTypes.h"
+
+// Worker count used by ParallelFor: the SetWorkerCount override, else the hardware thread count or 1 when unknown
+uint32 GetWorkerCount() noexcept;
+
+// Overrides the worker count, e.g. so tests run the pool on a single core machine. 0 restores the hardware count.
+// The pool is resized by the next job, once the running one finished
+void SetWorkerCount(uint32 count) noexcept;
+
+// One ParallelFor call as seen by the worker pool. Items are handed out one at a time through Next
+struct ParallelJob
+{
+    size_t Count = 0;
+    std::atomic<size_t> Next{ 0 };
+    void (*Invoke)(void* context, size_t index) = nullptr;
+    void* Context = nullptr;
+};
+
+// Runs the job on the calling thread plus up to threadCount - 1 threads of a pool created on first use, which holds
+// GetWorkerCount() - 1 threads until the process exits or the count is overridden. One job runs at a time, calls from other threads wait
+// for it. Calls made from inside a job (by its items) run serially on the calling thread. The first exception is
+// rethrown after all threads left the job
+void RunParallelJob(ParallelJob& job, size_t threadCount);
+
+// Calls func(i) for every i in [0, count) from up to GetWorkerCount() threads, the calling thread included.
+// Items are handed out one at a time, so uneven work balances itself. The first exception is rethrown after all workers finish
+template<class Func>
+void ParallelFor(size_t count, Func&& func, uint32 maxThreads = 0)
+{
+    if (count == 0)
+        return;
+
+    const size_t threadCount = std::min<size_t>(count, maxThreads ? maxThreads : GetWorkerCount());
+    if (threadCount <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    using FuncType = std::remove_reference_t<Func>;
+    ParallelJob job;
+    job.Count = count;
+    job.Context = const_cast<void*>(static_cast<const void*>(std::addressof(func)));
+    job.Invoke = [](void* context, size_t index) { (*static_cast<FuncType*>(context))(index); };
+    RunParallelJob(job, threadCount);
+}
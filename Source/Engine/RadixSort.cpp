@@ -0,0 +1,98 @@
+#include "RadixSort.h"
+#include "Engine/Parallel.h"
+
+#include <array>
+
+namespace
+{
+    constexpr uint32 s_RadixBits = 8;
+    constexpr uint32 s_BucketCount = 1u << s_RadixBits;
+    constexpr uint32 s_PassCount = 64 / s_RadixBits;
+    constexpr size_t s_MinChunkSize = 16384;
+
+    using Histogram = std::array<uint32, s_BucketCount>;
+
+    uint32 Digit(uint64 key, uint32 pass)
+    {
+        return static_cast<uint32>(key >> (pass * s_RadixBits)) & (s_BucketCount - 1);
+    }
+}
+
+void RadixSort(Vector<RadixSortItem>& items, Vector<RadixSortItem>& scratch, size_t parallelThreshold)
+{
+    const size_t count = items.size();
+    scratch.resize(count);
+    if (count < 2)
+        return;
+
+    const size_t chunkCount = count >= parallelThreshold ? std::clamp<size_t>(count / s_MinChunkSize, 1, GetWorkerCount()) : 1;
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+
+    // Digit totals do not change between passes, one read up front finds the passes that would not move anything
+    Vector<std::array<Histogram, s_PassCount>> totals(chunkCount);
+    ParallelFor(chunkCount, [&](size_t chunk)
+    {
+        std::array<Histogram, s_PassCount>& histograms = totals[chunk];
+        for (Histogram& histogram : histograms)
+            histogram.fill(0);
+        for (size_t i = chunk * chunkSize; i < std::min(count, (chunk + 1) * chunkSize); ++i)
+        {
+            for (uint32 pass = 0; pass < s_PassCount; ++pass)
+                histograms[pass][Digit(items[i].Key, pass)]++;
+        }
+    });
+
+    RadixSortItem* source = items.data();
+    RadixSortItem* destination = scratch.data();
+    Vector<Histogram> offsets(chunkCount);
+    for (uint32 pass = 0; pass < s_PassCount; ++pass)
+    {
+        bool trivial = false;
+        for (uint32 bucket = 0; bucket < s_BucketCount && !trivial; ++bucket)
+        {
+            size_t total = 0;
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+                total += totals[chunk][pass][bucket];
+            trivial = total == count;
+        }
+        if (trivial)
+            continue;
+
+        // Per-chunk histograms of the current order, then bucket-major, chunk-minor offsets keep the scatter stable
+        if (chunkCount == 1)
+        {
+            offsets[0] = totals[0][pass];
+        }
+        else
+        {
+            ParallelFor(chunkCount, [&](size_t chunk)
+            {
+                offsets[chunk].fill(0);
+                for (size_t i = chunk * chunkSize; i < std::min(count, (chunk + 1) * chunkSize); ++i)
+                    offsets[chunk][Digit(source[i].Key, pass)]++;
+            });
+        }
+
+        uint32 running = 0;
+        for (uint32 bucket = 0; bucket < s_BucketCount; ++bucket)
+        {
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                const uint32 bucketCount = offsets[chunk][bucket];
+                offsets[chunk][bucket] = running;
+                running += bucketCount;
+            }
+        }
+
+        ParallelFor(chunkCount, [&](size_t chunk)
+        {
+            Histogram& next = offsets[chunk];
+            for (size_t i = chunk * chunkSize; i < std::min(count, (chunk + 1) * chunkSize); ++i)
+                destination[next[Digit(source[i].Key, pass)]++] = source[i];
+        });
+        std::swap(source, destination);
+    }
+
+    if (source != items.data())
+        items.swap(scratch);
+}
@@ -0,0 +1,13 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+struct RadixSortItem
+{
+    uint64 Key;
+    uint32 Value;
+};
+
+// Stable LSD radix sort by Key, 8 bits per pass. Passes where every key has the same digit are skipped, so keys that
+// only differ in a few bytes cost a few passes. From parallelThreshold items the histogram and scatter of every pass
+// run on the worker threads, each over its own chunk. scratch is resized to match and keeps its capacity for reuse
+void RadixSort(Vector<RadixSortItem>& items, Vector<RadixSortItem>& scratch, size_t parallelThreshold = 65536);
@@ -0,0 +1,224 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <bit>
+#include <algorithm>
+#include <immintrin.h>
+
+// Only standard headers here: BaseTypes.h pulls this in through FastMath.h when THOR_FAST_MATH is defined
+#include "Engine/CpuFeatures.h"
+
+// Thin wrappers over one SIMD register width so batch kernels can be written once as templates.
+// ScalarLanes handles loop tails and the scalar fallback with the same kernel body.
+// IReg holds 32-bit integers in the same lanes, used for exponent and quadrant bit tricks.
+// MoveMask packs a comparison result into one bit per lane, lane 0 in bit 0.
+
+struct ScalarLanes
+{
+    using Reg = float;
+    using IReg = int32_t;
+    using Mask = bool;
+    static constexpr size_t Width = 1;
+
+    static Reg Load(const float* p) { return *p; }
+    static void Store(float* p, Reg v) { *p = v; }
+    static Reg Set1(float v) { return v; }
+    static Reg Add(Reg a, Reg b) { return a + b; }
+    static Reg Sub(Reg a, Reg b) { return a - b; }
+    static Reg Mul(Reg a, Reg b) { return a * b; }
+    static Reg Div(Reg a, Reg b) { return a / b; }
+    static Reg MulAdd(Reg a, Reg b, Reg c) { return a * b + c; }
+    static Reg Min(Reg a, Reg b) { return std::min(a, b); }
+    static Reg Max(Reg a, Reg b) { return std::max(a, b); }
+    static Reg Sqrt(Reg a) { return std::sqrt(a); }
+    static Mask CmpGt(Reg a, Reg b) { return a > b; }
+    static Mask CmpLt(Reg a, Reg b) { return a < b; }
+    static uint32_t MoveMask(Mask m) { return m ? 1u : 0u; }
+    static Reg Select(Mask m, Reg ifTrue, Reg ifFalse) { return m ? ifTrue : ifFalse; }
+    static Reg Abs(Reg a) { return std::fabs(a); }
+    static Reg And(Reg a, Reg b) { return AsFloat(AsInt(a) & AsInt(b)); }
+    static Reg Xor(Reg a, Reg b) { return AsFloat(AsInt(a) ^ AsInt(b)); }
+
+    static IReg ISet1(int32_t v) { return v; }
+    static IReg IAdd(IReg a, IReg b) { return a + b; }
+    static IReg ISub(IReg a, IReg b) { return a - b; }
+    static IReg IAnd(IReg a, IReg b) { return a & b; }
+    static IReg IOr(IReg a, IReg b) { return a | b; }
+    static IReg ShiftLeft(IReg a, int bits) { return static_cast<int32_t>(static_cast<uint32_t>(a) << bits); }
+    static IReg ShiftRight(IReg a, int bits) { return static_cast<int32_t>(static_cast<uint32_t>(a) >> bits); }
+    static Mask TestBits(IReg a, int32_t bits) { return (a & bits) != 0; }
+    static IReg ToIntRound(Reg a) { return static_cast<int32_t>(std::lrint(a)); }
+    static Reg ToFloat(IReg a) { return static_cast<float>(a); }
+    static Reg AsFloat(IReg a) { return std::bit_cast<float>(a); }
+    static IReg AsInt(Reg a) { return std::bit_cast<int32_t>(a); }
+};
+
+struct SseLanes
+{
+    using Reg = __m128;
+    using IReg = __m128i;
+    using Mask = __m128;
+    static constexpr size_t Width = 4;
+
+    static Reg Load(const float* p) { return _mm_loadu_ps(p); }
+    static void Store(float* p, Reg v) { _mm_storeu_ps(p, v); }
+    static Reg Set1(float v) { return _mm_set1_ps(v); }
+    static Reg Add(Reg a, Reg b) { return _mm_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static Reg Min(Reg a, Reg b) { return _mm_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm_max_ps(a, b); }
+    static Reg Sqrt(Reg a) { return _mm_sqrt_ps(a); }
+    static Mask CmpGt(Reg a, Reg b) { return _mm_cmpgt_ps(a, b); }
+    static Mask CmpLt(Reg a, Reg b) { return _mm_cmplt_ps(a, b); }
+    static uint32_t MoveMask(Mask m) { return static_cast<uint32_t>(_mm_movemask_ps(m)); }
+    static Reg Select(Mask m, Reg ifTrue, Reg ifFalse) { return _mm_or_ps(_mm_and_ps(m, ifTrue), _mm_andnot_ps(m, ifFalse)); }
+    static Reg Abs(Reg a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static Reg And(Reg a, Reg b) { return _mm_and_ps(a, b); }
+    static Reg Xor(Reg a, Reg b) { return _mm_xor_ps(a, b); }
+
+    static IReg ISet1(int32_t v) { return _mm_set1_epi32(v); }
+    static IReg IAdd(IReg a, IReg b) { return _mm_add_epi32(a, b); }
+    static IReg ISub(IReg a, IReg b) { return _mm_sub_epi32(a, b); }
+    static IReg IAnd(IReg a, IReg b) { return _mm_and_si128(a, b); }
+    static IReg IOr(IReg a, IReg b) { return _mm_or_si128(a, b); }
+    static IReg ShiftLeft(IReg a, int bits) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static IReg ShiftRight(IReg a, int bits) { return _mm_srl_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static Mask TestBits(IReg a, int32_t bits)
+    {
+        const __m128i masked = _mm_and_si128(a, _mm_set1_epi32(bits));
+        return _mm_castsi128_ps(_mm_xor_si128(_mm_cmpeq_epi32(masked, _mm_setzero_si128()), _mm_set1_epi32(-1)));
+    }
+    static IReg ToIntRound(Reg a) { return _mm_cvtps_epi32(a); }
+    static Reg ToFloat(IReg a) { return _mm_cvtepi32_ps(a); }
+    static Reg AsFloat(IReg a) { return _mm_castsi128_ps(a); }
+    static IReg AsInt(Reg a) { return _mm_castps_si128(a); }
+};
+
+// Requires AVX2 + FMA, only instantiate behind a GetSimdLevel() check
+struct Avx2Lanes
+{
+    using Reg = __m256;
+    using IReg = __m256i;
+    using Mask = __m256;
+    static constexpr size_t Width = 8;
+
+    static Reg Load(const float* p) { return _mm256_loadu_ps(p); }
+    static void Store(float* p, Reg v) { _mm256_storeu_ps(p, v); }
+    static Reg Set1(float v) { return _mm256_set1_ps(v); }
+    static Reg Add(Reg a, Reg b) { return _mm256_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm256_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm256_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm256_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) { return _mm256_fmadd_ps(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm256_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm256_max_ps(a, b); }
+    static Reg Sqrt(Reg a) { return _mm256_sqrt_ps(a); }
+    static Mask CmpGt(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static Mask CmpLt(Reg a, Reg b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static uint32_t MoveMask(Mask m) { return static_cast<uint32_t>(_mm256_movemask_ps(m)); }
+    static Reg Select(Mask m, Reg ifTrue, Reg ifFalse) { return _mm256_blendv_ps(ifFalse, ifTrue, m); }
+    static Reg Abs(Reg a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static Reg And(Reg a, Reg b) { return _mm256_and_ps(a, b); }
+    static Reg Xor(Reg a, Reg b) { return _mm256_xor_ps(a, b); }
+
+    static IReg ISet1(int32_t v) { return _mm256_set1_epi32(v); }
+    static IReg IAdd(IReg a, IReg b) { return _mm256_add_epi32(a, b); }
+    static IReg ISub(IReg a, IReg b) { return _mm256_sub_epi32(a, b); }
+    static IReg IAnd(IReg a, IReg b) { return _mm256_and_si256(a, b); }
+    static IReg IOr(IReg a, IReg b) { return _mm256_or_si256(a, b); }
+    static IReg ShiftLeft(IReg a, int bits) { return _mm256_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static IReg ShiftRight(IReg a, int bits) { return _mm256_srl_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static Mask TestBits(IReg a, int32_t bits)
+    {
+        const __m256i masked = _mm256_and_si256(a, _mm256_set1_epi32(bits));
+        return _mm256_castsi256_ps(_mm256_xor_si256(_mm256_cmpeq_epi32(masked, _mm256_setzero_si256()), _mm256_set1_epi32(-1)));
+    }
+    static IReg ToIntRound(Reg a) { return _mm256_cvtps_epi32(a); }
+    static Reg ToFloat(IReg a) { return _mm256_cvtepi32_ps(a); }
+    static Reg AsFloat(IReg a) { return _mm256_castsi256_ps(a); }
+    static IReg AsInt(Reg a) { return _mm256_castps_si256(a); }
+};
+
+// Requires AVX-512F, only instantiate behind a GetSimdLevel() check
+struct Avx512Lanes
+{
+    using Reg = __m512;
+    using IReg = __m512i;
+    using Mask = __mmask16;
+    static constexpr size_t Width = 16;
+
+    static Reg Load(const float* p) { return _mm512_loadu_ps(p); }
+    static void Store(float* p, Reg v) { _mm512_storeu_ps(p, v); }
+    static Reg Set1(float v) { return _mm512_set1_ps(v); }
+    static Reg Add(Reg a, Reg b) { return _mm512_add_ps(a, b); }
+    static Reg Sub(Reg a, Reg b) { return _mm512_sub_ps(a, b); }
+    static Reg Mul(Reg a, Reg b) { return _mm512_mul_ps(a, b); }
+    static Reg Div(Reg a, Reg b) { return _mm512_div_ps(a, b); }
+    static Reg MulAdd(Reg a, Reg b, Reg c) { return _mm512_fmadd_ps(a, b, c); }
+    static Reg Min(Reg a, Reg b) { return _mm512_min_ps(a, b); }
+    static Reg Max(Reg a, Reg b) { return _mm512_max_ps(a, b); }
+    static Reg Sqrt(Reg a) { return _mm512_sqrt_ps(a); }
+    static Mask CmpGt(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+    static Mask CmpLt(Reg a, Reg b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static uint32_t MoveMask(Mask m) { return static_cast<uint32_t>(m); }
+    static Reg Select(Mask m, Reg ifTrue, Reg ifFalse) { return _mm512_mask_blend_ps(m, ifFalse, ifTrue); }
+    // Float bitwise ops need AVX-512DQ, so they go through the integer domain
+    static Reg Abs(Reg a) { return AsFloat(_mm512_and_si512(AsInt(a), _mm512_set1_epi32(0x7FFFFFFF))); }
+    static Reg And(Reg a, Reg b) { return AsFloat(_mm512_and_si512(AsInt(a), AsInt(b))); }
+    static Reg Xor(Reg a, Reg b) { return AsFloat(_mm512_xor_si512(AsInt(a), AsInt(b))); }
+
+    static IReg ISet1(int32_t v) { return _mm512_set1_epi32(v); }
+    static IReg IAdd(IReg a, IReg b) { return _mm512_add_epi32(a, b); }
+    static IReg ISub(IReg a, IReg b) { return _mm512_sub_epi32(a, b); }
+    static IReg IAnd(IReg a, IReg b) { return _mm512_and_si512(a, b); }
+    static IReg IOr(IReg a, IReg b) { return _mm512_or_si512(a, b); }
+    static IReg ShiftLeft(IReg a, int bits) { return _mm512_sll_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static IReg ShiftRight(IReg a, int bits) { return _mm512_srl_epi32(a, _mm_cvtsi32_si128(bits)); }
+    static Mask TestBits(IReg a, int32_t bits) { return _mm512_test_epi32_mask(a, _mm512_set1_epi32(bits)); }
+    static IReg ToIntRound(Reg a) { return _mm512_cvtps_epi32(a); }
+    static Reg ToFloat(IReg a) { return _mm512_cvtepi32_ps(a); }
+    static Reg AsFloat(IReg a) { return _mm512_castsi512_ps(a); }
+    static IReg AsInt(Reg a) { return _mm512_castps_si512(a); }
+};
+
+// Calls body.template operator()<L>(i) for every full block of L::Width elements, then finishes the tail one element at a time
+template<class L, class Body>
+inline void ForEachBlock(size_t count, Body&& body)
+{
+    size_t i = 0;
+    for (; i + L::Width <= count; i += L::Width)
+    {
+        body.template operator()<L>(i);
+    }
+    for (; i < count; ++i)
+    {
+        body.template operator()<ScalarLanes>(i);
+    }
+}
+
+// Runs Kernel<L>::Run(args...) with the widest lane type allowed by GetSimdLevel()
+template<template<class> class Kernel, class... Args>
+inline void DispatchSimd(Args&&... args)
+{
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        Kernel<ScalarLanes>::Run(args...);
+        break;
+    case SimdLevel::Sse:
+        Kernel<SseLanes>::Run(args...);
+        break;
+    case SimdLevel::Avx2:
+        Kernel<Avx2Lanes>::Run(args...);
+        _mm256_zeroupper();
+        break;
+    case SimdLevel::Avx512:
+        Kernel<Avx512Lanes>::Run(args...);
+        _mm256_zeroupper();
+        break;
+    }
+}
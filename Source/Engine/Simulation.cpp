@@ -33,6 +33,14 @@ void Simulation::Init(const uint width, const uint height, const HWND hwnd)
 void Simulation::Release()
 {
     PreRelease();
+    m_UploadRing.Release();
+    m_StagingUploader.Release();
+    m_MaterialTable.Release();
+    for (GpuAllocation& depthBuffer : m_DepthBuffers)
+        m_GpuAllocator.Free(depthBuffer);
+    m_GpuAllocator.Release();
+    m_CbvUavSrvDescriptors.Release();
+    m_SamplerDescriptors.Release();
     CloseHandle(m_FenceEvent);
 }
 
@@ -64,8 +72,6 @@ void Simulation::ResizeScreen(const uint width, const uint height)
 
     // Recreate depth buffers
     {
-        D3D12_HEAP_PROPERTIES heapProps = {};
-        heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
         D3D12_RESOURCE_DESC depthDesc = {};
         depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
         depthDesc.Alignment = 0;
@@ -84,17 +90,9 @@ void Simulation::ResizeScreen(const uint width, const uint height)
         clearValue.DepthStencil.Stencil = 0;
         CD3DX12_CPU_DESCRIPTOR_HANDLE dsvHandle(m_DsvHeap->GetCPUDescriptorHandleForHeapStart());
         for (uint i = 0; i < s_FrameCount; ++i) {
-            if (FAILED(m_Device->CreateCommittedResource(
-                &heapProps,
-                D3D12_HEAP_FLAG_NONE,
-                &depthDesc,
-                D3D12_RESOURCE_STATE_DEPTH_WRITE,
-                &clearValue,
-                IID_PPV_ARGS(&m_DepthBuffers[i]))))
-            {
-                throw std::runtime_error("Failed to create depth buffer.");
-            }
-            m_Device->CreateDepthStencilView(m_DepthBuffers[i].Get(), nullptr, dsvHandle);
+            m_GpuAllocator.Free(m_DepthBuffers[i]);
+            m_DepthBuffers[i] = m_GpuAllocator.CreateTexture(depthDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearValue);
+            m_Device->CreateDepthStencilView(m_DepthBuffers[i].Resource.Get(), nullptr, dsvHandle);
             dsvHandle.Offset(1, m_DsvDescriptorSize);
         }
     }
@@ -124,10 +122,13 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
         m_Device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&m_CommandQueue));
     }
 
+    // GPU memory
+    {
+        m_GpuAllocator.Initialize(m_Device.Get());
+    }
+
     // Depth buffers
     {
-        D3D12_HEAP_PROPERTIES heapProps = {};
-        heapProps.Type = D3D12_HEAP_TYPE_DEFAULT;
         D3D12_RESOURCE_DESC depthDesc = {};
         depthDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
         depthDesc.Alignment = 0;
@@ -145,16 +146,8 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
         clearValue.DepthStencil.Depth = 1.0f;
         clearValue.DepthStencil.Stencil = 0;
         for (uint i = 0; i < s_FrameCount; ++i) {
-            if (FAILED(m_Device->CreateCommittedResource(
-                &heapProps,
-                D3D12_HEAP_FLAG_NONE,
-                &depthDesc,
-                D3D12_RESOURCE_STATE_DEPTH_WRITE,
-                &clearValue,
-                IID_PPV_ARGS(&m_DepthBuffers[i]))))
-            {
-                throw std::runtime_error("Failed to create depth buffer.");
-            }
+            m_GpuAllocator.Free(m_DepthBuffers[i]);
+            m_DepthBuffers[i] = m_GpuAllocator.CreateTexture(depthDesc, D3D12_RESOURCE_STATE_DEPTH_WRITE, &clearValue);
         }
     }
 
@@ -207,7 +200,7 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
             m_Device->CreateRenderTargetView(m_RenderTargets[i].Get(), nullptr, rtvHandle);
             rtvHandle.Offset(1, m_RtvDescriptorSize);
 
-            m_Device->CreateDepthStencilView(m_DepthBuffers[i].Get(), nullptr, dsvHandle);
+            m_Device->CreateDepthStencilView(m_DepthBuffers[i].Resource.Get(), nullptr, dsvHandle);
             dsvHandle.Offset(1, m_DsvDescriptorSize);
 
             m_Device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&m_CommandAllocator[i]));
@@ -223,6 +216,8 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
         heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         if (FAILED(m_Device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_CbvUavSrvHeap))))
             throw std::runtime_error("Failed to create CBV SRV UAV descriptor heap");
+        m_CbvUavSrvDescriptors.Initialize(m_Device.Get(), m_CbvUavSrvHeap.Get(), heapDesc.NumDescriptors - s_TransientDescriptorCount);
+        m_MaterialTable.Initialize(m_Device.Get(), &m_CbvUavSrvDescriptors);
     }
 
     // Create sampler descriptor heap
@@ -233,6 +228,7 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
         heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
         if (FAILED(m_Device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&m_SamplerHeap))))
             throw std::runtime_error("Failed to create sampler descriptor heap");
+        m_SamplerDescriptors.Initialize(m_Device.Get(), m_SamplerHeap.Get(), heapDesc.NumDescriptors);
     }
 
     // Command list
@@ -247,29 +243,59 @@ void Simulation::InitD3D12(const uint width, const uint height, const HWND hwnd)
         m_FenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
         if (!m_FenceEvent) throw std::runtime_error("Failed to create fence event.");
     }
+
+    // Upload ring
+    {
+        m_UploadRing.Initialize(m_Device.Get(), s_UploadRingSize);
+    }
+
+    // Staging uploads
+    {
+        m_StagingUploader.Initialize(m_Device.Get(), &m_GpuAllocator, s_FrameCount);
+    }
 }
 
 void Simulation::WaitForPreviousFrame()
 {
-    // Signal and increment the fence value.
-    const uint64 fenceToWaitFor = ++m_FenceValue[m_FrameIndex];
+    // Signal and increment the fence value. Values increase across frames so the upload ring can compare them
+    const uint64 fenceToWaitFor = ++m_LastFenceValue;
+    m_FenceValue[m_FrameIndex] = fenceToWaitFor;
     m_CommandQueue->Signal(m_Fence.Get(), fenceToWaitFor);
+    m_UploadRing.FinishFrame(fenceToWaitFor);
+    m_StagingUploader.FinishFrame(fenceToWaitFor);
+    m_CbvUavSrvDescriptors.FinishFrame(fenceToWaitFor);
+    m_SamplerDescriptors.FinishFrame(fenceToWaitFor);
 
     // Wait until the previous frame is finished.
     if (m_Fence->GetCompletedValue() < fenceToWaitFor) {
         m_Fence->SetEventOnCompletion(fenceToWaitFor, m_FenceEvent);
         WaitForSingleObject(m_FenceEvent, INFINITE);
     }
+    const uint64 completedFenceValue = m_Fence->GetCompletedValue();
+    m_UploadRing.Reclaim(completedFenceValue);
+    m_StagingUploader.Reclaim(completedFenceValue);
+    m_CbvUavSrvDescriptors.Reclaim(completedFenceValue);
+    m_SamplerDescriptors.Reclaim(completedFenceValue);
 
     m_FrameIndex = m_SwapChain->GetCurrentBackBufferIndex();
 }
 
 void Simulation::Render()
 {
+    // Record the uploads first so meshes they finish are drawable by this frame
+    ID3D12CommandList* uploadCommandList = m_StagingUploader.RecordFrame(m_FrameIndex);
     PopulateCommandList();
 
-    ID3D12CommandList* ppCommandLists[] = { m_CommandList.Get() };
-    m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    if (uploadCommandList)
+    {
+        ID3D12CommandList* ppCommandLists[] = { uploadCommandList, m_CommandList.Get() };
+        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    }
+    else
+    {
+        ID3D12CommandList* ppCommandLists[] = { m_CommandList.Get() };
+        m_CommandQueue->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    }
 
     m_SwapChain->Present(1, 0);
 
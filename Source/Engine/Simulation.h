@@ -5,6 +5,11 @@
 #include "directx/d3dx12.h"
 
 #include "Engine/BaseTypes.h"
+#include "Graphics/DescriptorAllocator.h"
+#include "Graphics/GpuMemoryAllocator.h"
+#include "Graphics/MaterialTable.h"
+#include "Graphics/StagingUploader.h"
+#include "Graphics/UploadRingBuffer.h"
 
 #ifdef _DEBUG
 #include "Debug/DebugLayer.h"
@@ -14,6 +19,10 @@ class Simulation
 {
 public:
     static constexpr uint s_FrameCount = 2;
+    // Per-frame constants of all frames in flight, e.g. 8 MB fits ~16k objects per frame
+    static constexpr uint64 s_UploadRingSize = 8ull << 20;
+    // Slots of the shader-visible CBV SRV UAV heap handed out per frame, the others are persistent
+    static constexpr uint s_TransientDescriptorCount = 65536;
 
 public:
     Simulation();
@@ -40,8 +49,10 @@ protected:
     ComPtr<ID3D12DescriptorHeap> m_DsvHeap;
     ComPtr<ID3D12DescriptorHeap> m_CbvUavSrvHeap;
     ComPtr<ID3D12DescriptorHeap> m_SamplerHeap;
+    DescriptorAllocator m_CbvUavSrvDescriptors;
+    DescriptorAllocator m_SamplerDescriptors;
     ComPtr<ID3D12Resource> m_RenderTargets[s_FrameCount];
-    ComPtr<ID3D12Resource> m_DepthBuffers[s_FrameCount];
+    GpuAllocation m_DepthBuffers[s_FrameCount];
     ComPtr<ID3D12CommandAllocator> m_CommandAllocator[s_FrameCount];
     ComPtr<ID3D12GraphicsCommandList> m_CommandList;
     uint m_RtvDescriptorSize;
@@ -51,8 +62,19 @@ protected:
     // Fence objects
     ComPtr<ID3D12Fence> m_Fence;
     uint64 m_FenceValue[s_FrameCount];
+    uint64 m_LastFenceValue = 0;
     HANDLE m_FenceEvent;
 
+    // Frame and object constants, reclaimed as the fence completes
+    UploadRingBuffer m_UploadRing;
+
+    // Default heap memory of the depth buffers and static geometry, which is copied in ahead of each frame's command list
+    GpuMemoryAllocator m_GpuAllocator;
+    StagingUploader m_StagingUploader;
+
+    // Deduplicated materials of every mesh, textures referenced through m_CbvUavSrvDescriptors
+    MaterialTable m_MaterialTable;
+
 #ifdef _DEBUG
     D3D12DebugLayer m_DebugLayer;
 #endif
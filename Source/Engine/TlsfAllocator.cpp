@@ -0,0 +1,330 @@
+#include "TlsfAllocator.h"
+
+#include <bit>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+
+TlsfAllocator::TlsfAllocator(uint64 capacity)
+    : m_Capacity(capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("TLSF allocator capacity must be positive");
+    }
+
+    for (auto& lists : m_FreeLists)
+    {
+        for (uint32& head : lists)
+            head = s_InvalidBlock;
+    }
+
+    // The whole range starts out as one free block
+    const uint32 index = CreateBlock();
+    m_Blocks[index].Size = capacity;
+    InsertFreeBlock(index);
+}
+
+TlsfAllocation TlsfAllocator::Allocate(uint64 size, uint64 alignment)
+{
+    if (size == 0)
+    {
+        throw std::invalid_argument("TLSF allocation size must be positive");
+    }
+    if (size > m_Capacity)
+        return {};
+
+    // Sizes that are multiples of the alignment keep offsets aligned, so padding for it is only searched for when the
+    // block found for size itself is misaligned. Any block holding the worst case padding fits wherever it starts
+    uint32 index = FindFreeBlock(size, alignment);
+    if (index == s_InvalidBlock && alignment > 1 && size + alignment - 1 <= m_Capacity)
+        index = FindFreeBlock(size + alignment - 1, 1);
+    if (index == s_InvalidBlock)
+        return {};
+
+    RemoveFreeBlock(index);
+
+    // Return the padding in front of the aligned offset as a free block of its own
+    const uint64 padding = AlignUp(m_Blocks[index].Offset, alignment) - m_Blocks[index].Offset;
+    if (padding > 0)
+    {
+        const uint32 front = CreateBlock();
+        Block& block = m_Blocks[index];
+        m_Blocks[front].Offset = block.Offset;
+        m_Blocks[front].Size = padding;
+        m_Blocks[front].PrevPhysical = block.PrevPhysical;
+        m_Blocks[front].NextPhysical = index;
+        if (block.PrevPhysical != s_InvalidBlock)
+            m_Blocks[block.PrevPhysical].NextPhysical = front;
+        block.PrevPhysical = front;
+        block.Offset += padding;
+        block.Size -= padding;
+        InsertFreeBlock(front);
+    }
+
+    // And the rest behind it
+    if (m_Blocks[index].Size > size)
+    {
+        const uint32 back = CreateBlock();
+        Block& block = m_Blocks[index];
+        m_Blocks[back].Offset = block.Offset + size;
+        m_Blocks[back].Size = block.Size - size;
+        m_Blocks[back].PrevPhysical = index;
+        m_Blocks[back].NextPhysical = block.NextPhysical;
+        if (block.NextPhysical != s_InvalidBlock)
+            m_Blocks[block.NextPhysical].PrevPhysical = back;
+        block.NextPhysical = back;
+        block.Size = size;
+        InsertFreeBlock(back);
+    }
+
+    m_UsedBytes += size;
+    m_AllocationCount++;
+    return TlsfAllocation{ m_Blocks[index].Offset, index };
+}
+
+void TlsfAllocator::Free(uint32 handle)
+{
+    if (handle >= m_Blocks.size() || m_Blocks[handle].IsFree || m_Blocks[handle].Size == 0)
+    {
+        throw std::invalid_argument("TLSF handle is not a live allocation");
+    }
+
+    m_UsedBytes -= m_Blocks[handle].Size;
+    m_AllocationCount--;
+
+    uint32 index = handle;
+    const uint32 prev = m_Blocks[index].PrevPhysical;
+    if (prev != s_InvalidBlock && m_Blocks[prev].IsFree)
+    {
+        RemoveFreeBlock(prev);
+        m_Blocks[prev].Size += m_Blocks[index].Size;
+        m_Blocks[prev].NextPhysical = m_Blocks[index].NextPhysical;
+        if (m_Blocks[index].NextPhysical != s_InvalidBlock)
+            m_Blocks[m_Blocks[index].NextPhysical].PrevPhysical = prev;
+        RecycleBlock(index);
+        index = prev;
+    }
+
+    const uint32 next = m_Blocks[index].NextPhysical;
+    if (next != s_InvalidBlock && m_Blocks[next].IsFree)
+    {
+        RemoveFreeBlock(next);
+        m_Blocks[index].Size += m_Blocks[next].Size;
+        m_Blocks[index].NextPhysical = m_Blocks[next].NextPhysical;
+        if (m_Blocks[next].NextPhysical != s_InvalidBlock)
+            m_Blocks[m_Blocks[next].NextPhysical].PrevPhysical = index;
+        RecycleBlock(next);
+    }
+
+    InsertFreeBlock(index);
+}
+
+TlsfStats TlsfAllocator::GetStats() const
+{
+    TlsfStats stats;
+    stats.Capacity = m_Capacity;
+    stats.UsedBytes = m_UsedBytes;
+    stats.FreeBytes = m_Capacity - m_UsedBytes;
+    stats.AllocationCount = m_AllocationCount;
+    stats.FreeBlockCount = m_FreeBlockCount;
+
+    // The largest block is in the highest non-empty class, which also holds somewhat smaller ones
+    if (m_FirstLevelMap != 0)
+    {
+        const uint32 firstLevel = 63 - std::countl_zero(m_FirstLevelMap);
+        const uint32 secondLevel = 31 - std::countl_zero(m_SecondLevelMaps[firstLevel]);
+        for (uint32 index = m_FreeLists[firstLevel][secondLevel]; index != s_InvalidBlock; index = m_Blocks[index].NextFree)
+            stats.LargestFreeBlock = std::max(stats.LargestFreeBlock, m_Blocks[index].Size);
+    }
+    if (stats.FreeBytes > 0)
+        stats.Fragmentation = 1.0f - float(double(stats.LargestFreeBlock) / double(stats.FreeBytes));
+    return stats;
+}
+
+void TlsfAllocator::MapSize(uint64 size, uint32& firstLevel, uint32& secondLevel)
+{
+    if (size < s_SecondLevelCount)
+    {
+        firstLevel = 0;
+        secondLevel = static_cast<uint32>(size);
+        return;
+    }
+    const uint32 topBit = 63 - std::countl_zero(size);
+    firstLevel = topBit - s_SecondLevelBits + 1;
+    secondLevel = static_cast<uint32>(size >> (topBit - s_SecondLevelBits)) - s_SecondLevelCount;
+}
+
+uint32 TlsfAllocator::FindFreeBlock(uint64 size, uint64 alignment) const
+{
+    uint32 firstLevel = 0;
+    uint32 secondLevel = 0;
+
+    // Every block of the classes above the one holding size fits it, round size up to the next class
+    uint64 rounded = size;
+    if (size >= s_SecondLevelCount)
+        rounded += (1ull << (63 - std::countl_zero(size) - s_SecondLevelBits)) - 1;
+    if (rounded <= m_Capacity)
+    {
+        MapSize(rounded, firstLevel, secondLevel);
+        uint32 secondLevelMap = m_SecondLevelMaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0)
+        {
+            const uint64 firstLevelMap = firstLevel + 1 < 64 ? m_FirstLevelMap & (~0ull << (firstLevel + 1)) : 0;
+            if (firstLevelMap != 0)
+            {
+                firstLevel = static_cast<uint32>(std::countr_zero(firstLevelMap));
+                secondLevelMap = m_SecondLevelMaps[firstLevel];
+            }
+        }
+        if (secondLevelMap != 0)
+        {
+            const uint32 index = m_FreeLists[firstLevel][std::countr_zero(secondLevelMap)];
+            if (Fits(m_Blocks[index], size, alignment))
+                return index;
+        }
+    }
+
+    // The class of size itself mixes blocks above and below it, e.g. the whole free heap asked for in one piece
+    MapSize(size, firstLevel, secondLevel);
+    if ((m_SecondLevelMaps[firstLevel] & (1u << secondLevel)) == 0)
+        return s_InvalidBlock;
+    for (uint32 index = m_FreeLists[firstLevel][secondLevel]; index != s_InvalidBlock; index = m_Blocks[index].NextFree)
+    {
+        if (Fits(m_Blocks[index], size, alignment))
+            return index;
+    }
+    return s_InvalidBlock;
+}
+
+bool TlsfAllocator::Fits(const Block& block, uint64 size, uint64 alignment) const
+{
+    return AlignUp(block.Offset, alignment) + size <= block.Offset + block.Size;
+}
+
+uint32 TlsfAllocator::CreateBlock()
+{
+    if (m_UnusedBlock != s_InvalidBlock)
+    {
+        const uint32 index = m_UnusedBlock;
+        m_UnusedBlock = m_Blocks[index].NextFree;
+        m_Blocks[index] = Block();
+        return index;
+    }
+    m_Blocks.emplace_back();
+    return static_cast<uint32>(m_Blocks.size() - 1);
+}
+
+void TlsfAllocator::RecycleBlock(uint32 index)
+{
+    // Size 0 marks the slot as unused so Free rejects stale handles to it
+    m_Blocks[index] = Block();
+    m_Blocks[index].NextFree = m_UnusedBlock;
+    m_UnusedBlock = index;
+}
+
+void TlsfAllocator::InsertFreeBlock(uint32 index)
+{
+    uint32 firstLevel = 0;
+    uint32 secondLevel = 0;
+    MapSize(m_Blocks[index].Size, firstLevel, secondLevel);
+
+    Block& block = m_Blocks[index];
+    uint32& head = m_FreeLists[firstLevel][secondLevel];
+    block.IsFree = true;
+    block.PrevFree = s_InvalidBlock;
+    block.NextFree = head;
+    if (head != s_InvalidBlock)
+        m_Blocks[head].PrevFree = index;
+    head = index;
+
+    m_FirstLevelMap |= 1ull << firstLevel;
+    m_SecondLevelMaps[firstLevel] |= 1u << secondLevel;
+    m_FreeBlockCount++;
+}
+
+void TlsfAllocator::RemoveFreeBlock(uint32 index)
+{
+    uint32 firstLevel = 0;
+    uint32 secondLevel = 0;
+    MapSize(m_Blocks[index].Size, firstLevel, secondLevel);
+
+    Block& block = m_Blocks[index];
+    if (block.PrevFree != s_InvalidBlock)
+        m_Blocks[block.PrevFree].NextFree = block.NextFree;
+    else
+        m_FreeLists[firstLevel][secondLevel] = block.NextFree;
+    if (block.NextFree != s_InvalidBlock)
+        m_Blocks[block.NextFree].PrevFree = block.PrevFree;
+    block.IsFree = false;
+    block.PrevFree = s_InvalidBlock;
+    block.NextFree = s_InvalidBlock;
+
+    if (m_FreeLists[firstLevel][secondLevel] == s_InvalidBlock)
+    {
+        m_SecondLevelMaps[firstLevel] &= ~(1u << secondLevel);
+        if (m_SecondLevelMaps[firstLevel] == 0)
+            m_FirstLevelMap &= ~(1ull << firstLevel);
+    }
+    m_FreeBlockCount--;
+}
+
+TlsfBenchmarkReport RunTlsfBenchmark(uint32 operationCount, uint64 capacity, uint32 seed)
+{
+    using Clock = std::chrono::steady_clock;
+
+    TlsfBenchmarkReport report;
+    TlsfAllocator allocator(capacity);
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<float> logSize(8.0f, 20.0f);
+    std::uniform_int_distribution<uint32> alignmentPick(0, 3);
+
+    Vector<uint32> live;
+    double allocateSeconds = 0.0;
+    double freeSeconds = 0.0;
+    for (uint32 operation = 0; operation < operationCount; ++operation)
+    {
+        // Free more often once the heap is three quarters full
+        const bool allocate = live.empty() || allocator.GetUsedBytes() * 4 < capacity * 3 ? random() % 4 != 0 : random() % 4 == 0;
+        if (allocate)
+        {
+            const uint64 size = static_cast<uint64>(std::exp2(logSize(random)));
+            const uint64 alignment = alignmentPick(random) == 0 ? 64ull << 10 : 256;
+
+            const auto start = Clock::now();
+            const TlsfAllocation allocation = allocator.Allocate(size, alignment);
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            report.Allocations++;
+            allocateSeconds += seconds;
+            report.MaxAllocateNanoseconds = std::max(report.MaxAllocateNanoseconds, seconds * 1e9);
+            if (allocation.IsValid())
+                live.push_back(allocation.Handle);
+            else
+                report.FailedAllocations++;
+        }
+        else
+        {
+            const size_t pick = random() % live.size();
+            const uint32 handle = live[pick];
+            live[pick] = live.back();
+            live.pop_back();
+
+            const auto start = Clock::now();
+            allocator.Free(handle);
+            const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            report.Frees++;
+            freeSeconds += seconds;
+            report.MaxFreeNanoseconds = std::max(report.MaxFreeNanoseconds, seconds * 1e9);
+        }
+
+        report.PeakUsedBytes = std::max(report.PeakUsedBytes, allocator.GetUsedBytes());
+        if (operation % 1024 == 0)
+            report.PeakFragmentation = std::max(report.PeakFragmentation, allocator.GetStats().Fragmentation);
+    }
+
+    report.MeanAllocateNanoseconds = report.Allocations > 0 ? allocateSeconds * 1e9 / report.Allocations : 0.0;
+    report.MeanFreeNanoseconds = report.Frees > 0 ? freeSeconds * 1e9 / report.Frees : 0.0;
+    return report;
+}
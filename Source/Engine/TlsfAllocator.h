@@ -0,0 +1,107 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+struct TlsfAllocation
+{
+    static constexpr uint32 s_InvalidHandle = ~0u;
+
+    uint64 Offset = 0;
+    uint32 Handle = s_InvalidHandle;    // Passed back to Free
+
+    bool IsValid() const { return Handle != s_InvalidHandle; }
+};
+
+struct TlsfStats
+{
+    uint64 Capacity = 0;
+    uint64 UsedBytes = 0;
+    uint64 FreeBytes = 0;
+    uint64 LargestFreeBlock = 0;
+    uint32 AllocationCount = 0;
+    uint32 FreeBlockCount = 0;
+    // 0 while the free bytes form one block, towards 1 as they scatter into blocks too small for large requests
+    float Fragmentation = 0.0f;
+};
+
+// Two-level segregated fit allocator over a range of capacity bytes, without any GPU resource so it can be fuzzed and
+// benchmarked headless. Free blocks are kept in lists per size class (power of two, split into 16 linear steps) found
+// through two bitmaps. Free takes constant time, and so does Allocate whenever a class above the one holding the size
+// has a block. Otherwise it walks the free list of the size's own class, which mixes blocks above and below the size,
+// so a nearly full or fragmented heap can make it linear in that list. Allocate splits the block it takes and Free
+// merges with free neighbours right away, so no two free blocks are ever adjacent
+class TlsfAllocator
+{
+public:
+    TlsfAllocator() = default;
+    explicit TlsfAllocator(uint64 capacity);
+
+    // size bytes at an offset aligned to alignment (a power of two), invalid when no free block fits
+    TlsfAllocation Allocate(uint64 size, uint64 alignment = 1);
+    void Free(uint32 handle);
+
+    uint64 GetAllocationSize(uint32 handle) const { return m_Blocks.at(handle).Size; }
+    uint64 GetCapacity() const { return m_Capacity; }
+    uint64 GetUsedBytes() const { return m_UsedBytes; }
+    bool IsEmpty() const { return m_AllocationCount == 0; }
+    // Walks the top size class for the largest free block, otherwise constant time
+    TlsfStats GetStats() const;
+
+private:
+    static constexpr uint32 s_SecondLevelBits = 4;
+    static constexpr uint32 s_SecondLevelCount = 1u << s_SecondLevelBits;
+    // Class 0 holds sizes below s_SecondLevelCount one by one, class f > 0 the sizes with their top bit at f + 3
+    static constexpr uint32 s_FirstLevelCount = 64 - s_SecondLevelBits + 1;
+    static constexpr uint32 s_InvalidBlock = ~0u;
+
+    struct Block
+    {
+        uint64 Offset = 0;
+        uint64 Size = 0;
+        uint32 PrevPhysical = s_InvalidBlock;
+        uint32 NextPhysical = s_InvalidBlock;
+        uint32 PrevFree = s_InvalidBlock;
+        uint32 NextFree = s_InvalidBlock;   // Next unused slot while the block is recycled
+        bool IsFree = false;
+    };
+
+    static void MapSize(uint64 size, uint32& firstLevel, uint32& secondLevel);
+    // First free block that holds size bytes at the alignment, s_InvalidBlock when none was found. Constant time
+    // unless it falls back to walking the list of the class holding size
+    uint32 FindFreeBlock(uint64 size, uint64 alignment) const;
+    bool Fits(const Block& block, uint64 size, uint64 alignment) const;
+
+    uint32 CreateBlock();
+    void RecycleBlock(uint32 index);
+    void InsertFreeBlock(uint32 index);
+    void RemoveFreeBlock(uint32 index);
+
+    uint64 m_Capacity = 0;
+    uint64 m_UsedBytes = 0;
+    uint32 m_AllocationCount = 0;
+    uint32 m_FreeBlockCount = 0;
+
+    uint64 m_FirstLevelMap = 0;
+    uint32 m_SecondLevelMaps[s_FirstLevelCount] = {};
+    uint32 m_FreeLists[s_FirstLevelCount][s_SecondLevelCount] = {};
+
+    Vector<Block> m_Blocks;
+    uint32 m_UnusedBlock = s_InvalidBlock;
+};
+
+struct TlsfBenchmarkReport
+{
+    uint64 Allocations = 0;
+    uint64 Frees = 0;
+    uint64 FailedAllocations = 0;       // No free block fit, the heap was too fragmented or too full
+    // Per call, measured around each call so they include the clock overhead of a few tens of nanoseconds
+    double MeanAllocateNanoseconds = 0.0;
+    double MaxAllocateNanoseconds = 0.0;
+    double MeanFreeNanoseconds = 0.0;
+    double MaxFreeNanoseconds = 0.0;
+    uint64 PeakUsedBytes = 0;
+    float PeakFragmentation = 0.0f;
+};
+
+// Headless benchmark: operationCount random allocations and frees keeping the heap around three quarters full.
+// Sizes are log-uniform from 256 bytes to 1 MB, a quarter of them 64 KB aligned like placed resources
+TlsfBenchmarkReport RunTlsfBenchmark(uint32 operationCount = 1000000, uint64 capacity = 256ull << 20, uint32 seed = 1);
@@ -0,0 +1,198 @@
+#include "Engine/Transform.h"
+
+#include <chrono>
+#include <random>
+
+float4 QuaternionFromEuler(const float3& pitchYawRoll) noexcept
+{
+    const float halfPitch = pitchYawRoll.x * 0.5f;
+    const float halfYaw = pitchYawRoll.y * 0.5f;
+    const float halfRoll = pitchYawRoll.z * 0.5f;
+    const float sp = Sin(halfPitch), cp = Cos(halfPitch);
+    const float sy = Sin(halfYaw), cy = Cos(halfYaw);
+    const float sr = Sin(halfRoll), cr = Cos(halfRoll);
+
+    return float4{
+        cr * sp * cy + sr * cp * sy,
+        cr * cp * sy - sr * sp * cy,
+        sr * cp * cy - cr * sp * sy,
+        cr * cp * cy + sr * sp * sy
+    };
+}
+
+float3 QuaternionToEuler(const float4& q) noexcept
+{
+    // Row 2 of Rz * Rx * Ry is (cos p sin y, -sin p, cos p cos y), rows 0 and 1 hold roll in their second column
+    const float m20 = 2.0f * (q.x * q.z + q.y * q.w);
+    const float m21 = 2.0f * (q.y * q.z - q.x * q.w);
+    const float m22 = 1.0f - 2.0f * (q.x * q.x + q.y * q.y);
+    const float cosPitch = Sqrt(m20 * m20 + m22 * m22);
+    const float pitch = Atan2(-m21, cosPitch);
+
+    if (cosPitch < 1e-6f)
+    {
+        const float m00 = 1.0f - 2.0f * (q.y * q.y + q.z * q.z);
+        const float m02 = 2.0f * (q.x * q.z - q.y * q.w);
+        return float3{ pitch, Atan2(-m02, m00), 0.0f };
+    }
+
+    const float m01 = 2.0f * (q.x * q.y + q.z * q.w);
+    const float m11 = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+    return float3{ pitch, Atan2(m20, m22), Atan2(m01, m11) };
+}
+
+float4 QuaternionFromAxisAngle(const float3& axis, float angle) noexcept
+{
+    const float3 n = Normalize(axis);
+    const float s = Sin(angle * 0.5f);
+    return float4{ n.x * s, n.y * s, n.z * s, Cos(angle * 0.5f) };
+}
+
+float4 QuaternionMultiply(const float4& a, const float4& b) noexcept
+{
+    // Hamilton product b * a, so that a is applied first like XMQuaternionMultiply(a, b)
+    return float4{
+        b.w * a.x + b.x * a.w + b.y * a.z - b.z * a.y,
+        b.w * a.y - b.x * a.z + b.y * a.w + b.z * a.x,
+        b.w * a.z + b.x * a.y - b.y * a.x + b.z * a.w,
+        b.w * a.w - b.x * a.x - b.y * a.y - b.z * a.z
+    };
+}
+
+float3 QuaternionRotate(const float4& q, const float3& v) noexcept
+{
+    // v + 2w (u x v) + 2 u x (u x v), u = q.xyz
+    const float3 u{ q.x, q.y, q.z };
+    const float3 t = 2.0f * Cross(u, v);
+    return v + q.w * t + Cross(u, t);
+}
+
+float3x3 QuaternionToMatrix(const float4& q) noexcept
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return float3x3{
+        1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy),
+        2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx),
+        2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy)
+    };
+}
+
+float3x4 ComposeAffine(const Transform& transform) noexcept
+{
+    // World rows are Scale[i] * R[i] plus the translation row; stored transposed, so R[i] becomes column i
+    const float3x3 r = QuaternionToMatrix(transform.Rotation);
+    const float3& s = transform.Scale;
+    const float3& t = transform.Translation;
+
+    return float3x4{
+        s.x * r._11, s.y * r._21, s.z * r._31, t.x,
+        s.x * r._12, s.y * r._22, s.z * r._32, t.y,
+        s.x * r._13, s.y * r._23, s.z * r._33, t.z
+    };
+}
+
+float3x3 ComputeNormalMatrix(const Transform& transform) noexcept
+{
+    // (S * R)^-1 = R^T * S^-1: entry (i, j) is R(j, i) / Scale[j]
+    const float3x3 r = QuaternionToMatrix(transform.Rotation);
+    const float3 invScale = 1.0f / transform.Scale;
+
+    return float3x3{
+        r._11 * invScale.x, r._21 * invScale.y, r._31 * invScale.z,
+        r._12 * invScale.x, r._22 * invScale.y, r._32 * invScale.z,
+        r._13 * invScale.x, r._23 * invScale.y, r._33 * invScale.z
+    };
+}
+
+void ComposeTransform(const Transform& transform, float4x4& transposedWorld, float4x4& normalMatrix) noexcept
+{
+    const float3x3 r = QuaternionToMatrix(transform.Rotation);
+    const float3& s = transform.Scale;
+    const float3& t = transform.Translation;
+    const float3 invScale = 1.0f / s;
+
+    transposedWorld = float4x4{
+        s.x * r._11, s.y * r._21, s.z * r._31, t.x,
+        s.x * r._12, s.y * r._22, s.z * r._32, t.y,
+        s.x * r._13, s.y * r._23, s.z * r._33, t.z,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+
+    normalMatrix = float4x4{
+        r._11 * invScale.x, r._21 * invScale.y, r._31 * invScale.z, 0.0f,
+        r._12 * invScale.x, r._22 * invScale.y, r._32 * invScale.z, 0.0f,
+        r._13 * invScale.x, r._23 * invScale.y, r._33 * invScale.z, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+    };
+}
+
+void ComposeTransforms(Span<const Transform> transforms, Span<float4x4> transposedWorlds, Span<float4x4> normalMatrices)
+{
+    if (transforms.size() != transposedWorlds.size() || transforms.size() != normalMatrices.size())
+        throw std::invalid_argument("ComposeTransforms: spans differ in length");
+
+    for (size_t i = 0; i < transforms.size(); ++i)
+    {
+        ComposeTransform(transforms[i], transposedWorlds[i], normalMatrices[i]);
+    }
+}
+
+TransformBenchmarkReport RunTransformBenchmark(uint32 transformCount, uint32 iterations)
+{
+    TransformBenchmarkReport report;
+    report.TransformCount = transformCount;
+    if (transformCount == 0 || iterations == 0)
+        return report;
+
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> angle(-PI, PI);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+
+    Vector<float3> eulers(transformCount);
+    Vector<Transform> transforms(transformCount);
+    for (uint32 i = 0; i < transformCount; ++i)
+    {
+        eulers[i] = float3{ angle(random), angle(random), angle(random) };
+        transforms[i].Translation = float3{ position(random), position(random), position(random) };
+        transforms[i].Rotation = QuaternionFromEuler(eulers[i]);
+        transforms[i].Scale = float3{ scale(random), scale(random), scale(random) };
+    }
+    Vector<float4x4> worlds(transformCount);
+    Vector<float4x4> normals(transformCount);
+
+    auto measure = [&](auto&& pass)
+    {
+        pass();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            pass();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? double(transformCount) * iterations / seconds : 0.0;
+    };
+
+    report.MatrixTransformsPerSecond = measure([&]
+    {
+        for (uint32 i = 0; i < transformCount; ++i)
+        {
+            const Transform& transform = transforms[i];
+            const XMMATRIX world = XMMatrixScaling(transform.Scale.x, transform.Scale.y, transform.Scale.z)
+                * XMMatrixRotationRollPitchYaw(eulers[i].x, eulers[i].y, eulers[i].z)
+                * XMMatrixTranslation(transform.Translation.x, transform.Translation.y, transform.Translation.z);
+            XMStoreFloat4x4(&worlds[i], XMMatrixTranspose(world));
+
+            XMMATRIX upperLeft = world;
+            upperLeft.r[3] = XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f);
+            XMStoreFloat4x4(&normals[i], XMMatrixInverse(nullptr, upperLeft));
+        }
+    });
+    report.ComposedTransformsPerSecond = measure([&] { ComposeTransforms(transforms, worlds, normals); });
+
+    report.Speedup = report.MatrixTransformsPerSecond > 0.0 ? report.ComposedTransformsPerSecond / report.MatrixTransformsPerSecond : 0.0;
+    return report;
+}
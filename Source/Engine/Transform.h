@@ -0,0 +1,64 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+// Quaternions are stored as float4 (x, y, z, w) with w the scalar part.
+// Rotations follow the DirectXMath conventions: row vectors, left-handed, v' = v * M.
+
+constexpr float4 QuaternionIdentity() noexcept
+{
+    return float4{ 0.0f, 0.0f, 0.0f, 1.0f };
+}
+
+// Same rotation as XMMatrixRotationRollPitchYaw(euler.x, euler.y, euler.z): roll about Z, then pitch about X, then yaw about Y
+float4 QuaternionFromEuler(const float3& pitchYawRoll) noexcept;
+
+// Inverse of QuaternionFromEuler, pitch in [-pi/2, pi/2]. Roll is 0 at the gimbal poles
+float3 QuaternionToEuler(const float4& q) noexcept;
+
+float4 QuaternionFromAxisAngle(const float3& axis, float angle) noexcept;
+
+// Rotation by a followed by b
+float4 QuaternionMultiply(const float4& a, const float4& b) noexcept;
+
+float3 QuaternionRotate(const float4& q, const float3& v) noexcept;
+
+inline float4 QuaternionNormalize(const float4& q) noexcept
+{
+    return Normalize(q);
+}
+
+// Row-vector rotation matrix of a unit quaternion
+float3x3 QuaternionToMatrix(const float4& q) noexcept;
+
+// Scale, then rotate, then translate
+struct Transform
+{
+    float3 Translation = { 0.0f, 0.0f, 0.0f };
+    float4 Rotation = QuaternionIdentity();
+    float3 Scale = { 1.0f, 1.0f, 1.0f };
+};
+
+// Transposed world matrix (column vectors, as uploaded to the shaders) in 3x4 form: the affine last row is implicit
+float3x4 ComposeAffine(const Transform& transform) noexcept;
+
+// Inverse transpose of the upper 3x3 for transforming normals, built from the rotation and reciprocal scale.
+// Row-major like XMMatrixInverse of the world matrix, i.e. ready for mul(float4(n, 0), Normal) in HLSL
+float3x3 ComputeNormalMatrix(const Transform& transform) noexcept;
+
+// Writes both matrices in the 4x4 layout of the ObjectData constant buffer
+void ComposeTransform(const Transform& transform, float4x4& transposedWorld, float4x4& normalMatrix) noexcept;
+
+// Batch version, all spans must have the same length
+void ComposeTransforms(Span<const Transform> transforms, Span<float4x4> transposedWorlds, Span<float4x4> normalMatrices);
+
+struct TransformBenchmarkReport
+{
+    uint32 TransformCount = 0;
+    double MatrixTransformsPerSecond = 0.0;     // Euler SRT XMMATRIX product and XMMatrixInverse, the former Object path
+    double ComposedTransformsPerSecond = 0.0;   // ComposeTransforms over the same transforms
+    double Speedup = 0.0;                       // Composed over matrix
+};
+
+// Headless benchmark: iterations passes of world and normal matrices for transformCount random transforms, both paths
+// writing the 4x4 layout of ObjectData
+TransformBenchmarkReport RunTransformBenchmark(uint32 transformCount = 10000, uint32 iterations = 200);
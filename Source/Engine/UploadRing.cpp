@@ -0,0 +1,102 @@
+#include "UploadRing.h"
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+UploadRing::UploadRing(uint64 capacity)
+    : m_Capacity(capacity)
+{
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("Upload ring capacity must be positive");
+    }
+}
+
+uint64 UploadRing::Allocate(uint64 size, uint64 alignment)
+{
+    // A default-constructed ring has no capacity to take offsets modulo
+    if (m_Capacity == 0 || size == 0 || size > m_Capacity)
+        return s_InvalidOffset;
+
+    // Skip to the aligned offset, or to the start of the next lap when the allocation would straddle the end
+    const uint64 offset = m_Head % m_Capacity;
+    const uint64 alignedOffset = AlignUp(offset, alignment);
+    const uint64 start = alignedOffset + size > m_Capacity ? m_Head + (m_Capacity - offset) : m_Head + (alignedOffset - offset);
+    if (start + size - m_Tail > m_Capacity)
+        return s_InvalidOffset;
+
+    m_Head = start + size;
+    return start % m_Capacity;
+}
+
+void UploadRing::FinishFrame(uint64 fenceValue)
+{
+    if (!m_Frames.empty() && fenceValue < m_Frames.back().FenceValue)
+    {
+        throw std::invalid_argument("Upload ring fence values must not decrease");
+    }
+    m_Frames.push_back(FrameMark{ fenceValue, m_Head });
+}
+
+void UploadRing::Reclaim(uint64 completedFenceValue)
+{
+    size_t completed = 0;
+    while (completed < m_Frames.size() && m_Frames[completed].FenceValue <= completedFenceValue)
+    {
+        m_Tail = m_Frames[completed].End;
+        ++completed;
+    }
+    m_Frames.erase(m_Frames.begin(), m_Frames.begin() + completed);
+}
+
+UploadRingBenchmarkReport RunUploadRingBenchmark(uint32 frameCount, uint32 allocationsPerFrame, uint32 framesInFlight, uint64 capacity)
+{
+    // The size of the per-object constants: two matrices, the UV transform, material index and padding
+    static constexpr uint64 s_SliceSize = 160;
+    static constexpr uint64 s_SliceAlignment = 256;
+
+    UploadRingBenchmarkReport report;
+    Vector<uint8> memory(capacity);
+    const uint8 constants[s_SliceSize] = {};
+
+    auto run = [&](bool copy)
+    {
+        UploadRing ring(capacity);
+        uint64 fenceValue = 0;
+        uint64 completedFenceValue = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 frame = 0; frame < frameCount; ++frame)
+        {
+            ring.Reclaim(completedFenceValue);
+            for (uint32 i = 0; i < allocationsPerFrame; ++i)
+            {
+                uint64 offset = ring.Allocate(s_SliceSize, s_SliceAlignment);
+                if (offset == UploadRing::s_InvalidOffset)
+                {
+                    // Wait for the fake GPU to finish everything submitted so far
+                    report.Stalls++;
+                    completedFenceValue = fenceValue;
+                    ring.Reclaim(completedFenceValue);
+                    offset = ring.Allocate(s_SliceSize, s_SliceAlignment);
+                    if (offset == UploadRing::s_InvalidOffset)
+                    {
+                        throw std::runtime_error("Upload ring benchmark frame does not fit in the ring");
+                    }
+                }
+                if (copy)
+                    memcpy(memory.data() + offset, constants, s_SliceSize);
+            }
+            report.PeakUsedBytes = std::max(report.PeakUsedBytes, ring.GetUsedBytes());
+            ring.FinishFrame(++fenceValue);
+            completedFenceValue = std::max(completedFenceValue, fenceValue > framesInFlight ? fenceValue - framesInFlight : 0);
+        }
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    report.Allocations = uint64(frameCount) * allocationsPerFrame;
+    report.AllocationsPerSecond = report.Allocations / run(false);
+    report.Stalls = 0;
+    report.UploadGigabytesPerSecond = report.Allocations * s_SliceSize / run(true) * 1e-9;
+    return report;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+
+// Offset bookkeeping of a linear upload ring, without any GPU resource so it can run against a fake fence.
+// Allocations bump a head through the ring and never straddle its end. FinishFrame closes the allocations made since
+// the previous call under the fence value signaled after them, and Reclaim frees every closed frame whose fence value
+// completed. Fence values must not decrease from one frame to the next
+class UploadRing
+{
+public:
+    static constexpr uint64 s_InvalidOffset = ~0ull;
+
+    UploadRing() = default;
+    // capacity must be a multiple of the largest alignment requested
+    explicit UploadRing(uint64 capacity);
+
+    // Offset of size bytes aligned to alignment (a power of two), s_InvalidOffset when the ring has no room left, for
+    // zero bytes and for a default-constructed ring
+    uint64 Allocate(uint64 size, uint64 alignment);
+
+    void FinishFrame(uint64 fenceValue);
+    void Reclaim(uint64 completedFenceValue);
+
+    uint64 GetCapacity() const { return m_Capacity; }
+    // Bytes in flight, including the padding skipped at alignments and at the end of the ring
+    uint64 GetUsedBytes() const { return m_Head - m_Tail; }
+    size_t GetPendingFrameCount() const { return m_Frames.size(); }
+
+private:
+    struct FrameMark
+    {
+        uint64 FenceValue = 0;
+        uint64 End = 0;         // Head when the frame was finished
+    };
+
+    // Head and tail count bytes since the start, offsets into the ring are modulo the capacity
+    uint64 m_Capacity = 0;
+    uint64 m_Head = 0;
+    uint64 m_Tail = 0;
+    Vector<FrameMark> m_Frames;
+};
+
+struct UploadRingBenchmarkReport
+{
+    uint64 Allocations = 0;
+    double AllocationsPerSecond = 0.0;      // Allocate alone
+    double UploadGigabytesPerSecond = 0.0;  // Allocate plus a copy of the constants into the ring memory
+    uint32 Stalls = 0;                      // Allocations that had to wait for the fake GPU to free a frame
+    uint64 PeakUsedBytes = 0;
+};
+
+// Headless benchmark: frameCount frames of allocationsPerFrame 160-byte constant slices (256-byte aligned)
+// against a fake fence the GPU completes framesInFlight frames late
+UploadRingBenchmarkReport RunUploadRingBenchmark(uint32 frameCount = 1000, uint32 allocationsPerFrame = 10000, uint32 framesInFlight = 2,
+    uint64 capacity = 16ull << 20);
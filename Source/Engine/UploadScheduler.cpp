@@ -0,0 +1,102 @@
+#include "UploadScheduler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+UploadScheduler::UploadScheduler(uint64 stagingCapacity, uint64 frameBudget)
+    : m_Staging(stagingCapacity), m_FrameBudget(frameBudget)
+{
+    if (frameBudget == 0)
+    {
+        throw std::invalid_argument("Upload frame budget must be positive");
+    }
+    if (stagingCapacity % s_StagingAlignment != 0 || stagingCapacity < 2 * s_StagingAlignment)
+    {
+        throw std::invalid_argument("Staging capacity must be a multiple of 16 bytes and hold two chunks");
+    }
+    m_MaxChunk = stagingCapacity / 2;
+}
+
+uint64 UploadScheduler::Enqueue(const UploadDestination& destination, uint64 destinationOffset, const void* data, uint64 size)
+{
+    Request& request = m_Pending.emplace_back();
+    request.Destination = destination;
+    request.DestinationOffset = destinationOffset;
+    request.Data.assign(static_cast<const uint8*>(data), static_cast<const uint8*>(data) + size);
+    request.Ticket = m_NextTicket++;
+    m_PendingBytes += size;
+    return request.Ticket;
+}
+
+UploadFlushStats UploadScheduler::Flush(uint8* stagingMemory, UploadCommandRecorder& recorder)
+{
+    UploadFlushStats stats;
+    uint64 budget = m_FrameBudget;
+    while (!m_Pending.empty())
+    {
+        Request& request = m_Pending.front();
+        const uint64 remaining = request.Data.size() - request.Copied;
+        if (remaining > 0)
+        {
+            if (budget == 0)
+                break;
+
+            const uint64 chunk = std::min({ remaining, budget, m_MaxChunk });
+            const uint64 stagingOffset = m_Staging.Allocate(chunk, s_StagingAlignment);
+            if (stagingOffset == UploadRing::s_InvalidOffset)
+            {
+                stats.StagingFull = true;
+                break;
+            }
+
+            memcpy(stagingMemory + stagingOffset, request.Data.data() + request.Copied, chunk);
+            recorder.CopyBuffer(request.Destination, request.DestinationOffset + request.Copied, stagingOffset, chunk);
+            request.Copied += chunk;
+            budget -= chunk;
+            m_PendingBytes -= chunk;
+            stats.Copies++;
+            stats.Bytes += chunk;
+            if (request.Copied < request.Data.size())
+                continue;
+        }
+
+        recorder.FinishRequest(request.Destination);
+        m_RecordedTicket = request.Ticket;
+        stats.FinishedRequests++;
+        m_Pending.pop_front();
+    }
+    stats.PendingBytes = m_PendingBytes;
+    return stats;
+}
+
+Vector<UploadDestination> UploadScheduler::CancelAll()
+{
+    Vector<UploadDestination> destinations;
+    destinations.reserve(m_Pending.size());
+    for (const Request& request : m_Pending)
+    {
+        destinations.push_back(request.Destination);
+    }
+    m_Pending.clear();
+    m_PendingBytes = 0;
+    return destinations;
+}
+
+Vector<UploadDestination> UploadScheduler::Cancel(const void* resource, uint64 offset, uint64 size)
+{
+    Vector<UploadDestination> destinations;
+    std::erase_if(m_Pending, [&](const Request& request)
+    {
+        if (request.Destination.Resource != resource || request.DestinationOffset < offset
+            || request.DestinationOffset + request.Data.size() > offset + size)
+        {
+            return false;
+        }
+
+        destinations.push_back(request.Destination);
+        m_PendingBytes -= request.Data.size() - request.Copied;
+        return true;
+    });
+    return destinations;
+}
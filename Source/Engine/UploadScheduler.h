@@ -0,0 +1,84 @@
+#pragma once
+#include <deque>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/UploadRing.h"
+
+// Opaque to the scheduler, handed back to the recorder. Resource is e.g. the ID3D12Resource to copy into
+struct UploadDestination
+{
+    void* Resource = nullptr;
+    uint32 FinalState = 0;      // State to leave the resource in after copying into it, for the recorder
+};
+
+// Receives the copies of a flush. Implemented over a command list by Graphics/StagingUploader.h, tests can record
+class UploadCommandRecorder
+{
+public:
+    virtual ~UploadCommandRecorder() = default;
+
+    virtual void CopyBuffer(const UploadDestination& destination, uint64 destinationOffset, uint64 stagingOffset, uint64 size) = 0;
+    // Every byte of the request was copied by this or an earlier flush
+    virtual void FinishRequest(const UploadDestination& destination) = 0;
+};
+
+struct UploadFlushStats
+{
+    uint32 Copies = 0;
+    uint32 FinishedRequests = 0;
+    uint64 Bytes = 0;
+    uint64 PendingBytes = 0;        // Left for later flushes
+    bool StagingFull = false;       // Stopped before the budget since the frames in flight fill the staging ring
+};
+
+// Schedules buffer uploads through a staging ring with a byte budget per frame. Requests are copied on Enqueue and
+// staged first in, first out, a request larger than the budget is split over several frames. Typical frame: Reclaim,
+// Flush into the frame's copy command list, FinishFrame with the fence value signaled after it
+class UploadScheduler
+{
+public:
+    UploadScheduler() = default;
+    // Copies are at most stagingCapacity / 2 so a wrap never blocks a chunk forever
+    UploadScheduler(uint64 stagingCapacity, uint64 frameBudget);
+
+    // Returns the request's ticket, recorded once GetRecordedTicket() reaches it
+    uint64 Enqueue(const UploadDestination& destination, uint64 destinationOffset, const void* data, uint64 size);
+
+    // Stages pending data into stagingMemory (the memory the staging ring offsets refer to) and records its copies
+    UploadFlushStats Flush(uint8* stagingMemory, UploadCommandRecorder& recorder);
+
+    // Drops every pending request without recording it, returning their destinations in queue order. Copies recorded
+    // by earlier flushes are not undone
+    Vector<UploadDestination> CancelAll();
+    // Same for the requests into [offset, offset + size) of resource, e.g. a buffer freed before its upload finished
+    Vector<UploadDestination> Cancel(const void* resource, uint64 offset, uint64 size);
+
+    void FinishFrame(uint64 fenceValue) { m_Staging.FinishFrame(fenceValue); }
+    void Reclaim(uint64 completedFenceValue) { m_Staging.Reclaim(completedFenceValue); }
+
+    // Requests up to this ticket have all their copies recorded
+    uint64 GetRecordedTicket() const { return m_RecordedTicket; }
+    bool IsIdle() const { return m_Pending.empty(); }
+    uint64 GetPendingBytes() const { return m_PendingBytes; }
+    uint64 GetFrameBudget() const { return m_FrameBudget; }
+
+private:
+    static constexpr uint64 s_StagingAlignment = 16;
+
+    struct Request
+    {
+        UploadDestination Destination;
+        uint64 DestinationOffset = 0;
+        Vector<uint8> Data;
+        uint64 Copied = 0;
+        uint64 Ticket = 0;
+    };
+
+    UploadRing m_Staging;
+    uint64 m_FrameBudget = 0;
+    uint64 m_MaxChunk = 0;
+    std::deque<Request> m_Pending;
+    uint64 m_PendingBytes = 0;
+    uint64 m_NextTicket = 1;
+    uint64 m_RecordedTicket = 0;
+};
@@ -0,0 +1,441 @@
+#include "Engine/VectorStreams.h"
+#include "Engine/SimdLanes.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    void CheckSize(size_t expected, size_t actual)
+    {
+        if (expected != actual)
+            throw std::invalid_argument("Vector stream components differ in length");
+    }
+
+    void CheckStream(const ConstFloat3SoA& v, size_t size)
+    {
+        CheckSize(size, v.X.size());
+        CheckSize(size, v.Y.size());
+        CheckSize(size, v.Z.size());
+    }
+
+    void CheckStream(const ConstFloat4SoA& v, size_t size)
+    {
+        CheckSize(size, v.X.size());
+        CheckSize(size, v.Y.size());
+        CheckSize(size, v.Z.size());
+        CheckSize(size, v.W.size());
+    }
+
+    // Component pointers so the 3 and 4 wide kernels share one body
+    template<size_t N>
+    struct Components
+    {
+        float* C[N];
+    };
+
+    template<size_t N>
+    struct ConstComponents
+    {
+        const float* C[N];
+    };
+
+    Components<3> GetComponents(const Float3SoA& v) { return { v.X.data(), v.Y.data(), v.Z.data() }; }
+    Components<4> GetComponents(const Float4SoA& v) { return { v.X.data(), v.Y.data(), v.Z.data(), v.W.data() }; }
+    ConstComponents<3> GetComponents(const ConstFloat3SoA& v) { return { v.X.data(), v.Y.data(), v.Z.data() }; }
+    ConstComponents<4> GetComponents(const ConstFloat4SoA& v) { return { v.X.data(), v.Y.data(), v.Z.data(), v.W.data() }; }
+
+    // ---------- Kernels ------------
+    template<class L>
+    struct TransformKernel
+    {
+        // w is the homogeneous coordinate of the input (1 for points, 0 for directions)
+        template<size_t N>
+        static void Run(const float4x4& m, float w, const ConstComponents<3>& in, const Components<N>& out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                const auto x = B::Load(in.C[0] + i);
+                const auto y = B::Load(in.C[1] + i);
+                const auto z = B::Load(in.C[2] + i);
+                for (size_t col = 0; col < N; ++col)
+                {
+                    auto r = B::Set1(m(3, col) * w);
+                    r = B::MulAdd(x, B::Set1(m(0, col)), r);
+                    r = B::MulAdd(y, B::Set1(m(1, col)), r);
+                    r = B::MulAdd(z, B::Set1(m(2, col)), r);
+                    B::Store(out.C[col] + i, r);
+                }
+            });
+        }
+    };
+
+    template<class L>
+    struct NormalizeKernel
+    {
+        template<size_t N>
+        static void Run(const ConstComponents<N>& in, const Components<N>& out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                typename B::Reg v[N];
+                auto lengthSq = B::Set1(0.0f);
+                for (size_t c = 0; c < N; ++c)
+                {
+                    v[c] = B::Load(in.C[c] + i);
+                    lengthSq = B::MulAdd(v[c], v[c], lengthSq);
+                }
+
+                const auto nonZero = B::CmpGt(lengthSq, B::Set1(0.0f));
+                const auto invLength = B::Div(B::Set1(1.0f), B::Sqrt(lengthSq));
+                for (size_t c = 0; c < N; ++c)
+                {
+                    B::Store(out.C[c] + i, B::Select(nonZero, B::Mul(v[c], invLength), v[c]));
+                }
+            });
+        }
+    };
+
+    template<class L>
+    struct DotKernel
+    {
+        template<size_t N>
+        static void Run(const ConstComponents<N>& a, const ConstComponents<N>& b, float* out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                auto dot = B::Mul(B::Load(a.C[0] + i), B::Load(b.C[0] + i));
+                for (size_t c = 1; c < N; ++c)
+                {
+                    dot = B::MulAdd(B::Load(a.C[c] + i), B::Load(b.C[c] + i), dot);
+                }
+                B::Store(out + i, dot);
+            });
+        }
+    };
+
+    template<class L>
+    struct CrossKernel
+    {
+        static void Run(const ConstComponents<3>& a, const ConstComponents<3>& b, const Components<3>& out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                const auto ax = B::Load(a.C[0] + i), ay = B::Load(a.C[1] + i), az = B::Load(a.C[2] + i);
+                const auto bx = B::Load(b.C[0] + i), by = B::Load(b.C[1] + i), bz = B::Load(b.C[2] + i);
+                B::Store(out.C[0] + i, B::Sub(B::Mul(ay, bz), B::Mul(az, by)));
+                B::Store(out.C[1] + i, B::Sub(B::Mul(az, bx), B::Mul(ax, bz)));
+                B::Store(out.C[2] + i, B::Sub(B::Mul(ax, by), B::Mul(ay, bx)));
+            });
+        }
+    };
+
+    template<class L>
+    struct LerpKernel
+    {
+        template<size_t N>
+        static void Run(const ConstComponents<N>& a, const ConstComponents<N>& b, float t, const Components<N>& out, size_t count)
+        {
+            ForEachBlock<L>(count, [&]<class B>(size_t i)
+            {
+                const auto tv = B::Set1(t);
+                for (size_t c = 0; c < N; ++c)
+                {
+                    const auto av = B::Load(a.C[c] + i);
+                    B::Store(out.C[c] + i, B::MulAdd(B::Sub(B::Load(b.C[c] + i), av), tv, av));
+                }
+            });
+        }
+    };
+}
+
+void TransformPoints(const float4x4& m, ConstFloat3SoA in, Float3SoA out)
+{
+    CheckStream(in, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<TransformKernel>(m, 1.0f, GetComponents(in), GetComponents(out), out.Size());
+}
+
+void TransformPoints(const float4x4& m, ConstFloat3SoA in, Float4SoA out)
+{
+    CheckStream(in, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<TransformKernel>(m, 1.0f, GetComponents(in), GetComponents(out), out.Size());
+}
+
+void TransformNormals(const float4x4& m, ConstFloat3SoA in, Float3SoA out)
+{
+    CheckStream(in, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<TransformKernel>(m, 0.0f, GetComponents(in), GetComponents(out), out.Size());
+}
+
+void NormalizeN(ConstFloat3SoA in, Float3SoA out)
+{
+    CheckStream(in, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<NormalizeKernel>(GetComponents(in), GetComponents(out), out.Size());
+}
+
+void NormalizeN(ConstFloat4SoA in, Float4SoA out)
+{
+    CheckStream(in, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<NormalizeKernel>(GetComponents(in), GetComponents(out), out.Size());
+}
+
+void DotN(ConstFloat3SoA a, ConstFloat3SoA b, Span<float> out)
+{
+    CheckStream(a, out.size());
+    CheckStream(b, out.size());
+    DispatchSimd<DotKernel>(GetComponents(a), GetComponents(b), out.data(), out.size());
+}
+
+void DotN(ConstFloat4SoA a, ConstFloat4SoA b, Span<float> out)
+{
+    CheckStream(a, out.size());
+    CheckStream(b, out.size());
+    DispatchSimd<DotKernel>(GetComponents(a), GetComponents(b), out.data(), out.size());
+}
+
+void CrossN(ConstFloat3SoA a, ConstFloat3SoA b, Float3SoA out)
+{
+    CheckStream(a, out.Size());
+    CheckStream(b, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<CrossKernel>(GetComponents(a), GetComponents(b), GetComponents(out), out.Size());
+}
+
+void LerpN(ConstFloat3SoA a, ConstFloat3SoA b, float t, Float3SoA out)
+{
+    CheckStream(a, out.Size());
+    CheckStream(b, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<LerpKernel>(GetComponents(a), GetComponents(b), t, GetComponents(out), out.Size());
+}
+
+void LerpN(ConstFloat4SoA a, ConstFloat4SoA b, float t, Float4SoA out)
+{
+    CheckStream(a, out.Size());
+    CheckStream(b, out.Size());
+    CheckStream(out, out.Size());
+    DispatchSimd<LerpKernel>(GetComponents(a), GetComponents(b), t, GetComponents(out), out.Size());
+}
+
+void Deinterleave(Span<const float3> in, Float3SoA out)
+{
+    CheckStream(out, in.size());
+
+    size_t i = 0;
+    if (GetSimdLevel() != SimdLevel::Scalar)
+    {
+        // Four float3 are three registers: a = [x0 y0 z0 x1], b = [y1 z1 x2 y2], c = [z2 x3 y3 z3]
+        for (; i + 4 <= in.size(); i += 4)
+        {
+            const float* src = &in[i].x;
+            const __m128 a = _mm_loadu_ps(src);
+            const __m128 b = _mm_loadu_ps(src + 4);
+            const __m128 c = _mm_loadu_ps(src + 8);
+
+            const __m128 xTail = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+            const __m128 x = _mm_shuffle_ps(a, xTail, _MM_SHUFFLE(2, 0, 3, 0));
+
+            const __m128 yHead = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+            const __m128 yTail = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+            const __m128 y = _mm_shuffle_ps(yHead, yTail, _MM_SHUFFLE(2, 0, 2, 0));
+
+            const __m128 zHead = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+            const __m128 zTail = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+            const __m128 z = _mm_shuffle_ps(zHead, zTail, _MM_SHUFFLE(2, 0, 2, 0));
+
+            _mm_storeu_ps(&out.X[i], x);
+            _mm_storeu_ps(&out.Y[i], y);
+            _mm_storeu_ps(&out.Z[i], z);
+        }
+    }
+
+    for (; i < in.size(); ++i)
+    {
+        out.X[i] = in[i].x;
+        out.Y[i] = in[i].y;
+        out.Z[i] = in[i].z;
+    }
+}
+
+void Deinterleave(Span<const float4> in, Float4SoA out)
+{
+    CheckStream(out, in.size());
+
+    size_t i = 0;
+    if (GetSimdLevel() != SimdLevel::Scalar)
+    {
+        for (; i + 4 <= in.size(); i += 4)
+        {
+            __m128 r0 = _mm_loadu_ps(&in[i + 0].x);
+            __m128 r1 = _mm_loadu_ps(&in[i + 1].x);
+            __m128 r2 = _mm_loadu_ps(&in[i + 2].x);
+            __m128 r3 = _mm_loadu_ps(&in[i + 3].x);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(&out.X[i], r0);
+            _mm_storeu_ps(&out.Y[i], r1);
+            _mm_storeu_ps(&out.Z[i], r2);
+            _mm_storeu_ps(&out.W[i], r3);
+        }
+    }
+
+    for (; i < in.size(); ++i)
+    {
+        out.X[i] = in[i].x;
+        out.Y[i] = in[i].y;
+        out.Z[i] = in[i].z;
+        out.W[i] = in[i].w;
+    }
+}
+
+void Interleave(ConstFloat3SoA in, Span<float3> out)
+{
+    CheckStream(in, out.size());
+
+    size_t i = 0;
+    if (GetSimdLevel() != SimdLevel::Scalar)
+    {
+        for (; i + 4 <= out.size(); i += 4)
+        {
+            const __m128 x = _mm_loadu_ps(&in.X[i]);
+            const __m128 y = _mm_loadu_ps(&in.Y[i]);
+            const __m128 z = _mm_loadu_ps(&in.Z[i]);
+
+            const __m128 xy0 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0));
+            const __m128 zx0 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+            const __m128 a = _mm_shuffle_ps(xy0, zx0, _MM_SHUFFLE(2, 0, 2, 0));
+
+            const __m128 yz1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+            const __m128 xy2 = _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2));
+            const __m128 b = _mm_shuffle_ps(yz1, xy2, _MM_SHUFFLE(2, 0, 2, 0));
+
+            const __m128 zx2 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2));
+            const __m128 yz3 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3));
+            const __m128 c = _mm_shuffle_ps(zx2, yz3, _MM_SHUFFLE(2, 0, 2, 0));
+
+            float* dst = &out[i].x;
+            _mm_storeu_ps(dst, a);
+            _mm_storeu_ps(dst + 4, b);
+            _mm_storeu_ps(dst + 8, c);
+        }
+    }
+
+    for (; i < out.size(); ++i)
+    {
+        out[i] = float3{ in.X[i], in.Y[i], in.Z[i] };
+    }
+}
+
+void Interleave(ConstFloat4SoA in, Span<float4> out)
+{
+    CheckStream(in, out.size());
+
+    size_t i = 0;
+    if (GetSimdLevel() != SimdLevel::Scalar)
+    {
+        for (; i + 4 <= out.size(); i += 4)
+        {
+            __m128 r0 = _mm_loadu_ps(&in.X[i]);
+            __m128 r1 = _mm_loadu_ps(&in.Y[i]);
+            __m128 r2 = _mm_loadu_ps(&in.Z[i]);
+            __m128 r3 = _mm_loadu_ps(&in.W[i]);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(&out[i + 0].x, r0);
+            _mm_storeu_ps(&out[i + 1].x, r1);
+            _mm_storeu_ps(&out[i + 2].x, r2);
+            _mm_storeu_ps(&out[i + 3].x, r3);
+        }
+    }
+
+    for (; i < out.size(); ++i)
+    {
+        out[i] = float4{ in.X[i], in.Y[i], in.Z[i], in.W[i] };
+    }
+}
+
+void DeinterleaveStrided(const float3* first, size_t strideBytes, Float3SoA out)
+{
+    CheckStream(out, out.Size());
+
+    const uint8* src = reinterpret_cast<const uint8*>(first);
+    for (size_t i = 0; i < out.Size(); ++i, src += strideBytes)
+    {
+        const float3& v = *reinterpret_cast<const float3*>(src);
+        out.X[i] = v.x;
+        out.Y[i] = v.y;
+        out.Z[i] = v.z;
+    }
+}
+
+void InterleaveStrided(ConstFloat3SoA in, float3* first, size_t strideBytes)
+{
+    CheckStream(in, in.Size());
+
+    uint8* dst = reinterpret_cast<uint8*>(first);
+    for (size_t i = 0; i < in.Size(); ++i, dst += strideBytes)
+    {
+        *reinterpret_cast<float3*>(dst) = float3{ in.X[i], in.Y[i], in.Z[i] };
+    }
+}
+
+VectorStreamsBenchmarkReport RunVectorStreamsBenchmark(uint32 pointCount, uint32 iterations)
+{
+    VectorStreamsBenchmarkReport report;
+    report.PointCount = pointCount;
+    report.Level = GetSimdLevel();
+    if (pointCount == 0 || iterations == 0)
+        return report;
+
+    Float3Stream in(pointCount);
+    Float3Stream out(pointCount);
+    const Float3SoA inView = in.View();
+    for (uint32 i = 0; i < pointCount; ++i)
+    {
+        inView.X[i] = float(i % 101) * 0.1f;
+        inView.Y[i] = float(i % 89) * -0.2f;
+        inView.Z[i] = float(i % 53) * 0.3f;
+    }
+    const float4x4 world(0.0f, 0.0f, -1.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 5.0f, -3.0f, 7.0f, 1.0f);
+    const double bytes = double(pointCount) * 2 * sizeof(float3) * iterations;
+
+    auto time = [&](auto&& pass)
+    {
+        pass();
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < iterations; ++i)
+        {
+            pass();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? bytes / seconds : 0.0;
+    };
+
+    report.CopyBytesPerSecond = time([&]
+    {
+        const ConstFloat3SoA src = in.View();
+        const Float3SoA dst = out.View();
+        memcpy(dst.X.data(), src.X.data(), pointCount * sizeof(float));
+        memcpy(dst.Y.data(), src.Y.data(), pointCount * sizeof(float));
+        memcpy(dst.Z.data(), src.Z.data(), pointCount * sizeof(float));
+    });
+
+    auto run = [&](SimdLevel level)
+    {
+        SetMaxSimdLevel(level);
+        return time([&] { TransformPoints(world, in.View(), out.View()); });
+    };
+
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    report.ScalarBytesPerSecond = run(SimdLevel::Scalar);
+    report.SseBytesPerSecond = run(SimdLevel::Sse);
+    if (report.Level >= SimdLevel::Avx2)
+        report.Avx2BytesPerSecond = run(SimdLevel::Avx2);
+    if (report.Level >= SimdLevel::Avx512)
+        report.Avx512BytesPerSecond = run(SimdLevel::Avx512);
+    SetMaxSimdLevel(previousCap);
+    return report;
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Engine/CpuFeatures.h"
+
+// Structure-of-arrays views over float3/float4 streams. All component spans of a view must have the same length.
+struct Float3SoA
+{
+    Span<float> X;
+    Span<float> Y;
+    Span<float> Z;
+
+    size_t Size() const { return X.size(); }
+};
+
+struct ConstFloat3SoA
+{
+    Span<const float> X;
+    Span<const float> Y;
+    Span<const float> Z;
+
+    ConstFloat3SoA() = default;
+    ConstFloat3SoA(Span<const float> x, Span<const float> y, Span<const float> z) : X(x), Y(y), Z(z) {}
+    ConstFloat3SoA(const Float3SoA& v) : X(v.X), Y(v.Y), Z(v.Z) {}
+
+    size_t Size() const { return X.size(); }
+};
+
+struct Float4SoA
+{
+    Span<float> X;
+    Span<float> Y;
+    Span<float> Z;
+    Span<float> W;
+
+    size_t Size() const { return X.size(); }
+};
+
+struct ConstFloat4SoA
+{
+    Span<const float> X;
+    Span<const float> Y;
+    Span<const float> Z;
+    Span<const float> W;
+
+    ConstFloat4SoA() = default;
+    ConstFloat4SoA(Span<const float> x, Span<const float> y, Span<const float> z, Span<const float> w) : X(x), Y(y), Z(z), W(w) {}
+    ConstFloat4SoA(const Float4SoA& v) : X(v.X), Y(v.Y), Z(v.Z), W(v.W) {}
+
+    size_t Size() const { return X.size(); }
+};
+
+// Owning storage for a float3 stream
+class Float3Stream
+{
+public:
+    Float3Stream() = default;
+    explicit Float3Stream(size_t size) { Resize(size); }
+
+    void Resize(size_t size)
+    {
+        m_X.resize(size);
+        m_Y.resize(size);
+        m_Z.resize(size);
+    }
+
+    size_t Size() const { return m_X.size(); }
+
+    Float3SoA View() { return Float3SoA{ m_X, m_Y, m_Z }; }
+    ConstFloat3SoA View() const { return ConstFloat3SoA{ m_X, m_Y, m_Z }; }
+
+private:
+    Vector<float> m_X;
+    Vector<float> m_Y;
+    Vector<float> m_Z;
+};
+
+// Owning storage for a float4 stream
+class Float4Stream
+{
+public:
+    Float4Stream() = default;
+    explicit Float4Stream(size_t size) { Resize(size); }
+
+    void Resize(size_t size)
+    {
+        m_X.resize(size);
+        m_Y.resize(size);
+        m_Z.resize(size);
+        m_W.resize(size);
+    }
+
+    size_t Size() const { return m_X.size(); }
+
+    Float4SoA View() { return Float4SoA{ m_X, m_Y, m_Z, m_W }; }
+    ConstFloat4SoA View() const { return ConstFloat4SoA{ m_X, m_Y, m_Z, m_W }; }
+
+private:
+    Vector<float> m_X;
+    Vector<float> m_Y;
+    Vector<float> m_Z;
+    Vector<float> m_W;
+};
+
+// ---------- Stream kernels ------------
+// Vectorized 4/8/16 wide depending on GetSimdLevel(). Outputs may alias inputs element-for-element.
+// Matrices use the row-vector convention of BaseTypes.h
+
+// out = float4(in, 1) * m, w discarded (affine transforms)
+void TransformPoints(const float4x4& m, ConstFloat3SoA in, Float3SoA out);
+
+// out = float4(in, 1) * m, keeping w (e.g. clip space)
+void TransformPoints(const float4x4& m, ConstFloat3SoA in, Float4SoA out);
+
+// out = float4(in, 0) * m. Pass a normal matrix (inverse transpose) for non-uniform scale
+void TransformNormals(const float4x4& m, ConstFloat3SoA in, Float3SoA out);
+
+// Zero-length vectors are passed through unchanged, like Normalize()
+void NormalizeN(ConstFloat3SoA in, Float3SoA out);
+void NormalizeN(ConstFloat4SoA in, Float4SoA out);
+
+void DotN(ConstFloat3SoA a, ConstFloat3SoA b, Span<float> out);
+void DotN(ConstFloat4SoA a, ConstFloat4SoA b, Span<float> out);
+
+void CrossN(ConstFloat3SoA a, ConstFloat3SoA b, Float3SoA out);
+
+void LerpN(ConstFloat3SoA a, ConstFloat3SoA b, float t, Float3SoA out);
+void LerpN(ConstFloat4SoA a, ConstFloat4SoA b, float t, Float4SoA out);
+
+// ---------- AoS <-> SoA swizzles ------------
+void Deinterleave(Span<const float3> in, Float3SoA out);
+void Deinterleave(Span<const float4> in, Float4SoA out);
+void Interleave(ConstFloat3SoA in, Span<float3> out);
+void Interleave(ConstFloat4SoA in, Span<float4> out);
+
+// Strided variants for one float3 member of an interleaved vertex, e.g. MeshVertex::Position:
+// DeinterleaveStrided(&vertices[0].Position, sizeof(MeshVertex), positions.View())
+void DeinterleaveStrided(const float3* first, size_t strideBytes, Float3SoA out);
+void InterleaveStrided(ConstFloat3SoA in, float3* first, size_t strideBytes);
+
+struct VectorStreamsBenchmarkReport
+{
+    uint32 PointCount = 0;
+    SimdLevel Level = SimdLevel::Scalar;        // Level the dispatch picks on this CPU
+    double CopyBytesPerSecond = 0.0;            // memcpy of the same bytes, the bandwidth the kernels aim for
+    double ScalarBytesPerSecond = 0.0;          // Forced with SetMaxSimdLevel(SimdLevel::Scalar)
+    double SseBytesPerSecond = 0.0;
+    double Avx2BytesPerSecond = 0.0;            // 0 when the CPU has no AVX2 and FMA
+    double Avx512BytesPerSecond = 0.0;          // 0 when the CPU has no AVX-512F
+};
+
+// Headless benchmark: iterations passes of TransformPoints over pointCount float3, once per SIMD level the CPU supports.
+// Bytes count the 12 read and 12 written per point. Restores the previous SetMaxSimdLevel cap
+VectorStreamsBenchmarkReport RunVectorStreamsBenchmark(uint32 pointCount = 1 << 20, uint32 iterations = 20);
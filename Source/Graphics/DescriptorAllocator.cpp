@@ -0,0 +1,121 @@
+#include "DescriptorAllocator.h"
+
+#include <stdexcept>
+
+void DescriptorAllocator::Initialize(ID3D12Device* device, ID3D12DescriptorHeap* heap, uint32 persistentCount)
+{
+    if (!device || !heap)
+    {
+        throw std::invalid_argument("Device and descriptor heap cannot be null");
+    }
+
+    const D3D12_DESCRIPTOR_HEAP_DESC desc = heap->GetDesc();
+    if (!(desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE))
+    {
+        throw std::invalid_argument("Descriptor allocator needs a shader-visible heap");
+    }
+    if (persistentCount > desc.NumDescriptors)
+    {
+        throw std::invalid_argument("More persistent descriptors than the heap holds");
+    }
+
+    m_Device = device;
+    m_Heap = heap;
+    m_Type = desc.Type;
+    m_CpuStart = heap->GetCPUDescriptorHandleForHeapStart();
+    m_GpuStart = heap->GetGPUDescriptorHandleForHeapStart();
+    m_IncrementSize = device->GetDescriptorHandleIncrementSize(desc.Type);
+    m_Persistent.Reset(persistentCount);
+    m_Transient.Reset(desc.NumDescriptors - persistentCount);
+}
+
+void DescriptorAllocator::Release()
+{
+    m_Persistent.Reset(0);
+    m_Transient.Reset(0);
+    m_Heap.Reset();
+    m_Device.Reset();
+}
+
+DescriptorRange DescriptorAllocator::AllocatePersistent()
+{
+    const uint32 index = m_Persistent.Allocate();
+    if (index == DescriptorFreeList::s_InvalidIndex)
+    {
+        throw std::runtime_error("Out of persistent descriptors");
+    }
+    return MakeRange(index, 1);
+}
+
+void DescriptorAllocator::FreePersistent(DescriptorRange& descriptor)
+{
+    if (!descriptor.IsValid())
+        return;
+    m_Persistent.FreeDeferred(descriptor.Index);
+    descriptor = DescriptorRange();
+}
+
+void DescriptorAllocator::FinishFrame(uint64 fenceValue)
+{
+    m_Persistent.FinishFrame(fenceValue);
+    m_Transient.FinishFrame(fenceValue);
+}
+
+void DescriptorAllocator::Reclaim(uint64 completedFenceValue)
+{
+    m_Persistent.Reclaim(completedFenceValue);
+    m_Transient.Reclaim(completedFenceValue);
+}
+
+DescriptorRange DescriptorAllocator::AllocateTransient(uint32 count)
+{
+    // Transient slots follow the persistent ones
+    const uint32 slot = m_Transient.Allocate(count);
+    if (slot == DescriptorRing::s_InvalidIndex)
+    {
+        throw std::runtime_error("Transient descriptor ring is full, increase its capacity");
+    }
+    return MakeRange(m_Persistent.GetCapacity() + slot, count);
+}
+
+void DescriptorAllocator::Copy(Span<const DescriptorRange> destinations, Span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources) const
+{
+    if (destinations.size() != sources.size())
+    {
+        throw std::invalid_argument("Descriptor copy needs one source per destination");
+    }
+    if (destinations.empty())
+        return;
+
+    Vector<D3D12_CPU_DESCRIPTOR_HANDLE> destinationStarts(destinations.size());
+    Vector<UINT> destinationSizes(destinations.size());
+    for (size_t i = 0; i < destinations.size(); ++i)
+    {
+        destinationStarts[i] = destinations[i].Cpu;
+        destinationSizes[i] = 1;
+    }
+    m_Device->CopyDescriptors(static_cast<UINT>(destinations.size()), destinationStarts.data(), destinationSizes.data(),
+        static_cast<UINT>(sources.size()), sources.data(), nullptr, m_Type);
+}
+
+DescriptorRange DescriptorAllocator::CopyToTransient(Span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources)
+{
+    if (sources.empty())
+        return {};
+
+    const DescriptorRange range = AllocateTransient(static_cast<uint32>(sources.size()));
+    const UINT count = static_cast<UINT>(sources.size());
+    m_Device->CopyDescriptors(1, &range.Cpu, &count, count, sources.data(), nullptr, m_Type);
+    return range;
+}
+
+DescriptorRange DescriptorAllocator::MakeRange(uint32 index, uint32 count) const
+{
+    DescriptorRange range;
+    range.Cpu.ptr = m_CpuStart.ptr + SIZE_T(index) * m_IncrementSize;
+    range.Gpu.ptr = m_GpuStart.ptr + UINT64(index) * m_IncrementSize;
+    range.Index = index;
+    range.Count = count;
+    range.IncrementSize = m_IncrementSize;
+    return range;
+}
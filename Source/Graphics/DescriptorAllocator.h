@@ -0,0 +1,64 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/DescriptorSlots.h"
+
+// Contiguous descriptors of one heap, Index is the first slot. A persistent descriptor is a range of one
+struct DescriptorRange
+{
+    static constexpr uint32 s_InvalidIndex = ~0u;
+
+    D3D12_CPU_DESCRIPTOR_HANDLE Cpu = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE Gpu = {};
+    uint32 Index = s_InvalidIndex;
+    uint32 Count = 0;
+    uint32 IncrementSize = 0;
+
+    bool IsValid() const { return Index != s_InvalidIndex; }
+    D3D12_CPU_DESCRIPTOR_HANDLE GetCpu(uint32 i) const { return D3D12_CPU_DESCRIPTOR_HANDLE{ Cpu.ptr + SIZE_T(i) * IncrementSize }; }
+    D3D12_GPU_DESCRIPTOR_HANDLE GetGpu(uint32 i) const { return D3D12_GPU_DESCRIPTOR_HANDLE{ Gpu.ptr + UINT64(i) * IncrementSize }; }
+};
+
+// Hands out the slots of a shader-visible heap: the first persistentCount one by one from a lock-free free list, for
+// resources that live across frames, and the rest as per-frame transient ranges reclaimed by fence, e.g. descriptor
+// tables gathered while recording. Allocation is safe from any recording thread. A freed persistent slot is reused
+// only once the frame it was freed in completes, the frames in flight may still read it. Views can be created straight
+// into the CPU handles or gathered with the copy helpers from non shader-visible heaps, which are the only valid sources
+class DescriptorAllocator
+{
+public:
+    void Initialize(ID3D12Device* device, ID3D12DescriptorHeap* heap, uint32 persistentCount);
+    void Release();
+
+    // Throw when the slots run out
+    DescriptorRange AllocatePersistent();
+    void FreePersistent(DescriptorRange& descriptor);
+    DescriptorRange AllocateTransient(uint32 count);
+
+    // Copies sources[i] into the first slot of destinations[i] with a single CopyDescriptors call
+    void Copy(Span<const DescriptorRange> destinations, Span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources) const;
+    // Gathers scattered sources into a new transient range, in order, with a single CopyDescriptors call
+    DescriptorRange CopyToTransient(Span<const D3D12_CPU_DESCRIPTOR_HANDLE> sources);
+
+    // Frame thread only, while no other thread allocates transient ranges
+    void FinishFrame(uint64 fenceValue);
+    void Reclaim(uint64 completedFenceValue);
+
+    ID3D12DescriptorHeap* GetHeap() const { return m_Heap.Get(); }
+    uint32 GetPersistentCount() const { return m_Persistent.GetCapacity(); }
+    uint32 GetAllocatedPersistentCount() const { return m_Persistent.GetAllocatedCount(); }
+    uint32 GetTransientCapacity() const { return m_Transient.GetCapacity(); }
+
+private:
+    DescriptorRange MakeRange(uint32 index, uint32 count) const;
+
+    ComPtr<ID3D12Device> m_Device;
+    ComPtr<ID3D12DescriptorHeap> m_Heap;
+    D3D12_DESCRIPTOR_HEAP_TYPE m_Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+    D3D12_CPU_DESCRIPTOR_HANDLE m_CpuStart = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE m_GpuStart = {};
+    uint32 m_IncrementSize = 0;
+    DescriptorFreeList m_Persistent;
+    DescriptorRing m_Transient;
+};
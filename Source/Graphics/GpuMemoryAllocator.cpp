@@ -0,0 +1,284 @@
+#include "GpuMemoryAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "directx/d3dx12.h"
+
+void GpuMemoryAllocator::Initialize(ID3D12Device* device, uint64 blockSize)
+{
+    if (!device)
+    {
+        throw std::invalid_argument("Device cannot be null");
+    }
+    if (blockSize % D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT != 0 || blockSize < s_SmallBufferPageSize)
+    {
+        throw std::invalid_argument("GPU memory block size must be a multiple of 4 MB");
+    }
+
+    m_Device = device;
+    m_BlockSize = blockSize;
+    for (uint32 i = 0; i <= s_SmallBufferPool; ++i)
+    {
+        m_Pools[i] = Pool();
+        m_Pools[i].Category = i == s_SmallBufferPool ? GpuHeapCategory::Buffers : static_cast<GpuHeapCategory>(i);
+        m_Pools[i].SmallBufferPage = i == s_SmallBufferPool;
+    }
+}
+
+void GpuMemoryAllocator::Release()
+{
+    // Pages first, they are placed in the buffer blocks
+    for (uint32 i = s_SmallBufferPool + 1; i-- > 0;)
+        m_Pools[i].Blocks.clear();
+    m_Device.Reset();
+}
+
+GpuAllocation GpuMemoryAllocator::CreateBuffer(uint64 size, D3D12_RESOURCE_STATES initialState)
+{
+    if (size == 0)
+    {
+        throw std::invalid_argument("GPU buffer size must be positive");
+    }
+
+    GpuAllocation result;
+    result.Size = size;
+
+    // Small buffers take a range of a shared page instead of a 64 KB placement of their own
+    if (size < D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        TlsfAllocation allocation;
+        result.Pool = s_SmallBufferPool;
+        result.Block = Allocate(s_SmallBufferPool, AlignUp(size, s_SmallBufferAlignment), s_SmallBufferAlignment, allocation);
+        result.Handle = allocation.Handle;
+
+        const GpuAllocation& page = m_Pools[s_SmallBufferPool].Blocks[result.Block]->Page;
+        result.Resource = page.Resource;
+        result.Offset = allocation.Offset;
+        result.GpuAddress = page.GpuAddress + allocation.Offset;
+        return result;
+    }
+
+    TlsfAllocation allocation;
+    result.Pool = static_cast<uint32>(GpuHeapCategory::Buffers);
+    result.Block = Allocate(result.Pool, AlignUp(size, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT), D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, allocation);
+    result.Handle = allocation.Handle;
+
+    Block& block = *m_Pools[result.Pool].Blocks[result.Block];
+    auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(size);
+    if (FAILED(m_Device->CreatePlacedResource(block.Heap.Get(), allocation.Offset, &resourceDesc, initialState, nullptr, IID_PPV_ARGS(&result.Resource))))
+    {
+        Free(result);
+        throw std::runtime_error("Failed to create placed buffer");
+    }
+    result.GpuAddress = result.Resource->GetGPUVirtualAddress();
+    return result;
+}
+
+GpuAllocation GpuMemoryAllocator::CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue)
+{
+    const bool renderTarget = (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) != 0;
+    const GpuHeapCategory category = renderTarget ? GpuHeapCategory::RenderTargets : GpuHeapCategory::Textures;
+
+    // Small textures may be placed at 4 KB, the device answers with a larger alignment when they may not
+    D3D12_RESOURCE_DESC placedDesc = desc;
+    D3D12_RESOURCE_ALLOCATION_INFO info = {};
+    if (!renderTarget && desc.SampleDesc.Count <= 1)
+    {
+        placedDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+        info = m_Device->GetResourceAllocationInfo(0, 1, &placedDesc);
+    }
+    if (info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        placedDesc.Alignment = 0;
+        info = m_Device->GetResourceAllocationInfo(0, 1, &placedDesc);
+    }
+    if (info.SizeInBytes == ~0ull)
+    {
+        throw std::invalid_argument("Invalid texture description");
+    }
+
+    GpuAllocation result;
+    TlsfAllocation allocation;
+    result.Size = info.SizeInBytes;
+    result.Pool = static_cast<uint32>(category);
+    result.Block = Allocate(result.Pool, info.SizeInBytes, info.Alignment, allocation);
+    result.Handle = allocation.Handle;
+
+    Block& block = *m_Pools[result.Pool].Blocks[result.Block];
+    if (FAILED(m_Device->CreatePlacedResource(block.Heap.Get(), allocation.Offset, &placedDesc, initialState, clearValue, IID_PPV_ARGS(&result.Resource))))
+    {
+        Free(result);
+        throw std::runtime_error("Failed to create placed texture");
+    }
+    return result;
+}
+
+void GpuMemoryAllocator::Free(GpuAllocation& allocation)
+{
+    if (allocation.Handle == TlsfAllocation::s_InvalidHandle)
+        return;
+
+    // Blocks are gone after Release, their heaps live on in the resources still placed in them
+    const uint32 poolIndex = allocation.Pool;
+    const uint32 blockIndex = allocation.Block;
+    const uint32 handle = allocation.Handle;
+    allocation = GpuAllocation();
+    if (poolIndex > s_SmallBufferPool || blockIndex >= m_Pools[poolIndex].Blocks.size() || !m_Pools[poolIndex].Blocks[blockIndex])
+        return;
+
+    Pool& pool = m_Pools[poolIndex];
+    Block& block = *pool.Blocks[blockIndex];
+    block.Allocator.Free(handle);
+    if (!block.Allocator.IsEmpty())
+        return;
+
+    // Keep one regular block per pool around so a load and unload cycle does not create a heap each time. Blocks
+    // sized for a single large resource are always released
+    const uint64 regularSize = pool.SmallBufferPage ? s_SmallBufferPageSize : m_BlockSize;
+    bool otherBlock = false;
+    for (uint32 i = 0; i < pool.Blocks.size(); ++i)
+        otherBlock |= i != blockIndex && pool.Blocks[i] != nullptr;
+    if (!otherBlock && block.Allocator.GetCapacity() == regularSize)
+        return;
+
+    GpuAllocation page = std::move(block.Page);
+    pool.Blocks[blockIndex].reset();
+    Free(page);
+}
+
+GpuMemoryStats GpuMemoryAllocator::GetStats() const
+{
+    GpuMemoryStats stats;
+    for (uint32 i = 0; i <= s_SmallBufferPool; ++i)
+    {
+        const Pool& pool = m_Pools[i];
+        for (const UniquePtr<Block>& block : pool.Blocks)
+        {
+            if (!block)
+                continue;
+
+            const TlsfStats blockStats = block->Allocator.GetStats();
+            stats.UsedBytes += blockStats.UsedBytes;
+            stats.AllocationCount += blockStats.AllocationCount;
+            if (pool.SmallBufferPage)
+            {
+                // The page itself was counted as one allocation of its buffer block
+                stats.UsedBytes -= blockStats.Capacity;
+                stats.AllocationCount--;
+                continue;
+            }
+            stats.BlockCount++;
+            stats.ReservedBytes += blockStats.Capacity;
+            stats.Fragmentation = std::max(stats.Fragmentation, blockStats.Fragmentation);
+        }
+    }
+    return stats;
+}
+
+Vector<GpuDefragmentationHint> GpuMemoryAllocator::GetDefragmentationHints(float maxOccupancy) const
+{
+    Vector<GpuDefragmentationHint> hints;
+    for (uint32 i = 0; i <= s_SmallBufferPool; ++i)
+    {
+        const Pool& pool = m_Pools[i];
+        for (uint32 blockIndex = 0; blockIndex < pool.Blocks.size(); ++blockIndex)
+        {
+            if (!pool.Blocks[blockIndex])
+                continue;
+
+            const TlsfStats blockStats = pool.Blocks[blockIndex]->Allocator.GetStats();
+            if (blockStats.UsedBytes == 0 || float(double(blockStats.UsedBytes) / double(blockStats.Capacity)) > maxOccupancy)
+                continue;
+
+            GpuDefragmentationHint& hint = hints.emplace_back();
+            hint.Category = pool.Category;
+            hint.SmallBufferPage = pool.SmallBufferPage;
+            hint.Block = blockIndex;
+            hint.UsedBytes = blockStats.UsedBytes;
+            hint.Capacity = blockStats.Capacity;
+            hint.Fragmentation = blockStats.Fragmentation;
+        }
+    }
+
+    std::sort(hints.begin(), hints.end(), [](const GpuDefragmentationHint& a, const GpuDefragmentationHint& b)
+    {
+        return double(a.UsedBytes) / double(a.Capacity) < double(b.UsedBytes) / double(b.Capacity);
+    });
+    return hints;
+}
+
+uint32 GpuMemoryAllocator::Allocate(uint32 poolIndex, uint64 size, uint64 alignment, TlsfAllocation& allocation)
+{
+    if (!m_Device)
+    {
+        throw std::runtime_error("GPU memory allocator is not initialized");
+    }
+
+    Pool& pool = m_Pools[poolIndex];
+    for (uint32 i = 0; i < pool.Blocks.size(); ++i)
+    {
+        if (!pool.Blocks[i])
+            continue;
+        allocation = pool.Blocks[i]->Allocator.Allocate(size, alignment);
+        if (allocation.IsValid())
+            return i;
+    }
+
+    UniquePtr<Block> block = pool.SmallBufferPage
+        ? CreatePageBlock()
+        : CreateHeapBlock(pool.Category, std::max(m_BlockSize, AlignUp(size, D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT)));
+    allocation = block->Allocator.Allocate(size, alignment);
+    if (!allocation.IsValid())
+    {
+        throw std::runtime_error("GPU allocation does not fit in a new block");
+    }
+
+    for (uint32 i = 0; i < pool.Blocks.size(); ++i)
+    {
+        if (!pool.Blocks[i])
+        {
+            pool.Blocks[i] = std::move(block);
+            return i;
+        }
+    }
+    pool.Blocks.push_back(std::move(block));
+    return static_cast<uint32>(pool.Blocks.size() - 1);
+}
+
+UniquePtr<GpuMemoryAllocator::Block> GpuMemoryAllocator::CreateHeapBlock(GpuHeapCategory category, uint64 size) const
+{
+    static constexpr D3D12_HEAP_FLAGS s_CategoryFlags[] =
+    {
+        D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+    };
+
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = size;
+    heapDesc.Properties.Type = D3D12_HEAP_TYPE_DEFAULT;
+    heapDesc.Properties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapDesc.Properties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    heapDesc.Properties.CreationNodeMask = 1;
+    heapDesc.Properties.VisibleNodeMask = 1;
+    // Render targets may be multisampled, which needs the 4 MB placement
+    heapDesc.Alignment = category == GpuHeapCategory::RenderTargets ? D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    heapDesc.Flags = s_CategoryFlags[static_cast<uint32>(category)];
+
+    UniquePtr<Block> block = std::make_unique<Block>();
+    if (FAILED(m_Device->CreateHeap(&heapDesc, IID_PPV_ARGS(&block->Heap))))
+    {
+        throw std::runtime_error("Failed to create GPU memory heap");
+    }
+    block->Allocator = TlsfAllocator(size);
+    return block;
+}
+
+UniquePtr<GpuMemoryAllocator::Block> GpuMemoryAllocator::CreatePageBlock()
+{
+    UniquePtr<Block> block = std::make_unique<Block>();
+    block->Page = CreateBuffer(s_SmallBufferPageSize, D3D12_RESOURCE_STATE_COMMON);
+    block->Allocator = TlsfAllocator(s_SmallBufferPageSize);
+    return block;
+}
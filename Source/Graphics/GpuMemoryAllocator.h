@@ -0,0 +1,102 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/TlsfAllocator.h"
+
+// Resource heap tier 1 keeps buffers, render target / depth textures and other textures in separate heaps
+enum class GpuHeapCategory : uint8
+{
+    Buffers,
+    RenderTargets,
+    Textures,
+    Count
+};
+
+struct GpuAllocation
+{
+    ComPtr<ID3D12Resource> Resource;
+    uint64 Offset = 0;                              // Into Resource, non-zero for small buffers packed into a page
+    uint64 Size = 0;
+    D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;       // Of the first byte, buffers only
+
+    uint32 Pool = ~0u;
+    uint32 Block = 0;
+    uint32 Handle = TlsfAllocation::s_InvalidHandle;
+
+    bool IsValid() const { return Resource != nullptr; }
+};
+
+struct GpuMemoryStats
+{
+    uint32 BlockCount = 0;
+    uint64 ReservedBytes = 0;       // Heap blocks
+    uint64 UsedBytes = 0;           // Placed resources and packed buffers, not the pages holding them
+    uint32 AllocationCount = 0;
+    float Fragmentation = 0.0f;     // Worst block
+};
+
+// A block whose few allocations could be recreated elsewhere, e.g. by the next load, so the block is released
+struct GpuDefragmentationHint
+{
+    GpuHeapCategory Category = GpuHeapCategory::Buffers;
+    bool SmallBufferPage = false;
+    uint32 Block = 0;
+    uint64 UsedBytes = 0;
+    uint64 Capacity = 0;
+    float Fragmentation = 0.0f;
+};
+
+// Places resources into large ID3D12Heap blocks, each suballocated by a TlsfAllocator, instead of one committed
+// resource (and one 64 KB aligned heap) each. Buffers smaller than the placement alignment are packed at 256 bytes
+// into shared page buffers, which are placed resources themselves. Resources larger than a block get a heap of their
+// own. Free is immediate, so like releasing a committed resource it must wait until the GPU is done with it
+class GpuMemoryAllocator
+{
+public:
+    static constexpr uint64 s_DefaultBlockSize = 64ull << 20;
+    static constexpr uint64 s_SmallBufferPageSize = 4ull << 20;
+    static constexpr uint64 s_SmallBufferAlignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;
+
+    void Initialize(ID3D12Device* device, uint64 blockSize = s_DefaultBlockSize);
+    // Every allocation must have been freed
+    void Release();
+
+    // Default heap buffer. Buffers smaller than the placement alignment share a page created in the common state and
+    // rely on implicit promotion, initialState only applies to the buffers placed on their own
+    GpuAllocation CreateBuffer(uint64 size, D3D12_RESOURCE_STATES initialState);
+    // Default heap texture, placed at 4 KB when small enough for it and at the alignment the device asks for otherwise
+    GpuAllocation CreateTexture(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES initialState, const D3D12_CLEAR_VALUE* clearValue = nullptr);
+    // Releases the resource of a placed allocation, and empty blocks beyond the first of their pool
+    void Free(GpuAllocation& allocation);
+
+    GpuMemoryStats GetStats() const;
+    // Blocks filled to at most maxOccupancy, emptiest first
+    Vector<GpuDefragmentationHint> GetDefragmentationHints(float maxOccupancy = 0.25f) const;
+
+private:
+    struct Block
+    {
+        ComPtr<ID3D12Heap> Heap;
+        GpuAllocation Page;             // Small buffer pages only, placed in a buffer block
+        TlsfAllocator Allocator;
+    };
+
+    struct Pool
+    {
+        GpuHeapCategory Category = GpuHeapCategory::Buffers;
+        bool SmallBufferPage = false;
+        Vector<UniquePtr<Block>> Blocks;    // Empty slots are reused
+    };
+
+    static constexpr uint32 s_SmallBufferPool = static_cast<uint32>(GpuHeapCategory::Count);
+
+    // Block index and its allocation, a new block of at least size bytes when no existing one has room
+    uint32 Allocate(uint32 pool, uint64 size, uint64 alignment, TlsfAllocation& allocation);
+    UniquePtr<Block> CreateHeapBlock(GpuHeapCategory category, uint64 size) const;
+    UniquePtr<Block> CreatePageBlock();
+
+    ComPtr<ID3D12Device> m_Device;
+    uint64 m_BlockSize = s_DefaultBlockSize;
+    Pool m_Pools[s_SmallBufferPool + 1];
+};
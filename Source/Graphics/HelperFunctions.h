@@ -4,78 +4,17 @@
 #include "Engine/BaseTypes.h"
 #include "Engine/Camera.h"
 #include "Graphics/Mesh.h"
+#include "Graphics/PrimitiveTables.h"
 
 
 inline MeshTemplate CreateCubeMesh(float size = 1.0f)
 {
-    MeshTemplate cube;
-    float halfSize = size * 0.5f;
-    
-    // Front face vertices
-    cube.AddVertex({ float3{-halfSize, -halfSize,  halfSize}, float3{ 0.0f,  0.0f,  1.0f}, float2{0.0f, 1.0f} });
-    cube.AddVertex({ float3{ halfSize, -halfSize,  halfSize}, float3{ 0.0f,  0.0f,  1.0f}, float2{1.0f, 1.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize,  halfSize}, float3{ 0.0f,  0.0f,  1.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{-halfSize,  halfSize,  halfSize}, float3{ 0.0f,  0.0f,  1.0f}, float2{0.0f, 0.0f} });
-
-    // Back face vertices
-    cube.AddVertex({ float3{ halfSize, -halfSize, -halfSize}, float3{ 0.0f,  0.0f, -1.0f}, float2{0.0f, 1.0f} });
-    cube.AddVertex({ float3{-halfSize, -halfSize, -halfSize}, float3{ 0.0f,  0.0f, -1.0f}, float2{1.0f, 1.0f} });
-    cube.AddVertex({ float3{-halfSize,  halfSize, -halfSize}, float3{ 0.0f,  0.0f, -1.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize, -halfSize}, float3{ 0.0f,  0.0f, -1.0f}, float2{0.0f, 0.0f} });
-
-    // Top face vertices
-    cube.AddVertex({ float3{-halfSize,  halfSize, -halfSize}, float3{ 0.0f,  1.0f,  0.0f}, float2{0.0f, 1.0f} });
-    cube.AddVertex({ float3{-halfSize,  halfSize,  halfSize}, float3{ 0.0f,  1.0f,  0.0f}, float2{0.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize,  halfSize}, float3{ 0.0f,  1.0f,  0.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize, -halfSize}, float3{ 0.0f,  1.0f,  0.0f}, float2{1.0f, 1.0f} });
-
-    // Bottom face vertices
-    cube.AddVertex({ float3{-halfSize, -halfSize, -halfSize}, float3{ 0.0f, -1.0f,  0.0f}, float2{0.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize, -halfSize, -halfSize}, float3{ 0.0f, -1.0f,  0.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize, -halfSize,  halfSize}, float3{ 0.0f, -1.0f,  0.0f}, float2{1.0f, 1.0f} });
-    cube.AddVertex({ float3{-halfSize, -halfSize,  halfSize}, float3{ 0.0f, -1.0f,  0.0f}, float2{0.0f, 1.0f} });
-
-    // Right face vertices
-    cube.AddVertex({ float3{ halfSize, -halfSize, -halfSize}, float3{ 1.0f,  0.0f,  0.0f}, float2{0.0f, 1.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize, -halfSize}, float3{ 1.0f,  0.0f,  0.0f}, float2{0.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize,  halfSize,  halfSize}, float3{ 1.0f,  0.0f,  0.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{ halfSize, -halfSize,  halfSize}, float3{ 1.0f,  0.0f,  0.0f}, float2{1.0f, 1.0f} });
-
-    // Left face vertices
-    cube.AddVertex({ float3{-halfSize, -halfSize,  halfSize}, float3{-1.0f,  0.0f,  0.0f}, float2{0.0f, 1.0f} });
-    cube.AddVertex({ float3{-halfSize,  halfSize,  halfSize}, float3{-1.0f,  0.0f,  0.0f}, float2{0.0f, 0.0f} });
-    cube.AddVertex({ float3{-halfSize,  halfSize, -halfSize}, float3{-1.0f,  0.0f,  0.0f}, float2{1.0f, 0.0f} });
-    cube.AddVertex({ float3{-halfSize, -halfSize, -halfSize}, float3{-1.0f,  0.0f,  0.0f}, float2{1.0f, 1.0f} });
-
-    // Add triangles for each face (2 triangles per face, 6 faces)
-    // Front face
-    cube.AddTriangle(0, 1, 2);
-    cube.AddTriangle(2, 3, 0);
-
-    // Back face
-    cube.AddTriangle(4, 5, 6);
-    cube.AddTriangle(6, 7, 4);
-
-    // Top face
-    cube.AddTriangle(8, 9, 10);
-    cube.AddTriangle(10, 11, 8);
-
-    // Bottom face
-    cube.AddTriangle(12, 13, 14);
-    cube.AddTriangle(14, 15, 12);
-
-    // Right face
-    cube.AddTriangle(16, 17, 18);
-    cube.AddTriangle(18, 19, 16);
-
-    // Left face
-    cube.AddTriangle(20, 21, 22);
-    cube.AddTriangle(22, 23, 20);
-
-    return cube;
+    // Same generator as the compile-time table, copied in one go instead of 24 push_backs
+    const auto table = MakeCubeTable(size);
+    return MeshTemplate(table.Vertices, table.Indices);
 }
 
-MeshTemplate CreateSphereMesh(float radius = 1.0f, uint32 latitudeSegments = 16, uint32 longitudeSegments = 16)
+inline MeshTemplate CreateSphereMesh(float radius = 1.0f, uint32 latitudeSegments = 16, uint32 longitudeSegments = 16)
 {
     MeshTemplate mesh;
     for (uint32 lat = 0; lat <= latitudeSegments; ++lat)
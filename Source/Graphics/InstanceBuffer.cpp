@@ -0,0 +1,127 @@
+#include "InstanceBuffer.h"
+
+#include <stdexcept>
+
+#include "Graphics/MaterialTable.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/MeshPipeline.h"
+
+void InstanceBuffer::Initialize(ID3D12Device* device, uint32 frameCount, uint32 initialCapacity)
+{
+    if (!device)
+    {
+        throw std::invalid_argument("Device cannot be null");
+    }
+
+    m_Device = device;
+    m_Regions.resize(frameCount);
+    for (Region& region : m_Regions)
+    {
+        CreateRegion(region, std::max(initialCapacity, 1u));
+    }
+}
+
+void InstanceBuffer::Release()
+{
+    for (Region& region : m_Regions)
+    {
+        if (region.Buffer)
+        {
+            region.Buffer->Unmap(0, nullptr);
+        }
+    }
+    m_Regions.clear();
+    m_Device.Reset();
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS InstanceBuffer::Upload(Span<const ObjectData> instances, uint32 frameIndex)
+{
+    if (frameIndex >= m_Regions.size())
+    {
+        throw std::out_of_range("Frame index exceeds the instance buffer frame count");
+    }
+
+    Region& region = m_Regions[frameIndex];
+    if (instances.size() > region.Capacity)
+    {
+        region.Buffer->Unmap(0, nullptr);
+        CreateRegion(region, std::max(static_cast<uint32>(instances.size()), region.Capacity * 2));
+    }
+
+    if (!instances.empty())
+    {
+        memcpy(region.MappedData, instances.data(), instances.size_bytes());
+    }
+    return region.Buffer->GetGPUVirtualAddress();
+}
+
+void InstanceBuffer::Draw(ID3D12GraphicsCommandList* commandList, const InstanceBatcher& batcher, Span<const MeshPipeline* const> pipelines,
+    D3D12_GPU_VIRTUAL_ADDRESS frameDataAddress, const MaterialTable& materials, uint32 frameIndex)
+{
+    const D3D12_GPU_VIRTUAL_ADDRESS instances = Upload(batcher.GetInstances(), frameIndex);
+    const MeshPipeline* pipeline = nullptr;
+    for (const InstanceBatch& batch : batcher.GetBatches())
+    {
+        // Setting the root signature clears all root bindings
+        const size_t format = static_cast<size_t>(batch.Format);
+        if (format >= pipelines.size() || !pipelines[format])
+        {
+            throw std::out_of_range("No instanced pipeline for the vertex format of a batch");
+        }
+        if (pipelines[format] != pipeline)
+        {
+            pipeline = pipelines[format];
+            pipeline->Bind(commandList);
+            commandList->SetGraphicsRootConstantBufferView(0, frameDataAddress);
+            materials.Bind(commandList);
+        }
+
+        commandList->SetGraphicsRootShaderResourceView(1, instances + uint64(batch.FirstInstance) * sizeof(ObjectData));
+        batch.Mesh->BindBuffers(commandList);
+        batch.Mesh->DrawIndexed(commandList, batch.InstanceCount);
+    }
+}
+
+void InstanceBuffer::CreateRegion(Region& region, uint32 capacity)
+{
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    heapProps.CreationNodeMask = 1;
+    heapProps.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC resourceDesc = {};
+    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    resourceDesc.Alignment = 0;
+    resourceDesc.Width = uint64(capacity) * sizeof(ObjectData);
+    resourceDesc.Height = 1;
+    resourceDesc.DepthOrArraySize = 1;
+    resourceDesc.MipLevels = 1;
+    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+    resourceDesc.SampleDesc.Count = 1;
+    resourceDesc.SampleDesc.Quality = 0;
+    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    region.Buffer.Reset();
+    region.MappedData = nullptr;
+    region.Capacity = 0;
+    if (FAILED(m_Device->CreateCommittedResource(
+        &heapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &resourceDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&region.Buffer))))
+    {
+        throw std::runtime_error("Failed to create instance buffer");
+    }
+
+    // Keep it mapped for the lifetime of the resource
+    if (FAILED(region.Buffer->Map(0, nullptr, reinterpret_cast<void**>(&region.MappedData))))
+    {
+        throw std::runtime_error("Failed to map instance buffer");
+    }
+    region.Capacity = capacity;
+}
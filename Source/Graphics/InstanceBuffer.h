@@ -0,0 +1,39 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/InstanceBatcher.h"
+
+class MaterialTable;
+class MeshPipeline;
+
+// Upload heap buffer holding the packed ObjectData of InstanceBatcher, one region per frame in flight. A region grows
+// when a frame needs more instances, which is safe since the frame's previous commands finished before it is reused
+class InstanceBuffer
+{
+public:
+    void Initialize(ID3D12Device* device, uint32 frameCount, uint32 initialCapacity = 1024);
+    void Release();
+
+    // Copies the instances into the frame's region and returns its GPU address
+    D3D12_GPU_VIRTUAL_ADDRESS Upload(Span<const ObjectData> instances, uint32 frameIndex);
+
+    // Uploads the batcher's instances, then issues one instanced draw per batch with the instance buffer root SRV (t0)
+    // pointing at its first instance. pipelines holds a MeshPipelineMode::Instanced pipeline per VertexFormat drawn,
+    // indexed by it. Each is bound once, along with the frame data (b0) from frameDataAddress and the material table
+    void Draw(ID3D12GraphicsCommandList* commandList, const InstanceBatcher& batcher, Span<const MeshPipeline* const> pipelines,
+        D3D12_GPU_VIRTUAL_ADDRESS frameDataAddress, const MaterialTable& materials, uint32 frameIndex);
+
+private:
+    struct Region
+    {
+        ComPtr<ID3D12Resource> Buffer;
+        uint8* MappedData = nullptr;
+        uint32 Capacity = 0;
+    };
+
+    void CreateRegion(Region& region, uint32 capacity);
+
+    ComPtr<ID3D12Device> m_Device;
+    Vector<Region> m_Regions;
+};
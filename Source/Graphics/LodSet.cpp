@@ -0,0 +1,35 @@
+#include "LodSet.h"
+
+LodSet::LodSet(const MeshTemplate& source, Span<const MeshLod> lods, ID3D12Device* device, VertexFormat format, StagingUploader* uploader,
+    MaterialTable* materials)
+{
+    const float4 sphere = ComputeBoundingSphere(source.GetVertices());
+    SetBounds(float3{ sphere.x, sphere.y, sphere.z }, sphere.w);
+
+    AddLevel(MakeShared<Mesh>(source, device, format, uploader, materials), 0.0f);
+    for (const MeshLod& lod : lods)
+    {
+        if (lod.Mesh.GetIndexCount() == 0 || lod.Mesh.GetIndexCount() / 3 >= m_Levels.back().TriangleCount)
+            continue;
+        if (lod.AbsoluteError < m_Levels.back().Error)
+            continue;
+        AddLevel(MakeShared<Mesh>(lod.Mesh, device, format, uploader, materials), lod.AbsoluteError);
+    }
+}
+
+void LodSet::AddLevel(SharedPtr<Mesh> mesh, float error)
+{
+    if (!mesh)
+        throw std::invalid_argument("LodSet::AddLevel: mesh is null");
+    if (!m_Levels.empty() && error < m_Levels.back().Error)
+        throw std::invalid_argument("LodSet::AddLevel: levels must be added with non-decreasing error");
+
+    const uint32 triangleCount = mesh->GetIndexCount() / 3;
+    m_Levels.push_back(LodLevel{ std::move(mesh), error, triangleCount });
+}
+
+void LodSet::SetBounds(const float3& center, float radius)
+{
+    m_BoundsCenter = center;
+    m_BoundsRadius = radius;
+}
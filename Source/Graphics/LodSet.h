@@ -0,0 +1,38 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+#include "Graphics/MeshSimplifier.h"
+
+struct LodLevel
+{
+    SharedPtr<::Mesh> Mesh;
+    float Error = 0.0f;             // Geometric error in object-space units, 0 for the source mesh
+    uint32 TriangleCount = 0;
+};
+
+// Meshes of one model ordered from finest to coarsest, plus the object-space bounding sphere used to project
+// the level errors to the screen. Shared between all objects drawing the model
+class LodSet
+{
+public:
+    LodSet() = default;
+
+    // Uploads the source as level 0 followed by the levels of BuildLodChain, skipping levels that did not get coarser
+    LodSet(const MeshTemplate& source, Span<const MeshLod> lods, ID3D12Device* device, VertexFormat format = VertexFormat::Float32,
+        StagingUploader* uploader = nullptr, MaterialTable* materials = nullptr);
+
+    // Levels must be added finest first with non-decreasing error
+    void AddLevel(SharedPtr<Mesh> mesh, float error);
+    void SetBounds(const float3& center, float radius);
+
+    const Vector<LodLevel>& GetLevels() const { return m_Levels; }
+    uint32 GetLevelCount() const { return static_cast<uint32>(m_Levels.size()); }
+    const LodLevel& GetLevel(uint32 level) const { return m_Levels.at(level); }
+    const float3& GetBoundsCenter() const { return m_BoundsCenter; }
+    float GetBoundsRadius() const { return m_BoundsRadius; }
+
+private:
+    Vector<LodLevel> m_Levels;
+    float3 m_BoundsCenter = { 0.0f, 0.0f, 0.0f };
+    float m_BoundsRadius = 0.0f;
+};
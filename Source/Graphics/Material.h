@@ -2,13 +2,22 @@
 #include "Engine/BaseTypes.h"
 #include <d3d12.h>
 
+// One entry of the material table, matching MaterialData in BlinnPhong.pshader. The maps are slots of the shader-visible
+// CBV SRV UAV heap, s_NoTexture when the material has none
 struct MaterialData
 {
+    static constexpr uint32 s_NoTexture = ~0u;
+
     float3 Albedo;
     float Metallic;
     float Roughness;
-    float Padding[3];
+    uint32 AlbedoMap = s_NoTexture;
+    uint32 NormalMap = s_NoTexture;
+    uint32 MetallicMap = s_NoTexture;
+    uint32 RoughnessMap = s_NoTexture;
+    uint32 Padding[3] = {};
 };
+static_assert(sizeof(MaterialData) % 16 == 0, "MaterialData must be 16-byte aligned");
 
 struct Material
 {
@@ -0,0 +1,84 @@
+#include "MaterialEntries.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+MaterialKey MaterialKey::FromMaterial(const Material& material)
+{
+    MaterialKey key;
+    key.Albedo = material.Albedo;
+    key.Metallic = material.Metallic;
+    key.Roughness = material.Roughness;
+    key.Maps[0] = material.AlbedoMap.Get();
+    key.Maps[1] = material.NormalMap.Get();
+    key.Maps[2] = material.MetallicMap.Get();
+    key.Maps[3] = material.RoughnessMap.Get();
+    return key;
+}
+
+size_t MaterialEntries::EntryHash::operator()(const MaterialData& entry) const
+{
+    // The padding is always zero, so equal entries hash their bytes alike
+    return std::hash<std::string_view>()(std::string_view(reinterpret_cast<const char*>(&entry), sizeof(MaterialData)));
+}
+
+bool MaterialEntries::EntryEqual::operator()(const MaterialData& a, const MaterialData& b) const
+{
+    return memcmp(&a, &b, sizeof(MaterialData)) == 0;
+}
+
+void MaterialEntries::Reset(uint32 capacity)
+{
+    m_Capacity = capacity;
+    m_Entries.clear();
+    m_Entries.reserve(capacity);
+    m_EntryIndices.clear();
+    m_TextureSlots.clear();
+}
+
+MaterialData MaterialEntries::MakeEntry(const MaterialKey& material) const
+{
+    MaterialData entry{};
+    entry.Albedo = material.Albedo;
+    entry.Metallic = material.Metallic;
+    entry.Roughness = material.Roughness;
+    for (uint32 map = 0; map < MaterialKey::s_MapCount; ++map)
+    {
+        const auto found = m_TextureSlots.find(material.Maps[map]);
+        entry.*s_MapSlots[map] = found != m_TextureSlots.end() ? found->second : MaterialData::s_NoTexture;
+    }
+    return entry;
+}
+
+bool MaterialEntries::HasNewTexture(const MaterialKey& material) const
+{
+    for (ID3D12Resource* texture : material.Maps)
+    {
+        if (texture && !m_TextureSlots.contains(texture))
+            return true;
+    }
+    return false;
+}
+
+uint32 MaterialEntries::Find(const MaterialData& entry) const
+{
+    const auto found = m_EntryIndices.find(entry);
+    return found != m_EntryIndices.end() ? found->second : s_InvalidIndex;
+}
+
+void MaterialEntries::CheckCapacity() const
+{
+    if (m_Entries.size() >= m_Capacity)
+    {
+        throw std::runtime_error("Material table is full, increase its capacity");
+    }
+}
+
+uint32 MaterialEntries::Append(const MaterialData& entry)
+{
+    const uint32 index = static_cast<uint32>(m_Entries.size());
+    m_Entries.push_back(entry);
+    m_EntryIndices.emplace(entry, index);
+    return index;
+}
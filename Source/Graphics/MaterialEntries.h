@@ -0,0 +1,93 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Graphics/Material.h"
+
+// The values of a Material the table stores. The maps are the texture resources, nullptr when absent; they are only
+// compared, never dereferenced
+struct MaterialKey
+{
+    static constexpr uint32 s_MapCount = 4;
+
+    float3 Albedo = { 1, 0, 0 };
+    float Metallic = .5;
+    float Roughness = .5;
+    ID3D12Resource* Maps[s_MapCount] = {};     // Albedo, normal, metallic, roughness
+
+    static MaterialKey FromMaterial(const Material& material);
+};
+
+// CPU side of MaterialTable: builds the MaterialData entries, deduplicates them by value and gives every distinct
+// texture one slot. Slots come from a callback, so the table stays device free here and in the tests
+class MaterialEntries
+{
+public:
+    // Drops every entry and texture slot
+    void Reset(uint32 capacity);
+
+    // Index of the entry equal to the material, appended when there is none. createTextureSlot(texture) returns the
+    // slot of a texture seen for the first time; it is only called once the new entry is known to fit, so a full
+    // table throws before any slot is taken
+    template<class CreateTextureSlot>
+    uint32 Add(const MaterialKey& material, CreateTextureSlot&& createTextureSlot)
+    {
+        MaterialData entry = MakeEntry(material);
+        if (!HasNewTexture(material))
+        {
+            const uint32 found = Find(entry);
+            if (found != s_InvalidIndex)
+                return found;
+        }
+        CheckCapacity();
+
+        for (uint32 map = 0; map < MaterialKey::s_MapCount; ++map)
+        {
+            // Looked up again, a new texture may be used by two maps of the material
+            if (material.Maps[map] && entry.*s_MapSlots[map] == MaterialData::s_NoTexture)
+                entry.*s_MapSlots[map] = FindOrAddTexture(material.Maps[map], createTextureSlot);
+        }
+        return Append(entry);
+    }
+
+    uint32 GetCount() const { return static_cast<uint32>(m_Entries.size()); }
+    uint32 GetCapacity() const { return m_Capacity; }
+    uint32 GetTextureCount() const { return static_cast<uint32>(m_TextureSlots.size()); }
+    const MaterialData& GetEntry(uint32 index) const { return m_Entries.at(index); }
+
+private:
+    static constexpr uint32 s_InvalidIndex = ~0u;
+    static constexpr uint32 MaterialData::* s_MapSlots[MaterialKey::s_MapCount] = {
+        &MaterialData::AlbedoMap, &MaterialData::NormalMap, &MaterialData::MetallicMap, &MaterialData::RoughnessMap };
+
+    struct EntryHash
+    {
+        size_t operator()(const MaterialData& entry) const;
+    };
+    struct EntryEqual
+    {
+        bool operator()(const MaterialData& a, const MaterialData& b) const;
+    };
+
+    // The slots of the textures already known, s_NoTexture for the others
+    MaterialData MakeEntry(const MaterialKey& material) const;
+    bool HasNewTexture(const MaterialKey& material) const;
+    uint32 Find(const MaterialData& entry) const;
+    void CheckCapacity() const;
+    uint32 Append(const MaterialData& entry);
+
+    template<class CreateTextureSlot>
+    uint32 FindOrAddTexture(ID3D12Resource* texture, CreateTextureSlot& createTextureSlot)
+    {
+        const auto found = m_TextureSlots.find(texture);
+        if (found != m_TextureSlots.end())
+            return found->second;
+
+        const uint32 slot = createTextureSlot(texture);
+        m_TextureSlots.emplace(texture, slot);
+        return slot;
+    }
+
+    uint32 m_Capacity = 0;
+    Vector<MaterialData> m_Entries;
+    HashMap<MaterialData, uint32, EntryHash, EntryEqual> m_EntryIndices;
+    HashMap<const ID3D12Resource*, uint32> m_TextureSlots;
+};
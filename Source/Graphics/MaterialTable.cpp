@@ -0,0 +1,113 @@
+#include "MaterialTable.h"
+
+#include <stdexcept>
+
+void MaterialTable::Initialize(ID3D12Device* device, DescriptorAllocator* descriptors, uint32 capacity)
+{
+    if (!device || !descriptors)
+    {
+        throw std::invalid_argument("Device and descriptor allocator cannot be null");
+    }
+    if (capacity == 0)
+    {
+        throw std::invalid_argument("Material table capacity cannot be zero");
+    }
+
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    heapProps.CreationNodeMask = 1;
+    heapProps.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC resourceDesc = {};
+    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    resourceDesc.Alignment = 0;
+    resourceDesc.Width = uint64(capacity) * sizeof(MaterialData);
+    resourceDesc.Height = 1;
+    resourceDesc.DepthOrArraySize = 1;
+    resourceDesc.MipLevels = 1;
+    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+    resourceDesc.SampleDesc.Count = 1;
+    resourceDesc.SampleDesc.Quality = 0;
+    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    if (FAILED(device->CreateCommittedResource(
+        &heapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &resourceDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_Buffer))))
+    {
+        throw std::runtime_error("Failed to create material table buffer");
+    }
+
+    // Keep it mapped for the lifetime of the resource
+    if (FAILED(m_Buffer->Map(0, nullptr, reinterpret_cast<void**>(&m_MappedData))))
+    {
+        throw std::runtime_error("Failed to map material table buffer");
+    }
+
+    m_Device = device;
+    m_Descriptors = descriptors;
+    m_Entries.Reset(capacity);
+
+    const uint32 defaultMaterial = Add(Material{});
+    if (defaultMaterial != s_DefaultMaterial)
+    {
+        throw std::logic_error("The default material must be the first entry");
+    }
+}
+
+void MaterialTable::Release()
+{
+    for (Texture& texture : m_Textures)
+    {
+        m_Descriptors->FreePersistent(texture.Descriptor);
+    }
+    m_Textures.clear();
+    m_Entries.Reset(0);
+
+    if (m_Buffer)
+    {
+        m_Buffer->Unmap(0, nullptr);
+        m_Buffer.Reset();
+    }
+    m_MappedData = nullptr;
+    m_Descriptors = nullptr;
+    m_Device.Reset();
+}
+
+uint32 MaterialTable::Add(const Material& material)
+{
+    const uint32 count = m_Entries.GetCount();
+    const uint32 index = m_Entries.Add(MaterialKey::FromMaterial(material),
+        [this](ID3D12Resource* texture) { return CreateTextureSlot(texture); });
+
+    // The GPU only reads entries already referenced by recorded draws, appending one never races with them.
+    // The CPU copy spares reading back the write-combined upload memory
+    if (index == count)
+        m_MappedData[index] = m_Entries.GetEntry(index);
+    return index;
+}
+
+void MaterialTable::Bind(ID3D12GraphicsCommandList* commandList) const
+{
+    commandList->SetGraphicsRootShaderResourceView(2, m_Buffer->GetGPUVirtualAddress());
+    commandList->SetGraphicsRootDescriptorTable(3, m_Descriptors->GetHeap()->GetGPUDescriptorHandleForHeapStart());
+}
+
+uint32 MaterialTable::CreateTextureSlot(ID3D12Resource* texture)
+{
+    // Default view of the whole resource, the textures are created with a typed format
+    Texture entry;
+    entry.Resource = texture;
+    entry.Descriptor = m_Descriptors->AllocatePersistent();
+    m_Device->CreateShaderResourceView(texture, nullptr, entry.Descriptor.Cpu);
+
+    const uint32 slot = entry.Descriptor.Index;
+    m_Textures.push_back(std::move(entry));
+    return slot;
+}
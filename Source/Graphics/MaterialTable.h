@@ -0,0 +1,52 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Graphics/DescriptorAllocator.h"
+#include "Graphics/Material.h"
+#include "Graphics/MaterialEntries.h"
+
+// Every material of the scene in one StructuredBuffer<MaterialData>, indexed by the MaterialIndex of ObjectData, so
+// draws no longer bind a constant buffer per material. Equal materials share an entry and every texture gets one
+// persistent SRV, which the entries reference by heap slot. Entries never change once added, so the buffer stays in
+// the upload heap, persistently mapped, and new ones can be appended while earlier frames still read the table.
+// Deduplication lives in MaterialEntries. Not thread safe, materials are added at load time
+class MaterialTable
+{
+public:
+    // Entry of a default Material{}, also used by meshes created without a table
+    static constexpr uint32 s_DefaultMaterial = 0;
+
+    void Initialize(ID3D12Device* device, DescriptorAllocator* descriptors, uint32 capacity = 4096);
+    void Release();
+
+    // Index of the entry equal to the material, added when there is none. Throws when the table is full
+    uint32 Add(const Material& material);
+
+    // Binds the table (t1) and the texture descriptor table over the whole heap (t0, space1), root parameters 2 and 3 of
+    // MeshPipeline. Call after binding the pipeline, with the descriptor heap of the allocator set on the command list
+    void Bind(ID3D12GraphicsCommandList* commandList) const;
+
+    uint32 GetCount() const { return m_Entries.GetCount(); }
+    uint32 GetCapacity() const { return m_Entries.GetCapacity(); }
+    uint32 GetTextureCount() const { return m_Entries.GetTextureCount(); }
+    const MaterialData& GetEntry(uint32 index) const { return m_Entries.GetEntry(index); }
+
+private:
+    struct Texture
+    {
+        ComPtr<ID3D12Resource> Resource;
+        DescriptorRange Descriptor;
+    };
+
+    // Persistent SRV of a texture the entries have not referenced yet
+    uint32 CreateTextureSlot(ID3D12Resource* texture);
+
+    ComPtr<ID3D12Device> m_Device;
+    DescriptorAllocator* m_Descriptors = nullptr;
+    ComPtr<ID3D12Resource> m_Buffer;
+    MaterialData* m_MappedData = nullptr;
+
+    MaterialEntries m_Entries;
+    Vector<Texture> m_Textures;
+};
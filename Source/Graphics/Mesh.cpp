@@ -1,14 +1,109 @@
 #include "Mesh.h"
+#include "MaterialTable.h"
+#include "StagingUploader.h"
+#include "VertexCompression.h"
 #include "directx/d3dx12.h"
 
-Mesh::Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device)
+uint32 Mesh::AddMaterial(MaterialTable* materials, const Material& material)
 {
-    const auto& vertices = meshTemplate.GetVertices();
-    const auto& indices = meshTemplate.GetIndices();
-    m_IndexCount = static_cast<uint>(indices.size());
+    return materials ? materials->Add(material) : MaterialTable::s_DefaultMaterial;
+}
+
+Mesh::IndexData Mesh::GetIndexData(const MeshTemplate& meshTemplate)
+{
+    IndexData indices;
+    indices.Format = meshTemplate.GetIndexFormat();
+    indices.Count = static_cast<uint32>(meshTemplate.GetIndexCount());
+    indices.Data = indices.Format == IndexFormat::UInt16
+        ? static_cast<const void*>(meshTemplate.GetIndices16().data())
+        : static_cast<const void*>(meshTemplate.GetIndices32().data());
+    return indices;
+}
+
+Mesh::Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device, VertexFormat format, StagingUploader* uploader, MaterialTable* materials)
+    : m_BoundingSphere(ComputeBoundingSphere(meshTemplate.GetVertices())), m_MaterialIndex(AddMaterial(materials, meshTemplate.GetMaterial()))
+{
+    const IndexData indices = GetIndexData(meshTemplate);
+    if (format == VertexFormat::Float32)
+    {
+        CreateBuffers(meshTemplate.GetVertices().data(), static_cast<uint32>(meshTemplate.GetVertexCount()), sizeof(MeshVertex),
+            indices, meshTemplate.GetSubmeshes(), device, uploader);
+        return;
+    }
+
+    const CompressedVertices compressed = CompressVertices(meshTemplate, format);
+    m_VertexFormat = format;
+    m_PositionDequantization = compressed.Dequantization;
+    CreateBuffers(compressed.Data.data(), compressed.VertexCount, compressed.Stride, indices, meshTemplate.GetSubmeshes(), device, uploader);
+}
+
+Mesh::Mesh(Span<const MeshVertex> vertices, Span<const uint32> indices, const Material& material, ID3D12Device* device, StagingUploader* uploader,
+    MaterialTable* materials)
+    : m_BoundingSphere(ComputeBoundingSphere(vertices)), m_MaterialIndex(AddMaterial(materials, material))
+{
+    if (vertices.size() <= s_MaxVerticesPer16BitIndex && SelectIndexFormat(indices) == IndexFormat::UInt16)
+    {
+        const Vector<uint16> narrow = NarrowIndices(indices);
+        CreateBuffers(vertices.data(), static_cast<uint32>(vertices.size()), sizeof(MeshVertex),
+            IndexData{ narrow.data(), static_cast<uint32>(narrow.size()), IndexFormat::UInt16 }, {}, device, uploader);
+        return;
+    }
+
+    CreateBuffers(vertices.data(), static_cast<uint32>(vertices.size()), sizeof(MeshVertex),
+        IndexData{ indices.data(), static_cast<uint32>(indices.size()), IndexFormat::UInt32 }, {}, device, uploader);
+}
+
+Mesh::Mesh(Span<const MeshVertex> vertices, Span<const uint16> indices, const Material& material, ID3D12Device* device, StagingUploader* uploader,
+    MaterialTable* materials)
+    : m_BoundingSphere(ComputeBoundingSphere(vertices)), m_MaterialIndex(AddMaterial(materials, material))
+{
+    CreateBuffers(vertices.data(), static_cast<uint32>(vertices.size()), sizeof(MeshVertex),
+        IndexData{ indices.data(), static_cast<uint32>(indices.size()), IndexFormat::UInt16 }, {}, device, uploader);
+}
+
+Mesh::Mesh(const CompressedVertices& vertices, Span<const uint32> indices, const Material& material, ID3D12Device* device,
+    StagingUploader* uploader, MaterialTable* materials)
+    : m_VertexFormat(vertices.Format), m_PositionDequantization(vertices.Dequantization), m_MaterialIndex(AddMaterial(materials, material))
+{
+    // The quantization box encloses every position
+    const float3 center = vertices.Dequantization.Offset + vertices.Dequantization.Scale * 0.5f;
+    m_BoundingSphere = float4{ center.x, center.y, center.z, Length(vertices.Dequantization.Scale) * 0.5f };
+
+    if (SelectIndexFormat(indices) == IndexFormat::UInt16)
+    {
+        const Vector<uint16> narrow = NarrowIndices(indices);
+        CreateBuffers(vertices.Data.data(), vertices.VertexCount, vertices.Stride,
+            IndexData{ narrow.data(), static_cast<uint32>(narrow.size()), IndexFormat::UInt16 }, {}, device, uploader);
+        return;
+    }
+
+    CreateBuffers(vertices.Data.data(), vertices.VertexCount, vertices.Stride,
+        IndexData{ indices.data(), static_cast<uint32>(indices.size()), IndexFormat::UInt32 }, {}, device, uploader);
+}
+
+void Mesh::CreateBuffers(const void* vertexData, uint32 vertexCount, uint32 vertexStride, const IndexData& indices, Span<const Submesh> submeshes,
+    ID3D12Device* device, StagingUploader* uploader)
+{
+    m_IndexCount = static_cast<uint>(indices.Count);
+    m_IndexFormat = indices.Format;
+    m_Submeshes.assign(submeshes.begin(), submeshes.end());
+
+    const UINT vertexBufferSize = vertexCount * vertexStride;
+    const UINT indexBufferSize = indices.Count * (indices.Format == IndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32));
+
+    // Default heap buffers filled through the staging uploader, the index buffer is queued last so its ticket covers both
+    if (uploader)
+    {
+        m_Uploader = uploader;
+        m_Allocator = uploader->GetAllocator();
+        m_VertexAllocation = uploader->CreateBuffer(vertexData, vertexBufferSize, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, m_UploadTicket);
+        m_IndexAllocation = uploader->CreateBuffer(indices.Data, indexBufferSize, D3D12_RESOURCE_STATE_INDEX_BUFFER, m_UploadTicket);
+        m_VertexBuffer = m_VertexAllocation.Resource;
+        m_IndexBuffer = m_IndexAllocation.Resource;
+    }
 
     // Create vertex buffer
-    const UINT vertexBufferSize = vertices.size() * sizeof(MeshVertex);
+    if (!uploader)
     {
         // Create default heap buffer
         auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
@@ -28,18 +123,19 @@ Mesh::Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device)
             HRESULT hr = m_VertexBuffer->Map(0, &readRange, &pData);
             if (FAILED(hr))
                 throw std::runtime_error("Failed to map frame data buffer");
-            memcpy(pData, vertices.data(), vertexBufferSize);
+            memcpy(pData, vertexData, vertexBufferSize);
             m_VertexBuffer->Unmap(0, nullptr);
         }
 
-        // Setup vertex buffer view
-        m_VertexBufferView.BufferLocation = m_VertexBuffer->GetGPUVirtualAddress();
-        m_VertexBufferView.StrideInBytes = sizeof(MeshVertex);
-        m_VertexBufferView.SizeInBytes = vertexBufferSize;
     }
 
+    // Setup vertex buffer view
+    m_VertexBufferView.BufferLocation = uploader ? m_VertexAllocation.GpuAddress : m_VertexBuffer->GetGPUVirtualAddress();
+    m_VertexBufferView.StrideInBytes = vertexStride;
+    m_VertexBufferView.SizeInBytes = vertexBufferSize;
+
     // Create index buffer
-    const UINT indexBufferSize = indices.size() * sizeof(uint32_t);
+    if (!uploader)
     {
         // Create default heap buffer
         auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
@@ -59,52 +155,58 @@ Mesh::Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device)
             HRESULT hr = m_IndexBuffer->Map(0, &readRange, &pData);
             if (FAILED(hr))
                 throw std::runtime_error("Failed to map frame data buffer");
-            memcpy(pData, indices.data(), indexBufferSize);
+            memcpy(pData, indices.Data, indexBufferSize);
             m_IndexBuffer->Unmap(0, nullptr);
         }
 
-        // Setup index buffer view
-        m_IndexBufferView.BufferLocation = m_IndexBuffer->GetGPUVirtualAddress();
-        m_IndexBufferView.Format = DXGI_FORMAT_R32_UINT;
-        m_IndexBufferView.SizeInBytes = indexBufferSize;
     }
 
-    // Create material buffer
-    {
-        // Create default heap buffer
-        auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-        auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(sizeof(Material));
-        device->CreateCommittedResource(
-            &heapProperties,
-            D3D12_HEAP_FLAG_NONE,
-            &resourceDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_MaterialBuffer));
+    // Setup index buffer view
+    m_IndexBufferView.BufferLocation = uploader ? m_IndexAllocation.GpuAddress : m_IndexBuffer->GetGPUVirtualAddress();
+    m_IndexBufferView.Format = indices.Format == IndexFormat::UInt16 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+    m_IndexBufferView.SizeInBytes = indexBufferSize;
+}
 
-        // Copy data to the buffer
-        {
-            void* pData;
-            CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resource on the CPU.
-            HRESULT hr = m_MaterialBuffer->Map(0, &readRange, &pData);
-            if (FAILED(hr))
-                throw std::runtime_error("Failed to map frame data buffer");
-            Material material = meshTemplate.GetMaterial();
-            MaterialData materialData{};
-            materialData.Albedo = material.Albedo;
-            materialData.Metallic = material.Metallic;
-            materialData.Roughness = material.Roughness;
-            memcpy(pData, &materialData, sizeof(MaterialData));
-            m_MaterialBuffer->Unmap(0, nullptr);
-        }
+Mesh::~Mesh()
+{
+    // The ranges may be handed out again right away, a pending copy must not land in them later
+    if (m_Allocator)
+    {
+        m_Uploader->CancelUploads(m_VertexAllocation);
+        m_Uploader->CancelUploads(m_IndexAllocation);
+        m_Allocator->Free(m_VertexAllocation);
+        m_Allocator->Free(m_IndexAllocation);
     }
 }
 
+bool Mesh::IsResident() const
+{
+    return !m_Uploader || m_Uploader->IsUploaded(m_UploadTicket);
+}
+
 void Mesh::Draw(ID3D12GraphicsCommandList* commandList) const
 {
-    commandList->SetGraphicsRootConstantBufferView(2, m_MaterialBuffer->GetGPUVirtualAddress());
+    BindBuffers(commandList);
+    DrawIndexed(commandList);
+}
+
+void Mesh::BindBuffers(ID3D12GraphicsCommandList* commandList) const
+{
     commandList->IASetVertexBuffers(0, 1, &m_VertexBufferView);
     commandList->IASetIndexBuffer(&m_IndexBufferView);
     commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    commandList->DrawIndexedInstanced(m_IndexCount, 1, 0, 0, 0);
+}
+
+void Mesh::DrawIndexed(ID3D12GraphicsCommandList* commandList, uint32 instanceCount) const
+{
+    if (m_Submeshes.empty())
+    {
+        commandList->DrawIndexedInstanced(m_IndexCount, instanceCount, 0, 0, 0);
+        return;
+    }
+
+    for (const Submesh& submesh : m_Submeshes)
+    {
+        commandList->DrawIndexedInstanced(submesh.IndexCount, instanceCount, submesh.IndexOffset, submesh.BaseVertex, 0);
+    }
 }
@@ -5,6 +5,7 @@
 #include <d3d12.h>
 
 #include "Engine/BaseTypes.h"
+#include "Graphics/GpuMemoryAllocator.h"
 #include "Graphics/Material.h"
 
 // Vertex: position + normal + uv
@@ -15,11 +16,69 @@ struct MeshVertex
     float2 Uv;
 };
 
+// Vertex encodings, see Graphics/VertexCompression.h
+enum class VertexFormat : uint8
+{
+    Float32,        // MeshVertex, 32 bytes
+    Quantized16,    // QuantizedVertex, 16 bytes: 16-bit AABB positions, 2x16 octahedral normal, half UV
+    Quantized8,     // QuantizedVertexOct8, 12 bytes: as above with a 2x8 octahedral normal
+};
+
+// Maps decoded UNORM positions back to object space: position = Offset + unorm * Scale.
+// Folded into the model matrix so the vertex shader reads the positions as is
+struct PositionDequantization
+{
+    float3 Offset = { 0.0f, 0.0f, 0.0f };
+    float3 Scale = { 1.0f, 1.0f, 1.0f };
+};
+
+struct CompressedVertices;
+class MaterialTable;
+class StagingUploader;
+
+// Index buffer element type. Meshes with at most 65536 vertices use 16-bit indices
+enum class IndexFormat : uint8
+{
+    UInt16,
+    UInt32,
+};
+
+constexpr size_t s_MaxVerticesPer16BitIndex = 65536;
+
+// Range drawn with one DrawIndexedInstanced call, indices are relative to BaseVertex
+struct Submesh
+{
+    uint32 IndexOffset = 0;
+    uint32 IndexCount = 0;
+    int32 BaseVertex = 0;
+};
+
+// Narrowest format able to address every index in the list
+IndexFormat SelectIndexFormat(Span<const uint32> indices);
+Vector<uint16> NarrowIndices(Span<const uint32> indices);
+
+// Sphere around the AABB center of the positions: xyz center, w radius. Zero for an empty span
+float4 ComputeBoundingSphere(Span<const MeshVertex> vertices);
+
+// CPU-side vertices, indices and material of a mesh. Its functions and the ones above are defined in MeshTemplate.cpp,
+// which needs no device
 class MeshTemplate
 {
 public:
     MeshTemplate() = default;
 
+    MeshTemplate(Span<const MeshVertex> vertices, Span<const uint32> indices)
+        : m_Vertices(vertices.begin(), vertices.end())
+    {
+        SetIndices(indices);
+    }
+
+    MeshTemplate(Span<const MeshVertex> vertices, Span<const uint16> indices)
+        : m_Vertices(vertices.begin(), vertices.end()),
+        m_Indices16(indices.begin(), indices.end())
+    {
+    }
+
     void AddVertex(const MeshVertex& v)
     {
         m_Vertices.push_back(v);
@@ -27,47 +86,156 @@ public:
 
     void AddTriangle(uint32_t i0, uint32_t i1, uint32_t i2)
     {
-        m_Indices.push_back(i0);
-        m_Indices.push_back(i1);
-        m_Indices.push_back(i2);
+        if (m_IndexFormat == IndexFormat::UInt16 && std::max({ i0, i1, i2 }) > 0xFFFF)
+        {
+            WidenIndices();
+        }
+
+        if (m_IndexFormat == IndexFormat::UInt16)
+        {
+            m_Indices16.push_back(static_cast<uint16>(i0));
+            m_Indices16.push_back(static_cast<uint16>(i1));
+            m_Indices16.push_back(static_cast<uint16>(i2));
+        }
+        else
+        {
+            m_Indices32.push_back(i0);
+            m_Indices32.push_back(i1);
+            m_Indices32.push_back(i2);
+        }
     }
 
+    // Replaces the index list, stored as 16-bit when every index fits
+    void SetIndices(Span<const uint32> indices);
+
+    // Replaces the vertex list, the caller keeps the indices and submeshes consistent with it
+    void SetVertices(Vector<MeshVertex> vertices) { m_Vertices = std::move(vertices); }
+
+    // Sets the draw ranges after SetIndices, which clears them
+    void SetSubmeshes(Span<const Submesh> submeshes) { m_Submeshes.assign(submeshes.begin(), submeshes.end()); }
+
+    // Writes back an edited copy of CopyIndices() with the same length, keeping the index format and submesh ranges
+    void ReorderIndices(Span<const uint32> indices);
+
     void SetMaterial(const Material& material)
     {
         m_Material = material;
     }
 
+    // Re-packs a mesh with more than 65536 vertices into submeshes that each address at most 65536 vertices
+    // through BaseVertex, so the whole mesh uses a 16-bit index buffer. Vertices shared across a split are duplicated
+    void SplitInto16BitSubmeshes();
+
     const Vector<MeshVertex>& GetVertices() const { return m_Vertices; }
-    const Vector<uint32>& GetIndices() const { return m_Indices; }
     size_t GetVertexCount() const { return m_Vertices.size(); }
-    size_t GetIndexCount() const { return m_Indices.size(); }
+
+    IndexFormat GetIndexFormat() const { return m_IndexFormat; }
+    Span<const uint16> GetIndices16() const { return m_Indices16; }
+    Span<const uint32> GetIndices32() const { return m_Indices32; }
+    size_t GetIndexCount() const { return m_IndexFormat == IndexFormat::UInt16 ? m_Indices16.size() : m_Indices32.size(); }
+    uint32 GetIndex(size_t i) const { return m_IndexFormat == IndexFormat::UInt16 ? m_Indices16[i] : m_Indices32[i]; }
+
+    // Indices widened to 32 bits, relative to the submesh BaseVertex when split
+    Vector<uint32> CopyIndices() const;
+
+    // Empty unless SplitInto16BitSubmeshes created more than one range
+    const Vector<Submesh>& GetSubmeshes() const { return m_Submeshes; }
+
     const Material& GetMaterial() const { return m_Material; }
 
 
 private:
+    void WidenIndices();
+
     Vector<MeshVertex> m_Vertices;
-    Vector<uint32> m_Indices;
+    Vector<uint16> m_Indices16;
+    Vector<uint32> m_Indices32;
+    IndexFormat m_IndexFormat = IndexFormat::UInt16;
+    Vector<Submesh> m_Submeshes;
     Material m_Material;
 };
 
+// Vertex and index buffers live in the default heap when created with a StagingUploader, which places them through
+// its GpuMemoryAllocator and fills them over the next frames; without one they stay in the upload heap, readable right
+// away but fetched over PCIe on every draw. The material is added to the MaterialTable passed in, the mesh keeps its index;
+// without a table it draws with MaterialTable::s_DefaultMaterial
 class Mesh
 {
 public:
-    Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device);
+    Mesh(const MeshTemplate& meshTemplate, ID3D12Device* device, VertexFormat format = VertexFormat::Float32, StagingUploader* uploader = nullptr,
+        MaterialTable* materials = nullptr);
 
+    // Uploads the data directly, e.g. from a constexpr table in Graphics/PrimitiveTables.h.
+    // 32-bit indices are narrowed to a 16-bit buffer when they fit
+    Mesh(Span<const MeshVertex> vertices, Span<const uint32> indices, const Material& material, ID3D12Device* device,
+        StagingUploader* uploader = nullptr, MaterialTable* materials = nullptr);
+    Mesh(Span<const MeshVertex> vertices, Span<const uint16> indices, const Material& material, ID3D12Device* device,
+        StagingUploader* uploader = nullptr, MaterialTable* materials = nullptr);
+
+    // Uploads an encoded stream from CompressVertices, drawn with the pipeline of the same VertexFormat
+    Mesh(const CompressedVertices& vertices, Span<const uint32> indices, const Material& material, ID3D12Device* device,
+        StagingUploader* uploader = nullptr, MaterialTable* materials = nullptr);
+
+    // Frees the placed buffers and drops their uploads still pending, the GPU must be done with them
+    ~Mesh();
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    // Draw binds the buffers and then draws. A sorted draw list binds them only when they change. The material table
+    // is bound with the pipeline, the shaders pick the entry through the MaterialIndex of the object data
     void Draw(ID3D12GraphicsCommandList* commandList) const;
+    void BindBuffers(ID3D12GraphicsCommandList* commandList) const;
+    // Instanced draws read their per-instance constants through SV_InstanceID, which starts at 0 for every call
+    void DrawIndexed(ID3D12GraphicsCommandList* commandList, uint32 instanceCount = 1) const;
 
+    // False until the staging upload of the buffers was recorded, the mesh must not be drawn before
+    bool IsResident() const;
+
+    VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+    IndexFormat GetIndexFormat() const { return m_IndexFormat; }
+    uint32 GetIndexCount() const { return m_IndexCount; }
+    const PositionDequantization& GetPositionDequantization() const { return m_PositionDequantization; }
+    // Object-space bounds, xyz center and w radius
+    const float4& GetBoundingSphere() const { return m_BoundingSphere; }
+
+    // Small placed buffers share their resource with others, the views hold their offsets
     const ComPtr<ID3D12Resource>& GetVertexBuffer() const { return m_VertexBuffer; }
     const ComPtr<ID3D12Resource>& GetIndexBuffer() const { return m_IndexBuffer; }
     const D3D12_VERTEX_BUFFER_VIEW& GetVertexBufferView() const { return m_VertexBufferView; }
     const D3D12_INDEX_BUFFER_VIEW& GetIndexBufferView() const { return m_IndexBufferView; }
+    uint32 GetMaterialIndex() const { return m_MaterialIndex; }
 
 private:
+    struct IndexData
+    {
+        const void* Data = nullptr;
+        uint32 Count = 0;
+        IndexFormat Format = IndexFormat::UInt16;
+    };
+
+    static IndexData GetIndexData(const MeshTemplate& meshTemplate);
+    static uint32 AddMaterial(MaterialTable* materials, const Material& material);
+
+    void CreateBuffers(const void* vertexData, uint32 vertexCount, uint32 vertexStride, const IndexData& indices, Span<const Submesh> submeshes,
+        ID3D12Device* device, StagingUploader* uploader);
+
     ComPtr<ID3D12Resource> m_VertexBuffer = nullptr;
     ComPtr<ID3D12Resource> m_IndexBuffer = nullptr;
-    ComPtr<ID3D12Resource> m_MaterialBuffer = nullptr;
     D3D12_VERTEX_BUFFER_VIEW m_VertexBufferView = {};
     D3D12_INDEX_BUFFER_VIEW m_IndexBufferView = {};
 
     uint m_IndexCount = 0;
+    IndexFormat m_IndexFormat = IndexFormat::UInt32;
+    Vector<Submesh> m_Submeshes;
+
+    VertexFormat m_VertexFormat = VertexFormat::Float32;
+    PositionDequantization m_PositionDequantization;
+    float4 m_BoundingSphere = { 0.0f, 0.0f, 0.0f, 0.0f };
+    uint32 m_MaterialIndex = 0;
+
+    StagingUploader* m_Uploader = nullptr;
+    uint64 m_UploadTicket = 0;
+    GpuMemoryAllocator* m_Allocator = nullptr;
+    GpuAllocation m_VertexAllocation;
+    GpuAllocation m_IndexAllocation;
 };
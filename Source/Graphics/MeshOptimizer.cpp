@@ -0,0 +1,785 @@
+#include "MeshOptimizer.h"
+
+#include <bit>
+#include <cfloat>
+
+#include "Engine/Parallel.h"
+
+namespace
+{
+    struct CacheCounts
+    {
+        size_t Misses = 0;
+        size_t Triangles = 0;
+        size_t ReferencedVertices = 0;
+    };
+
+    // FIFO cache simulation, the model used by most fixed-function post-transform caches
+    CacheCounts SimulateVertexCache(Span<const uint32> indices, size_t vertexCount, uint32 cacheSize)
+    {
+        CacheCounts counts;
+        counts.Triangles = indices.size() / 3;
+
+        // Timestamp of the vertex's last insertion, a vertex is cached while fewer than cacheSize misses happened since
+        Vector<size_t> insertedAt(vertexCount, 0);
+        Vector<bool> referenced(vertexCount, false);
+        for (uint32 index : indices)
+        {
+            if (index >= vertexCount)
+                throw std::out_of_range("AnalyzeVertexCache: index exceeds the vertex count");
+
+            if (!referenced[index])
+            {
+                referenced[index] = true;
+                counts.ReferencedVertices++;
+            }
+
+            if (insertedAt[index] == 0 || counts.Misses - insertedAt[index] >= cacheSize)
+            {
+                counts.Misses++;
+                insertedAt[index] = counts.Misses;
+            }
+        }
+        return counts;
+    }
+
+    VertexCacheStats ToStats(const CacheCounts& counts, uint32 cacheSize)
+    {
+        VertexCacheStats stats;
+        stats.CacheSize = cacheSize;
+        stats.Acmr = counts.Triangles ? float(counts.Misses) / counts.Triangles : 0.0f;
+        stats.Atvr = counts.ReferencedVertices ? float(counts.Misses) / counts.ReferencedVertices : 0.0f;
+        return stats;
+    }
+
+    // Incremental FIFO cache for the overdraw pass, same model as SimulateVertexCache
+    class CacheSimulator
+    {
+    public:
+        CacheSimulator(size_t vertexCount, uint32 cacheSize)
+            : m_InsertedAt(vertexCount, 0), m_CacheSize(cacheSize)
+        {
+        }
+
+        void Reset()
+        {
+            // Moving the clock past every stored timestamp empties the cache without touching the array
+            m_Misses += m_CacheSize;
+        }
+
+        uint32 AddTriangle(const uint32* triangle)
+        {
+            uint32 misses = 0;
+            for (size_t k = 0; k < 3; ++k)
+            {
+                size_t& insertedAt = m_InsertedAt[triangle[k]];
+                if (insertedAt == 0 || m_Misses - insertedAt >= m_CacheSize)
+                {
+                    m_Misses++;
+                    insertedAt = m_Misses;
+                    misses++;
+                }
+            }
+            return misses;
+        }
+
+    private:
+        Vector<size_t> m_InsertedAt;
+        size_t m_Misses = 0;
+        uint32 m_CacheSize;
+    };
+
+    float3 TriangleNormal(const float3& a, const float3& b, const float3& c)
+    {
+        // Left-handed with clockwise front faces, so the plain cross product points out of the front face
+        return Cross(b - a, c - a);
+    }
+
+    // Software rasterizer for AnalyzeOverdraw: orthographic view along direction, depth test LESS, back faces culled
+    void RasterizeOverdraw(Span<const MeshVertex> vertices, Span<const uint32> indices, const float3& direction,
+        const float3& center, float radius, uint32 resolution, uint64& covered, uint64& shaded)
+    {
+        // Orthonormal basis with the view looking along direction
+        const float3 helper = std::fabs(direction.y) < 0.99f ? float3{ 0.0f, 1.0f, 0.0f } : float3{ 1.0f, 0.0f, 0.0f };
+        const float3 right = Normalize(Cross(helper, direction));
+        const float3 up = Cross(direction, right);
+        const float scale = resolution / (2.0f * radius);
+
+        Vector<float> depth(size_t(resolution) * resolution, std::numeric_limits<float>::infinity());
+        Vector<uint32> writes(size_t(resolution) * resolution, 0);
+
+        for (size_t t = 0; t + 2 < indices.size(); t += 3)
+        {
+            const float3& p0 = vertices[indices[t]].Position;
+            const float3& p1 = vertices[indices[t + 1]].Position;
+            const float3& p2 = vertices[indices[t + 2]].Position;
+            if (Dot(TriangleNormal(p0, p1, p2), direction) >= 0.0f)
+                continue;
+
+            float x[3], y[3], z[3];
+            const float3* p[3] = { &p0, &p1, &p2 };
+            for (int k = 0; k < 3; ++k)
+            {
+                const float3 d = *p[k] - center;
+                x[k] = (Dot(d, right) + radius) * scale;
+                y[k] = (Dot(d, up) + radius) * scale;
+                z[k] = Dot(d, direction);
+            }
+
+            float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+            if (area == 0.0f)
+                continue;
+            if (area < 0.0f)
+            {
+                std::swap(x[1], x[2]);
+                std::swap(y[1], y[2]);
+                std::swap(z[1], z[2]);
+                area = -area;
+            }
+
+            const int32 minX = std::max(0, int32(std::floor(std::min({ x[0], x[1], x[2] }))));
+            const int32 maxX = std::min(int32(resolution) - 1, int32(std::ceil(std::max({ x[0], x[1], x[2] }))));
+            const int32 minY = std::max(0, int32(std::floor(std::min({ y[0], y[1], y[2] }))));
+            const int32 maxY = std::min(int32(resolution) - 1, int32(std::ceil(std::max({ y[0], y[1], y[2] }))));
+            const float invArea = 1.0f / area;
+
+            for (int32 py = minY; py <= maxY; ++py)
+            {
+                for (int32 px = minX; px <= maxX; ++px)
+                {
+                    // Edge functions at the pixel center
+                    const float cx = px + 0.5f, cy = py + 0.5f;
+                    const float w0 = (x[2] - x[1]) * (cy - y[1]) - (y[2] - y[1]) * (cx - x[1]);
+                    const float w1 = (x[0] - x[2]) * (cy - y[2]) - (y[0] - y[2]) * (cx - x[2]);
+                    const float w2 = (x[1] - x[0]) * (cy - y[0]) - (y[1] - y[0]) * (cx - x[0]);
+                    if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                        continue;
+
+                    const float pixelDepth = (w0 * z[0] + w1 * z[1] + w2 * z[2]) * invArea;
+                    const size_t pixel = size_t(py) * resolution + px;
+                    if (pixelDepth < depth[pixel])
+                    {
+                        depth[pixel] = pixelDepth;
+                        writes[pixel]++;
+                    }
+                }
+            }
+        }
+
+        for (uint32 w : writes)
+        {
+            covered += w > 0 ? 1 : 0;
+            shaded += w;
+        }
+    }
+
+    // Bit pattern of a vertex for exact welding, so -0 and 0 or different NaNs stay apart
+    struct VertexBits
+    {
+        std::array<uint32, sizeof(MeshVertex) / sizeof(uint32)> Words;
+
+        bool operator==(const VertexBits& other) const { return Words == other.Words; }
+    };
+    static_assert(sizeof(MeshVertex) % sizeof(uint32) == 0, "MeshVertex must be made of 32-bit words");
+
+    struct VertexBitsHash
+    {
+        size_t operator()(const VertexBits& bits) const noexcept
+        {
+            // FNV-1a over the words
+            uint64 hash = 14695981039346656037ull;
+            for (uint32 word : bits.Words)
+            {
+                hash ^= word;
+                hash *= 1099511628211ull;
+            }
+            return static_cast<size_t>(hash);
+        }
+    };
+
+    struct CellKey
+    {
+        int64 X, Y, Z;
+
+        bool operator==(const CellKey& other) const { return X == other.X && Y == other.Y && Z == other.Z; }
+    };
+
+    struct CellKeyHash
+    {
+        size_t operator()(const CellKey& key) const noexcept
+        {
+            // Unsigned, so large cell coordinates wrap instead of overflowing
+            return static_cast<size_t>(uint64(key.X) * 73856093ull ^ uint64(key.Y) * 19349663ull ^ uint64(key.Z) * 83492791ull);
+        }
+    };
+
+    bool WithinTolerance(const MeshVertex& a, const MeshVertex& b, const WeldOptions& options)
+    {
+        auto close = [](float x, float y, float epsilon) { return std::fabs(x - y) <= epsilon; };
+        return close(a.Position.x, b.Position.x, options.PositionEpsilon)
+            && close(a.Position.y, b.Position.y, options.PositionEpsilon)
+            && close(a.Position.z, b.Position.z, options.PositionEpsilon)
+            && close(a.Normal.x, b.Normal.x, options.NormalEpsilon)
+            && close(a.Normal.y, b.Normal.y, options.NormalEpsilon)
+            && close(a.Normal.z, b.Normal.z, options.NormalEpsilon)
+            && close(a.Uv.x, b.Uv.x, options.UvEpsilon)
+            && close(a.Uv.y, b.Uv.y, options.UvEpsilon);
+    }
+
+    int64 SkipDeadEnd(Vector<uint32>& deadEnds, const Vector<uint32>& liveTriangles, uint32& cursor, size_t vertexCount)
+    {
+        while (!deadEnds.empty())
+        {
+            const uint32 v = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[v] > 0)
+                return v;
+        }
+        for (; cursor < vertexCount; ++cursor)
+        {
+            if (liveTriangles[cursor] > 0)
+                return cursor;
+        }
+        return -1;
+    }
+}
+
+VertexCacheStats AnalyzeVertexCache(Span<const uint32> indices, size_t vertexCount, uint32 cacheSize)
+{
+    return ToStats(SimulateVertexCache(indices, vertexCount, cacheSize), cacheSize);
+}
+
+void OptimizeVertexCache(Span<const uint32> indices, size_t vertexCount, Span<uint32> outIndices, uint32 cacheSize)
+{
+    if (indices.size() % 3 != 0)
+        throw std::invalid_argument("OptimizeVertexCache: index count must be a multiple of 3");
+    if (outIndices.size() != indices.size())
+        throw std::invalid_argument("OptimizeVertexCache: output size differs from input");
+
+    const size_t triangleCount = indices.size() / 3;
+
+    // Vertex -> triangle adjacency in CSR form
+    Vector<uint32> liveTriangles(vertexCount, 0);
+    for (uint32 index : indices)
+    {
+        if (index >= vertexCount)
+            throw std::out_of_range("OptimizeVertexCache: index exceeds the vertex count");
+        liveTriangles[index]++;
+    }
+
+    Vector<uint32> adjacencyOffsets(vertexCount + 1, 0);
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+    Vector<uint32> adjacency(indices.size());
+    {
+        Vector<uint32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32>(t);
+        }
+    }
+
+    // The input is read until the very end, so write to a copy when the spans alias
+    Vector<uint32> output;
+    output.reserve(indices.size());
+
+    Vector<uint32> cacheTime(vertexCount, 0);
+    Vector<bool> emitted(triangleCount, false);
+    Vector<uint32> deadEnds;
+    Vector<uint32> candidates;
+    uint32 time = cacheSize + 1;
+    uint32 cursor = 0;
+
+    int64 fan = SkipDeadEnd(deadEnds, liveTriangles, cursor, vertexCount);
+    while (fan >= 0)
+    {
+        candidates.clear();
+
+        for (uint32 a = adjacencyOffsets[fan]; a < adjacencyOffsets[fan + 1]; ++a)
+        {
+            const uint32 t = adjacency[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const uint32 v = indices[t * 3 + k];
+                output.push_back(v);
+                deadEnds.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time;
+                    time++;
+                }
+            }
+        }
+
+        // Prefer the candidate that stays in the cache longest while its remaining triangles are emitted
+        int64 next = -1;
+        int64 bestPriority = -1;
+        for (uint32 v : candidates)
+        {
+            if (liveTriangles[v] == 0)
+                continue;
+
+            int64 priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                priority = time - cacheTime[v];
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        fan = next >= 0 ? next : SkipDeadEnd(deadEnds, liveTriangles, cursor, vertexCount);
+    }
+
+    std::copy(output.begin(), output.end(), outIndices.begin());
+}
+
+VertexCacheReport OptimizeVertexCache(MeshTemplate& meshTemplate, uint32 cacheSize)
+{
+    Vector<uint32> indices = meshTemplate.CopyIndices();
+
+    Vector<Submesh> ranges = meshTemplate.GetSubmeshes();
+    if (ranges.empty())
+        ranges.push_back(Submesh{ 0, static_cast<uint32>(indices.size()), 0 });
+
+    // Submesh indices are relative to BaseVertex, so each range is an independent problem sized by its largest index
+    Vector<CacheCounts> before(ranges.size());
+    Vector<CacheCounts> after(ranges.size());
+    ParallelFor(ranges.size(), [&](size_t r)
+    {
+        const Span<uint32> range(indices.data() + ranges[r].IndexOffset, ranges[r].IndexCount);
+        const size_t vertexCount = range.empty() ? 0 : size_t(*std::max_element(range.begin(), range.end())) + 1;
+
+        before[r] = SimulateVertexCache(range, vertexCount, cacheSize);
+        OptimizeVertexCache(range, vertexCount, range, cacheSize);
+        after[r] = SimulateVertexCache(range, vertexCount, cacheSize);
+    });
+
+    meshTemplate.ReorderIndices(indices);
+
+    CacheCounts totalBefore, totalAfter;
+    for (size_t r = 0; r < ranges.size(); ++r)
+    {
+        totalBefore.Misses += before[r].Misses;
+        totalBefore.Triangles += before[r].Triangles;
+        totalBefore.ReferencedVertices += before[r].ReferencedVertices;
+        totalAfter.Misses += after[r].Misses;
+        totalAfter.Triangles += after[r].Triangles;
+        totalAfter.ReferencedVertices += after[r].ReferencedVertices;
+    }
+    return VertexCacheReport{ ToStats(totalBefore, cacheSize), ToStats(totalAfter, cacheSize) };
+}
+
+OverdrawStats AnalyzeOverdraw(Span<const MeshVertex> vertices, Span<const uint32> indices, uint32 viewCount, uint32 resolution)
+{
+    OverdrawStats stats;
+    stats.ViewCount = viewCount;
+    if (vertices.empty() || indices.empty() || viewCount == 0)
+        return stats;
+
+    // Bounding sphere around the AABB center, the views are fitted to it
+    float3 minimum = vertices[0].Position, maximum = vertices[0].Position;
+    for (const MeshVertex& v : vertices)
+    {
+        minimum = { std::min(minimum.x, v.Position.x), std::min(minimum.y, v.Position.y), std::min(minimum.z, v.Position.z) };
+        maximum = { std::max(maximum.x, v.Position.x), std::max(maximum.y, v.Position.y), std::max(maximum.z, v.Position.z) };
+    }
+    const float3 center = (minimum + maximum) * 0.5f;
+    float radius = 0.0f;
+    for (const MeshVertex& v : vertices)
+        radius = std::max(radius, Length(v.Position - center));
+    radius = std::max(radius * 1.01f, 1e-6f);
+
+    Vector<uint64> covered(viewCount, 0), shaded(viewCount, 0);
+    ParallelFor(viewCount, [&](size_t view)
+    {
+        // Fibonacci sphere directions
+        const float z = 1.0f - (2.0f * view + 1.0f) / viewCount;
+        const float r = Sqrt(std::max(0.0f, 1.0f - z * z));
+        const float phi = view * PI * (3.0f - Sqrt(5.0f));
+        const float3 direction{ r * std::cos(phi), r * std::sin(phi), z };
+        RasterizeOverdraw(vertices, indices, direction, center, radius, resolution, covered[view], shaded[view]);
+    });
+
+    for (uint32 view = 0; view < viewCount; ++view)
+    {
+        stats.PixelsCovered += covered[view];
+        stats.PixelsShaded += shaded[view];
+    }
+    stats.Overdraw = stats.PixelsCovered ? float(double(stats.PixelsShaded) / double(stats.PixelsCovered)) : 0.0f;
+    return stats;
+}
+
+void OptimizeOverdraw(Span<const MeshVertex> vertices, Span<const uint32> indices, Span<uint32> outIndices, float threshold, uint32 cacheSize)
+{
+    if (indices.size() % 3 != 0)
+        throw std::invalid_argument("OptimizeOverdraw: index count must be a multiple of 3");
+    if (outIndices.size() != indices.size())
+        throw std::invalid_argument("OptimizeOverdraw: output size differs from input");
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0)
+        return;
+    for (uint32 index : indices)
+    {
+        if (index >= vertices.size())
+            throw std::out_of_range("OptimizeOverdraw: index exceeds the vertex count");
+    }
+
+    // Hard boundaries: triangles that miss on all three vertices, i.e. where the cache-optimized order restarted
+    Vector<uint32> hardBoundaries;
+    {
+        CacheSimulator cache(vertices.size(), cacheSize);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (cache.AddTriangle(&indices[t * 3]) == 3)
+                hardBoundaries.push_back(static_cast<uint32>(t));
+        }
+        if (hardBoundaries.empty() || hardBoundaries[0] != 0)
+            hardBoundaries.insert(hardBoundaries.begin(), 0);
+        hardBoundaries.push_back(static_cast<uint32>(triangleCount));
+    }
+
+    // Soft boundaries split each hard cluster where its running ACMR is already within threshold of the whole run
+    Vector<uint32> clusterStarts;
+    {
+        CacheSimulator cache(vertices.size(), cacheSize);
+        for (size_t h = 0; h + 1 < hardBoundaries.size(); ++h)
+        {
+            const uint32 start = hardBoundaries[h], end = hardBoundaries[h + 1];
+
+            cache.Reset();
+            uint32 runMisses = 0;
+            for (uint32 t = start; t < end; ++t)
+                runMisses += cache.AddTriangle(&indices[t * 3]);
+            const float clusterThreshold = threshold * float(runMisses) / float(end - start);
+
+            clusterStarts.push_back(start);
+            cache.Reset();
+            uint32 misses = 0, triangles = 0;
+            for (uint32 t = start; t < end; ++t)
+            {
+                misses += cache.AddTriangle(&indices[t * 3]);
+                triangles++;
+                if (t + 1 < end && float(misses) / float(triangles) <= clusterThreshold)
+                {
+                    clusterStarts.push_back(t + 1);
+                    cache.Reset();
+                    misses = 0;
+                    triangles = 0;
+                }
+            }
+        }
+        clusterStarts.push_back(static_cast<uint32>(triangleCount));
+    }
+
+    // Sort key: how far the cluster faces away from the mesh center. Outward clusters occlude the rest from most directions
+    float3 meshCenter{ 0.0f, 0.0f, 0.0f };
+    for (const MeshVertex& v : vertices)
+        meshCenter = meshCenter + v.Position;
+    meshCenter = meshCenter / float(vertices.size());
+
+    const size_t clusterCount = clusterStarts.size() - 1;
+    Vector<float> sortKeys(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c)
+    {
+        float3 centroid{ 0.0f, 0.0f, 0.0f };
+        float3 normal{ 0.0f, 0.0f, 0.0f };
+        float totalArea = 0.0f;
+        for (uint32 t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+        {
+            const float3& a = vertices[indices[t * 3]].Position;
+            const float3& b = vertices[indices[t * 3 + 1]].Position;
+            const float3& d = vertices[indices[t * 3 + 2]].Position;
+            const float3 n = TriangleNormal(a, b, d);
+            const float area = Length(n);
+            centroid = centroid + (a + b + d) * (area / 3.0f);
+            normal = normal + n;
+            totalArea += area;
+        }
+
+        const float normalLength = Length(normal);
+        if (totalArea > 0.0f && normalLength > 0.0f)
+            sortKeys[c] = Dot(centroid / totalArea - meshCenter, normal / normalLength);
+        else
+            sortKeys[c] = -std::numeric_limits<float>::infinity();
+    }
+
+    Vector<uint32> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32 a, uint32 b) { return sortKeys[a] > sortKeys[b]; });
+
+    Vector<uint32> output;
+    output.reserve(indices.size());
+    for (uint32 c : order)
+        output.insert(output.end(), indices.begin() + size_t(clusterStarts[c]) * 3, indices.begin() + size_t(clusterStarts[c + 1]) * 3);
+
+    std::copy(output.begin(), output.end(), outIndices.begin());
+}
+
+OverdrawReport OptimizeOverdraw(MeshTemplate& meshTemplate, float threshold, uint32 cacheSize)
+{
+    Vector<uint32> indices = meshTemplate.CopyIndices();
+    const Vector<MeshVertex>& vertices = meshTemplate.GetVertices();
+
+    Vector<Submesh> ranges = meshTemplate.GetSubmeshes();
+    if (ranges.empty())
+        ranges.push_back(Submesh{ 0, static_cast<uint32>(indices.size()), 0 });
+
+    // Analysis runs on absolute indices so that submeshes overdraw each other as they would on screen
+    auto toAbsolute = [&](const Vector<uint32>& relative)
+    {
+        Vector<uint32> absolute(relative.size());
+        for (const Submesh& range : ranges)
+        {
+            for (uint32 i = range.IndexOffset; i < range.IndexOffset + range.IndexCount; ++i)
+                absolute[i] = relative[i] + range.BaseVertex;
+        }
+        return absolute;
+    };
+
+    OverdrawReport report;
+    const Vector<uint32> absoluteBefore = toAbsolute(indices);
+    report.CacheBefore = AnalyzeVertexCache(absoluteBefore, vertices.size(), cacheSize);
+    report.OverdrawBefore = AnalyzeOverdraw(vertices, absoluteBefore);
+
+    ParallelFor(ranges.size(), [&](size_t r)
+    {
+        const Span<uint32> range(indices.data() + ranges[r].IndexOffset, ranges[r].IndexCount);
+        const size_t vertexCount = range.empty() ? 0 : size_t(*std::max_element(range.begin(), range.end())) + 1;
+        const Span<const MeshVertex> rangeVertices(vertices.data() + ranges[r].BaseVertex, vertexCount);
+        OptimizeOverdraw(rangeVertices, range, range, threshold, cacheSize);
+    });
+
+    meshTemplate.ReorderIndices(indices);
+
+    const Vector<uint32> absoluteAfter = toAbsolute(indices);
+    report.CacheAfter = AnalyzeVertexCache(absoluteAfter, vertices.size(), cacheSize);
+    report.OverdrawAfter = AnalyzeOverdraw(vertices, absoluteAfter);
+    return report;
+}
+
+VertexFetchStats AnalyzeVertexFetch(Span<const uint32> indices, size_t vertexCount, size_t vertexStride)
+{
+    // Direct-mapped cache of 64 lines of 64 bytes, small enough that the layout order shows
+    static constexpr size_t s_LineSize = 64;
+    static constexpr size_t s_LineCount = 64;
+
+    VertexFetchStats stats;
+    stats.VertexCount = vertexCount;
+    stats.VertexBytes = vertexCount * vertexStride;
+    stats.TriangleCount = indices.size() / 3;
+
+    std::array<size_t, s_LineCount> lines;
+    lines.fill(~size_t(0));
+    size_t fetchedBytes = 0;
+    for (uint32 index : indices)
+    {
+        const size_t first = index * vertexStride / s_LineSize;
+        const size_t last = ((index + 1) * vertexStride - 1) / s_LineSize;
+        for (size_t line = first; line <= last; ++line)
+        {
+            size_t& slot = lines[line % s_LineCount];
+            if (slot != line)
+            {
+                slot = line;
+                fetchedBytes += s_LineSize;
+            }
+        }
+    }
+
+    stats.Overfetch = stats.VertexBytes ? float(double(fetchedBytes) / double(stats.VertexBytes)) : 0.0f;
+    return stats;
+}
+
+size_t WeldVertices(Span<const MeshVertex> vertices, Span<uint32> remap, const WeldOptions& options)
+{
+    if (remap.size() != vertices.size())
+        throw std::invalid_argument("WeldVertices: remap size differs from the vertex count");
+
+    uint32 uniqueCount = 0;
+    Vector<uint32> representatives;
+    representatives.reserve(vertices.size());
+
+    const bool exact = options.PositionEpsilon <= 0.0f && options.NormalEpsilon <= 0.0f && options.UvEpsilon <= 0.0f;
+    if (exact)
+    {
+        HashMap<VertexBits, uint32, VertexBitsHash> unique;
+        unique.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            const auto [it, inserted] = unique.try_emplace(std::bit_cast<VertexBits>(vertices[i]), uniqueCount);
+            remap[i] = it->second;
+            uniqueCount += inserted ? 1 : 0;
+        }
+        return uniqueCount;
+    }
+
+    // Cells as wide as the position tolerance: a match can only sit in the same or an adjacent cell. Wider cells only
+    // add candidates, so the size is floored at 2^-40 of the largest coordinate to keep the cell coordinates well
+    // inside int64 when the tolerance is tiny or only the normals and UVs have one. Non-finite positions share cell 0
+    float largestCoordinate = 0.0f;
+    for (const MeshVertex& v : vertices)
+    {
+        for (float value : { v.Position.x, v.Position.y, v.Position.z })
+        {
+            if (std::isfinite(value))
+                largestCoordinate = std::max(largestCoordinate, std::fabs(value));
+        }
+    }
+    const float cellSize = std::max({ options.PositionEpsilon, largestCoordinate * 0x1p-40f, FLT_MIN });
+    auto cellOf = [&](float value) { return std::isfinite(value) ? static_cast<int64>(std::floor(value / cellSize)) : 0; };
+
+    HashMap<CellKey, Vector<uint32>, CellKeyHash> cells;
+    cells.reserve(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const MeshVertex& v = vertices[i];
+        const CellKey cell{ cellOf(v.Position.x), cellOf(v.Position.y), cellOf(v.Position.z) };
+
+        int64 match = -1;
+        for (int64 dz = -1; dz <= 1 && match < 0; ++dz)
+        {
+            for (int64 dy = -1; dy <= 1 && match < 0; ++dy)
+            {
+                for (int64 dx = -1; dx <= 1 && match < 0; ++dx)
+                {
+                    const auto it = cells.find(CellKey{ cell.X + dx, cell.Y + dy, cell.Z + dz });
+                    if (it == cells.end())
+                        continue;
+                    for (uint32 candidate : it->second)
+                    {
+                        if (WithinTolerance(vertices[representatives[candidate]], v, options))
+                        {
+                            match = candidate;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (match < 0)
+        {
+            match = uniqueCount++;
+            representatives.push_back(static_cast<uint32>(i));
+            cells[cell].push_back(static_cast<uint32>(match));
+        }
+        remap[i] = static_cast<uint32>(match);
+    }
+    return uniqueCount;
+}
+
+size_t OptimizeVertexFetchRemap(Span<const uint32> indices, size_t vertexCount, Span<uint32> remap)
+{
+    if (remap.size() != vertexCount)
+        throw std::invalid_argument("OptimizeVertexFetchRemap: remap size differs from the vertex count");
+
+    std::fill(remap.begin(), remap.end(), ~0u);
+    uint32 next = 0;
+    for (uint32 index : indices)
+    {
+        if (index >= vertexCount)
+            throw std::out_of_range("OptimizeVertexFetchRemap: index exceeds the vertex count");
+        if (remap[index] == ~0u)
+            remap[index] = next++;
+    }
+    return next;
+}
+
+VertexFetchReport WeldAndReorderVertices(MeshTemplate& meshTemplate, const WeldOptions& options)
+{
+    const Vector<MeshVertex>& vertices = meshTemplate.GetVertices();
+    const Vector<uint32> indices = meshTemplate.CopyIndices();
+
+    Vector<Submesh> ranges = meshTemplate.GetSubmeshes();
+    if (ranges.empty())
+        ranges.push_back(Submesh{ 0, static_cast<uint32>(indices.size()), 0 });
+
+    // Submesh indices are relative, measure the buffer as the GPU addresses it
+    Vector<uint32> absoluteBefore(indices.size());
+    for (const Submesh& range : ranges)
+    {
+        for (uint32 i = range.IndexOffset; i < range.IndexOffset + range.IndexCount; ++i)
+            absoluteBefore[i] = indices[i] + range.BaseVertex;
+    }
+
+    VertexFetchReport report;
+    report.Before = AnalyzeVertexFetch(absoluteBefore, vertices.size(), sizeof(MeshVertex));
+
+    struct RangeResult
+    {
+        Vector<MeshVertex> Vertices;
+        Vector<uint32> Indices;
+    };
+    Vector<RangeResult> results(ranges.size());
+
+    ParallelFor(ranges.size(), [&](size_t r)
+    {
+        const Span<const uint32> range(indices.data() + ranges[r].IndexOffset, ranges[r].IndexCount);
+        const size_t vertexCount = range.empty() ? 0 : size_t(*std::max_element(range.begin(), range.end())) + 1;
+        const Span<const MeshVertex> rangeVertices(vertices.data() + ranges[r].BaseVertex, vertexCount);
+        RangeResult& result = results[r];
+
+        // Weld: indices point at representatives, triangles that lost an edge are dropped
+        Vector<uint32> weldRemap(vertexCount);
+        const size_t weldedCount = WeldVertices(rangeVertices, weldRemap, options);
+        Vector<MeshVertex> welded(weldedCount);
+        for (size_t v = vertexCount; v-- > 0;)
+            welded[weldRemap[v]] = rangeVertices[v];
+
+        Vector<uint32> weldedIndices;
+        weldedIndices.reserve(range.size());
+        for (size_t t = 0; t + 2 < range.size(); t += 3)
+        {
+            const uint32 a = weldRemap[range[t]], b = weldRemap[range[t + 1]], c = weldRemap[range[t + 2]];
+            if (options.RemoveDegenerateTriangles && (a == b || b == c || a == c))
+                continue;
+            weldedIndices.insert(weldedIndices.end(), { a, b, c });
+        }
+
+        // Fetch order: vertices in order of first reference
+        Vector<uint32> fetchRemap(weldedCount);
+        const size_t usedCount = OptimizeVertexFetchRemap(weldedIndices, weldedCount, fetchRemap);
+        result.Vertices.resize(usedCount);
+        for (size_t v = 0; v < weldedCount; ++v)
+        {
+            if (fetchRemap[v] != ~0u)
+                result.Vertices[fetchRemap[v]] = welded[v];
+        }
+        result.Indices.resize(weldedIndices.size());
+        for (size_t i = 0; i < weldedIndices.size(); ++i)
+            result.Indices[i] = fetchRemap[weldedIndices[i]];
+    });
+
+    Vector<MeshVertex> newVertices;
+    Vector<uint32> newIndices;
+    Vector<uint32> absoluteIndices;
+    Vector<Submesh> newRanges;
+    for (RangeResult& result : results)
+    {
+        const Submesh range{ static_cast<uint32>(newIndices.size()), static_cast<uint32>(result.Indices.size()), static_cast<int32>(newVertices.size()) };
+        newRanges.push_back(range);
+        newIndices.insert(newIndices.end(), result.Indices.begin(), result.Indices.end());
+        for (uint32 index : result.Indices)
+            absoluteIndices.push_back(index + range.BaseVertex);
+        newVertices.insert(newVertices.end(), result.Vertices.begin(), result.Vertices.end());
+    }
+
+    report.After = AnalyzeVertexFetch(absoluteIndices, newVertices.size(), sizeof(MeshVertex));
+
+    meshTemplate.SetVertices(std::move(newVertices));
+    meshTemplate.SetIndices(newIndices);
+    if (newRanges.size() > 1)
+        meshTemplate.SetSubmeshes(newRanges);
+    return report;
+}
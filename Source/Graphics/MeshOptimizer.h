@@ -0,0 +1,99 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+// Post-transform vertex cache statistics for a FIFO cache of CacheSize entries
+struct VertexCacheStats
+{
+    float Acmr = 0.0f;      // Average cache miss ratio: vertex shader invocations per triangle, 0.5 is ideal for regular grids
+    float Atvr = 0.0f;      // Average transformed vertex ratio: invocations per referenced vertex, 1.0 is ideal
+    uint32 CacheSize = 0;
+};
+
+struct VertexCacheReport
+{
+    VertexCacheStats Before;
+    VertexCacheStats After;
+};
+
+constexpr uint32 s_DefaultVertexCacheSize = 16;
+
+VertexCacheStats AnalyzeVertexCache(Span<const uint32> indices, size_t vertexCount, uint32 cacheSize = s_DefaultVertexCacheSize);
+
+// Reorders triangles with Tipsify (Sander, Nehab and Barczak 2007): fans around the most recently used vertex
+// and falls back to a dead-end stack. Linear time, so it is cheap enough to run at load time.
+// outIndices may alias indices
+void OptimizeVertexCache(Span<const uint32> indices, size_t vertexCount, Span<uint32> outIndices, uint32 cacheSize = s_DefaultVertexCacheSize);
+
+// Optimizes every submesh of the template (or the whole index list when it has none) on the worker threads.
+// The triangle set, index format and submesh ranges are preserved
+VertexCacheReport OptimizeVertexCache(MeshTemplate& meshTemplate, uint32 cacheSize = s_DefaultVertexCacheSize);
+
+// Pixel overdraw measured by rasterizing the mesh in index order with depth test and back-face culling
+// from ViewCount orthographic directions spread over the sphere
+struct OverdrawStats
+{
+    float Overdraw = 0.0f;          // Shaded / covered pixels, 1.0 is ideal
+    uint64 PixelsCovered = 0;
+    uint64 PixelsShaded = 0;
+    uint32 ViewCount = 0;
+};
+
+struct OverdrawReport
+{
+    VertexCacheStats CacheBefore;
+    VertexCacheStats CacheAfter;
+    OverdrawStats OverdrawBefore;
+    OverdrawStats OverdrawAfter;
+};
+
+constexpr float s_DefaultOverdrawThreshold = 1.05f;
+
+OverdrawStats AnalyzeOverdraw(Span<const MeshVertex> vertices, Span<const uint32> indices, uint32 viewCount = 32, uint32 resolution = 256);
+
+// Splits a vertex-cache-optimized index list into clusters and draws outward-facing clusters first.
+// Clusters end wherever the cache restarts and wherever the running ACMR of a cluster drops to threshold times
+// the ACMR of the surrounding cache run, so 1.05 lets the vertex cache efficiency degrade by about 5%.
+// outIndices may alias indices
+void OptimizeOverdraw(Span<const MeshVertex> vertices, Span<const uint32> indices, Span<uint32> outIndices,
+    float threshold = s_DefaultOverdrawThreshold, uint32 cacheSize = s_DefaultVertexCacheSize);
+
+// Runs OptimizeOverdraw per submesh on the worker threads, call it after OptimizeVertexCache
+OverdrawReport OptimizeOverdraw(MeshTemplate& meshTemplate, float threshold = s_DefaultOverdrawThreshold, uint32 cacheSize = s_DefaultVertexCacheSize);
+
+// Tolerances for WeldVertices, all zero welds bit-identical vertices only
+struct WeldOptions
+{
+    float PositionEpsilon = 0.0f;
+    float NormalEpsilon = 0.0f;
+    float UvEpsilon = 0.0f;
+    bool RemoveDegenerateTriangles = true;   // Drops triangles that collapse onto a shared vertex after welding
+};
+
+struct VertexFetchStats
+{
+    size_t VertexCount = 0;
+    size_t VertexBytes = 0;
+    size_t TriangleCount = 0;
+    float Overfetch = 0.0f;     // Bytes fetched through a small cache-line simulation / vertex buffer bytes, 1.0 is ideal
+};
+
+struct VertexFetchReport
+{
+    VertexFetchStats Before;
+    VertexFetchStats After;
+};
+
+VertexFetchStats AnalyzeVertexFetch(Span<const uint32> indices, size_t vertexCount, size_t vertexStride);
+
+// Fills remap with the welded index of every vertex and returns the welded vertex count. Representatives keep their
+// first-seen order. With tolerances, vertices are bucketed by position cell and compared against neighbouring cells
+size_t WeldVertices(Span<const MeshVertex> vertices, Span<uint32> remap, const WeldOptions& options = {});
+
+// Fills remap with the position of every vertex in order of first use by indices, unreferenced vertices get ~0u.
+// Returns the referenced vertex count
+size_t OptimizeVertexFetchRemap(Span<const uint32> indices, size_t vertexCount, Span<uint32> remap);
+
+// Welds, then lays vertices out in first-use order so fetches walk the vertex buffer linearly. Runs per submesh,
+// as vertices are never shared between submeshes. Call after the index order passes
+VertexFetchReport WeldAndReorderVertices(MeshTemplate& meshTemplate, const WeldOptions& options = {});
@@ -1,15 +1,19 @@
 #include "MeshPipeline.h"
+#include "VertexCompression.h"
 #include <stdexcept>
 
-void MeshPipeline::Initialize(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat)
+void MeshPipeline::Initialize(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat, VertexFormat vertexFormat,
+    MeshPipelineMode mode)
 {
     if (!device)
     {
         throw std::invalid_argument("Device cannot be null");
     }
 
+    m_Mode = mode;
     CreateRootSignature(device);
-    CreatePipelineState(device, renderTargetFormat, depthStencilFormat);
+    m_VertexFormat = vertexFormat;
+    CreatePipelineState(device, renderTargetFormat, depthStencilFormat, vertexFormat);
 }
 
 void MeshPipeline::Bind(ID3D12GraphicsCommandList* commandList) const
@@ -27,31 +31,47 @@ void MeshPipeline::Bind(ID3D12GraphicsCommandList* commandList) const
 // TODO add root signature description as argument instead of using hardcoded values
 void MeshPipeline::CreateRootSignature(ID3D12Device* device)
 {
+    // The unbounded texture table below needs resource binding tier 2, tier 1 hardware only fails inside CreateRootSignature
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    if (FAILED(device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) ||
+        options.ResourceBindingTier < D3D12_RESOURCE_BINDING_TIER_2)
+    {
+        throw std::runtime_error("MeshPipeline needs resource binding tier 2 for the unbounded material texture table");
+    }
+
     // Root parameters for constant buffers and texture resources
-    CD3DX12_ROOT_PARAMETER1 rootParameters[3] = {};
+    CD3DX12_ROOT_PARAMETER1 rootParameters[4] = {};
 
     // Frame data constant buffer (b0) - used by both vertex and pixel shaders
     rootParameters[0].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_ALL);
 
-    // Object data constant buffer (b1) - used by vertex shader
-    rootParameters[1].InitAsConstantBufferView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_VERTEX);
+    // Object data constant buffer (b1), or the instance buffer (t0) of the instanced variant - used by vertex shader
+    if (m_Mode == MeshPipelineMode::Instanced)
+    {
+        rootParameters[1].InitAsShaderResourceView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_VERTEX);
+    }
+    else
+    {
+        rootParameters[1].InitAsConstantBufferView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_VERTEX);
+    }
 
-    // Material data constant buffer (b2) - used by pixel shader
-    rootParameters[2].InitAsConstantBufferView(2, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_PIXEL);
+    // Material table (t1) - used by pixel shader. Volatile since entries are appended while it is bound
+    rootParameters[2].InitAsShaderResourceView(1, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE, D3D12_SHADER_VISIBILITY_PIXEL);
 
-    //// Texture descriptor table for material textures (t0-t3)
-    //CD3DX12_DESCRIPTOR_RANGE1 textureRange;
-    //textureRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 4, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE);
-    //rootParameters[3].InitAsDescriptorTable(1, &textureRange, D3D12_SHADER_VISIBILITY_PIXEL);
+    // Unbounded texture table over the whole CBV SRV UAV heap (t0, space1), indexed by the material maps - used by pixel
+    // shader. Needs resource binding tier 2, most slots hold no texture so the descriptors are volatile
+    CD3DX12_DESCRIPTOR_RANGE1 textureRange;
+    textureRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, UINT_MAX, 0, 1,
+        D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE | D3D12_DESCRIPTOR_RANGE_FLAG_DATA_VOLATILE, 0);
+    rootParameters[3].InitAsDescriptorTable(1, &textureRange, D3D12_SHADER_VISIBILITY_PIXEL);
 
-    //// Sampler descriptor table (s0)
-    //CD3DX12_DESCRIPTOR_RANGE1 samplerRange;
-    //samplerRange.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, 1, 0, 0, D3D12_DESCRIPTOR_RANGE_FLAG_NONE);
-    //rootParameters[4].InitAsDescriptorTable(1, &samplerRange, D3D12_SHADER_VISIBILITY_PIXEL);
+    // Linear wrap sampler (s0) for the material maps
+    CD3DX12_STATIC_SAMPLER_DESC linearSampler(0, D3D12_FILTER_MIN_MAG_MIP_LINEAR);
+    linearSampler.ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL;
 
     // Create versioned root signature
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
-    rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, 0, nullptr,
+    rootSignatureDesc.Init_1_1(_countof(rootParameters), rootParameters, 1, &linearSampler,
         D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
     ComPtr<ID3DBlob> signature;
@@ -75,14 +95,10 @@ void MeshPipeline::CreateRootSignature(ID3D12Device* device)
     }
 }
 
-void MeshPipeline::CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat)
+void MeshPipeline::CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat, VertexFormat vertexFormat)
 {
-    // Input layout description matching MeshVertex structure
-    D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-    };
+    // Input layout description matching the vertex format
+    const Span<const D3D12_INPUT_ELEMENT_DESC> inputLayout = GetInputLayout(vertexFormat);
 
     // Pipeline state description
     D3D12_GRAPHICS_PIPELINE_STATE_DESC psoDesc = {};
@@ -90,7 +106,8 @@ void MeshPipeline::CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderT
 
     // Shader bytecode
     Vector<uint8_t> vertexShaderBytecode, pixelShaderBytecode;
-    LOAD_VERTEX_SHADER("BlinnPhong", vertexShaderBytecode);
+    const String vertexShaderName = String(GetVertexShaderName(vertexFormat)) + (m_Mode == MeshPipelineMode::Instanced ? "Instanced" : "");
+    LoadBinaryFile(SHADER_PATH + vertexShaderName + "_vs.dxil", vertexShaderBytecode);
     LOAD_PIXEL_SHADER("BlinnPhong", pixelShaderBytecode);
     psoDesc.VS = { vertexShaderBytecode.data(), vertexShaderBytecode.size() };
     psoDesc.PS = { pixelShaderBytecode.data(), pixelShaderBytecode.size() };
@@ -110,7 +127,7 @@ void MeshPipeline::CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderT
     psoDesc.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;
 
     // Input layout
-    psoDesc.InputLayout = { inputLayout, _countof(inputLayout) };
+    psoDesc.InputLayout = { inputLayout.data(), static_cast<UINT>(inputLayout.size()) };
 
     // Primitive topology
     psoDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
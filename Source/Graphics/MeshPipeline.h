@@ -6,6 +6,14 @@
 
 #include "Engine/BaseTypes.h"
 #include "IO/Files.h"
+#include "Graphics/Mesh.h"
+
+// Where the vertex shader reads ObjectData from, the root parameter 1 of the pipeline
+enum class MeshPipelineMode : uint8
+{
+    PerObject,      // Constant buffer (b1), one draw per object
+    Instanced,      // StructuredBuffer root SRV (t0) indexed by SV_InstanceID, see Graphics/InstanceBuffer.h
+};
 
 class MeshPipeline
 {
@@ -13,10 +21,12 @@ public:
     MeshPipeline() = default;
     ~MeshPipeline() = default;
 
-    // Initialize the pipeline with shaders and render target format
-    void Initialize(ID3D12Device* device, DXGI_FORMAT renderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT depthStencilFormat = DXGI_FORMAT_D32_FLOAT);
+    // Initialize the pipeline with shaders and render target format. Meshes drawn with it must use the same vertex format
+    void Initialize(ID3D12Device* device, DXGI_FORMAT renderTargetFormat = DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT depthStencilFormat = DXGI_FORMAT_D32_FLOAT,
+        VertexFormat vertexFormat = VertexFormat::Float32, MeshPipelineMode mode = MeshPipelineMode::PerObject);
 
-    // Bind the pipeline to the command list
+    // Bind the pipeline to the command list. Root parameters: 0 frame data (b0), 1 object data (see MeshPipelineMode),
+    // 2 and 3 the material table and its textures, bound by MaterialTable::Bind
     void Bind(ID3D12GraphicsCommandList* commandList) const;
 
     // Get the root signature for setting constant buffers and resources
@@ -25,11 +35,16 @@ public:
     // Check if pipeline is initialized
     bool IsInitialized() const { return m_PipelineState != nullptr; }
 
+    VertexFormat GetVertexFormat() const { return m_VertexFormat; }
+    MeshPipelineMode GetMode() const { return m_Mode; }
+
 private:
     void CreateRootSignature(ID3D12Device* device);
-    void CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat);
+    void CreatePipelineState(ID3D12Device* device, DXGI_FORMAT renderTargetFormat, DXGI_FORMAT depthStencilFormat, VertexFormat vertexFormat);
 
 private:
     ComPtr<ID3D12RootSignature> m_RootSignature;
     ComPtr<ID3D12PipelineState> m_PipelineState;
+    VertexFormat m_VertexFormat = VertexFormat::Float32;
+    MeshPipelineMode m_Mode = MeshPipelineMode::PerObject;
 };
\ No newline at end of file
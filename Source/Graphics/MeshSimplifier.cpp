@@ -0,0 +1,604 @@
+#include "MeshSimplifier.h"
+
+#include <bit>
+
+#include "Engine/Parallel.h"
+#include "Graphics/MeshOptimizer.h"
+
+namespace
+{
+    // Border edges get a perpendicular plane with this weight per squared edge length so the outline stays in place
+    constexpr double s_BorderWeight = 10.0;
+
+    // A collapse may rotate a surrounding triangle's normal by at most ~84 degrees
+    constexpr float s_MinNormalDot = 0.1f;
+
+    // Symmetric 4x4 quadric stored as A (3x3), b and c, plus the accumulated area weight
+    struct Quadric
+    {
+        double A00 = 0, A01 = 0, A02 = 0, A11 = 0, A12 = 0, A22 = 0;
+        double B0 = 0, B1 = 0, B2 = 0;
+        double C = 0;
+        double Weight = 0;
+
+        static Quadric FromPlane(double nx, double ny, double nz, double d, double weight)
+        {
+            Quadric q;
+            q.A00 = weight * nx * nx; q.A01 = weight * nx * ny; q.A02 = weight * nx * nz;
+            q.A11 = weight * ny * ny; q.A12 = weight * ny * nz; q.A22 = weight * nz * nz;
+            q.B0 = weight * nx * d; q.B1 = weight * ny * d; q.B2 = weight * nz * d;
+            q.C = weight * d * d;
+            q.Weight = weight;
+            return q;
+        }
+
+        Quadric& operator+=(const Quadric& o)
+        {
+            A00 += o.A00; A01 += o.A01; A02 += o.A02; A11 += o.A11; A12 += o.A12; A22 += o.A22;
+            B0 += o.B0; B1 += o.B1; B2 += o.B2;
+            C += o.C;
+            Weight += o.Weight;
+            return *this;
+        }
+
+        // Weighted sum of squared plane distances at p
+        double Evaluate(const float3& p) const
+        {
+            const double x = p.x, y = p.y, z = p.z;
+            return x * (A00 * x + A01 * y + A02 * z) + y * (A01 * x + A11 * y + A12 * z) + z * (A02 * x + A12 * y + A22 * z)
+                + 2.0 * (B0 * x + B1 * y + B2 * z) + C;
+        }
+    };
+
+    enum class VertexKind : uint8
+    {
+        Interior,
+        Border,
+        Locked,
+    };
+
+    struct Collapse
+    {
+        float Error;
+        uint32 From;
+        uint32 To;
+    };
+
+    float3 TriangleNormal(const float3& a, const float3& b, const float3& c)
+    {
+        return Cross(b - a, c - a);
+    }
+
+    class Simplifier
+    {
+    public:
+        Simplifier(Span<const MeshVertex> vertices, Span<const uint32> indices, const SimplifyOptions& options)
+            : m_Vertices(vertices), m_Options(options)
+        {
+            BuildGroups();
+            BuildTriangles(indices);
+            ClassifyAndBuildQuadrics();
+        }
+
+        SimplifyResult Run()
+        {
+            const size_t target = static_cast<size_t>(std::max(0.0f, m_Options.TargetRatio) * m_SourceTriangleCount);
+            const double maxError = double(std::max(m_Options.MaxError, 0.0f)) * m_Radius;
+
+            SimplifyResult result;
+            double largestError = 0.0;
+            Vector<Collapse> collapses;
+            Vector<uint8> touched(m_GroupPositions.size(), 0);
+
+            while (m_LiveTriangles > target)
+            {
+                GatherCollapses(collapses);
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Error < b.Error; });
+
+                // Each pass takes the cheapest collapses whose endpoints were not touched yet in this pass
+                std::fill(touched.begin(), touched.end(), uint8(0));
+                size_t performed = 0;
+                for (const Collapse& collapse : collapses)
+                {
+                    if (m_LiveTriangles <= target || collapse.Error > maxError)
+                        break;
+                    if (touched[collapse.From] || touched[collapse.To])
+                        continue;
+                    if (!TryCollapse(collapse.From, collapse.To))
+                        continue;
+
+                    touched[collapse.From] = 1;
+                    touched[collapse.To] = 1;
+                    largestError = std::max(largestError, double(collapse.Error));
+                    performed++;
+                }
+
+                if (performed == 0)
+                    break;
+            }
+
+            result.Indices.reserve(m_LiveTriangles * 3);
+            for (size_t t = 0; t < m_Triangles.size(); ++t)
+            {
+                if (m_Alive[t])
+                    result.Indices.insert(result.Indices.end(), m_Triangles[t].begin(), m_Triangles[t].end());
+            }
+            result.AbsoluteError = static_cast<float>(largestError);
+            result.Error = m_Radius > 0.0 ? static_cast<float>(largestError / m_Radius) : 0.0f;
+            return result;
+        }
+
+    private:
+        // Wedges (vertices) sharing a bit-identical position form one group, the unit the collapses work on
+        void BuildGroups()
+        {
+            struct PositionHash
+            {
+                size_t operator()(const std::array<uint32, 3>& p) const noexcept
+                {
+                    return static_cast<size_t>((uint64(p[0]) * 73856093ull) ^ (uint64(p[1]) * 19349663ull) ^ (uint64(p[2]) * 83492791ull));
+                }
+            };
+
+            HashMap<std::array<uint32, 3>, uint32, PositionHash> groups;
+            groups.reserve(m_Vertices.size());
+            m_WedgeGroup.resize(m_Vertices.size());
+            for (size_t v = 0; v < m_Vertices.size(); ++v)
+            {
+                const float3& p = m_Vertices[v].Position;
+                const std::array<uint32, 3> key{ std::bit_cast<uint32>(p.x), std::bit_cast<uint32>(p.y), std::bit_cast<uint32>(p.z) };
+                const auto [it, inserted] = groups.try_emplace(key, static_cast<uint32>(m_GroupPositions.size()));
+                if (inserted)
+                    m_GroupPositions.push_back(p);
+                m_WedgeGroup[v] = it->second;
+            }
+
+            // Bounding radius for the relative error
+            if (!m_GroupPositions.empty())
+            {
+                float3 minimum = m_GroupPositions[0], maximum = m_GroupPositions[0];
+                for (const float3& p : m_GroupPositions)
+                {
+                    minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+                    maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+                }
+                m_Radius = 0.5 * Length(maximum - minimum);
+            }
+        }
+
+        void BuildTriangles(Span<const uint32> indices)
+        {
+            if (indices.size() % 3 != 0)
+                throw std::invalid_argument("SimplifyMesh: index count must be a multiple of 3");
+
+            m_SourceTriangleCount = indices.size() / 3;
+            m_Triangles.reserve(m_SourceTriangleCount);
+            m_GroupTriangles.resize(m_GroupPositions.size());
+            for (size_t t = 0; t < m_SourceTriangleCount; ++t)
+            {
+                const std::array<uint32, 3> triangle{ indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+                for (uint32 v : triangle)
+                {
+                    if (v >= m_Vertices.size())
+                        throw std::out_of_range("SimplifyMesh: index exceeds the vertex count");
+                }
+
+                // Triangles that are already degenerate in position carry no surface and are dropped up front
+                const uint32 g0 = m_WedgeGroup[triangle[0]], g1 = m_WedgeGroup[triangle[1]], g2 = m_WedgeGroup[triangle[2]];
+                if (g0 == g1 || g1 == g2 || g0 == g2)
+                    continue;
+
+                const uint32 id = static_cast<uint32>(m_Triangles.size());
+                m_Triangles.push_back(triangle);
+                m_Alive.push_back(true);
+                m_GroupTriangles[g0].push_back(id);
+                m_GroupTriangles[g1].push_back(id);
+                m_GroupTriangles[g2].push_back(id);
+            }
+            m_LiveTriangles = m_Triangles.size();
+        }
+
+        void ClassifyAndBuildQuadrics()
+        {
+            m_Quadrics.assign(m_GroupPositions.size(), Quadric{});
+            m_Kinds.assign(m_GroupPositions.size(), VertexKind::Interior);
+
+            // Edge use counts between position groups
+            HashMap<uint64, uint32> edgeUses;
+            edgeUses.reserve(m_Triangles.size() * 3);
+            auto edgeKey = [](uint32 a, uint32 b) { return (uint64(std::min(a, b)) << 32) | std::max(a, b); };
+
+            for (const auto& triangle : m_Triangles)
+            {
+                const uint32 g[3] = { m_WedgeGroup[triangle[0]], m_WedgeGroup[triangle[1]], m_WedgeGroup[triangle[2]] };
+                for (int k = 0; k < 3; ++k)
+                    edgeUses[edgeKey(g[k], g[(k + 1) % 3])]++;
+
+                // Area-weighted plane quadric
+                const float3 n = TriangleNormal(m_GroupPositions[g[0]], m_GroupPositions[g[1]], m_GroupPositions[g[2]]);
+                const double length = Length(n);
+                if (length <= 0.0)
+                    continue;
+                const double nx = n.x / length, ny = n.y / length, nz = n.z / length;
+                const float3& p = m_GroupPositions[g[0]];
+                const double d = -(nx * p.x + ny * p.y + nz * p.z);
+                const Quadric q = Quadric::FromPlane(nx, ny, nz, d, length * 0.5);
+                for (uint32 group : g)
+                    m_Quadrics[group] += q;
+            }
+
+            for (const auto& triangle : m_Triangles)
+            {
+                const uint32 g[3] = { m_WedgeGroup[triangle[0]], m_WedgeGroup[triangle[1]], m_WedgeGroup[triangle[2]] };
+                const float3 n = TriangleNormal(m_GroupPositions[g[0]], m_GroupPositions[g[1]], m_GroupPositions[g[2]]);
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint32 a = g[k], b = g[(k + 1) % 3];
+                    const uint32 uses = edgeUses[edgeKey(a, b)];
+                    if (uses == 2)
+                        continue;
+
+                    // Non-manifold edges are left alone entirely
+                    if (uses > 2)
+                    {
+                        m_Kinds[a] = VertexKind::Locked;
+                        m_Kinds[b] = VertexKind::Locked;
+                        continue;
+                    }
+
+                    const VertexKind borderKind = m_Options.LockBorders ? VertexKind::Locked : VertexKind::Border;
+                    for (uint32 v : { a, b })
+                    {
+                        if (m_Kinds[v] != VertexKind::Locked)
+                            m_Kinds[v] = borderKind;
+                    }
+
+                    // Plane through the edge, perpendicular to the triangle
+                    const float3 edge = m_GroupPositions[b] - m_GroupPositions[a];
+                    const float3 perpendicular = Cross(edge, n);
+                    const double length = Length(perpendicular);
+                    if (length <= 0.0)
+                        continue;
+                    const double nx = perpendicular.x / length, ny = perpendicular.y / length, nz = perpendicular.z / length;
+                    const float3& p = m_GroupPositions[a];
+                    const double d = -(nx * p.x + ny * p.y + nz * p.z);
+                    const Quadric q = Quadric::FromPlane(nx, ny, nz, d, s_BorderWeight * Dot(edge, edge));
+                    m_Quadrics[a] += q;
+                    m_Quadrics[b] += q;
+                }
+            }
+        }
+
+        float CollapseError(uint32 from, uint32 to) const
+        {
+            Quadric q = m_Quadrics[from];
+            q += m_Quadrics[to];
+            const double squared = q.Weight > 0.0 ? std::max(0.0, q.Evaluate(m_GroupPositions[to]) / q.Weight) : 0.0;
+            return static_cast<float>(std::sqrt(squared));
+        }
+
+        // Static part of the collapse rules, the topology checks happen in TryCollapse
+        bool CanMove(uint32 from, uint32 to) const
+        {
+            if (m_Kinds[from] == VertexKind::Locked)
+                return false;
+            if (m_Kinds[from] == VertexKind::Border && m_Kinds[to] == VertexKind::Interior)
+                return false;
+            return true;
+        }
+
+        void GatherCollapses(Vector<Collapse>& collapses) const
+        {
+            Vector<uint64> edges;
+            edges.reserve(m_LiveTriangles * 3);
+            for (size_t t = 0; t < m_Triangles.size(); ++t)
+            {
+                if (!m_Alive[t])
+                    continue;
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint32 a = m_WedgeGroup[m_Triangles[t][k]];
+                    const uint32 b = m_WedgeGroup[m_Triangles[t][(k + 1) % 3]];
+                    edges.push_back((uint64(std::min(a, b)) << 32) | std::max(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+            collapses.clear();
+            for (uint64 edge : edges)
+            {
+                const uint32 a = static_cast<uint32>(edge >> 32), b = static_cast<uint32>(edge);
+                const bool ab = CanMove(a, b), ba = CanMove(b, a);
+                if (!ab && !ba)
+                    continue;
+
+                const float errorAB = ab ? CollapseError(a, b) : std::numeric_limits<float>::infinity();
+                const float errorBA = ba ? CollapseError(b, a) : std::numeric_limits<float>::infinity();
+                collapses.push_back(errorAB <= errorBA ? Collapse{ errorAB, a, b } : Collapse{ errorBA, b, a });
+            }
+        }
+
+        bool TryCollapse(uint32 from, uint32 to)
+        {
+            // Every wedge of the moving group must have a counterpart in a triangle shared with the target. This keeps
+            // seams on seams and forbids collapses that would drag one side's attributes across the other
+            m_WedgeMap.clear();
+            m_MovingWedges.clear();
+            uint32 sharedTriangles = 0;
+            for (uint32 t : m_GroupTriangles[from])
+            {
+                if (!m_Alive[t])
+                    continue;
+
+                uint32 fromWedge = ~0u, toWedge = ~0u;
+                for (uint32 v : m_Triangles[t])
+                {
+                    if (m_WedgeGroup[v] == from)
+                        fromWedge = v;
+                    else if (m_WedgeGroup[v] == to)
+                        toWedge = v;
+                }
+
+                if (std::find(m_MovingWedges.begin(), m_MovingWedges.end(), fromWedge) == m_MovingWedges.end())
+                    m_MovingWedges.push_back(fromWedge);
+
+                if (toWedge == ~0u)
+                    continue;
+
+                sharedTriangles++;
+                auto it = std::find_if(m_WedgeMap.begin(), m_WedgeMap.end(), [&](const auto& pair) { return pair.first == fromWedge; });
+                if (it == m_WedgeMap.end())
+                    m_WedgeMap.emplace_back(fromWedge, toWedge);
+                else if (it->second != toWedge)
+                    return false;
+            }
+
+            if (sharedTriangles == 0)
+                return false;
+            for (uint32 wedge : m_MovingWedges)
+            {
+                if (std::find_if(m_WedgeMap.begin(), m_WedgeMap.end(), [&](const auto& pair) { return pair.first == wedge; }) == m_WedgeMap.end())
+                    return false;
+            }
+
+            // Border vertices may only slide along a border edge
+            if (m_Kinds[from] == VertexKind::Border && sharedTriangles != 1)
+                return false;
+
+            if (!SatisfiesLinkCondition(from, to))
+                return false;
+
+            // Reject collapses that flip or sharply rotate a surviving triangle
+            const float3& target = m_GroupPositions[to];
+            for (uint32 t : m_GroupTriangles[from])
+            {
+                if (!m_Alive[t])
+                    continue;
+
+                float3 p[3];
+                bool sharesTarget = false;
+                for (int k = 0; k < 3; ++k)
+                {
+                    const uint32 group = m_WedgeGroup[m_Triangles[t][k]];
+                    sharesTarget |= group == to;
+                    p[k] = m_GroupPositions[group];
+                }
+                if (sharesTarget)
+                    continue;
+
+                const float3 before = TriangleNormal(p[0], p[1], p[2]);
+                for (int k = 0; k < 3; ++k)
+                {
+                    if (m_WedgeGroup[m_Triangles[t][k]] == from)
+                        p[k] = target;
+                }
+                const float3 after = TriangleNormal(p[0], p[1], p[2]);
+                if (Dot(before, after) <= s_MinNormalDot * Length(before) * Length(after))
+                    return false;
+            }
+
+            // Apply: triangles on the edge vanish, the rest switch to the mapped wedges
+            for (uint32 t : m_GroupTriangles[from])
+            {
+                if (!m_Alive[t])
+                    continue;
+
+                bool sharesTarget = false;
+                for (uint32 v : m_Triangles[t])
+                    sharesTarget |= m_WedgeGroup[v] == to;
+
+                if (sharesTarget)
+                {
+                    m_Alive[t] = false;
+                    m_LiveTriangles--;
+                    continue;
+                }
+
+                for (uint32& v : m_Triangles[t])
+                {
+                    if (m_WedgeGroup[v] == from)
+                        v = std::find_if(m_WedgeMap.begin(), m_WedgeMap.end(), [&](const auto& pair) { return pair.first == v; })->second;
+                }
+                m_GroupTriangles[to].push_back(t);
+            }
+
+            m_GroupTriangles[from].clear();
+            m_Quadrics[to] += m_Quadrics[from];
+            CompactAdjacency(to);
+            return true;
+        }
+
+        // Link condition (Dey et al. 1999): the vertices and edges around both endpoints may only meet at the triangles
+        // on the collapsing edge. Otherwise the collapse pinches the surface, e.g. closes a tube or folds a tetrahedron
+        bool SatisfiesLinkCondition(uint32 from, uint32 to)
+        {
+            auto gatherLink = [&](uint32 center, uint32 other, Vector<uint32>& vertices, Vector<uint64>& edges)
+            {
+                vertices.clear();
+                edges.clear();
+                for (uint32 t : m_GroupTriangles[center])
+                {
+                    if (!m_Alive[t])
+                        continue;
+
+                    uint32 opposite[2];
+                    uint32 count = 0;
+                    bool onEdge = false;
+                    for (uint32 v : m_Triangles[t])
+                    {
+                        const uint32 group = m_WedgeGroup[v];
+                        onEdge |= group == other;
+                        if (group != center)
+                            opposite[count++] = group;
+                    }
+                    vertices.insert(vertices.end(), opposite, opposite + 2);
+                    if (!onEdge)
+                        edges.push_back((uint64(std::min(opposite[0], opposite[1])) << 32) | std::max(opposite[0], opposite[1]));
+                }
+                std::sort(vertices.begin(), vertices.end());
+                vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+                std::sort(edges.begin(), edges.end());
+            };
+
+            gatherLink(from, to, m_FromLink, m_FromLinkEdges);
+            gatherLink(to, from, m_ToLink, m_ToLinkEdges);
+
+            // Common neighbours must be the apexes of the shared triangles
+            for (uint32 group : m_FromLink)
+            {
+                if (group == to || !std::binary_search(m_ToLink.begin(), m_ToLink.end(), group))
+                    continue;
+                bool apex = false;
+                for (uint32 t : m_GroupTriangles[from])
+                {
+                    if (!m_Alive[t])
+                        continue;
+                    bool hasTo = false, hasGroup = false;
+                    for (uint32 v : m_Triangles[t])
+                    {
+                        hasTo |= m_WedgeGroup[v] == to;
+                        hasGroup |= m_WedgeGroup[v] == group;
+                    }
+                    apex |= hasTo && hasGroup;
+                }
+                if (!apex)
+                    return false;
+            }
+
+            // No edge may be opposite both endpoints
+            for (uint64 edge : m_FromLinkEdges)
+            {
+                if (std::binary_search(m_ToLinkEdges.begin(), m_ToLinkEdges.end(), edge))
+                    return false;
+            }
+            return true;
+        }
+
+        void CompactAdjacency(uint32 group)
+        {
+            Vector<uint32>& triangles = m_GroupTriangles[group];
+            triangles.erase(std::remove_if(triangles.begin(), triangles.end(), [&](uint32 t) { return !m_Alive[t]; }), triangles.end());
+        }
+
+        Span<const MeshVertex> m_Vertices;
+        SimplifyOptions m_Options;
+
+        Vector<uint32> m_WedgeGroup;
+        Vector<float3> m_GroupPositions;
+        Vector<Quadric> m_Quadrics;
+        Vector<VertexKind> m_Kinds;
+        Vector<Vector<uint32>> m_GroupTriangles;
+
+        Vector<std::array<uint32, 3>> m_Triangles;
+        Vector<bool> m_Alive;
+        size_t m_LiveTriangles = 0;
+        size_t m_SourceTriangleCount = 0;
+        double m_Radius = 0.0;
+
+        // Scratch for TryCollapse
+        Vector<std::pair<uint32, uint32>> m_WedgeMap;
+        Vector<uint32> m_MovingWedges;
+        Vector<uint32> m_FromLink;
+        Vector<uint32> m_ToLink;
+        Vector<uint64> m_FromLinkEdges;
+        Vector<uint64> m_ToLinkEdges;
+    };
+
+    MeshLod MakeLod(const MeshTemplate& source, const Vector<MeshVertex>& vertices, const SimplifyResult& simplified, size_t sourceTriangles)
+    {
+        // Keep only the referenced vertices, in first-use order
+        Vector<uint32> remap(vertices.size());
+        const size_t used = OptimizeVertexFetchRemap(simplified.Indices, vertices.size(), remap);
+
+        Vector<MeshVertex> lodVertices(used);
+        for (size_t v = 0; v < vertices.size(); ++v)
+        {
+            if (remap[v] != ~0u)
+                lodVertices[remap[v]] = vertices[v];
+        }
+        Vector<uint32> lodIndices(simplified.Indices.size());
+        for (size_t i = 0; i < lodIndices.size(); ++i)
+            lodIndices[i] = remap[simplified.Indices[i]];
+
+        MeshLod lod;
+        lod.Mesh = MeshTemplate(lodVertices, lodIndices);
+        lod.Mesh.SetMaterial(source.GetMaterial());
+        lod.Ratio = sourceTriangles ? float(lodIndices.size() / 3) / float(sourceTriangles) : 1.0f;
+        lod.Error = simplified.Error;
+        lod.AbsoluteError = simplified.AbsoluteError;
+        return lod;
+    }
+
+    // Submesh indices are relative to BaseVertex, the simplifier needs them absolute
+    Vector<uint32> AbsoluteIndices(const MeshTemplate& meshTemplate)
+    {
+        Vector<uint32> indices = meshTemplate.CopyIndices();
+        for (const Submesh& range : meshTemplate.GetSubmeshes())
+        {
+            for (uint32 i = range.IndexOffset; i < range.IndexOffset + range.IndexCount; ++i)
+                indices[i] += range.BaseVertex;
+        }
+        return indices;
+    }
+}
+
+SimplifyResult SimplifyMesh(Span<const MeshVertex> vertices, Span<const uint32> indices, const SimplifyOptions& options)
+{
+    Simplifier simplifier(vertices, indices, options);
+    return simplifier.Run();
+}
+
+Vector<MeshLod> BuildLodChain(const MeshTemplate& meshTemplate, Span<const float> ratios, float maxError)
+{
+    const MeshTemplate* meshes[] = { &meshTemplate };
+    return std::move(BuildLodChains(meshes, ratios, maxError)[0]);
+}
+
+Vector<Vector<MeshLod>> BuildLodChains(Span<const MeshTemplate* const> meshTemplates, Span<const float> ratios, float maxError)
+{
+    Vector<Vector<uint32>> sourceIndices(meshTemplates.size());
+    ParallelFor(meshTemplates.size(), [&](size_t m)
+    {
+        sourceIndices[m] = AbsoluteIndices(*meshTemplates[m]);
+    });
+
+    Vector<Vector<MeshLod>> chains(meshTemplates.size());
+    for (Vector<MeshLod>& chain : chains)
+        chain.resize(ratios.size());
+
+    ParallelFor(meshTemplates.size() * ratios.size(), [&](size_t job)
+    {
+        const size_t m = job / ratios.size();
+        const size_t r = job % ratios.size();
+        const MeshTemplate& source = *meshTemplates[m];
+
+        SimplifyOptions options;
+        options.TargetRatio = ratios[r];
+        options.MaxError = maxError;
+        const SimplifyResult simplified = SimplifyMesh(source.GetVertices(), sourceIndices[m], options);
+        chains[m][r] = MakeLod(source, source.GetVertices(), simplified, sourceIndices[m].size() / 3);
+    });
+
+    return chains;
+}
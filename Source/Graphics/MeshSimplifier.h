@@ -0,0 +1,37 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+struct SimplifyOptions
+{
+    float TargetRatio = 0.5f;       // Triangle count relative to the source
+    float MaxError = 1.0f;          // Largest accepted collapse error, relative to the mesh bounding radius
+    bool LockBorders = false;       // Keep open borders exactly, otherwise they may only collapse along themselves
+};
+
+struct SimplifyResult
+{
+    Vector<uint32> Indices;         // Into the unchanged source vertex list
+    float Error = 0.0f;             // Largest collapse error taken, relative to the mesh bounding radius
+    float AbsoluteError = 0.0f;     // Same in object-space units
+};
+
+// Quadric error metric edge collapse (Garland and Heckbert 1997). Vertices only ever move onto a neighbour, so the
+// attributes of the surviving vertices stay exact. UV and normal seams (vertices sharing a position with different
+// attributes) only collapse along the seam onto another seam vertex, borders only along the border. Collapses that
+// break the link condition are skipped, so manifold meshes stay manifold and keep their genus
+SimplifyResult SimplifyMesh(Span<const MeshVertex> vertices, Span<const uint32> indices, const SimplifyOptions& options = {});
+
+struct MeshLod
+{
+    MeshTemplate Mesh;              // Compacted to the vertices the LOD references
+    float Ratio = 1.0f;             // Reached triangle ratio, may stay above the target when MaxError stops early
+    float Error = 0.0f;             // Relative to the bounding radius of the source
+    float AbsoluteError = 0.0f;
+};
+
+// One LOD per target ratio, each simplified from the source so the errors do not accumulate
+Vector<MeshLod> BuildLodChain(const MeshTemplate& meshTemplate, Span<const float> ratios, float maxError = 1.0f);
+
+// BuildLodChain for many meshes, all (mesh, ratio) pairs run on the worker threads
+Vector<Vector<MeshLod>> BuildLodChains(Span<const MeshTemplate* const> meshTemplates, Span<const float> ratios, float maxError = 1.0f);
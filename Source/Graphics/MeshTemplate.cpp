@@ -0,0 +1,138 @@
+#include "Mesh.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+IndexFormat SelectIndexFormat(Span<const uint32> indices)
+{
+    const uint32 maxIndex = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+    return maxIndex < s_MaxVerticesPer16BitIndex ? IndexFormat::UInt16 : IndexFormat::UInt32;
+}
+
+Vector<uint16> NarrowIndices(Span<const uint32> indices)
+{
+    Vector<uint16> narrow(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)
+    {
+        if (indices[i] >= s_MaxVerticesPer16BitIndex)
+            throw std::out_of_range("NarrowIndices: index does not fit in 16 bits");
+        narrow[i] = static_cast<uint16>(indices[i]);
+    }
+    return narrow;
+}
+
+float4 ComputeBoundingSphere(Span<const MeshVertex> vertices)
+{
+    if (vertices.empty())
+        return float4{ 0.0f, 0.0f, 0.0f, 0.0f };
+
+    float3 minimum = vertices[0].Position, maximum = vertices[0].Position;
+    for (const MeshVertex& vertex : vertices)
+    {
+        const float3& p = vertex.Position;
+        minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+        maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+    }
+
+    const float3 center = (minimum + maximum) * 0.5f;
+    float radius = 0.0f;
+    for (const MeshVertex& vertex : vertices)
+        radius = std::max(radius, Length(vertex.Position - center));
+    return float4{ center.x, center.y, center.z, radius };
+}
+
+void MeshTemplate::SetIndices(Span<const uint32> indices)
+{
+    m_Submeshes.clear();
+    m_IndexFormat = SelectIndexFormat(indices);
+    if (m_IndexFormat == IndexFormat::UInt16)
+    {
+        m_Indices16 = NarrowIndices(indices);
+        m_Indices32.clear();
+    }
+    else
+    {
+        m_Indices32.assign(indices.begin(), indices.end());
+        m_Indices16.clear();
+    }
+}
+
+void MeshTemplate::ReorderIndices(Span<const uint32> indices)
+{
+    if (indices.size() != GetIndexCount())
+        throw std::invalid_argument("MeshTemplate::ReorderIndices: index count changed");
+
+    if (m_IndexFormat == IndexFormat::UInt16)
+        m_Indices16 = NarrowIndices(indices);
+    else
+        m_Indices32.assign(indices.begin(), indices.end());
+}
+
+Vector<uint32> MeshTemplate::CopyIndices() const
+{
+    if (m_IndexFormat == IndexFormat::UInt32)
+        return m_Indices32;
+    return Vector<uint32>(m_Indices16.begin(), m_Indices16.end());
+}
+
+void MeshTemplate::WidenIndices()
+{
+    m_Indices32.assign(m_Indices16.begin(), m_Indices16.end());
+    m_Indices16.clear();
+    m_Indices16.shrink_to_fit();
+    m_IndexFormat = IndexFormat::UInt32;
+}
+
+void MeshTemplate::SplitInto16BitSubmeshes()
+{
+    if (m_IndexFormat == IndexFormat::UInt16)
+        return;
+
+    static constexpr uint32 s_Unmapped = ~0u;
+    const Vector<uint32> indices = std::move(m_Indices32);
+    Vector<MeshVertex> vertices;
+    vertices.reserve(m_Vertices.size());
+    Vector<uint16> narrow;
+    narrow.reserve(indices.size());
+    Vector<Submesh> submeshes;
+
+    // Greedy split in triangle order: a chunk closes once the next triangle would push it past 65536 vertices
+    Vector<uint32> remap(m_Vertices.size(), s_Unmapped);
+    Vector<uint32> chunkVertices;
+    Submesh current;
+    for (size_t t = 0; t + 2 < indices.size(); t += 3)
+    {
+        uint32 newVertices = 0;
+        for (size_t k = 0; k < 3; ++k)
+            newVertices += remap[indices[t + k]] == s_Unmapped ? 1 : 0;
+
+        if (chunkVertices.size() + newVertices > s_MaxVerticesPer16BitIndex)
+        {
+            submeshes.push_back(current);
+            for (uint32 v : chunkVertices)
+                remap[v] = s_Unmapped;
+            chunkVertices.clear();
+            current = Submesh{ static_cast<uint32>(narrow.size()), 0, static_cast<int32>(vertices.size()) };
+        }
+
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const uint32 v = indices[t + k];
+            if (remap[v] == s_Unmapped)
+            {
+                remap[v] = static_cast<uint32>(chunkVertices.size());
+                chunkVertices.push_back(v);
+                vertices.push_back(m_Vertices[v]);
+            }
+            narrow.push_back(static_cast<uint16>(remap[v]));
+        }
+        current.IndexCount += 3;
+    }
+    submeshes.push_back(current);
+
+    m_Vertices = std::move(vertices);
+    m_Indices16 = std::move(narrow);
+    m_Indices32.clear();
+    m_IndexFormat = IndexFormat::UInt16;
+    m_Submeshes = submeshes.size() > 1 ? std::move(submeshes) : Vector<Submesh>{};
+}
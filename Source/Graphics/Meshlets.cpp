@@ -0,0 +1,302 @@
+#include "Meshlets.h"
+#include "Engine/Parallel.h"
+
+namespace
+{
+    constexpr uint32 s_NotInMeshlet = ~0u;
+
+    float3 TriangleNormal(const float3& a, const float3& b, const float3& c)
+    {
+        // Left-handed with clockwise front faces, so the plain cross product points out of the front face
+        return Cross(b - a, c - a);
+    }
+
+    void ValidateLimits(const MeshletLimits& limits)
+    {
+        if (limits.MaxVertices < 3 || limits.MaxVertices > 256)
+            throw std::invalid_argument("BuildMeshlets: MaxVertices must be in [3, 256]");
+        if (limits.MaxTriangles < 1)
+            throw std::invalid_argument("BuildMeshlets: MaxTriangles must be at least 1");
+    }
+}
+
+MeshletData BuildMeshlets(Span<const MeshVertex> vertices, Span<const uint32> indices, const MeshletLimits& limits)
+{
+    ValidateLimits(limits);
+    if (indices.size() % 3 != 0)
+        throw std::invalid_argument("BuildMeshlets: index count must be a multiple of 3");
+
+    const size_t vertexCount = vertices.size();
+    const size_t triangleCount = indices.size() / 3;
+
+    // Vertex -> triangle adjacency in CSR form
+    Vector<uint32> adjacencyOffsets(vertexCount + 1, 0);
+    for (uint32 index : indices)
+    {
+        if (index >= vertexCount)
+            throw std::out_of_range("BuildMeshlets: index exceeds the vertex count");
+        adjacencyOffsets[index + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; ++v)
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+    Vector<uint32> adjacency(indices.size());
+    {
+        Vector<uint32> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            for (size_t k = 0; k < 3; ++k)
+                adjacency[fill[indices[t * 3 + k]]++] = static_cast<uint32>(t);
+        }
+    }
+
+    MeshletData data;
+    data.Meshlets.reserve(triangleCount / limits.MaxTriangles + 1);
+
+    Vector<bool> emitted(triangleCount, false);
+    Vector<uint32> localIndex(vertexCount, s_NotInMeshlet);
+    Meshlet current;
+    size_t scanCursor = 0;
+
+    auto newVertexCount = [&](size_t t)
+    {
+        uint32 count = 0;
+        for (size_t k = 0; k < 3; ++k)
+            count += localIndex[indices[t * 3 + k]] == s_NotInMeshlet ? 1 : 0;
+        return count;
+    };
+
+    auto finishMeshlet = [&]()
+    {
+        if (current.TriangleCount == 0)
+            return;
+        for (uint32 i = current.VertexOffset; i < current.VertexOffset + current.VertexCount; ++i)
+            localIndex[data.VertexIndices[i]] = s_NotInMeshlet;
+        data.Meshlets.push_back(current);
+        current = Meshlet{ static_cast<uint32>(data.VertexIndices.size()), 0, static_cast<uint32>(data.PrimitiveIndices.size() / 3), 0 };
+    };
+
+    for (size_t emittedCount = 0; emittedCount < triangleCount; ++emittedCount)
+    {
+        // Best neighbour of the current meshlet: fewest new vertices, earliest in index order on ties
+        int64 best = -1;
+        uint32 bestNew = 4;
+        for (uint32 i = current.VertexOffset; i < current.VertexOffset + current.VertexCount && bestNew > 0; ++i)
+        {
+            const uint32 v = data.VertexIndices[i];
+            for (uint32 a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; ++a)
+            {
+                const uint32 t = adjacency[a];
+                if (emitted[t])
+                    continue;
+                const uint32 added = newVertexCount(t);
+                if (added < bestNew || (added == bestNew && t < best))
+                {
+                    best = t;
+                    bestNew = added;
+                }
+            }
+        }
+
+        // No neighbour left: continue with the next triangle in index order
+        if (best < 0)
+        {
+            while (emitted[scanCursor])
+                scanCursor++;
+            best = static_cast<int64>(scanCursor);
+            bestNew = newVertexCount(scanCursor);
+        }
+
+        if (current.VertexCount + bestNew > limits.MaxVertices || current.TriangleCount + 1 > limits.MaxTriangles)
+        {
+            finishMeshlet();
+            bestNew = 3;
+        }
+
+        emitted[best] = true;
+        for (size_t k = 0; k < 3; ++k)
+        {
+            const uint32 v = indices[best * 3 + k];
+            if (localIndex[v] == s_NotInMeshlet)
+            {
+                localIndex[v] = current.VertexCount++;
+                data.VertexIndices.push_back(v);
+            }
+            data.PrimitiveIndices.push_back(static_cast<uint8>(localIndex[v]));
+        }
+        current.TriangleCount++;
+    }
+    finishMeshlet();
+
+    data.Bounds.resize(data.Meshlets.size());
+    for (size_t m = 0; m < data.Meshlets.size(); ++m)
+        data.Bounds[m] = ComputeMeshletBounds(vertices, data, data.Meshlets[m]);
+
+    return data;
+}
+
+MeshletData BuildMeshlets(const MeshTemplate& meshTemplate, const MeshletLimits& limits)
+{
+    const Vector<MeshVertex>& vertices = meshTemplate.GetVertices();
+    const Vector<uint32> indices = meshTemplate.CopyIndices();
+
+    Vector<Submesh> ranges = meshTemplate.GetSubmeshes();
+    if (ranges.empty())
+        ranges.push_back(Submesh{ 0, static_cast<uint32>(indices.size()), 0 });
+
+    Vector<MeshletData> parts(ranges.size());
+    ParallelFor(ranges.size(), [&](size_t r)
+    {
+        const Span<const uint32> range(indices.data() + ranges[r].IndexOffset, ranges[r].IndexCount);
+        const Span<const MeshVertex> rangeVertices(vertices.data() + ranges[r].BaseVertex, vertices.size() - ranges[r].BaseVertex);
+        parts[r] = BuildMeshlets(rangeVertices, range, limits);
+    });
+
+    MeshletData data;
+    for (size_t r = 0; r < parts.size(); ++r)
+    {
+        const uint32 vertexOffset = static_cast<uint32>(data.VertexIndices.size());
+        const uint32 triangleOffset = static_cast<uint32>(data.PrimitiveIndices.size() / 3);
+        for (Meshlet meshlet : parts[r].Meshlets)
+        {
+            meshlet.VertexOffset += vertexOffset;
+            meshlet.TriangleOffset += triangleOffset;
+            data.Meshlets.push_back(meshlet);
+        }
+        data.Bounds.insert(data.Bounds.end(), parts[r].Bounds.begin(), parts[r].Bounds.end());
+        for (uint32 v : parts[r].VertexIndices)
+            data.VertexIndices.push_back(v + ranges[r].BaseVertex);
+        data.PrimitiveIndices.insert(data.PrimitiveIndices.end(), parts[r].PrimitiveIndices.begin(), parts[r].PrimitiveIndices.end());
+    }
+    return data;
+}
+
+MeshletBounds ComputeMeshletBounds(Span<const MeshVertex> vertices, const MeshletData& data, const Meshlet& meshlet)
+{
+    MeshletBounds bounds;
+    if (meshlet.VertexCount == 0)
+        return bounds;
+
+    auto position = [&](uint32 local) -> const float3& { return vertices[data.VertexIndices[meshlet.VertexOffset + local]].Position; };
+
+    // Sphere around the AABB center, within a few percent of the minimal sphere for compact clusters
+    float3 minimum = position(0), maximum = position(0);
+    for (uint32 i = 1; i < meshlet.VertexCount; ++i)
+    {
+        const float3& p = position(i);
+        minimum = { std::min(minimum.x, p.x), std::min(minimum.y, p.y), std::min(minimum.z, p.z) };
+        maximum = { std::max(maximum.x, p.x), std::max(maximum.y, p.y), std::max(maximum.z, p.z) };
+    }
+    bounds.Center = (minimum + maximum) * 0.5f;
+    for (uint32 i = 0; i < meshlet.VertexCount; ++i)
+        bounds.Radius = std::max(bounds.Radius, Length(position(i) - bounds.Center));
+
+    // Normal cone over the unit triangle normals, degenerate triangles do not vote
+    Vector<float3> normals;
+    Vector<float3> corners;
+    normals.reserve(meshlet.TriangleCount);
+    corners.reserve(meshlet.TriangleCount);
+    float3 axis{ 0.0f, 0.0f, 0.0f };
+    for (uint32 t = 0; t < meshlet.TriangleCount; ++t)
+    {
+        const uint8* triangle = &data.PrimitiveIndices[(meshlet.TriangleOffset + t) * 3];
+        const float3 n = TriangleNormal(position(triangle[0]), position(triangle[1]), position(triangle[2]));
+        const float area = Length(n);
+        if (area <= 0.0f)
+            continue;
+        normals.push_back(n / area);
+        corners.push_back(position(triangle[0]));
+        axis = axis + normals.back();
+    }
+
+    const float axisLength = Length(axis);
+    if (normals.empty() || axisLength <= 0.0f)
+        return bounds;
+    axis = axis / axisLength;
+
+    float minDot = 1.0f;
+    for (const float3& n : normals)
+        minDot = std::min(minDot, Dot(n, axis));
+
+    // Wider than about 84 degrees the cone rarely culls anything and the apex runs off to infinity
+    if (minDot <= 0.1f)
+        return bounds;
+
+    // Apex on the axis behind the center, in the negative half-space of every triangle plane
+    float maxT = 0.0f;
+    for (size_t i = 0; i < normals.size(); ++i)
+    {
+        const float t = Dot(bounds.Center - corners[i], normals[i]) / Dot(axis, normals[i]);
+        maxT = std::max(maxT, t);
+    }
+
+    bounds.ConeApex = bounds.Center - axis * maxT;
+    bounds.ConeAxis = axis;
+    bounds.ConeCutoff = Sqrt(1.0f - minDot * minDot);
+    return bounds;
+}
+
+MeshletStats AnalyzeMeshlets(const MeshletData& data, const MeshletLimits& limits)
+{
+    MeshletStats stats;
+    stats.MeshletCount = data.Meshlets.size();
+    if (data.Meshlets.empty())
+        return stats;
+
+    size_t vertices = 0, triangles = 0;
+    for (const Meshlet& meshlet : data.Meshlets)
+    {
+        vertices += meshlet.VertexCount;
+        triangles += meshlet.TriangleCount;
+    }
+
+    stats.VertexFill = float(vertices) / float(data.Meshlets.size() * limits.MaxVertices);
+    stats.TriangleFill = float(triangles) / float(data.Meshlets.size() * limits.MaxTriangles);
+    stats.VerticesPerTriangle = triangles ? float(vertices) / float(triangles) : 0.0f;
+    return stats;
+}
+
+MeshletCullStats CullMeshlets(const MeshletData& data, const float3& eyePosition, Span<const float4, 6> frustumPlanes, Vector<uint32>& visible)
+{
+    MeshletCullStats stats;
+    stats.MeshletCount = data.Meshlets.size();
+
+    for (size_t m = 0; m < data.Meshlets.size(); ++m)
+    {
+        const MeshletBounds& bounds = data.Bounds[m];
+        const uint32 triangles = data.Meshlets[m].TriangleCount;
+        stats.TrianglesTotal += triangles;
+
+        bool outside = false;
+        for (const float4& plane : frustumPlanes)
+        {
+            if (plane.x * bounds.Center.x + plane.y * bounds.Center.y + plane.z * bounds.Center.z + plane.w < -bounds.Radius)
+            {
+                outside = true;
+                break;
+            }
+        }
+        if (outside)
+        {
+            stats.FrustumCulled++;
+            continue;
+        }
+
+        if (bounds.ConeCutoff < 1.0f)
+        {
+            const float3 toApex = bounds.ConeApex - eyePosition;
+            const float distance = Length(toApex);
+            if (distance > 0.0f && Dot(toApex, bounds.ConeAxis) >= bounds.ConeCutoff * distance)
+            {
+                stats.BackfaceCulled++;
+                continue;
+            }
+        }
+
+        visible.push_back(static_cast<uint32>(m));
+        stats.TrianglesVisible += triangles;
+    }
+
+    stats.CullRatio = stats.MeshletCount ? float(stats.FrustumCulled + stats.BackfaceCulled) / float(stats.MeshletCount) : 0.0f;
+    return stats;
+}
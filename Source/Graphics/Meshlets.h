@@ -0,0 +1,71 @@
+#pragma once
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+// Upper bounds per meshlet. The defaults match the common mesh shader sweet spot; MaxVertices <= 256 so that
+// primitive indices fit in a byte
+struct MeshletLimits
+{
+    uint32 MaxVertices = 64;
+    uint32 MaxTriangles = 124;
+};
+
+// Ranges into MeshletData::VertexIndices and MeshletData::PrimitiveIndices
+struct Meshlet
+{
+    uint32 VertexOffset = 0;
+    uint32 VertexCount = 0;
+    uint32 TriangleOffset = 0;     // In triangles, PrimitiveIndices holds three bytes per triangle
+    uint32 TriangleCount = 0;
+};
+
+// Object-space culling data. The cone is degenerate (ConeCutoff = 1) when the triangles face too many ways to cull
+struct MeshletBounds
+{
+    float3 Center = { 0.0f, 0.0f, 0.0f };
+    float Radius = 0.0f;
+    float3 ConeApex = { 0.0f, 0.0f, 0.0f };
+    float3 ConeAxis = { 0.0f, 0.0f, 0.0f };
+    float ConeCutoff = 1.0f;        // Sine of the cone half-angle spread, back-facing when dot(normalize(apex - eye), axis) >= cutoff
+};
+
+struct MeshletData
+{
+    Vector<Meshlet> Meshlets;
+    Vector<MeshletBounds> Bounds;
+    Vector<uint32> VertexIndices;       // Mesh vertex of every meshlet-local vertex
+    Vector<uint8> PrimitiveIndices;     // Meshlet-local vertex indices, three per triangle
+};
+
+struct MeshletStats
+{
+    size_t MeshletCount = 0;
+    float VertexFill = 0.0f;        // Average vertices per meshlet / MaxVertices
+    float TriangleFill = 0.0f;      // Average triangles per meshlet / MaxTriangles
+    float VerticesPerTriangle = 0.0f;
+};
+
+struct MeshletCullStats
+{
+    size_t MeshletCount = 0;
+    size_t FrustumCulled = 0;
+    size_t BackfaceCulled = 0;
+    size_t TrianglesTotal = 0;
+    size_t TrianglesVisible = 0;
+    float CullRatio = 0.0f;         // Culled / total meshlets
+};
+
+// Greedy builder: grows each meshlet from triangles adjacent to its vertices, preferring the ones that add the fewest
+// new vertices, and starts a new meshlet once either limit would be exceeded. Feed it a vertex-cache-optimized order
+MeshletData BuildMeshlets(Span<const MeshVertex> vertices, Span<const uint32> indices, const MeshletLimits& limits = {});
+
+// Builds every submesh separately, VertexIndices refer to the template's vertex list
+MeshletData BuildMeshlets(const MeshTemplate& meshTemplate, const MeshletLimits& limits = {});
+
+MeshletBounds ComputeMeshletBounds(Span<const MeshVertex> vertices, const MeshletData& data, const Meshlet& meshlet);
+
+MeshletStats AnalyzeMeshlets(const MeshletData& data, const MeshletLimits& limits = {});
+
+// CPU reference culler. The eye and the planes (xyz inward normal, w offset, inside when dot(xyz, p) + w >= 0) are in the
+// mesh's object space. Appends surviving meshlet indices to visible
+MeshletCullStats CullMeshlets(const MeshletData& data, const float3& eyePosition, Span<const float4, 6> frustumPlanes, Vector<uint32>& visible);
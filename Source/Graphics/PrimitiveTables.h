@@ -0,0 +1,154 @@
+#pragma once
+#include <array>
+
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+// Fixed-size vertex/index tables for procedural primitives, generated at compile time:
+//   static constexpr auto s_Sphere = MakeSphereTable<16, 16>(1.0f);
+// A constexpr table lives in the binary's read-only data and can be handed to Mesh without building a MeshTemplate.
+template<size_t VertexCount, size_t IndexCount>
+struct PrimitiveTable
+{
+    // 16-bit whenever the vertex count allows it, matching the index buffer Mesh uploads
+    using IndexType = std::conditional_t<(VertexCount <= s_MaxVerticesPer16BitIndex), uint16, uint32>;
+
+    std::array<MeshVertex, VertexCount> Vertices{};
+    std::array<IndexType, IndexCount> Indices{};
+
+    constexpr void SetIndex(size_t i, uint32 index) { Indices[i] = static_cast<IndexType>(index); }
+};
+
+constexpr PrimitiveTable<24, 36> MakeCubeTable(float size = 1.0f)
+{
+    const float h = size * 0.5f;
+    PrimitiveTable<24, 36> table;
+
+    // One quad per face: normal, then corners in the same winding as CreateCubeMesh
+    struct Face
+    {
+        float3 Normal;
+        float3 Corners[4];
+        float2 Uvs[4];
+    };
+    const Face faces[6] = {
+        // Front
+        { { 0.0f,  0.0f,  1.0f}, { {-h, -h,  h}, { h, -h,  h}, { h,  h,  h}, {-h,  h,  h} }, { {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, 0.0f} } },
+        // Back
+        { { 0.0f,  0.0f, -1.0f}, { { h, -h, -h}, {-h, -h, -h}, {-h,  h, -h}, { h,  h, -h} }, { {0.0f, 1.0f}, {1.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, 0.0f} } },
+        // Top
+        { { 0.0f,  1.0f,  0.0f}, { {-h,  h, -h}, {-h,  h,  h}, { h,  h,  h}, { h,  h, -h} }, { {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f} } },
+        // Bottom
+        { { 0.0f, -1.0f,  0.0f}, { {-h, -h, -h}, { h, -h, -h}, { h, -h,  h}, {-h, -h,  h} }, { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} } },
+        // Right
+        { { 1.0f,  0.0f,  0.0f}, { { h, -h, -h}, { h,  h, -h}, { h,  h,  h}, { h, -h,  h} }, { {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f} } },
+        // Left
+        { {-1.0f,  0.0f,  0.0f}, { {-h, -h,  h}, {-h,  h,  h}, {-h,  h, -h}, {-h, -h, -h} }, { {0.0f, 1.0f}, {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f} } },
+    };
+
+    for (uint32 face = 0; face < 6; ++face)
+    {
+        const uint32 base = face * 4;
+        for (uint32 corner = 0; corner < 4; ++corner)
+        {
+            table.Vertices[base + corner] = MeshVertex{ faces[face].Corners[corner], faces[face].Normal, faces[face].Uvs[corner] };
+        }
+
+        const uint32 quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+        for (uint32 i = 0; i < 6; ++i)
+        {
+            table.SetIndex(face * 6 + i, quad[i]);
+        }
+    }
+    return table;
+}
+
+// Plane in XZ facing +Y, centered on the origin, split into SegmentsX * SegmentsZ quads
+template<uint32 SegmentsX, uint32 SegmentsZ>
+constexpr auto MakePlaneTable(float sizeX = 1.0f, float sizeZ = 1.0f)
+{
+    static_assert(SegmentsX > 0 && SegmentsZ > 0, "Plane needs at least one segment per axis");
+    PrimitiveTable<(SegmentsX + 1) * (SegmentsZ + 1), SegmentsX * SegmentsZ * 6> table;
+
+    for (uint32 z = 0; z <= SegmentsZ; ++z)
+    {
+        for (uint32 x = 0; x <= SegmentsX; ++x)
+        {
+            const float u = static_cast<float>(x) / SegmentsX;
+            const float v = static_cast<float>(z) / SegmentsZ;
+            table.Vertices[z * (SegmentsX + 1) + x] = MeshVertex{
+                float3{ (u - 0.5f) * sizeX, 0.0f, (v - 0.5f) * sizeZ },
+                float3{ 0.0f, 1.0f, 0.0f },
+                float2{ u, 1.0f - v }
+            };
+        }
+    }
+
+    size_t index = 0;
+    for (uint32 z = 0; z < SegmentsZ; ++z)
+    {
+        for (uint32 x = 0; x < SegmentsX; ++x)
+        {
+            const uint32 first = z * (SegmentsX + 1) + x;
+            const uint32 second = first + SegmentsX + 1;
+
+            // Clockwise when seen from +Y, matching the front-face winding of the mesh pipeline
+            table.SetIndex(index++, first);
+            table.SetIndex(index++, second);
+            table.SetIndex(index++, first + 1);
+            table.SetIndex(index++, first + 1);
+            table.SetIndex(index++, second);
+            table.SetIndex(index++, second + 1);
+        }
+    }
+    return table;
+}
+
+// UV sphere with the same layout as CreateSphereMesh
+template<uint32 LatitudeSegments, uint32 LongitudeSegments>
+constexpr auto MakeSphereTable(float radius = 1.0f)
+{
+    static_assert(LatitudeSegments > 1 && LongitudeSegments > 2, "Sphere needs at least 2 latitude and 3 longitude segments");
+    PrimitiveTable<(LatitudeSegments + 1) * (LongitudeSegments + 1), LatitudeSegments * LongitudeSegments * 6> table;
+
+    // Each angle is evaluated once per row/column instead of once per vertex to keep constant evaluation cheap
+    std::array<float, LongitudeSegments + 1> sinPhi{}, cosPhi{};
+    for (uint32 lon = 0; lon <= LongitudeSegments; ++lon)
+    {
+        const float phi = lon * 2 * PI / LongitudeSegments;
+        sinPhi[lon] = Sin(phi);
+        cosPhi[lon] = Cos(phi);
+    }
+
+    for (uint32 lat = 0; lat <= LatitudeSegments; ++lat)
+    {
+        const float theta = PI * lat / LatitudeSegments;
+        const float sinTheta = Sin(theta);
+        const float cosTheta = Cos(theta);
+        for (uint32 lon = 0; lon <= LongitudeSegments; ++lon)
+        {
+            MeshVertex& vertex = table.Vertices[lat * (LongitudeSegments + 1) + lon];
+            vertex.Position = { radius * sinTheta * cosPhi[lon], radius * cosTheta, radius * sinTheta * sinPhi[lon] };
+            vertex.Normal = Normalize(float3{ sinTheta * cosPhi[lon], cosTheta, sinTheta * sinPhi[lon] });
+            vertex.Uv = { 1.0f - (float)lon / LongitudeSegments, 1.0f - (float)lat / LatitudeSegments };
+        }
+    }
+
+    size_t index = 0;
+    for (uint32 lat = 0; lat < LatitudeSegments; ++lat)
+    {
+        for (uint32 lon = 0; lon < LongitudeSegments; ++lon)
+        {
+            const uint32 first = (lat * (LongitudeSegments + 1)) + lon;
+            const uint32 second = first + LongitudeSegments + 1;
+
+            table.SetIndex(index++, first);
+            table.SetIndex(index++, first + 1);
+            table.SetIndex(index++, second);
+            table.SetIndex(index++, second);
+            table.SetIndex(index++, first + 1);
+            table.SetIndex(index++, second + 1);
+        }
+    }
+    return table;
+}
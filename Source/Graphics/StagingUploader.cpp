@@ -0,0 +1,160 @@
+#include "StagingUploader.h"
+
+#include <stdexcept>
+
+#include "directx/d3dx12.h"
+
+void StagingUploader::Initialize(ID3D12Device* device, GpuMemoryAllocator* allocator, uint32 frameCount, uint64 stagingSize, uint64 frameBudget)
+{
+    if (!device || !allocator)
+    {
+        throw std::invalid_argument("Device and allocator cannot be null");
+    }
+
+    m_Device = device;
+    m_Allocator = allocator;
+    m_Scheduler = UploadScheduler(stagingSize, frameBudget);
+
+    // Staging buffer, kept mapped for the lifetime of the resource
+    {
+        auto heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
+        auto resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(stagingSize);
+        if (FAILED(device->CreateCommittedResource(
+            &heapProperties,
+            D3D12_HEAP_FLAG_NONE,
+            &resourceDesc,
+            D3D12_RESOURCE_STATE_GENERIC_READ,
+            nullptr,
+            IID_PPV_ARGS(&m_StagingBuffer))))
+        {
+            throw std::runtime_error("Failed to create staging buffer");
+        }
+
+        CD3DX12_RANGE readRange(0, 0); // We do not intend to read from this resource on the CPU.
+        if (FAILED(m_StagingBuffer->Map(0, &readRange, reinterpret_cast<void**>(&m_MappedStaging))))
+        {
+            throw std::runtime_error("Failed to map staging buffer");
+        }
+    }
+
+    // Copy command list, one allocator per frame in flight
+    {
+        m_CommandAllocators.resize(frameCount);
+        for (ComPtr<ID3D12CommandAllocator>& allocator : m_CommandAllocators)
+        {
+            if (FAILED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator))))
+            {
+                throw std::runtime_error("Failed to create upload command allocator");
+            }
+        }
+        if (FAILED(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_CommandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&m_CommandList))))
+        {
+            throw std::runtime_error("Failed to create upload command list");
+        }
+        m_CommandList->Close();
+    }
+
+    m_Recorder.CommandList = m_CommandList.Get();
+    m_Recorder.Staging = m_StagingBuffer.Get();
+}
+
+void StagingUploader::Release()
+{
+    // Requests never recorded still hold the reference CreateBuffer took
+    for (const UploadDestination& destination : m_Scheduler.CancelAll())
+    {
+        static_cast<ID3D12Resource*>(destination.Resource)->Release();
+    }
+
+    if (m_StagingBuffer)
+    {
+        m_StagingBuffer->Unmap(0, nullptr);
+        m_MappedStaging = nullptr;
+        m_StagingBuffer.Reset();
+    }
+    m_CommandList.Reset();
+    m_CommandAllocators.clear();
+    m_Recorder = CommandListRecorder();
+    m_Scheduler = UploadScheduler();
+    m_Allocator = nullptr;
+    m_Device.Reset();
+}
+
+GpuAllocation StagingUploader::CreateBuffer(const void* data, uint64 size, D3D12_RESOURCE_STATES finalState, uint64& ticket)
+{
+    // Buffers start out in the common state and are promoted to the copy destination by each list copying into them
+    GpuAllocation buffer = m_Allocator->CreateBuffer(size, D3D12_RESOURCE_STATE_COMMON);
+
+    // The scheduler holds a reference until the last copy is recorded
+    buffer.Resource->AddRef();
+    ticket = m_Scheduler.Enqueue(UploadDestination{ buffer.Resource.Get(), static_cast<uint32>(finalState) }, buffer.Offset, data, size);
+    return buffer;
+}
+
+void StagingUploader::CancelUploads(const GpuAllocation& buffer)
+{
+    if (!buffer.Resource)
+    {
+        return;
+    }
+
+    // Each request holds the reference CreateBuffer took
+    for (const UploadDestination& destination : m_Scheduler.Cancel(buffer.Resource.Get(), buffer.Offset, buffer.Size))
+    {
+        static_cast<ID3D12Resource*>(destination.Resource)->Release();
+    }
+}
+
+ID3D12CommandList* StagingUploader::RecordFrame(uint32 frameIndex)
+{
+    m_LastFlushStats = {};
+    if (m_Scheduler.IsIdle())
+    {
+        return nullptr;
+    }
+
+    ID3D12CommandAllocator* allocator = m_CommandAllocators.at(frameIndex).Get();
+    allocator->Reset();
+    m_CommandList->Reset(allocator, nullptr);
+
+    m_Recorder.Barriers.clear();
+    m_Recorder.BarrierIndices.clear();
+    m_Recorder.Finished.clear();
+    m_LastFlushStats = m_Scheduler.Flush(m_MappedStaging, m_Recorder);
+    if (!m_Recorder.Barriers.empty())
+    {
+        m_CommandList->ResourceBarrier(static_cast<UINT>(m_Recorder.Barriers.size()), m_Recorder.Barriers.data());
+    }
+    m_CommandList->Close();
+
+    // Finished buffers are only referenced by their owners from here on, like any other buffer their draws use
+    for (ID3D12Resource* resource : m_Recorder.Finished)
+    {
+        resource->Release();
+    }
+    return m_LastFlushStats.Copies > 0 ? m_CommandList.Get() : nullptr;
+}
+
+void StagingUploader::CommandListRecorder::CopyBuffer(const UploadDestination& destination, uint64 destinationOffset, uint64 stagingOffset, uint64 size)
+{
+    ID3D12Resource* resource = static_cast<ID3D12Resource*>(destination.Resource);
+    CommandList->CopyBufferRegion(resource, destinationOffset, Staging, stagingOffset, size);
+
+    // Read states combine, e.g. vertex and index buffers packed into the same page
+    auto [it, inserted] = BarrierIndices.try_emplace(resource, Barriers.size());
+    if (inserted)
+    {
+        Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, D3D12_RESOURCE_STATE_COPY_DEST,
+            static_cast<D3D12_RESOURCE_STATES>(destination.FinalState)));
+    }
+    else
+    {
+        D3D12_RESOURCE_STATES& stateAfter = Barriers[it->second].Transition.StateAfter;
+        stateAfter = static_cast<D3D12_RESOURCE_STATES>(stateAfter | destination.FinalState);
+    }
+}
+
+void StagingUploader::CommandListRecorder::FinishRequest(const UploadDestination& destination)
+{
+    Finished.push_back(static_cast<ID3D12Resource*>(destination.Resource));
+}
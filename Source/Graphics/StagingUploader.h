@@ -0,0 +1,66 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/UploadScheduler.h"
+#include "Graphics/GpuMemoryAllocator.h"
+
+// Fills default heap buffers through a persistently mapped staging buffer. The copies of a frame, within its byte
+// budget, go into one command list executed ahead of the frame's own, so everything recorded by then is usable by
+// that frame's draws. Every buffer copied into is left readable at the end of that list, which matters for small
+// buffers sharing a page with others already drawn
+class StagingUploader
+{
+public:
+    static constexpr uint64 s_DefaultStagingSize = 32ull << 20;
+    static constexpr uint64 s_DefaultFrameBudget = 8ull << 20;
+
+    // Buffers are placed by allocator, which must outlive them
+    void Initialize(ID3D12Device* device, GpuMemoryAllocator* allocator, uint32 frameCount, uint64 stagingSize = s_DefaultStagingSize,
+        uint64 frameBudget = s_DefaultFrameBudget);
+    // Uploads still pending are dropped, their buffers stay allocated until their owners free them
+    void Release();
+
+    // Allocates a default heap buffer and queues data for it, readable in finalState after its last copy. ticket is
+    // ready once IsUploaded returns true for it. The allocation is freed through GetAllocator(), after CancelUploads
+    GpuAllocation CreateBuffer(const void* data, uint64 size, D3D12_RESOURCE_STATES finalState, uint64& ticket);
+    // Drops the copies into buffer still pending, so none lands in its range once freed. Copies already recorded are
+    // in flight like any draw reading the buffer, the GPU must be done with them before the free
+    void CancelUploads(const GpuAllocation& buffer);
+
+    // Records the frame's copies and barriers, nullptr when there was nothing to upload. frameIndex picks the command
+    // allocator, whose previous list must have completed
+    ID3D12CommandList* RecordFrame(uint32 frameIndex);
+
+    void FinishFrame(uint64 fenceValue) { m_Scheduler.FinishFrame(fenceValue); }
+    void Reclaim(uint64 completedFenceValue) { m_Scheduler.Reclaim(completedFenceValue); }
+
+    bool IsUploaded(uint64 ticket) const { return m_Scheduler.GetRecordedTicket() >= ticket; }
+    GpuMemoryAllocator* GetAllocator() const { return m_Allocator; }
+    const UploadFlushStats& GetLastFlushStats() const { return m_LastFlushStats; }
+
+private:
+    class CommandListRecorder : public UploadCommandRecorder
+    {
+    public:
+        ID3D12GraphicsCommandList* CommandList = nullptr;
+        ID3D12Resource* Staging = nullptr;
+        // One transition per buffer copied into, to the combined final states of its requests
+        Vector<D3D12_RESOURCE_BARRIER> Barriers;
+        HashMap<ID3D12Resource*, size_t> BarrierIndices;
+        Vector<ID3D12Resource*> Finished;
+
+        void CopyBuffer(const UploadDestination& destination, uint64 destinationOffset, uint64 stagingOffset, uint64 size) final;
+        void FinishRequest(const UploadDestination& destination) final;
+    };
+
+    ComPtr<ID3D12Device> m_Device;
+    GpuMemoryAllocator* m_Allocator = nullptr;
+    ComPtr<ID3D12Resource> m_StagingBuffer;
+    uint8* m_MappedStaging = nullptr;
+    Vector<ComPtr<ID3D12CommandAllocator>> m_CommandAllocators;
+    ComPtr<ID3D12GraphicsCommandList> m_CommandList;
+    UploadScheduler m_Scheduler;
+    CommandListRecorder m_Recorder;
+    UploadFlushStats m_LastFlushStats;
+};
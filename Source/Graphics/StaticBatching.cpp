@@ -0,0 +1,217 @@
+#include "StaticBatching.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "Engine/Parallel.h"
+#include "Graphics/HelperFunctions.h"
+
+namespace
+{
+    bool IsSameMaterial(const Material& a, const Material& b)
+    {
+        return a.Albedo.x == b.Albedo.x && a.Albedo.y == b.Albedo.y && a.Albedo.z == b.Albedo.z
+            && a.Metallic == b.Metallic && a.Roughness == b.Roughness
+            && a.AlbedoMap.Get() == b.AlbedoMap.Get() && a.NormalMap.Get() == b.NormalMap.Get()
+            && a.MetallicMap.Get() == b.MetallicMap.Get() && a.RoughnessMap.Get() == b.RoughnessMap.Get()
+            && a.UvOffset.x == b.UvOffset.x && a.UvOffset.y == b.UvOffset.y && a.UvScale.x == b.UvScale.x && a.UvScale.y == b.UvScale.y;
+    }
+
+    size_t GetMeshBytes(const MeshTemplate& meshTemplate)
+    {
+        const size_t indexSize = meshTemplate.GetIndexFormat() == IndexFormat::UInt16 ? sizeof(uint16) : sizeof(uint32);
+        return meshTemplate.GetVertexCount() * sizeof(MeshVertex) + meshTemplate.GetIndexCount() * indexSize;
+    }
+
+    // 16 bits per field, cells clamped to +-32767 so far away ones share the border cells instead of wrapping
+    uint64 MakeGroupKey(uint32 material, const int3& cell)
+    {
+        auto field = [](int32 value) { return uint64(std::clamp(value, -32767, 32767) + 32768); };
+        return (uint64(material) << 48) | (field(cell.x) << 32) | (field(cell.y) << 16) | field(cell.z);
+    }
+
+    // Appends the instance in world space, indices rebased onto the vertices already in the batch
+    void AppendInstance(const StaticMeshInstance& instance, Vector<MeshVertex>& vertices, Vector<uint32>& indices)
+    {
+        const MeshTemplate& source = *instance.Mesh;
+        const float3x4 world = ComposeAffine(instance.Transform);
+        const float3x3 normalMatrix = ComputeNormalMatrix(instance.Transform);
+
+        const uint32 baseVertex = static_cast<uint32>(vertices.size());
+        for (const MeshVertex& vertex : source.GetVertices())
+        {
+            const float4 position{ vertex.Position.x, vertex.Position.y, vertex.Position.z, 1.0f };
+            MeshVertex& baked = vertices.emplace_back();
+            baked.Position = world * position;
+            baked.Normal = Normalize(normalMatrix * vertex.Normal);
+            baked.Uv = vertex.Uv * instance.UvScale + instance.UvOffset;
+        }
+
+        const Vector<uint32> sourceIndices = source.CopyIndices();
+        const size_t firstIndex = indices.size();
+        if (source.GetSubmeshes().empty())
+        {
+            for (uint32 index : sourceIndices)
+                indices.push_back(baseVertex + index);
+        }
+        else
+        {
+            for (const Submesh& submesh : source.GetSubmeshes())
+            {
+                for (uint32 i = 0; i < submesh.IndexCount; ++i)
+                    indices.push_back(baseVertex + submesh.BaseVertex + sourceIndices[submesh.IndexOffset + i]);
+            }
+        }
+
+        // A negative scale determinant mirrors the triangles
+        const float3& s = instance.Transform.Scale;
+        if (s.x * s.y * s.z < 0.0f)
+        {
+            for (size_t i = firstIndex; i + 2 < indices.size(); i += 3)
+                std::swap(indices[i + 1], indices[i + 2]);
+        }
+    }
+}
+
+StaticBatchReport BuildStaticBatches(Span<const StaticMeshInstance> instances, Vector<StaticBatch>& batches, const StaticBatchSettings& settings)
+{
+    if (settings.CellSize <= 0.0f)
+    {
+        throw std::invalid_argument("Static batch cell size must be positive");
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    StaticBatchReport report;
+    report.Instances = static_cast<uint32>(instances.size());
+    batches.clear();
+
+    // Source bounds and sizes once per distinct mesh
+    HashMap<const MeshTemplate*, float4> sourceSpheres;
+    for (const StaticMeshInstance& instance : instances)
+    {
+        if (!instance.Mesh)
+        {
+            throw std::invalid_argument("Static mesh instance without a mesh");
+        }
+        report.DrawsBefore += static_cast<uint32>(std::max<size_t>(instance.Mesh->GetSubmeshes().size(), 1));
+        if (sourceSpheres.try_emplace(instance.Mesh, ComputeBoundingSphere(instance.Mesh->GetVertices())).second)
+            report.SourceBytes += GetMeshBytes(*instance.Mesh);
+    }
+
+    // Assign instances to batches by material and cell, starting a new batch when the current one is full
+    Vector<const Material*> materials;
+    HashMap<uint64, uint32> openBatches;
+    Vector<Vector<uint32>> batchInstances;
+    Vector<uint32> batchVertexCounts;
+    for (uint32 i = 0; i < instances.size(); ++i)
+    {
+        const StaticMeshInstance& instance = instances[i];
+        const Material& material = instance.Mesh->GetMaterial();
+        auto materialIt = std::find_if(materials.begin(), materials.end(), [&](const Material* m) { return IsSameMaterial(*m, material); });
+        if (materialIt == materials.end())
+        {
+            if (materials.size() > 0xFFFF)
+            {
+                throw std::out_of_range("Static batching supports up to 65536 distinct materials");
+            }
+            materials.push_back(&material);
+            materialIt = materials.end() - 1;
+        }
+
+        const float4& sphere = sourceSpheres[instance.Mesh];
+        const float3 center = ComposeAffine(instance.Transform) * float4{ sphere.x, sphere.y, sphere.z, 1.0f };
+        const int3 cell{
+            static_cast<int32>(std::floor(center.x / settings.CellSize)),
+            static_cast<int32>(std::floor(center.y / settings.CellSize)),
+            static_cast<int32>(std::floor(center.z / settings.CellSize)) };
+
+        const uint32 vertexCount = static_cast<uint32>(instance.Mesh->GetVertexCount());
+        const uint64 key = MakeGroupKey(static_cast<uint32>(materialIt - materials.begin()), cell);
+        auto [it, inserted] = openBatches.try_emplace(key, static_cast<uint32>(batches.size()));
+        if (!inserted && batchVertexCounts[it->second] + uint64(vertexCount) > settings.MaxBatchVertices)
+        {
+            it->second = static_cast<uint32>(batches.size());
+            inserted = true;
+        }
+        if (inserted)
+        {
+            StaticBatch& batch = batches.emplace_back();
+            batch.Cell = cell;
+            batch.Mesh.SetMaterial(material);
+            batchInstances.emplace_back();
+            batchVertexCounts.push_back(0);
+        }
+        batchInstances[it->second].push_back(i);
+        batchVertexCounts[it->second] += vertexCount;
+    }
+
+    // Bake every batch independently
+    ParallelFor(batches.size(), [&](size_t b)
+    {
+        StaticBatch& batch = batches[b];
+        Vector<MeshVertex> vertices;
+        Vector<uint32> indices;
+        vertices.reserve(batchVertexCounts[b]);
+        for (uint32 i : batchInstances[b])
+            AppendInstance(instances[i], vertices, indices);
+
+        if (!vertices.empty())
+        {
+            batch.Bounds = Aabb{ vertices[0].Position, vertices[0].Position };
+            for (const MeshVertex& vertex : vertices)
+                batch.Bounds = Union(batch.Bounds, Aabb{ vertex.Position, vertex.Position });
+        }
+        batch.InstanceCount = static_cast<uint32>(batchInstances[b].size());
+        batch.Mesh.SetVertices(std::move(vertices));
+        batch.Mesh.SetIndices(indices);
+    });
+
+    report.Batches = static_cast<uint32>(batches.size());
+    for (const StaticBatch& batch : batches)
+    {
+        report.DrawsAfter += static_cast<uint32>(std::max<size_t>(batch.Mesh.GetSubmeshes().size(), 1));
+        report.BatchedBytes += GetMeshBytes(batch.Mesh);
+    }
+    report.BuildMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
+
+StaticBatchReport RunStaticBatchingBenchmark(uint32 sphereSegments, float cellSize, uint32 countPerAxis)
+{
+    static constexpr float s_Spacing = 2.5f;
+
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, sphereSegments, sphereSegments);
+    MeshTemplate cube = CreateCubeMesh(0.5f);
+    Material cubeMaterial;
+    cubeMaterial.Albedo = { 0.0f, 0.0f, 1.0f };
+    cube.SetMaterial(cubeMaterial);
+
+    // Grid centered on the origin like the MeshTest one
+    const float origin = float(countPerAxis - 1) * -0.5f * s_Spacing;
+    Vector<StaticMeshInstance> instances;
+    for (uint32 z = 0; z < countPerAxis; ++z)
+    {
+        for (uint32 y = 0; y < countPerAxis; ++y)
+        {
+            for (uint32 x = 0; x < countPerAxis; ++x)
+            {
+                // Copied out, the cube's emplace_back may reallocate the instances
+                const float3 position = float3{ origin, origin, origin } + float3{ float(x), float(y), float(z) } * s_Spacing;
+                StaticMeshInstance& instance = instances.emplace_back();
+                instance.Mesh = &sphere;
+                instance.Transform.Translation = position;
+                if ((x + y + z) % 4 == 0)
+                {
+                    StaticMeshInstance& detail = instances.emplace_back();
+                    detail.Mesh = &cube;
+                    detail.Transform.Translation = position + float3{ 0.0f, 1.0f, 0.0f };
+                }
+            }
+        }
+    }
+
+    Vector<StaticBatch> batches;
+    StaticBatchSettings settings;
+    settings.CellSize = cellSize;
+    return BuildStaticBatches(instances, batches, settings);
+}
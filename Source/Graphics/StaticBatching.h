@@ -0,0 +1,50 @@
+#pragma once
+#include "Engine/AabbTree.h"
+#include "Engine/BaseTypes.h"
+#include "Engine/Transform.h"
+#include "Graphics/Mesh.h"
+
+// One placement of a mesh that never moves
+struct StaticMeshInstance
+{
+    const MeshTemplate* Mesh = nullptr;
+    ::Transform Transform;
+    float2 UvOffset = { 0.0f, 0.0f };   // Object UV transform, baked into the vertices
+    float2 UvScale = { 1.0f, 1.0f };
+};
+
+struct StaticBatchSettings
+{
+    float CellSize = 16.0f;             // World-space grid cell edge, instances go to the cell of their bounds center
+    uint32 MaxBatchVertices = s_MaxVerticesPer16BitIndex; // Full batches start a new one, so they keep 16-bit indices
+};
+
+// Merged geometry of the instances sharing a material and a cell, in world space. Draw it through an Object with the
+// identity transform: its bounding sphere then covers the cell contents and culls like any other object
+struct StaticBatch
+{
+    MeshTemplate Mesh;
+    Aabb Bounds;
+    int3 Cell = { 0, 0, 0 };
+    uint32 InstanceCount = 0;
+};
+
+struct StaticBatchReport
+{
+    uint32 Instances = 0;
+    uint32 Batches = 0;
+    uint32 DrawsBefore = 0;             // One per instance and submesh
+    uint32 DrawsAfter = 0;
+    size_t SourceBytes = 0;             // Vertex and index data of the distinct source meshes, shared by their instances
+    size_t BatchedBytes = 0;
+    double BuildMilliseconds = 0.0;
+};
+
+// Load-time batching of static geometry: bakes the instance transforms into merged vertex and index streams, one per
+// material and grid cell (split further at MaxBatchVertices). Batches are baked in parallel. Mirrored transforms get
+// their winding flipped, so front faces stay clockwise. Replaces the contents of batches
+StaticBatchReport BuildStaticBatches(Span<const StaticMeshInstance> instances, Vector<StaticBatch>& batches, const StaticBatchSettings& settings = {});
+
+// Headless benchmark on the MeshTest layout: countPerAxis^3 spheres of sphereSegments latitude and longitude segments,
+// 2.5 apart, with a cube of a second material next to every fourth one
+StaticBatchReport RunStaticBatchingBenchmark(uint32 sphereSegments = 16, float cellSize = 10.0f, uint32 countPerAxis = 10);
@@ -0,0 +1,970 @@
+#include "TriangleBvh.h"
+
+#include <array>
+#include <chrono>
+#include <random>
+
+#include "Engine/Parallel.h"
+#include "Engine/SimdLanes.h"
+
+namespace
+{
+    constexpr uint32 s_BinCount = 32;
+    constexpr size_t s_BinningChunk = 16384;
+    constexpr uint32 s_MaxStackSize = 1024;
+
+    // Binary build tree, Count > 0 marks a leaf over refs [First, First + Count)
+    struct BuildNode
+    {
+        Aabb Bounds;
+        uint32 Left = 0;
+        uint32 Right = 0;
+        uint32 First = 0;
+        uint32 Count = 0;
+    };
+
+    // Partitioned in place with its bounds, so the build streams through memory instead of chasing ids
+    struct TriangleRef
+    {
+        Aabb Bounds;
+        uint32 Id;
+    };
+
+    struct BuildInput
+    {
+        TriangleRef* Refs = nullptr;
+        uint32 MaxLeafTriangles = 4;
+    };
+
+    struct Bins
+    {
+        Aabb Bounds[s_BinCount];
+        uint32 Counts[s_BinCount] = {};
+    };
+
+    struct RangeBounds
+    {
+        Aabb Bounds;
+        Aabb Centroids;
+    };
+
+    // Inverted box, the identity for Union
+    constexpr float s_Huge = std::numeric_limits<float>::max();
+    const Aabb s_EmptyBox{ float3{ s_Huge, s_Huge, s_Huge }, float3{ -s_Huge, -s_Huge, -s_Huge } };
+
+    float Component(const float3& v, int axis)
+    {
+        return axis == 0 ? v.x : (axis == 1 ? v.y : v.z);
+    }
+
+    void AddPoint(Aabb& box, const float3& p)
+    {
+        box.Min = float3{ std::min(box.Min.x, p.x), std::min(box.Min.y, p.y), std::min(box.Min.z, p.z) };
+        box.Max = float3{ std::max(box.Max.x, p.x), std::max(box.Max.y, p.y), std::max(box.Max.z, p.z) };
+    }
+
+    double MillisecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Splits [begin, end) into chunks and runs them on the worker threads when parallel is set
+    template<class Func>
+    void ForEachChunk(size_t begin, size_t end, bool parallel, Func&& func)
+    {
+        if (!parallel)
+        {
+            func(size_t(0), begin, end);
+            return;
+        }
+        const size_t chunkCount = (end - begin + s_BinningChunk - 1) / s_BinningChunk;
+        ParallelFor(chunkCount, [&](size_t chunk)
+        {
+            func(chunk, begin + chunk * s_BinningChunk, std::min(end, begin + (chunk + 1) * s_BinningChunk));
+        });
+    }
+
+    // accumulate(result, first, last) per chunk, then merge(result, chunkResult). The serial path allocates nothing,
+    // which matters for the many small ranges near the leaves
+    template<class T, class Accumulate, class Merge>
+    T ReduceChunks(size_t begin, size_t end, bool parallel, const T& identity, Accumulate&& accumulate, Merge&& merge)
+    {
+        T result = identity;
+        if (!parallel)
+        {
+            accumulate(result, begin, end);
+            return result;
+        }
+
+        Vector<T> partial((end - begin + s_BinningChunk - 1) / s_BinningChunk, identity);
+        ForEachChunk(begin, end, true, [&](size_t chunk, size_t first, size_t last)
+        {
+            accumulate(partial[chunk], first, last);
+        });
+        for (const T& chunkResult : partial)
+            merge(result, chunkResult);
+        return result;
+    }
+
+    RangeBounds ComputeRangeBounds(const BuildInput& input, size_t begin, size_t end, bool parallel)
+    {
+        return ReduceChunks(begin, end, parallel, RangeBounds{ s_EmptyBox, s_EmptyBox },
+            [&](RangeBounds& result, size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const Aabb& bounds = input.Refs[i].Bounds;
+                    result.Bounds = Union(result.Bounds, bounds);
+                    AddPoint(result.Centroids, (bounds.Min + bounds.Max) * 0.5f);
+                }
+            },
+            [](RangeBounds& result, const RangeBounds& chunk)
+            {
+                result.Bounds = Union(result.Bounds, chunk.Bounds);
+                result.Centroids = Union(result.Centroids, chunk.Centroids);
+            });
+    }
+
+    struct Split
+    {
+        Aabb Bounds;
+        size_t Mid = 0;     // 0 for a leaf
+    };
+
+    // Binned SAH split of refs [begin, end), partitioned in place. Ranges above MaxLeafTriangles always split
+    Split FindSplit(const BuildInput& input, size_t begin, size_t end, bool parallel)
+    {
+        const size_t count = end - begin;
+        const RangeBounds range = ComputeRangeBounds(input, begin, end, parallel);
+        Split split{ range.Bounds, 0 };
+
+        const float3 extent = range.Centroids.Max - range.Centroids.Min;
+        const int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : (extent.y >= extent.z ? 1 : 2);
+        const float axisMin = Component(range.Centroids.Min, axis);
+        const float axisExtent = Component(extent, axis);
+
+        if (axisExtent <= 0.0f)
+        {
+            // Coincident centroids, binning cannot separate them
+            if (count > input.MaxLeafTriangles)
+                split.Mid = begin + count / 2;
+            return split;
+        }
+
+        // Fewer bins for small ranges, the sweep would otherwise cost more than the binning
+        const uint32 binCount = static_cast<uint32>(std::clamp<size_t>(count, 4, s_BinCount));
+        const float binScale = binCount / axisExtent;
+        auto binOf = [&](const TriangleRef& ref)
+        {
+            const float centroid = (Component(ref.Bounds.Min, axis) + Component(ref.Bounds.Max, axis)) * 0.5f;
+            return std::min(binCount - 1, static_cast<uint32>((centroid - axisMin) * binScale));
+        };
+
+        Bins emptyBins;
+        std::fill(emptyBins.Bounds, emptyBins.Bounds + binCount, s_EmptyBox);
+        const Bins bins = ReduceChunks(begin, end, parallel, emptyBins,
+            [&](Bins& result, size_t first, size_t last)
+            {
+                for (size_t i = first; i < last; ++i)
+                {
+                    const uint32 bin = binOf(input.Refs[i]);
+                    result.Bounds[bin] = Union(result.Bounds[bin], input.Refs[i].Bounds);
+                    result.Counts[bin]++;
+                }
+            },
+            [&](Bins& result, const Bins& chunk)
+            {
+                for (uint32 b = 0; b < binCount; ++b)
+                {
+                    result.Bounds[b] = Union(result.Bounds[b], chunk.Bounds[b]);
+                    result.Counts[b] += chunk.Counts[b];
+                }
+            });
+
+        float rightArea[s_BinCount] = {};
+        uint32 rightCount[s_BinCount] = {};
+        Aabb accumulated = s_EmptyBox;
+        uint32 accumulatedCount = 0;
+        for (uint32 b = binCount - 1; b > 0; --b)
+        {
+            accumulated = Union(accumulated, bins.Bounds[b]);
+            accumulatedCount += bins.Counts[b];
+            rightArea[b] = accumulatedCount ? SurfaceArea(accumulated) : 0.0f;
+            rightCount[b] = accumulatedCount;
+        }
+
+        float bestCost = std::numeric_limits<float>::max();
+        uint32 bestSplit = 0;
+        accumulated = s_EmptyBox;
+        accumulatedCount = 0;
+        for (uint32 b = 1; b < binCount; ++b)
+        {
+            accumulated = Union(accumulated, bins.Bounds[b - 1]);
+            accumulatedCount += bins.Counts[b - 1];
+            if (accumulatedCount == 0 || rightCount[b] == 0)
+                continue;
+            const float cost = SurfaceArea(accumulated) * accumulatedCount + rightArea[b] * rightCount[b];
+            if (cost < bestCost)
+            {
+                bestCost = cost;
+                bestSplit = b;
+            }
+        }
+
+        // One traversal step against intersecting every triangle, both in units of a triangle test
+        const float area = SurfaceArea(range.Bounds);
+        if (count <= input.MaxLeafTriangles && (bestSplit == 0 || area <= 0.0f || 1.0f + bestCost / area >= float(count)))
+            return split;
+
+        if (bestSplit > 0)
+            split.Mid = std::partition(input.Refs + begin, input.Refs + end, [&](const TriangleRef& ref) { return binOf(ref) < bestSplit; }) - input.Refs;
+
+        if (split.Mid <= begin || split.Mid >= end)
+        {
+            split.Mid = begin + count / 2;
+            std::nth_element(input.Refs + begin, input.Refs + split.Mid, input.Refs + end, [&](const TriangleRef& a, const TriangleRef& b)
+            {
+                return Component(a.Bounds.Min, axis) + Component(a.Bounds.Max, axis) < Component(b.Bounds.Min, axis) + Component(b.Bounds.Max, axis);
+            });
+        }
+        return split;
+    }
+
+    uint32 BuildSubtree(const BuildInput& input, size_t begin, size_t end, Vector<BuildNode>& nodes)
+    {
+        const uint32 index = static_cast<uint32>(nodes.size());
+        nodes.emplace_back();
+
+        const Split split = FindSplit(input, begin, end, false);
+        nodes[index].Bounds = split.Bounds;
+        if (split.Mid == 0)
+        {
+            nodes[index].First = static_cast<uint32>(begin);
+            nodes[index].Count = static_cast<uint32>(end - begin);
+            return index;
+        }
+
+        const uint32 left = BuildSubtree(input, begin, split.Mid, nodes);
+        const uint32 right = BuildSubtree(input, split.Mid, end, nodes);
+        nodes[index].Left = left;
+        nodes[index].Right = right;
+        return index;
+    }
+
+    struct SubtreeTask
+    {
+        uint32 Node;
+        size_t Begin;
+        size_t End;
+    };
+
+    // Top levels with parallel binning, ranges of at most taskSize triangles are left as tasks for the workers
+    uint32 BuildTopLevels(const BuildInput& input, size_t begin, size_t end, size_t taskSize, uint32 parallelThreshold, Vector<BuildNode>& nodes, Vector<SubtreeTask>& tasks)
+    {
+        const uint32 index = static_cast<uint32>(nodes.size());
+        nodes.emplace_back();
+        if (end - begin <= taskSize)
+        {
+            tasks.push_back(SubtreeTask{ index, begin, end });
+            return index;
+        }
+
+        const Split split = FindSplit(input, begin, end, end - begin >= parallelThreshold);
+        nodes[index].Bounds = split.Bounds;
+        if (split.Mid == 0)
+        {
+            nodes[index].First = static_cast<uint32>(begin);
+            nodes[index].Count = static_cast<uint32>(end - begin);
+            return index;
+        }
+
+        const uint32 left = BuildTopLevels(input, begin, split.Mid, taskSize, parallelThreshold, nodes, tasks);
+        const uint32 right = BuildTopLevels(input, split.Mid, end, taskSize, parallelThreshold, nodes, tasks);
+        nodes[index].Left = left;
+        nodes[index].Right = right;
+        return index;
+    }
+
+    Vector<BuildNode> BuildBinaryTree(const BuildInput& input, size_t count, uint32 parallelThreshold)
+    {
+        Vector<BuildNode> nodes;
+        nodes.reserve(2 * count / input.MaxLeafTriangles + 1);
+
+        if (count < parallelThreshold)
+        {
+            BuildSubtree(input, 0, count, nodes);
+            return nodes;
+        }
+
+        // A few tasks per worker so uneven subtrees balance out
+        const size_t taskSize = std::max<size_t>(parallelThreshold / 4, count / (GetWorkerCount() * 4));
+        Vector<SubtreeTask> tasks;
+        BuildTopLevels(input, 0, count, taskSize, parallelThreshold, nodes, tasks);
+
+        Vector<Vector<BuildNode>> subtrees(tasks.size());
+        ParallelFor(tasks.size(), [&](size_t t)
+        {
+            BuildSubtree(input, tasks[t].Begin, tasks[t].End, subtrees[t]);
+        });
+
+        // The subtree root replaces its placeholder, the rest is appended with shifted child indices
+        for (size_t t = 0; t < tasks.size(); ++t)
+        {
+            const Vector<BuildNode>& subtree = subtrees[t];
+            const uint32 offset = static_cast<uint32>(nodes.size()) - 1;
+            auto remap = [&](BuildNode node)
+            {
+                if (node.Count == 0)
+                {
+                    node.Left += offset;
+                    node.Right += offset;
+                }
+                return node;
+            };
+            nodes[tasks[t].Node] = remap(subtree[0]);
+            for (size_t n = 1; n < subtree.size(); ++n)
+                nodes.push_back(remap(subtree[n]));
+        }
+        return nodes;
+    }
+
+    template<uint32 Width>
+    uint32 CollapseNode(const Vector<BuildNode>& binary, uint32 root, Vector<TriangleBvhNode<Width>>& wide, uint32 depth, uint32& maxDepth)
+    {
+        using Node = TriangleBvhNode<Width>;
+        maxDepth = std::max(maxDepth, depth);
+
+        // Open the largest internal child until the node is full
+        std::array<uint32, Width> slots;
+        uint32 slotCount = 0;
+        if (binary[root].Count > 0)
+        {
+            slots[slotCount++] = root;
+        }
+        else
+        {
+            slots[slotCount++] = binary[root].Left;
+            slots[slotCount++] = binary[root].Right;
+        }
+        while (slotCount < Width)
+        {
+            int best = -1;
+            float bestArea = -1.0f;
+            for (uint32 s = 0; s < slotCount; ++s)
+            {
+                const BuildNode& node = binary[slots[s]];
+                if (node.Count == 0 && SurfaceArea(node.Bounds) > bestArea)
+                {
+                    best = static_cast<int>(s);
+                    bestArea = SurfaceArea(node.Bounds);
+                }
+            }
+            if (best < 0)
+                break;
+            const BuildNode& opened = binary[slots[best]];
+            slots[best] = opened.Left;
+            slots[slotCount++] = opened.Right;
+        }
+
+        const uint32 index = static_cast<uint32>(wide.size());
+        wide.emplace_back();
+        for (uint32 s = 0; s < Width; ++s)
+        {
+            Node& node = wide[index];
+            if (s >= slotCount)
+            {
+                node.MinX[s] = node.MinY[s] = node.MinZ[s] = s_Huge;
+                node.MaxX[s] = node.MaxY[s] = node.MaxZ[s] = -s_Huge;
+                node.Children[s] = Node::s_EmptyChild;
+                node.TriangleCounts[s] = 0;
+                continue;
+            }
+
+            const BuildNode& child = binary[slots[s]];
+            node.MinX[s] = child.Bounds.Min.x;
+            node.MinY[s] = child.Bounds.Min.y;
+            node.MinZ[s] = child.Bounds.Min.z;
+            node.MaxX[s] = child.Bounds.Max.x;
+            node.MaxY[s] = child.Bounds.Max.y;
+            node.MaxZ[s] = child.Bounds.Max.z;
+            if (child.Count > 0)
+            {
+                node.Children[s] = child.First | Node::s_LeafFlag;
+                node.TriangleCounts[s] = static_cast<uint8>(child.Count);
+            }
+            else
+            {
+                const uint32 childIndex = CollapseNode<Width>(binary, slots[s], wide, depth + 1, maxDepth);
+                wide[index].Children[s] = childIndex;
+                wide[index].TriangleCounts[s] = 0;
+            }
+        }
+        return index;
+    }
+
+    // Zero direction components become tiny ones so the slab distances stay finite or infinite, never NaN
+    float SafeInverse(float d)
+    {
+        constexpr float tiny = 1e-30f;
+        return 1.0f / (std::abs(d) > tiny ? d : std::copysign(tiny, d));
+    }
+
+    float3 SafeInverse(const float3& d)
+    {
+        return float3{ SafeInverse(d.x), SafeInverse(d.y), SafeInverse(d.z) };
+    }
+
+    // Triangle-box separating axis test (Akenine-Moller 2001)
+    bool TriangleOverlapsBox(const float3& a, const float3& b, const float3& c, const Aabb& box)
+    {
+        const float3 center = (box.Min + box.Max) * 0.5f;
+        const float3 half = (box.Max - box.Min) * 0.5f;
+        const float3 v[3] = { a - center, b - center, c - center };
+        const float3 e[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+
+        // Box face normals
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float p0 = Component(v[0], axis), p1 = Component(v[1], axis), p2 = Component(v[2], axis);
+            const float h = Component(half, axis);
+            if (std::min({ p0, p1, p2 }) > h || std::max({ p0, p1, p2 }) < -h)
+                return false;
+        }
+
+        // Triangle normal
+        const float3 n = Cross(e[0], e[1]);
+        const float r = half.x * std::abs(n.x) + half.y * std::abs(n.y) + half.z * std::abs(n.z);
+        if (std::abs(Dot(n, v[0])) > r)
+            return false;
+
+        // Edge cross box axis
+        const float3 axes[3] = { float3{ 1.0f, 0.0f, 0.0f }, float3{ 0.0f, 1.0f, 0.0f }, float3{ 0.0f, 0.0f, 1.0f } };
+        for (const float3& edge : e)
+        {
+            for (const float3& boxAxis : axes)
+            {
+                const float3 l = Cross(edge, boxAxis);
+                const float p0 = Dot(l, v[0]), p1 = Dot(l, v[1]), p2 = Dot(l, v[2]);
+                const float radius = half.x * std::abs(l.x) + half.y * std::abs(l.y) + half.z * std::abs(l.z);
+                if (std::min({ p0, p1, p2 }) > radius || std::max({ p0, p1, p2 }) < -radius)
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+template<uint32 Width>
+TriangleBvh<Width>::TriangleBvh(const MeshTemplate& meshTemplate, const TriangleBvhSettings& settings)
+{
+    Vector<uint32> indices = meshTemplate.CopyIndices();
+    for (const Submesh& submesh : meshTemplate.GetSubmeshes())
+    {
+        for (uint32 i = submesh.IndexOffset; i < submesh.IndexOffset + submesh.IndexCount; ++i)
+            indices[i] += submesh.BaseVertex;
+    }
+    Build(meshTemplate.GetVertices(), indices, settings);
+}
+
+template<uint32 Width>
+TriangleBvh<Width>::TriangleBvh(Span<const MeshVertex> vertices, Span<const uint32> indices, const TriangleBvhSettings& settings)
+{
+    Build(vertices, indices, settings);
+}
+
+template<uint32 Width>
+void TriangleBvh<Width>::Build(Span<const MeshVertex> vertices, Span<const uint32> indices, const TriangleBvhSettings& settings)
+{
+    if (indices.size() % 3 != 0)
+        throw std::invalid_argument("TriangleBvh: index count must be a multiple of 3");
+    if (settings.MaxLeafTriangles < 1 || settings.MaxLeafTriangles > 255)
+        throw std::invalid_argument("TriangleBvh: MaxLeafTriangles must be in [1, 255]");
+    for (uint32 index : indices)
+    {
+        if (index >= vertices.size())
+            throw std::out_of_range("TriangleBvh: index exceeds the vertex count");
+    }
+
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount >= Node::s_LeafFlag)
+        throw std::invalid_argument("TriangleBvh: too many triangles");
+
+    m_Nodes.clear();
+    m_Triangles.clear();
+    m_Bounds = Aabb{};
+    m_Depth = 0;
+    if (triangleCount == 0)
+        return;
+
+    Vector<TriangleRef> refs(triangleCount);
+    ForEachChunk(0, triangleCount, triangleCount >= settings.ParallelThreshold, [&](size_t, size_t first, size_t last)
+    {
+        for (size_t t = first; t < last; ++t)
+        {
+            const float3& a = vertices[indices[t * 3 + 0]].Position;
+            const float3& b = vertices[indices[t * 3 + 1]].Position;
+            const float3& c = vertices[indices[t * 3 + 2]].Position;
+            refs[t] = TriangleRef{ Aabb{ a, a }, static_cast<uint32>(t) };
+            AddPoint(refs[t].Bounds, b);
+            AddPoint(refs[t].Bounds, c);
+        }
+    });
+
+    const BuildInput input{ refs.data(), settings.MaxLeafTriangles };
+    const Vector<BuildNode> binary = BuildBinaryTree(input, triangleCount, std::max(settings.ParallelThreshold, 1u));
+    m_Bounds = binary[0].Bounds;
+
+    m_Nodes.reserve(binary.size() / (Width - 1) + 1);
+    CollapseNode<Width>(binary, 0, m_Nodes, 1, m_Depth);
+    if ((Width - 1) * m_Depth + 1 > s_MaxStackSize)
+        throw std::runtime_error("TriangleBvh: tree exceeds the traversal stack");
+
+    // Leaves reference positions in refs, so the triangles are stored in that order
+    m_Triangles.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i)
+    {
+        const uint32 t = refs[i].Id;
+        const float3& a = vertices[indices[t * 3 + 0]].Position;
+        const float3& b = vertices[indices[t * 3 + 1]].Position;
+        const float3& c = vertices[indices[t * 3 + 2]].Position;
+        m_Triangles[i] = Triangle{ a, b - a, c - a, t };
+    }
+}
+
+template<uint32 Width>
+template<class L>
+BvhHit TriangleBvh<Width>::IntersectSingle(const BvhRay& ray, bool anyHit) const
+{
+    BvhHit hit;
+    if (m_Nodes.empty())
+        return hit;
+
+    const float3 invDirection = SafeInverse(ray.Direction);
+    float closest = ray.MaxDistance;
+
+    // With the slabs ordered by direction sign, inverted (empty) boxes always miss
+    const bool negX = invDirection.x < 0.0f, negY = invDirection.y < 0.0f, negZ = invDirection.z < 0.0f;
+    const typename L::Reg originX = L::Set1(ray.Origin.x), originY = L::Set1(ray.Origin.y), originZ = L::Set1(ray.Origin.z);
+    const typename L::Reg invX = L::Set1(invDirection.x), invY = L::Set1(invDirection.y), invZ = L::Set1(invDirection.z);
+    const typename L::Reg zero = L::Set1(0.0f);
+
+    struct Entry
+    {
+        uint32 Node;
+        float Distance;
+    };
+    Entry stack[s_MaxStackSize];
+    uint32 stackSize = 0;
+    stack[stackSize++] = Entry{ 0, 0.0f };
+
+    while (stackSize > 0)
+    {
+        const Entry entry = stack[--stackSize];
+        if (entry.Distance > closest)
+            continue;
+
+        const Node& node = m_Nodes[entry.Node];
+        float nearDistances[Width];
+        uint32 hitMask = 0;
+        const typename L::Reg far = L::Set1(closest);
+        for (uint32 c = 0; c < Width; c += L::Width)
+        {
+            const typename L::Reg nearX = L::Mul(L::Sub(L::Load((negX ? node.MaxX : node.MinX) + c), originX), invX);
+            const typename L::Reg nearY = L::Mul(L::Sub(L::Load((negY ? node.MaxY : node.MinY) + c), originY), invY);
+            const typename L::Reg nearZ = L::Mul(L::Sub(L::Load((negZ ? node.MaxZ : node.MinZ) + c), originZ), invZ);
+            const typename L::Reg farX = L::Mul(L::Sub(L::Load((negX ? node.MinX : node.MaxX) + c), originX), invX);
+            const typename L::Reg farY = L::Mul(L::Sub(L::Load((negY ? node.MinY : node.MaxY) + c), originY), invY);
+            const typename L::Reg farZ = L::Mul(L::Sub(L::Load((negZ ? node.MinZ : node.MaxZ) + c), originZ), invZ);
+            const typename L::Reg enter = L::Max(L::Max(nearX, nearY), L::Max(nearZ, zero));
+            const typename L::Reg exit = L::Min(L::Min(farX, farY), L::Min(farZ, far));
+            L::Store(nearDistances + c, enter);
+            hitMask |= (~L::MoveMask(L::CmpGt(enter, exit)) & ((1u << L::Width) - 1)) << c;
+        }
+
+        Entry children[Width];
+        uint32 childCount = 0;
+        for (; hitMask; hitMask &= hitMask - 1)
+        {
+            const uint32 c = static_cast<uint32>(std::countr_zero(hitMask));
+            const uint32 child = node.Children[c];
+            if (!(child & Node::s_LeafFlag))
+            {
+                children[childCount++] = Entry{ child, nearDistances[c] };
+                continue;
+            }
+
+            const uint32 first = child & ~Node::s_LeafFlag;
+            for (uint32 t = first; t < first + node.TriangleCounts[c]; ++t)
+            {
+                const Triangle& triangle = m_Triangles[t];
+                const float3 p = Cross(ray.Direction, triangle.Edge2);
+                const float det = Dot(triangle.Edge1, p);
+                if (det == 0.0f)
+                    continue;
+                const float invDet = 1.0f / det;
+                const float3 s = ray.Origin - triangle.V0;
+                const float u = Dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+                const float3 q = Cross(s, triangle.Edge1);
+                const float v = Dot(ray.Direction, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+                const float distance = Dot(triangle.Edge2, q) * invDet;
+                if (distance < 0.0f || distance >= closest)
+                    continue;
+
+                closest = distance;
+                hit = BvhHit{ distance, triangle.Index, u, v };
+                if (anyHit)
+                    return hit;
+            }
+        }
+
+        // Farthest first so the nearest child is popped next
+        std::sort(children, children + childCount, [](const Entry& a, const Entry& b) { return a.Distance > b.Distance; });
+        for (uint32 c = 0; c < childCount; ++c)
+            stack[stackSize++] = children[c];
+    }
+    return hit;
+}
+
+template<uint32 Width>
+template<class L>
+void TriangleBvh<Width>::IntersectPacket(const BvhRay* rays, BvhHit* hits) const
+{
+    using Reg = typename L::Reg;
+    constexpr uint32 laneCount = static_cast<uint32>(L::Width);
+
+    // Rays across the lanes, every box and triangle is broadcast against all of them
+    float lanes[10][laneCount];
+    for (uint32 r = 0; r < laneCount; ++r)
+    {
+        const float3 invDirection = SafeInverse(rays[r].Direction);
+        lanes[0][r] = rays[r].Origin.x;
+        lanes[1][r] = rays[r].Origin.y;
+        lanes[2][r] = rays[r].Origin.z;
+        lanes[3][r] = rays[r].Direction.x;
+        lanes[4][r] = rays[r].Direction.y;
+        lanes[5][r] = rays[r].Direction.z;
+        lanes[6][r] = invDirection.x;
+        lanes[7][r] = invDirection.y;
+        lanes[8][r] = invDirection.z;
+        lanes[9][r] = rays[r].MaxDistance;
+    }
+    const Reg originX = L::Load(lanes[0]), originY = L::Load(lanes[1]), originZ = L::Load(lanes[2]);
+    const Reg directionX = L::Load(lanes[3]), directionY = L::Load(lanes[4]), directionZ = L::Load(lanes[5]);
+    const Reg invX = L::Load(lanes[6]), invY = L::Load(lanes[7]), invZ = L::Load(lanes[8]);
+    Reg closest = L::Load(lanes[9]);
+    Reg hitU = L::Set1(0.0f), hitV = L::Set1(0.0f);
+    Reg hitTriangle = L::AsFloat(L::ISet1(-1));
+    const Reg zero = L::Set1(0.0f), one = L::Set1(1.0f), negativeOne = L::Set1(-1.0f);
+
+    auto maxLane = [](Reg value)
+    {
+        float values[laneCount];
+        L::Store(values, value);
+        return *std::max_element(values, values + laneCount);
+    };
+    float packetFar = maxLane(closest);
+
+    struct Entry
+    {
+        uint32 Node;
+        float Distance;
+    };
+    Entry stack[s_MaxStackSize];
+    uint32 stackSize = 0;
+    if (!m_Nodes.empty())
+        stack[stackSize++] = Entry{ 0, 0.0f };
+
+    while (stackSize > 0)
+    {
+        const Entry entry = stack[--stackSize];
+        if (entry.Distance > packetFar)
+            continue;
+
+        const Node& node = m_Nodes[entry.Node];
+        Entry children[Width];
+        uint32 childCount = 0;
+        for (uint32 c = 0; c < Width; ++c)
+        {
+            const uint32 child = node.Children[c];
+            if (child == Node::s_EmptyChild)
+                continue;
+
+            const Reg x0 = L::Mul(L::Sub(L::Set1(node.MinX[c]), originX), invX), x1 = L::Mul(L::Sub(L::Set1(node.MaxX[c]), originX), invX);
+            const Reg y0 = L::Mul(L::Sub(L::Set1(node.MinY[c]), originY), invY), y1 = L::Mul(L::Sub(L::Set1(node.MaxY[c]), originY), invY);
+            const Reg z0 = L::Mul(L::Sub(L::Set1(node.MinZ[c]), originZ), invZ), z1 = L::Mul(L::Sub(L::Set1(node.MaxZ[c]), originZ), invZ);
+            const Reg enter = L::Max(L::Max(L::Min(x0, x1), L::Min(y0, y1)), L::Max(L::Min(z0, z1), zero));
+            const Reg exit = L::Min(L::Min(L::Max(x0, x1), L::Max(y0, y1)), L::Min(L::Max(z0, z1), closest));
+            const uint32 hitMask = ~L::MoveMask(L::CmpGt(enter, exit)) & ((1u << laneCount) - 1);
+            if (!hitMask)
+                continue;
+
+            if (!(child & Node::s_LeafFlag))
+            {
+                float enters[laneCount];
+                L::Store(enters, enter);
+                float nearest = std::numeric_limits<float>::infinity();
+                for (uint32 mask = hitMask; mask; mask &= mask - 1)
+                    nearest = std::min(nearest, enters[std::countr_zero(mask)]);
+                children[childCount++] = Entry{ child, nearest };
+                continue;
+            }
+
+            const uint32 first = child & ~Node::s_LeafFlag;
+            for (uint32 t = first; t < first + node.TriangleCounts[c]; ++t)
+            {
+                const Triangle& triangle = m_Triangles[t];
+                const Reg e1x = L::Set1(triangle.Edge1.x), e1y = L::Set1(triangle.Edge1.y), e1z = L::Set1(triangle.Edge1.z);
+                const Reg e2x = L::Set1(triangle.Edge2.x), e2y = L::Set1(triangle.Edge2.y), e2z = L::Set1(triangle.Edge2.z);
+
+                // p = direction x edge2
+                const Reg px = L::Sub(L::Mul(directionY, e2z), L::Mul(directionZ, e2y));
+                const Reg py = L::Sub(L::Mul(directionZ, e2x), L::Mul(directionX, e2z));
+                const Reg pz = L::Sub(L::Mul(directionX, e2y), L::Mul(directionY, e2x));
+                const Reg det = L::MulAdd(e1x, px, L::MulAdd(e1y, py, L::Mul(e1z, pz)));
+                const Reg invDet = L::Div(one, det);
+
+                const Reg sx = L::Sub(originX, L::Set1(triangle.V0.x));
+                const Reg sy = L::Sub(originY, L::Set1(triangle.V0.y));
+                const Reg sz = L::Sub(originZ, L::Set1(triangle.V0.z));
+                const Reg u = L::Mul(L::MulAdd(sx, px, L::MulAdd(sy, py, L::Mul(sz, pz))), invDet);
+
+                // q = s x edge1
+                const Reg qx = L::Sub(L::Mul(sy, e1z), L::Mul(sz, e1y));
+                const Reg qy = L::Sub(L::Mul(sz, e1x), L::Mul(sx, e1z));
+                const Reg qz = L::Sub(L::Mul(sx, e1y), L::Mul(sy, e1x));
+                const Reg v = L::Mul(L::MulAdd(directionX, qx, L::MulAdd(directionY, qy, L::Mul(directionZ, qz))), invDet);
+                const Reg distance = L::Mul(L::MulAdd(e2x, qx, L::MulAdd(e2y, qy, L::Mul(e2z, qz))), invDet);
+
+                // Every failed condition forces the lane negative; the determinant check goes last to also reject NaN lanes
+                Reg accept = one;
+                accept = L::Select(L::CmpLt(u, zero), negativeOne, accept);
+                accept = L::Select(L::CmpLt(v, zero), negativeOne, accept);
+                accept = L::Select(L::CmpGt(L::Add(u, v), one), negativeOne, accept);
+                accept = L::Select(L::CmpLt(distance, zero), negativeOne, accept);
+                accept = L::Select(L::CmpLt(distance, closest), accept, negativeOne);
+                accept = L::Select(L::CmpGt(L::Abs(det), zero), accept, negativeOne);
+                const typename L::Mask hit = L::CmpGt(accept, zero);
+                if (!L::MoveMask(hit))
+                    continue;
+
+                closest = L::Select(hit, distance, closest);
+                hitU = L::Select(hit, u, hitU);
+                hitV = L::Select(hit, v, hitV);
+                hitTriangle = L::Select(hit, L::AsFloat(L::ISet1(static_cast<int32_t>(triangle.Index))), hitTriangle);
+            }
+            packetFar = maxLane(closest);
+        }
+
+        std::sort(children, children + childCount, [](const Entry& a, const Entry& b) { return a.Distance > b.Distance; });
+        for (uint32 c = 0; c < childCount; ++c)
+            stack[stackSize++] = children[c];
+    }
+
+    float distances[laneCount], us[laneCount], vs[laneCount], triangles[laneCount];
+    L::Store(distances, closest);
+    L::Store(us, hitU);
+    L::Store(vs, hitV);
+    L::Store(triangles, hitTriangle);
+    for (uint32 r = 0; r < laneCount; ++r)
+    {
+        const uint32 triangle = std::bit_cast<uint32>(triangles[r]);
+        hits[r] = triangle == ~0u ? BvhHit{} : BvhHit{ distances[r], triangle, us[r], vs[r] };
+    }
+}
+
+template<uint32 Width>
+BvhHit TriangleBvh<Width>::Intersect(const BvhRay& ray) const
+{
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        return IntersectSingle<ScalarLanes>(ray, false);
+    case SimdLevel::Sse:
+        return IntersectSingle<SseLanes>(ray, false);
+    default:
+        // One register covers a node, wider lanes would only test empty slots
+        if constexpr (Width == 8)
+        {
+            const BvhHit hit = IntersectSingle<Avx2Lanes>(ray, false);
+            _mm256_zeroupper();
+            return hit;
+        }
+        else
+        {
+            return IntersectSingle<SseLanes>(ray, false);
+        }
+    }
+}
+
+template<uint32 Width>
+bool TriangleBvh<Width>::IsOccluded(const BvhRay& ray) const
+{
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        return IntersectSingle<ScalarLanes>(ray, true).IsHit();
+    case SimdLevel::Sse:
+        return IntersectSingle<SseLanes>(ray, true).IsHit();
+    default:
+        if constexpr (Width == 8)
+        {
+            const bool occluded = IntersectSingle<Avx2Lanes>(ray, true).IsHit();
+            _mm256_zeroupper();
+            return occluded;
+        }
+        else
+        {
+            return IntersectSingle<SseLanes>(ray, true).IsHit();
+        }
+    }
+}
+
+template<uint32 Width>
+void TriangleBvh<Width>::IntersectPackets(Span<const BvhRay> rays, Span<BvhHit> hits) const
+{
+    if (rays.size() != hits.size())
+        throw std::invalid_argument("TriangleBvh::IntersectPackets: spans differ in length");
+
+    auto trace = [&]<class L>()
+    {
+        ForEachBlock<L>(rays.size(), [&]<class B>(size_t i)
+        {
+            IntersectPacket<B>(rays.data() + i, hits.data() + i);
+        });
+    };
+
+    switch (GetSimdLevel())
+    {
+    case SimdLevel::Scalar:
+        trace.template operator()<ScalarLanes>();
+        break;
+    case SimdLevel::Sse:
+        trace.template operator()<SseLanes>();
+        break;
+    case SimdLevel::Avx2:
+        trace.template operator()<Avx2Lanes>();
+        _mm256_zeroupper();
+        break;
+    case SimdLevel::Avx512:
+        trace.template operator()<Avx512Lanes>();
+        _mm256_zeroupper();
+        break;
+    }
+}
+
+template<uint32 Width>
+void TriangleBvh<Width>::QueryOverlap(const Aabb& bounds, Vector<uint32>& triangles) const
+{
+    if (m_Nodes.empty())
+        return;
+
+    uint32 stack[s_MaxStackSize];
+    uint32 stackSize = 0;
+    stack[stackSize++] = 0;
+    while (stackSize > 0)
+    {
+        const Node& node = m_Nodes[stack[--stackSize]];
+        for (uint32 c = 0; c < Width; ++c)
+        {
+            const uint32 child = node.Children[c];
+            if (child == Node::s_EmptyChild)
+                continue;
+            const Aabb childBounds{ float3{ node.MinX[c], node.MinY[c], node.MinZ[c] }, float3{ node.MaxX[c], node.MaxY[c], node.MaxZ[c] } };
+            if (!Overlaps(childBounds, bounds))
+                continue;
+
+            if (!(child & Node::s_LeafFlag))
+            {
+                stack[stackSize++] = child;
+                continue;
+            }
+
+            const uint32 first = child & ~Node::s_LeafFlag;
+            for (uint32 t = first; t < first + node.TriangleCounts[c]; ++t)
+            {
+                const Triangle& triangle = m_Triangles[t];
+                if (TriangleOverlapsBox(triangle.V0, triangle.V0 + triangle.Edge1, triangle.V0 + triangle.Edge2, bounds))
+                    triangles.push_back(triangle.Index);
+            }
+        }
+    }
+}
+
+template class TriangleBvh<4>;
+template class TriangleBvh<8>;
+
+TriangleBvhBenchmarkReport RunTriangleBvhBenchmark(const MeshTemplate& meshTemplate, uint32 rayGridSize)
+{
+    TriangleBvhBenchmarkReport report;
+    report.TriangleCount = meshTemplate.GetIndexCount() / 3;
+
+    auto start = std::chrono::steady_clock::now();
+    const TriangleBvh4 bvh4(meshTemplate);
+    report.Build4Milliseconds = MillisecondsSince(start);
+
+    start = std::chrono::steady_clock::now();
+    const TriangleBvh8 bvh8(meshTemplate);
+    report.Build8Milliseconds = MillisecondsSince(start);
+    report.BuildMTrianglesPerSecond = report.Build8Milliseconds > 0.0 ? report.TriangleCount / (report.Build8Milliseconds * 1000.0) : 0.0;
+    report.Memory4Bytes = bvh4.GetMemoryBytes();
+    report.Memory8Bytes = bvh8.GetMemoryBytes();
+
+    // Pinhole camera on the diagonal looking at the bounds, rows of consecutive pixels form the packets
+    const Aabb& bounds = bvh8.GetBounds();
+    const float3 center = (bounds.Min + bounds.Max) * 0.5f;
+    const float radius = std::max(Length(bounds.Max - bounds.Min) * 0.5f, 1e-6f);
+    const float3 eye = center + Normalize(float3{ 1.0f, 0.7f, -1.2f }) * (radius * 2.5f);
+    const float3 forward = Normalize(center - eye);
+    const float3 right = Normalize(Cross(float3{ 0.0f, 1.0f, 0.0f }, forward));
+    const float3 up = Cross(forward, right);
+    const float halfSize = 0.45f;
+
+    const size_t rayCount = size_t(rayGridSize) * rayGridSize;
+    Vector<BvhRay> cameraRays(rayCount);
+    for (uint32 y = 0; y < rayGridSize; ++y)
+    {
+        for (uint32 x = 0; x < rayGridSize; ++x)
+        {
+            const float sx = ((x + 0.5f) / rayGridSize * 2.0f - 1.0f) * halfSize;
+            const float sy = (1.0f - (y + 0.5f) / rayGridSize * 2.0f) * halfSize;
+            cameraRays[size_t(y) * rayGridSize + x] = BvhRay{ eye, forward + right * sx + up * sy };
+        }
+    }
+
+    std::mt19937 random(99);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    Vector<BvhRay> randomRays(rayCount);
+    for (BvhRay& ray : randomRays)
+    {
+        const float3 from = center + Normalize(float3{ unit(random), unit(random), unit(random) }) * (radius * 1.5f);
+        const float3 to = center + float3{ unit(random), unit(random), unit(random) } * (radius * 0.5f);
+        ray = BvhRay{ from, to - from };
+    }
+
+    Vector<BvhHit> hits(rayCount);
+    auto traceSingle = [&](const auto& bvh, const Vector<BvhRay>& rays)
+    {
+        const auto traceStart = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rays.size(); ++r)
+            hits[r] = bvh.Intersect(rays[r]);
+        return rays.size() / (MillisecondsSince(traceStart) * 1000.0);
+    };
+    auto tracePackets = [&](const auto& bvh, const Vector<BvhRay>& rays)
+    {
+        const auto traceStart = std::chrono::steady_clock::now();
+        bvh.IntersectPackets(rays, hits);
+        return rays.size() / (MillisecondsSince(traceStart) * 1000.0);
+    };
+
+    report.Trace4MRaysPerSecond = traceSingle(bvh4, cameraRays);
+    report.Trace8MRaysPerSecond = traceSingle(bvh8, cameraRays);
+    report.HitRatio = float(std::count_if(hits.begin(), hits.end(), [](const BvhHit& hit) { return hit.IsHit(); })) / float(std::max<size_t>(rayCount, 1));
+    report.Packet4MRaysPerSecond = tracePackets(bvh4, cameraRays);
+    report.Packet8MRaysPerSecond = tracePackets(bvh8, cameraRays);
+    report.IncoherentTrace8MRaysPerSecond = traceSingle(bvh8, randomRays);
+    return report;
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "Engine/AabbTree.h"
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+struct BvhRay
+{
+    float3 Origin = { 0.0f, 0.0f, 0.0f };
+    float3 Direction = { 0.0f, 0.0f, 1.0f };    // Need not be normalized, distances are in units of its length
+    float MaxDistance = std::numeric_limits<float>::infinity();
+};
+
+struct BvhHit
+{
+    float Distance = std::numeric_limits<float>::infinity();
+    uint32 Triangle = ~0u;      // Position in the source index list / 3
+    float U = 0.0f;             // Barycentric weights of the second and third vertex
+    float V = 0.0f;
+
+    bool IsHit() const { return Triangle != ~0u; }
+};
+
+struct TriangleBvhSettings
+{
+    uint32 MaxLeafTriangles = 4;        // At most 255
+    uint32 ParallelThreshold = 65536;   // Triangle count from which the build runs on the worker threads
+};
+
+// Width children per node as SoA bounds, one or more whole cache lines. Children are a node index, or the first
+// triangle | s_LeafFlag with TriangleCounts set. Empty slots have inverted bounds so the box test always misses them
+template<uint32 Width>
+struct alignas(64) TriangleBvhNode
+{
+    static constexpr uint32 s_EmptyChild = ~0u;
+    static constexpr uint32 s_LeafFlag = 0x80000000u;
+
+    float MinX[Width];
+    float MinY[Width];
+    float MinZ[Width];
+    float MaxX[Width];
+    float MaxY[Width];
+    float MaxZ[Width];
+    uint32 Children[Width];
+    uint8 TriangleCounts[Width];
+};
+static_assert(sizeof(TriangleBvhNode<4>) == 128, "BVH4 node should span two cache lines");
+static_assert(sizeof(TriangleBvhNode<8>) == 256, "BVH8 node should span four cache lines");
+
+// Triangle BVH for picking, baking and collision queries. Built as a binary tree with binned SAH, large meshes split
+// their top levels with parallel binning and build the subtrees on the worker threads, then collapsed to Width-wide
+// nodes. Single rays test all children of a node in one SIMD pass, packets trace SIMD-width groups of rays together.
+// Triangles are double-sided
+template<uint32 Width>
+class TriangleBvh
+{
+public:
+    static_assert(Width == 4 || Width == 8, "TriangleBvh supports 4 and 8 wide nodes");
+    using Node = TriangleBvhNode<Width>;
+
+    TriangleBvh() = default;
+    // All submeshes, triangle ids count over CopyIndices()
+    explicit TriangleBvh(const MeshTemplate& meshTemplate, const TriangleBvhSettings& settings = {});
+    TriangleBvh(Span<const MeshVertex> vertices, Span<const uint32> indices, const TriangleBvhSettings& settings = {});
+
+    // Closest hit
+    BvhHit Intersect(const BvhRay& ray) const;
+    // Any hit, for shadow and visibility rays
+    bool IsOccluded(const BvhRay& ray) const;
+    // Closest hits for many rays. Consecutive rays are traced as one packet per SIMD width, order coherent rays together
+    void IntersectPackets(Span<const BvhRay> rays, Span<BvhHit> hits) const;
+
+    // Appends the triangles that intersect bounds
+    void QueryOverlap(const Aabb& bounds, Vector<uint32>& triangles) const;
+
+    const Aabb& GetBounds() const { return m_Bounds; }
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+    size_t GetTriangleCount() const { return m_Triangles.size(); }
+    uint32 GetDepth() const { return m_Depth; }
+    size_t GetMemoryBytes() const { return m_Nodes.size() * sizeof(Node) + m_Triangles.size() * sizeof(Triangle); }
+
+private:
+    // Pre-transformed for Moller-Trumbore
+    struct Triangle
+    {
+        float3 V0;
+        float3 Edge1;
+        float3 Edge2;
+        uint32 Index;
+    };
+
+    void Build(Span<const MeshVertex> vertices, Span<const uint32> indices, const TriangleBvhSettings& settings);
+
+    template<class L>
+    BvhHit IntersectSingle(const BvhRay& ray, bool anyHit) const;
+    template<class L>
+    void IntersectPacket(const BvhRay* rays, BvhHit* hits) const;
+
+    Vector<Node> m_Nodes;
+    Vector<Triangle> m_Triangles;
+    Aabb m_Bounds;
+    uint32 m_Depth = 0;
+};
+
+using TriangleBvh4 = TriangleBvh<4>;
+using TriangleBvh8 = TriangleBvh<8>;
+
+extern template class TriangleBvh<4>;
+extern template class TriangleBvh<8>;
+
+struct TriangleBvhBenchmarkReport
+{
+    size_t TriangleCount = 0;
+    double Build4Milliseconds = 0.0;
+    double Build8Milliseconds = 0.0;
+    double BuildMTrianglesPerSecond = 0.0;          // BVH8
+    double Trace4MRaysPerSecond = 0.0;              // Single rays over the camera view
+    double Trace8MRaysPerSecond = 0.0;
+    double Packet4MRaysPerSecond = 0.0;             // Camera rays only, packets need coherence
+    double Packet8MRaysPerSecond = 0.0;
+    double IncoherentTrace8MRaysPerSecond = 0.0;
+    float HitRatio = 0.0f;                          // Of the camera rays
+    size_t Memory4Bytes = 0;
+    size_t Memory8Bytes = 0;
+};
+
+// Headless benchmark: builds both widths, then traces a rayGridSize^2 camera view of the mesh bounds and as many
+// random rays through them
+TriangleBvhBenchmarkReport RunTriangleBvhBenchmark(const MeshTemplate& meshTemplate, uint32 rayGridSize = 512);
@@ -0,0 +1,73 @@
+#include "UploadRingBuffer.h"
+
+#include <stdexcept>
+
+void UploadRingBuffer::Initialize(ID3D12Device* device, uint64 capacity)
+{
+    if (!device)
+    {
+        throw std::invalid_argument("Device cannot be null");
+    }
+
+    D3D12_HEAP_PROPERTIES heapProps = {};
+    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
+    heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    heapProps.CreationNodeMask = 1;
+    heapProps.VisibleNodeMask = 1;
+
+    D3D12_RESOURCE_DESC resourceDesc = {};
+    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    resourceDesc.Alignment = 0;
+    resourceDesc.Width = AlignUp(capacity, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    resourceDesc.Height = 1;
+    resourceDesc.DepthOrArraySize = 1;
+    resourceDesc.MipLevels = 1;
+    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+    resourceDesc.SampleDesc.Count = 1;
+    resourceDesc.SampleDesc.Quality = 0;
+    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+    if (FAILED(device->CreateCommittedResource(
+        &heapProps,
+        D3D12_HEAP_FLAG_NONE,
+        &resourceDesc,
+        D3D12_RESOURCE_STATE_GENERIC_READ,
+        nullptr,
+        IID_PPV_ARGS(&m_Buffer))))
+    {
+        throw std::runtime_error("Failed to create upload ring buffer");
+    }
+
+    // Keep it mapped for the lifetime of the resource
+    if (FAILED(m_Buffer->Map(0, nullptr, reinterpret_cast<void**>(&m_MappedData))))
+    {
+        throw std::runtime_error("Failed to map upload ring buffer");
+    }
+
+    m_GpuAddress = m_Buffer->GetGPUVirtualAddress();
+    m_Ring = UploadRing(resourceDesc.Width);
+}
+
+void UploadRingBuffer::Release()
+{
+    if (m_Buffer)
+    {
+        m_Buffer->Unmap(0, nullptr);
+        m_MappedData = nullptr;
+        m_Buffer.Reset();
+    }
+    m_GpuAddress = 0;
+    m_Ring = UploadRing();
+}
+
+UploadAllocation UploadRingBuffer::Allocate(uint64 size, uint64 alignment)
+{
+    const uint64 offset = m_Ring.Allocate(size, alignment);
+    if (offset == UploadRing::s_InvalidOffset)
+    {
+        throw std::runtime_error("Upload ring buffer is full, increase its capacity");
+    }
+    return UploadAllocation{ m_MappedData + offset, m_GpuAddress + offset };
+}
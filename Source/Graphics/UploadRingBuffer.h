@@ -0,0 +1,45 @@
+#pragma once
+#include <cstring>
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Engine/UploadRing.h"
+
+struct UploadAllocation
+{
+    uint8* CpuAddress = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;
+};
+
+// Persistently mapped upload heap buffer shared by every frame in flight, suballocated through UploadRing.
+// Per-frame data such as the frame and object constants is written here instead of into buffers of their own
+class UploadRingBuffer
+{
+public:
+    void Initialize(ID3D12Device* device, uint64 capacity);
+    void Release();
+
+    // Throws when the frames in flight already fill the ring
+    UploadAllocation Allocate(uint64 size, uint64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    // Copies data into a constant buffer slice and returns its address for a root CBV
+    template<class T>
+    D3D12_GPU_VIRTUAL_ADDRESS UploadConstants(const T& data)
+    {
+        const UploadAllocation allocation = Allocate(sizeof(T));
+        memcpy(allocation.CpuAddress, &data, sizeof(T));
+        return allocation.GpuAddress;
+    }
+
+    // Call after signaling the fence for the frame's command lists, then Reclaim with the completed value later on
+    void FinishFrame(uint64 fenceValue) { m_Ring.FinishFrame(fenceValue); }
+    void Reclaim(uint64 completedFenceValue) { m_Ring.Reclaim(completedFenceValue); }
+
+    const UploadRing& GetRing() const { return m_Ring; }
+
+private:
+    ComPtr<ID3D12Resource> m_Buffer;
+    uint8* m_MappedData = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_GpuAddress = 0;
+    UploadRing m_Ring;
+};
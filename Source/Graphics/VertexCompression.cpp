@@ -0,0 +1,349 @@
+#include "VertexCompression.h"
+
+#include <bit>
+#include <cstring>
+
+namespace
+{
+    constexpr D3D12_INPUT_ELEMENT_DESC s_Float32Layout[] = {
+        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+
+    constexpr D3D12_INPUT_ELEMENT_DESC s_Quantized16Layout[] = {
+        { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+
+    // The normal overlaps the unused fourth position component, the shader only reads POSITION.xyz
+    constexpr D3D12_INPUT_ELEMENT_DESC s_Quantized8Layout[] = {
+        { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "NORMAL", 0, DXGI_FORMAT_R8G8_SNORM, 0, 6, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        { "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+    };
+
+    uint16 QuantizeUnorm16(float value) noexcept
+    {
+        return static_cast<uint16>(std::lround(Saturate(value) * 65535.0f));
+    }
+
+    float DequantizeUnorm16(uint16 value) noexcept
+    {
+        return value / 65535.0f;
+    }
+
+    // SNORM with 2^(bits-1) - 1 steps per unit, matching the D3D conversion rules
+    template<int Bits>
+    float DequantizeSnorm(int32 value) noexcept
+    {
+        constexpr float steps = float((1 << (Bits - 1)) - 1);
+        return std::max(value / steps, -1.0f);
+    }
+
+    // Picks the best of the four lattice points around the continuous octahedral coordinate,
+    // which roughly halves the angular error compared to plain rounding
+    template<int Bits>
+    void EncodeNormal(const float3& normal, int32& outX, int32& outY) noexcept
+    {
+        constexpr float steps = float((1 << (Bits - 1)) - 1);
+        const float3 n = Normalize(normal);
+        const float2 e = OctEncode(n);
+        const float baseX = std::floor(Clamp(e.x, -1.0f, 1.0f) * steps);
+        const float baseY = std::floor(Clamp(e.y, -1.0f, 1.0f) * steps);
+
+        float bestDot = -2.0f;
+        for (int i = 0; i < 4; ++i)
+        {
+            const int32 qx = static_cast<int32>(Clamp(baseX + (i & 1), -steps, steps));
+            const int32 qy = static_cast<int32>(Clamp(baseY + (i >> 1), -steps, steps));
+            const float3 decoded = OctDecode(float2{ DequantizeSnorm<Bits>(qx), DequantizeSnorm<Bits>(qy) });
+            const float d = Dot(decoded, n);
+            if (d > bestDot)
+            {
+                bestDot = d;
+                outX = qx;
+                outY = qy;
+            }
+        }
+    }
+
+    PositionDequantization ComputeDequantization(Span<const MeshVertex> vertices) noexcept
+    {
+        if (vertices.empty())
+            return {};
+
+        float3 minimum = vertices[0].Position;
+        float3 maximum = vertices[0].Position;
+        for (const MeshVertex& v : vertices)
+        {
+            minimum = { std::min(minimum.x, v.Position.x), std::min(minimum.y, v.Position.y), std::min(minimum.z, v.Position.z) };
+            maximum = { std::max(maximum.x, v.Position.x), std::max(maximum.y, v.Position.y), std::max(maximum.z, v.Position.z) };
+        }
+        return PositionDequantization{ minimum, maximum - minimum };
+    }
+
+    void EncodePosition(const float3& position, const PositionDequantization& dq, uint16 out[3]) noexcept
+    {
+        const float* p = &position.x;
+        const float* offset = &dq.Offset.x;
+        const float* scale = &dq.Scale.x;
+        for (int c = 0; c < 3; ++c)
+        {
+            // A flat axis keeps scale 0 and decodes to the offset regardless of the stored value
+            out[c] = scale[c] > 0.0f ? QuantizeUnorm16((p[c] - offset[c]) / scale[c]) : 0;
+        }
+    }
+
+    float3 DecodePosition(const uint16 in[3], const PositionDequantization& dq) noexcept
+    {
+        const float3 unorm{ DequantizeUnorm16(in[0]), DequantizeUnorm16(in[1]), DequantizeUnorm16(in[2]) };
+        return dq.Offset + unorm * dq.Scale;
+    }
+}
+
+uint16 FloatToHalf(float value) noexcept
+{
+    const uint32 bits = std::bit_cast<uint32>(value);
+    const uint16 sign = static_cast<uint16>((bits >> 16) & 0x8000u);
+    const uint32 absBits = bits & 0x7FFFFFFFu;
+
+    // NaN keeps a quiet payload bit, infinity and overflow map to infinity
+    if (absBits >= 0x7F800000u)
+        return sign | (absBits > 0x7F800000u ? 0x7E00u : 0x7C00u);
+    if (absBits >= 0x477FF000u)
+        return sign | 0x7C00u;
+
+    // Subnormal halves: let the FPU do the rounding by adding a magic number with the target exponent
+    if (absBits < 0x38800000u)
+    {
+        const float magic = std::bit_cast<float>(0x3F000000u); // 0.5, puts 2^-24 in the last mantissa bit
+        const float shifted = std::bit_cast<float>(absBits) + magic;
+        return sign | static_cast<uint16>(std::bit_cast<uint32>(shifted) - 0x3F000000u);
+    }
+
+    // Normal halves: rebias the exponent and round the mantissa to nearest even
+    const uint32 mantissaOdd = (absBits >> 13) & 1u;
+    const uint32 rounded = absBits + 0xC8000FFFu + mantissaOdd;
+    return sign | static_cast<uint16>(rounded >> 13);
+}
+
+float HalfToFloat(uint16 value) noexcept
+{
+    const uint32 sign = static_cast<uint32>(value & 0x8000u) << 16;
+    const uint32 exponent = (value >> 10) & 0x1Fu;
+    const uint32 mantissa = value & 0x3FFu;
+
+    if (exponent == 0x1Fu)
+        return std::bit_cast<float>(sign | 0x7F800000u | (mantissa << 13));
+    if (exponent == 0)
+    {
+        // Zero or subnormal: mantissa * 2^-24
+        const float magnitude = static_cast<float>(mantissa) * std::bit_cast<float>(0x33800000u);
+        return std::bit_cast<float>(sign | std::bit_cast<uint32>(magnitude));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+float2 OctEncode(const float3& n) noexcept
+{
+    const float invL1 = 1.0f / (std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z));
+    float2 e{ n.x * invL1, n.y * invL1 };
+    if (n.z < 0.0f)
+    {
+        // Fold the lower hemisphere over the diagonals
+        const float ex = (1.0f - std::fabs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+        const float ey = (1.0f - std::fabs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+        e = { ex, ey };
+    }
+    return e;
+}
+
+float3 OctDecode(const float2& e) noexcept
+{
+    float3 n{ e.x, e.y, 1.0f - std::fabs(e.x) - std::fabs(e.y) };
+    const float t = Saturate(-n.z);
+    n.x += n.x >= 0.0f ? -t : t;
+    n.y += n.y >= 0.0f ? -t : t;
+    return Normalize(n);
+}
+
+uint32 GetVertexStride(VertexFormat format) noexcept
+{
+    switch (format)
+    {
+    case VertexFormat::Quantized16:
+        return sizeof(QuantizedVertex);
+    case VertexFormat::Quantized8:
+        return sizeof(QuantizedVertexOct8);
+    default:
+        return sizeof(MeshVertex);
+    }
+}
+
+Span<const D3D12_INPUT_ELEMENT_DESC> GetInputLayout(VertexFormat format) noexcept
+{
+    switch (format)
+    {
+    case VertexFormat::Quantized16:
+        return s_Quantized16Layout;
+    case VertexFormat::Quantized8:
+        return s_Quantized8Layout;
+    default:
+        return s_Float32Layout;
+    }
+}
+
+float4x4 ApplyDequantization(const float4x4& transposedWorld, const PositionDequantization& dequantization) noexcept
+{
+    // transposedWorld * transpose(Scale then Offset): scale the first three columns, offset goes into the last
+    const float3& s = dequantization.Scale;
+    const float3& o = dequantization.Offset;
+    float4x4 result = transposedWorld;
+    for (int r = 0; r < 4; ++r)
+    {
+        const float* row = transposedWorld.m[r];
+        result.m[r][0] = row[0] * s.x;
+        result.m[r][1] = row[1] * s.y;
+        result.m[r][2] = row[2] * s.z;
+        result.m[r][3] = row[0] * o.x + row[1] * o.y + row[2] * o.z + row[3];
+    }
+    return result;
+}
+
+const char* GetVertexShaderName(VertexFormat format) noexcept
+{
+    return format == VertexFormat::Float32 ? "BlinnPhong" : "BlinnPhongQuantized";
+}
+
+CompressedVertices CompressVertices(Span<const MeshVertex> vertices, VertexFormat format)
+{
+    CompressedVertices result;
+    result.Format = format;
+    result.Stride = GetVertexStride(format);
+    result.VertexCount = static_cast<uint32>(vertices.size());
+    result.Data.resize(vertices.size() * result.Stride);
+
+    if (format == VertexFormat::Float32)
+    {
+        if (!vertices.empty())
+            memcpy(result.Data.data(), vertices.data(), result.Data.size());
+        return result;
+    }
+
+    result.Dequantization = ComputeDequantization(vertices);
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const MeshVertex& v = vertices[i];
+        uint8* dst = result.Data.data() + i * result.Stride;
+
+        if (format == VertexFormat::Quantized16)
+        {
+            QuantizedVertex q{};
+            EncodePosition(v.Position, result.Dequantization, q.Position);
+            int32 nx = 0, ny = 0;
+            EncodeNormal<16>(v.Normal, nx, ny);
+            q.Normal[0] = static_cast<int16>(nx);
+            q.Normal[1] = static_cast<int16>(ny);
+            q.Uv[0] = FloatToHalf(v.Uv.x);
+            q.Uv[1] = FloatToHalf(v.Uv.y);
+            memcpy(dst, &q, sizeof(q));
+        }
+        else
+        {
+            QuantizedVertexOct8 q{};
+            EncodePosition(v.Position, result.Dequantization, q.Position);
+            int32 nx = 0, ny = 0;
+            EncodeNormal<8>(v.Normal, nx, ny);
+            q.Normal[0] = static_cast<int8>(nx);
+            q.Normal[1] = static_cast<int8>(ny);
+            q.Uv[0] = FloatToHalf(v.Uv.x);
+            q.Uv[1] = FloatToHalf(v.Uv.y);
+            memcpy(dst, &q, sizeof(q));
+        }
+    }
+
+    return result;
+}
+
+CompressedVertices CompressVertices(const MeshTemplate& meshTemplate, VertexFormat format)
+{
+    return CompressVertices(meshTemplate.GetVertices(), format);
+}
+
+Vector<MeshVertex> DecompressVertices(const CompressedVertices& compressed)
+{
+    if (compressed.Data.size() != size_t(compressed.VertexCount) * compressed.Stride)
+        throw std::invalid_argument("DecompressVertices: data size does not match vertex count and stride");
+
+    Vector<MeshVertex> vertices(compressed.VertexCount);
+    if (compressed.Format == VertexFormat::Float32)
+    {
+        if (!vertices.empty())
+            memcpy(vertices.data(), compressed.Data.data(), compressed.Data.size());
+        return vertices;
+    }
+
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const uint8* src = compressed.Data.data() + i * compressed.Stride;
+        MeshVertex& v = vertices[i];
+
+        if (compressed.Format == VertexFormat::Quantized16)
+        {
+            QuantizedVertex q;
+            memcpy(&q, src, sizeof(q));
+            v.Position = DecodePosition(q.Position, compressed.Dequantization);
+            v.Normal = OctDecode(float2{ DequantizeSnorm<16>(q.Normal[0]), DequantizeSnorm<16>(q.Normal[1]) });
+            v.Uv = { HalfToFloat(q.Uv[0]), HalfToFloat(q.Uv[1]) };
+        }
+        else
+        {
+            QuantizedVertexOct8 q;
+            memcpy(&q, src, sizeof(q));
+            v.Position = DecodePosition(q.Position, compressed.Dequantization);
+            v.Normal = OctDecode(float2{ DequantizeSnorm<8>(q.Normal[0]), DequantizeSnorm<8>(q.Normal[1]) });
+            v.Uv = { HalfToFloat(q.Uv[0]), HalfToFloat(q.Uv[1]) };
+        }
+    }
+
+    return vertices;
+}
+
+VertexCompressionError MeasureCompressionError(Span<const MeshVertex> original, const CompressedVertices& compressed)
+{
+    if (original.size() != compressed.VertexCount)
+        throw std::invalid_argument("MeasureCompressionError: vertex counts differ");
+
+    const Vector<MeshVertex> decoded = DecompressVertices(compressed);
+
+    VertexCompressionError error;
+    error.OriginalBytes = original.size() * sizeof(MeshVertex);
+    error.CompressedBytes = compressed.Data.size();
+
+    double positionSum = 0.0;
+    double normalSum = 0.0;
+    for (size_t i = 0; i < original.size(); ++i)
+    {
+        const float positionError = Length(decoded[i].Position - original[i].Position);
+        // atan2 of sine and cosine stays accurate for the tiny angles acos would flush to zero
+        const float3 n = Normalize(original[i].Normal);
+        const float normalError = Degrees(Atan2(Length(Cross(decoded[i].Normal, n)), Dot(decoded[i].Normal, n)));
+        const float uvError = std::max(std::fabs(decoded[i].Uv.x - original[i].Uv.x), std::fabs(decoded[i].Uv.y - original[i].Uv.y));
+
+        error.MaxPositionError = std::max(error.MaxPositionError, positionError);
+        error.MaxNormalError = std::max(error.MaxNormalError, normalError);
+        error.MaxUvError = std::max(error.MaxUvError, uvError);
+        positionSum += positionError;
+        normalSum += normalError;
+    }
+
+    if (!original.empty())
+    {
+        error.MeanPositionError = static_cast<float>(positionSum / original.size());
+        error.MeanNormalError = static_cast<float>(normalSum / original.size());
+    }
+    return error;
+}
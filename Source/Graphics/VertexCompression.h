@@ -0,0 +1,70 @@
+#pragma once
+#include <d3d12.h>
+
+#include "Engine/BaseTypes.h"
+#include "Graphics/Mesh.h"
+
+struct QuantizedVertex
+{
+    uint16 Position[3];     // UNORM relative to the mesh AABB
+    uint16 Padding;
+    int16 Normal[2];        // SNORM octahedral
+    uint16 Uv[2];           // Half floats
+};
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must be 16 bytes");
+
+struct QuantizedVertexOct8
+{
+    uint16 Position[3];     // UNORM relative to the mesh AABB
+    int8 Normal[2];         // SNORM octahedral, read as the fourth position component's bytes
+    uint16 Uv[2];           // Half floats
+};
+static_assert(sizeof(QuantizedVertexOct8) == 12, "QuantizedVertexOct8 must be 12 bytes");
+
+// Encoded vertex stream ready for upload
+struct CompressedVertices
+{
+    VertexFormat Format = VertexFormat::Float32;
+    uint32 Stride = 0;
+    uint32 VertexCount = 0;
+    PositionDequantization Dequantization;
+    Vector<uint8> Data;
+};
+
+struct VertexCompressionError
+{
+    float MaxPositionError = 0.0f;      // Object-space units
+    float MeanPositionError = 0.0f;
+    float MaxNormalError = 0.0f;        // Degrees
+    float MeanNormalError = 0.0f;
+    float MaxUvError = 0.0f;            // Largest absolute component error
+    size_t OriginalBytes = 0;
+    size_t CompressedBytes = 0;
+};
+
+// IEEE 754 binary16 conversion, round to nearest even
+uint16 FloatToHalf(float value) noexcept;
+float HalfToFloat(uint16 value) noexcept;
+
+// Octahedral normal mapping onto [-1, 1]^2 and back
+float2 OctEncode(const float3& n) noexcept;
+float3 OctDecode(const float2& e) noexcept;
+
+uint32 GetVertexStride(VertexFormat format) noexcept;
+
+// Input layout for the format, input slot 0
+Span<const D3D12_INPUT_ELEMENT_DESC> GetInputLayout(VertexFormat format) noexcept;
+
+// Folds the position dequantization into a transposed world matrix as used by ObjectData
+float4x4 ApplyDequantization(const float4x4& transposedWorld, const PositionDequantization& dequantization) noexcept;
+
+// Vertex shader name loaded by MeshPipeline for the format
+const char* GetVertexShaderName(VertexFormat format) noexcept;
+
+CompressedVertices CompressVertices(Span<const MeshVertex> vertices, VertexFormat format);
+CompressedVertices CompressVertices(const MeshTemplate& meshTemplate, VertexFormat format);
+
+Vector<MeshVertex> DecompressVertices(const CompressedVertices& compressed);
+
+// Compares a compressed stream against its source vertices
+VertexCompressionError MeasureCompressionError(Span<const MeshVertex> original, const CompressedVertices& compressed);
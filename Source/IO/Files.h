@@ -18,7 +18,7 @@
 inline void LoadBinaryFile(const String& path, Vector<uint8>& outFile)
 {
     std::ifstream file(path, std::ios::binary | std::ios::ate);
-    if (!file) throw std::runtime_error("Failed to open shader file: " + path);
+    if (!file) throw std::runtime_error("Failed to open shader file: " + path + " (build the ThorShaders target or run Scripts/CompileShaders.bat)");
     std::streamsize size = file.tellg();
     file.seekg(0, std::ios::beg);
     outFile.resize(static_cast<size_t>(size));
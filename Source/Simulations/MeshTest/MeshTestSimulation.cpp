@@ -1,6 +1,7 @@
 #include "MeshTestSimulation.h"
 
 #include "Graphics/HelperFunctions.h"
+#include "Graphics/MeshSimplifier.h"
 
 void MeshTestSimulation::PopulateCommandList()
 {
@@ -12,15 +13,44 @@ void MeshTestSimulation::PopulateCommandList()
     frameData.LightColor = m_LightColor;
     frameData.InvView = XMMatrixTranspose(XMMatrixInverse(nullptr, m_Camera->GetViewMatrix()));
 
-    // Copy frame data to the buffer
+    // Copy frame data to the upload ring
+    const D3D12_GPU_VIRTUAL_ADDRESS frameDataAddress = m_UploadRing.UploadConstants(frameData);
+
+    // Cull against the view frustum, then against the occluders in view, then pick LOD levels for the survivors
     {
-        memcpy(m_MappedFrameData + m_FrameDataSize * m_FrameIndex, &frameData, sizeof(FrameData));
+        Object::GatherBoundingSpheres(m_ObjectPointers, m_BoundingSpheres.View());
+        m_VisibleIndices.clear();
+        m_CullStats = CullSpheres(m_Camera->GetFrustumPlanes(), m_BoundingSpheres.View(), m_VisibleIndices);
+
+        m_VisibleObjects.clear();
+        for (uint32 index : m_VisibleIndices)
+            m_VisibleObjects.push_back(m_ObjectPointers[index]);
+
+        float4x4 viewProjection;
+        XMStoreFloat4x4(&viewProjection, m_Camera->GetViewProjectionMatrix());
+        m_OcclusionCuller.BeginFrame(viewProjection);
+        m_OcclusionCuller.AddOccluders(m_VisibleObjects);
+        m_OcclusionCuller.RenderOccluders();
+
+        m_UnoccludedIndices.clear();
+        m_OcclusionStats = m_OcclusionCuller.CullSpheres(m_BoundingSpheres.View(), m_VisibleIndices, m_UnoccludedIndices);
+
+        m_VisibleObjects.clear();
+        for (uint32 index : m_UnoccludedIndices)
+            m_VisibleObjects.push_back(m_ObjectPointers[index]);
+
+        const float viewportHeight = static_cast<float>(m_RenderTargets[m_FrameIndex]->GetDesc().Height);
+        SelectLods(m_VisibleObjects, *m_Camera, viewportHeight);
     }
 
     // Reset command allocator and command list
     m_CommandAllocator[m_FrameIndex]->Reset();
     m_CommandList->Reset(m_CommandAllocator[m_FrameIndex].Get(), nullptr);
 
+    // Shader-visible heaps, the material textures are read through them
+    ID3D12DescriptorHeap* descriptorHeaps[] = { m_CbvUavSrvHeap.Get(), m_SamplerHeap.Get() };
+    m_CommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
+
     // Transition final frame to render target
     CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
         m_RenderTargets[m_FrameIndex].Get(),
@@ -65,14 +95,40 @@ void MeshTestSimulation::PopulateCommandList()
         m_CommandList->RSSetScissorRects(1, &scissorRect);
     }
 
-    // Draw mesh
+    // Draw meshes sorted by pipeline, material and mesh, then front to back. The frame data (b0) and material table are
+    // bound with each pipeline
     {
-        m_MeshPipeline->Bind(m_CommandList.Get());
-
-        // Set frame data constant buffer (b0)
-        m_CommandList->SetGraphicsRootConstantBufferView(0, m_FrameData->GetGPUVirtualAddress() + m_FrameDataSize * m_FrameIndex);
-
-        m_Object->Draw(m_CommandList.Get());
+        const float3& viewPosition = m_Camera->GetPosition();
+        const float3 viewDirection = Normalize(m_Camera->GetForward());
+        m_DrawList.Begin(m_Camera->GetNearZ(), m_Camera->GetFarZ());
+        for (Object* object : m_VisibleObjects)
+            m_DrawList.Add(*object, *m_MeshPipeline, Dot(object->GetPosition() - viewPosition, viewDirection));
+        m_DrawList.Sort();
+
+        if (m_UseInstancing)
+        {
+            // One instanced draw per mesh in sorted order, its instances front to back. DrawList::Add already left out
+            // the objects whose mesh still waits for its staging upload
+            m_InstanceMeshes.clear();
+            m_InstanceFormats.clear();
+            m_InstanceData.clear();
+            for (size_t i = 0; i < m_DrawList.GetItemCount(); ++i)
+            {
+                const Object& object = *m_DrawList.GetSortedItem(i).Object;
+                m_InstanceMeshes.push_back(object.GetMesh().get());
+                m_InstanceFormats.push_back(object.GetMesh()->GetVertexFormat());
+                m_InstanceData.push_back(object.GetObjectData());
+            }
+            m_InstanceBatcher.Build(m_InstanceMeshes, m_InstanceFormats, m_InstanceData);
+
+            // Indexed by VertexFormat, the scene only draws Float32 meshes
+            const MeshPipeline* const pipelines[] = { m_InstancedPipeline.get() };
+            m_InstanceBuffer.Draw(m_CommandList.Get(), m_InstanceBatcher, pipelines, frameDataAddress, m_MaterialTable, m_FrameIndex);
+        }
+        else
+        {
+            m_DrawList.Submit(m_CommandList.Get(), frameDataAddress, m_UploadRing, m_MaterialTable);
+        }
     }
 
     // Transition final frame to present
@@ -111,76 +167,70 @@ void MeshTestSimulation::PostInit()
     {
         D3D12_RESOURCE_DESC depthDesc, renderDesc;
         renderDesc = m_RenderTargets[0]->GetDesc();
-        depthDesc = m_DepthBuffers[0]->GetDesc();
-
-        // Create mesh, object and pipeline
-        m_Object = MakeUnique<Object>();
-        m_Object->Initialize(m_Device.Get());
+        depthDesc = m_DepthBuffers[0].Resource->GetDesc();
 
+        // Create pipeline, mesh and objects
         m_MeshPipeline = MakeShared<MeshPipeline>();
         m_MeshPipeline->Initialize(m_Device.Get(), renderDesc.Format, depthDesc.Format);
-
-        MeshTemplate meshTemplate = CreateSphereMesh(1);
-        SharedPtr<Mesh> mesh = MakeShared<Mesh>(meshTemplate, m_Device.Get());
-        m_Object->SetMesh(mesh);
-    }
-
-    // Create frame data buffer
-    {
-        D3D12_HEAP_PROPERTIES heapProps = {};
-        heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-        heapProps.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-        heapProps.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-        heapProps.CreationNodeMask = 1;
-        heapProps.VisibleNodeMask = 1;
-
-        D3D12_RESOURCE_DESC resourceDesc = {};
-        resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        resourceDesc.Alignment = 0;
-        m_FrameDataSize = AlignUp(sizeof(FrameData), 256);
-        resourceDesc.Width = m_FrameDataSize * Simulation::s_FrameCount;
-        resourceDesc.Height = 1;
-        resourceDesc.DepthOrArraySize = 1;
-        resourceDesc.MipLevels = 1;
-        resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-        resourceDesc.SampleDesc.Count = 1;
-        resourceDesc.SampleDesc.Quality = 0;
-        resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        HRESULT hr = m_Device->CreateCommittedResource(
-            &heapProps,
-            D3D12_HEAP_FLAG_NONE,
-            &resourceDesc,
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(&m_FrameData));
-
-        if (FAILED(hr))
-            throw std::runtime_error("Failed to create frame data buffer");
-
-        // Map the buffer
-        if (FAILED(m_FrameData->Map(0, nullptr, reinterpret_cast<void**>(&m_MappedFrameData))))
-            throw std::runtime_error("Failed to map frame data buffer");
+        m_InstancedPipeline = MakeShared<MeshPipeline>();
+        m_InstancedPipeline->Initialize(m_Device.Get(), renderDesc.Format, depthDesc.Format, VertexFormat::Float32, MeshPipelineMode::Instanced);
+        m_InstanceBuffer.Initialize(m_Device.Get(), Simulation::s_FrameCount, m_TotalMeshCount);
+
+        // Dense sphere with a simplified LOD chain, the level is picked per frame from its projected size
+        MeshTemplate sphere = CreateSphereMesh(1.0f, 64, 64);
+        static constexpr float s_LodRatios[] = { 0.5f, 0.25f, 0.1f };
+        const Vector<MeshLod> lods = BuildLodChain(sphere, s_LodRatios);
+        m_SphereLods = MakeShared<LodSet>(sphere, lods, m_Device.Get(), VertexFormat::Float32, &m_StagingUploader, &m_MaterialTable);
+
+        // Coarse sphere for the occlusion culler, its vertices lie on the sphere so its faces stay inside it
+        m_SphereOccluder = MakeShared<MeshTemplate>(CreateSphereMesh(1.0f, 8, 8));
+
+        // Grid centered on the origin, most of it outside the view
+        const float3 gridOrigin = float3{ float(m_MeshCountX - 1), float(m_MeshCountY - 1), float(m_MeshCountZ - 1) } * (-0.5f * m_MeshSpacing);
+        m_Objects.reserve(m_TotalMeshCount);
+        for (uint z = 0; z < m_MeshCountZ; ++z)
+        {
+            for (uint y = 0; y < m_MeshCountY; ++y)
+            {
+                for (uint x = 0; x < m_MeshCountX; ++x)
+                {
+                    UniquePtr<Object> object = MakeUnique<Object>();
+                    object->Initialize();
+                    object->SetPosition(gridOrigin + float3{ float(x), float(y), float(z) } * m_MeshSpacing);
+                    object->SetLodSet(m_SphereLods);
+                    object->SetOccluderMesh(m_SphereOccluder);
+                    m_ObjectPointers.push_back(object.get());
+                    m_Objects.push_back(std::move(object));
+                }
+            }
+        }
+        m_BoundingSpheres.Resize(m_Objects.size());
     }
 }
 
 void MeshTestSimulation::PreRelease()
 {
-    if (m_FrameData)
+    for (UniquePtr<Object>& object : m_Objects)
     {
-        m_FrameData->Unmap(0, nullptr);
-        m_MappedFrameData = nullptr;
-        m_FrameData.Reset();
-    }
-    if (m_Object)
-    {
-        m_Object->Release();
-        m_Object.reset();
+        object->Release();
     }
+    m_Objects.clear();
+    m_ObjectPointers.clear();
+    m_VisibleObjects.clear();
+    m_InstanceMeshes.clear();
+    m_InstanceFormats.clear();
+    m_InstanceData.clear();
+    m_InstanceBuffer.Release();
+    m_SphereLods.reset();
+    m_SphereOccluder.reset();
     if (m_MeshPipeline)
     {
         m_MeshPipeline.reset();
     }
+    if (m_InstancedPipeline)
+    {
+        m_InstancedPipeline.reset();
+    }
     if (m_Camera)
     {
         m_Camera.reset();
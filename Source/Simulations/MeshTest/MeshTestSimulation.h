@@ -3,6 +3,13 @@
 #include "Engine/Simulation.h"
 #include "Engine/Camera.h"
 #include "Engine/Object.h"
+#include "Engine/LodSelection.h"
+#include "Engine/Culling.h"
+#include "Engine/DrawList.h"
+#include "Engine/InstanceBatcher.h"
+#include "Engine/OcclusionCulling.h"
+#include "Engine/VectorStreams.h"
+#include "Graphics/InstanceBuffer.h"
 #include "Graphics/Mesh.h"
 
 class MeshTestSimulation : public Simulation
@@ -25,8 +32,30 @@ private:
     const float3 m_LightColor = float3{ 1, 1, 1};
     const uint m_FovHorizontal = 90;
 
-    UniquePtr<Object> m_Object = nullptr;
+    Vector<UniquePtr<Object>> m_Objects;
+    Vector<Object*> m_ObjectPointers;
+    SharedPtr<const LodSet> m_SphereLods = nullptr;
+    SharedPtr<const MeshTemplate> m_SphereOccluder = nullptr;
+
+    // Per-frame culling and LOD state, kept around to avoid reallocating
+    Float4Stream m_BoundingSpheres;
+    Vector<uint32> m_VisibleIndices;
+    Vector<uint32> m_UnoccludedIndices;
+    Vector<Object*> m_VisibleObjects;
+    OcclusionCuller m_OcclusionCuller;
+    CullStats m_CullStats;
+    OcclusionTestStats m_OcclusionStats;
+    DrawList m_DrawList;
+    // Sorted draws gathered for the batcher
+    Vector<const Mesh*> m_InstanceMeshes;
+    Vector<VertexFormat> m_InstanceFormats;
+    Vector<ObjectData> m_InstanceData;
+    InstanceBatcher m_InstanceBatcher;
+    InstanceBuffer m_InstanceBuffer;
+    // One instanced draw per mesh instead of one draw per object
+    bool m_UseInstancing = true;
     SharedPtr<MeshPipeline> m_MeshPipeline = nullptr;
+    SharedPtr<MeshPipeline> m_InstancedPipeline = nullptr;
     UniquePtr<Camera> m_Camera = nullptr;
 
     struct FrameData
@@ -40,8 +69,4 @@ private:
         float3 ViewPosition;
         float __Padding2;
     };
-
-    ComPtr<ID3D12Resource> m_FrameData = nullptr;
-    uint8* m_MappedFrameData = nullptr;
-    size_t m_FrameDataSize = 0;
 };
\ No newline at end of file
@@ -0,0 +1,242 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Engine/AabbTree.h"
+
+namespace
+{
+    Aabb MakeBox(std::mt19937& random, float worldSize)
+    {
+        std::uniform_real_distribution<float> position(-worldSize, worldSize);
+        std::uniform_real_distribution<float> size(0.1f, 3.0f);
+        const float3 min{ position(random), position(random), position(random) };
+        return Aabb{ min, min + float3{ size(random), size(random), size(random) } };
+    }
+
+    struct Proxy
+    {
+        uint32 Handle = DynamicAabbTree::s_NullNode;
+        Aabb Bounds;
+        bool Alive = false;
+    };
+
+    // Sorted query results of the tree and of a brute-force pass over the fat boxes, plus a miss count: proxies whose
+    // exact bounds overlap the query but were not returned
+    struct Comparison
+    {
+        Vector<uint32> Tree;
+        Vector<uint32> BruteForce;
+        uint32 Missed = 0;
+    };
+
+    Comparison CompareOverlap(const DynamicAabbTree& tree, const Vector<Proxy>& proxies, const Aabb& query)
+    {
+        Comparison result;
+        tree.QueryOverlap(query, result.Tree);
+        std::sort(result.Tree.begin(), result.Tree.end());
+        for (const Proxy& proxy : proxies)
+        {
+            if (!proxy.Alive)
+                continue;
+            if (Overlaps(tree.GetFatBounds(proxy.Handle), query))
+                result.BruteForce.push_back(proxy.Handle);
+            if (Overlaps(proxy.Bounds, query) && !std::binary_search(result.Tree.begin(), result.Tree.end(), proxy.Handle))
+                ++result.Missed;
+        }
+        std::sort(result.BruteForce.begin(), result.BruteForce.end());
+        return result;
+    }
+
+    bool FatBoundsContainProxies(const DynamicAabbTree& tree, const Vector<Proxy>& proxies)
+    {
+        bool contained = true;
+        size_t alive = 0;
+        for (uint32 i = 0; i < proxies.size(); ++i)
+        {
+            if (!proxies[i].Alive)
+                continue;
+            contained &= Contains(tree.GetFatBounds(proxies[i].Handle), proxies[i].Bounds);
+            contained &= tree.GetUserData(proxies[i].Handle) == &proxies[i];
+            ++alive;
+        }
+        return contained && alive == tree.GetProxyCount();
+    }
+}
+
+TEST(AabbTree, MatchesBruteForceOverlap)
+{
+    std::mt19937 random(13);
+    DynamicAabbTree tree(0.2f);
+    Vector<Proxy> proxies(2000);
+
+    bool matches = true;
+    uint32 missed = 0;
+    for (uint32 round = 0; round < 40; ++round)
+    {
+        // Create, destroy and move a random mix of proxies, small moves mostly stay inside the fat box
+        for (uint32 operation = 0; operation < 500; ++operation)
+        {
+            Proxy& proxy = proxies[random() % proxies.size()];
+            const uint32 kind = random() % 4;
+            if (!proxy.Alive)
+            {
+                proxy.Bounds = MakeBox(random, 50.0f);
+                proxy.Handle = tree.CreateProxy(proxy.Bounds, &proxy);
+                proxy.Alive = true;
+            }
+            else if (kind == 0)
+            {
+                tree.DestroyProxy(proxy.Handle);
+                proxy.Alive = false;
+            }
+            else
+            {
+                std::uniform_real_distribution<float> step(kind == 1 ? -10.0f : -0.1f, kind == 1 ? 10.0f : 0.1f);
+                const float3 displacement{ step(random), step(random), step(random) };
+                proxy.Bounds = Aabb{ proxy.Bounds.Min + displacement, proxy.Bounds.Max + displacement };
+                tree.MoveProxy(proxy.Handle, proxy.Bounds, displacement);
+            }
+        }
+        matches &= FatBoundsContainProxies(tree, proxies);
+
+        for (uint32 query = 0; query < 20; ++query)
+        {
+            const Comparison comparison = CompareOverlap(tree, proxies, MakeBox(random, 50.0f));
+            matches &= comparison.Tree == comparison.BruteForce;
+            missed += comparison.Missed;
+        }
+
+        // Rebuilding every few rounds keeps the proxies and the results
+        if (round % 10 == 9)
+        {
+            tree.Rebuild();
+            matches &= FatBoundsContainProxies(tree, proxies);
+        }
+    }
+    CHECK(matches);
+    CHECK(missed == 0);
+
+    // Everything removed leaves an empty tree
+    for (Proxy& proxy : proxies)
+    {
+        if (proxy.Alive)
+            tree.DestroyProxy(proxy.Handle);
+        proxy.Alive = false;
+    }
+    Vector<uint32> result;
+    tree.QueryOverlap(Aabb{ { -1e6f, -1e6f, -1e6f }, { 1e6f, 1e6f, 1e6f } }, result);
+    CHECK(result.empty() && tree.GetProxyCount() == 0 && tree.GetHeight() == 0);
+}
+
+TEST(AabbTree, FatBoundsReinsert)
+{
+    DynamicAabbTree tree(0.5f);
+    Proxy proxy;
+    proxy.Bounds = Aabb{ { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+    proxy.Handle = tree.CreateProxy(proxy.Bounds, &proxy);
+    const Aabb fat = tree.GetFatBounds(proxy.Handle);
+    CHECK(Contains(fat, proxy.Bounds) && !Contains(proxy.Bounds, fat));
+
+    // Inside the fat box nothing changes
+    CHECK(!tree.MoveProxy(proxy.Handle, Aabb{ { 0.2f, 0.0f, 0.0f }, { 1.2f, 1.0f, 1.0f } }));
+    CHECK(tree.GetFatBounds(proxy.Handle).Min.x == fat.Min.x && tree.GetFatBounds(proxy.Handle).Max.x == fat.Max.x);
+
+    // Leaving it reinserts with a box stretched along the displacement
+    const Aabb moved{ { 2.0f, 0.0f, 0.0f }, { 3.0f, 1.0f, 1.0f } };
+    CHECK(tree.MoveProxy(proxy.Handle, moved, float3{ 4.0f, 0.0f, 0.0f }));
+    const Aabb stretched = tree.GetFatBounds(proxy.Handle);
+    CHECK(Contains(stretched, moved));
+    CHECK(Contains(stretched, Aabb{ { 6.0f, 0.0f, 0.0f }, { 7.0f, 1.0f, 1.0f } }));
+    CHECK(stretched.Min.x > 1.0f);
+
+    // Batch updates refatten only the leaves that left their box
+    const Aabb nudged{ { 2.1f, 0.0f, 0.0f }, { 3.1f, 1.0f, 1.0f } };
+    const Aabb far{ { 20.0f, 0.0f, 0.0f }, { 21.0f, 1.0f, 1.0f } };
+    Proxy other;
+    other.Handle = tree.CreateProxy(Aabb{ { -5.0f, 0.0f, 0.0f }, { -4.0f, 1.0f, 1.0f } }, &other);
+    const uint32 handles[] = { proxy.Handle, other.Handle };
+    const Aabb bounds[] = { nudged, far };
+    tree.UpdateProxies(handles, bounds);
+    tree.Refit();
+    CHECK(tree.GetFatBounds(proxy.Handle).Min.x == stretched.Min.x);
+    CHECK(Contains(tree.GetFatBounds(other.Handle), far));
+
+    Vector<uint32> result;
+    tree.QueryOverlap(Aabb{ { 19.0f, 0.0f, 0.0f }, { 19.5f, 1.0f, 1.0f } }, result);
+    CHECK((result == Vector<uint32>{ other.Handle }));
+}
+
+TEST(AabbTree, FrustumAndRayQueries)
+{
+    std::mt19937 random(17);
+    DynamicAabbTree tree;
+    Vector<Proxy> proxies(3000);
+    for (Proxy& proxy : proxies)
+    {
+        proxy.Bounds = MakeBox(random, 100.0f);
+        proxy.Handle = tree.CreateProxy(proxy.Bounds, &proxy);
+        proxy.Alive = true;
+    }
+
+    // An axis-aligned box as a frustum: x, y in [-20, 20], z in [0, 60]
+    const float4 planes[6] = {
+        { 1.0f, 0.0f, 0.0f, 20.0f }, { -1.0f, 0.0f, 0.0f, 20.0f }, { 0.0f, 1.0f, 0.0f, 20.0f },
+        { 0.0f, -1.0f, 0.0f, 20.0f }, { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, -1.0f, 60.0f } };
+    const Aabb region{ { -20.0f, -20.0f, 0.0f }, { 20.0f, 20.0f, 60.0f } };
+
+    bool matches = true;
+    for (uint32 pass = 0; pass < 2; ++pass)
+    {
+        Vector<uint32> visible;
+        tree.QueryFrustum(planes, visible);
+        std::sort(visible.begin(), visible.end());
+        const Comparison comparison = CompareOverlap(tree, proxies, region);
+        matches &= visible == comparison.BruteForce;
+
+        // The closest hit along random rays against a brute-force pass over the exact boxes
+        for (uint32 ray = 0; ray < 200; ++ray)
+        {
+            std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+            const float3 origin = float3{ unit(random), unit(random), unit(random) } * 100.0f;
+            const float3 direction{ unit(random), unit(random), unit(random) };
+            const float3 invDirection{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+            float expected = 500.0f;
+            for (const Proxy& proxy : proxies)
+            {
+                const float t = IntersectRay(proxy.Bounds, origin, invDirection, expected);
+                if (t >= 0.0f)
+                    expected = t;
+            }
+
+            float closest = 500.0f;
+            tree.RayCast(origin, direction, closest, [&](uint32 proxy, float maxDistance)
+            {
+                const Proxy& hit = *static_cast<const Proxy*>(tree.GetUserData(proxy));
+                const float t = IntersectRay(hit.Bounds, origin, invDirection, maxDistance);
+                if (t >= 0.0f)
+                    closest = t;
+                return t >= 0.0f ? t : maxDistance;
+            });
+            matches &= closest == expected;
+        }
+
+        tree.Rebuild();
+    }
+    CHECK(matches);
+}
+
+TEST(AabbTree, Benchmark)
+{
+    const AabbTreeBenchmarkReport report = RunAabbTreeBenchmark(10000, 20);
+    printf("    %zu objects: insert %.2f ms, rebuild %.2f ms, move %.2f ms, refit %.2f ms\n", report.ObjectCount,
+        report.InsertMilliseconds, report.RebuildMilliseconds, report.MoveMilliseconds, report.RefitMilliseconds);
+    printf("    frustum %.3f ms (linear %.3f ms, %zu hits), overlap %.4f ms, ray %.4f ms, height %d, SAH %.1f -> %.1f\n",
+        report.FrustumQueryMilliseconds, report.LinearFrustumMilliseconds, report.FrustumHits, report.OverlapQueryMilliseconds,
+        report.RayCastMilliseconds, report.Height, report.SahCostIncremental, report.SahCostRebuilt);
+    CHECK(report.ObjectCount == 10000);
+    CHECK(report.FrustumHits > 0 && report.Height > 0);
+    CHECK(report.SahCostRebuilt <= report.SahCostIncremental);
+}
@@ -0,0 +1,152 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <random>
+
+#include "Engine/Camera.h"
+#include "Engine/CpuFeatures.h"
+#include "Engine/Culling.h"
+
+namespace
+{
+    std::array<float4, 6> MakeFrustum()
+    {
+        Camera camera;
+        camera.SetPosition(float3{ 1.0f, 2.0f, -3.0f });
+        camera.SetForward(Normalize(float3{ 0.3f, -0.2f, 1.0f }));
+        camera.SetPerspective(90.0f, 16.0f / 9.0f, 0.1f, 50.0f);
+        return camera.GetFrustumPlanes();
+    }
+
+    // Smallest signed distance of the volume's nearest point over the planes, in double. Negative is outside
+    double GetDistance(const std::array<float4, 6>& planes, const float3& center, const float3& extent, double radius)
+    {
+        double distance = INFINITY;
+        for (const float4& p : planes)
+        {
+            const double d = double(p.x) * center.x + double(p.y) * center.y + double(p.z) * center.z + p.w + radius
+                + std::abs(double(p.x)) * extent.x + std::abs(double(p.y)) * extent.y + std::abs(double(p.z)) * extent.z;
+            distance = std::min(distance, d);
+        }
+        return distance;
+    }
+
+    // The kernel result must match the reference away from the planes, where float rounding cannot flip it
+    bool MatchesReference(const Vector<double>& distances, const Vector<uint32>& visible)
+    {
+        bool ascending = std::is_sorted(visible.begin(), visible.end());
+        Vector<uint8> isVisible(distances.size());
+        for (uint32 index : visible)
+            isVisible[index] = 1;
+        for (size_t i = 0; i < distances.size(); ++i)
+        {
+            if (std::abs(distances[i]) > 1e-4 && isVisible[i] != (distances[i] >= 0.0))
+                return false;
+        }
+        return ascending;
+    }
+}
+
+TEST(Culling, FrustumPlanes)
+{
+    Camera camera;
+    camera.SetPosition(float3{ 0.0f, 0.0f, 0.0f });
+    camera.SetPerspective(90.0f, 1.0f, 0.1f, 100.0f);
+    const std::array<float4, 6> planes = camera.GetFrustumPlanes();
+
+    bool normalized = true;
+    for (const float4& plane : planes)
+        normalized &= std::abs(Length(float3{ plane.x, plane.y, plane.z }) - 1.0f) < 1e-5f;
+    CHECK(normalized);
+
+    auto inside = [&](const float3& p)
+    {
+        for (const float4& plane : planes)
+        {
+            if (Dot(float3{ plane.x, plane.y, plane.z }, p) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    };
+    CHECK(inside(float3{ 0.0f, 0.0f, 50.0f }));
+    // SetPerspective halves the horizontal FOV before converting it, so this frustum is 45 degrees wide
+    CHECK(inside(float3{ 3.5f, -3.5f, 10.0f }));
+    CHECK(!inside(float3{ 4.5f, 0.0f, 10.0f }));
+    CHECK(!inside(float3{ 0.0f, 0.0f, 0.05f }));
+    CHECK(!inside(float3{ 0.0f, 0.0f, 101.0f }));
+    CHECK(!inside(float3{ 0.0f, 0.0f, -10.0f }));
+
+    // The near and far planes face along the view direction
+    const float4& nearPlane = planes[size_t(FrustumPlane::Near)];
+    const float4& farPlane = planes[size_t(FrustumPlane::Far)];
+    CHECK(nearPlane.z > 0.99f && std::abs(nearPlane.w + 0.1f) < 1e-4f);
+    CHECK(farPlane.z < -0.99f && std::abs(farPlane.w - 100.0f) < 1e-2f);
+}
+
+TEST(Culling, MatchesBruteForce)
+{
+    const std::array<float4, 6> planes = MakeFrustum();
+    std::mt19937 random(9);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> size(0.0f, 5.0f);
+
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    bool matches = true;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2, SimdLevel::Avx512 })
+    {
+        SetMaxSimdLevel(level);
+
+        // Counts that are not multiples of any block width
+        for (size_t count : { size_t(0), size_t(1), size_t(7), size_t(17), size_t(1003) })
+        {
+            Float4Stream spheres(count);
+            Float3Stream centers(count), extents(count);
+            Vector<double> sphereDistances(count), boxDistances(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float3 center{ position(random), position(random), position(random) };
+                const float3 extent{ size(random), size(random), size(random) };
+                const float radius = size(random);
+                spheres.View().X[i] = center.x;
+                spheres.View().Y[i] = center.y;
+                spheres.View().Z[i] = center.z;
+                spheres.View().W[i] = radius;
+                centers.View().X[i] = center.x;
+                centers.View().Y[i] = center.y;
+                centers.View().Z[i] = center.z;
+                extents.View().X[i] = extent.x;
+                extents.View().Y[i] = extent.y;
+                extents.View().Z[i] = extent.z;
+                sphereDistances[i] = GetDistance(planes, center, float3{ 0.0f, 0.0f, 0.0f }, radius);
+                boxDistances[i] = GetDistance(planes, center, extent, 0.0);
+            }
+
+            // Appends after what is already in the list
+            Vector<uint32> visible{ 12345 };
+            const CullStats sphereStats = CullSpheres(planes, spheres.View(), visible);
+            matches &= visible.front() == 12345 && sphereStats.Tested == count && sphereStats.Visible == visible.size() - 1;
+            matches &= MatchesReference(sphereDistances, Vector<uint32>(visible.begin() + 1, visible.end()));
+
+            visible.clear();
+            const CullStats boxStats = CullBoxes(planes, centers.View(), extents.View(), visible);
+            matches &= boxStats.Tested == count && boxStats.Visible == visible.size();
+            matches &= MatchesReference(boxDistances, visible);
+        }
+    }
+    SetMaxSimdLevel(previousCap);
+    CHECK(matches);
+
+    // NaN bounds are kept
+    Float4Stream spheres(9);
+    for (size_t i = 0; i < 9; ++i)
+    {
+        spheres.View().X[i] = 1000.0f;
+        spheres.View().Y[i] = 0.0f;
+        spheres.View().Z[i] = 0.0f;
+        spheres.View().W[i] = 1.0f;
+    }
+    spheres.View().X[8] = NAN;
+    Vector<uint32> visible;
+    CullSpheres(planes, spheres.View(), visible);
+    CHECK((visible == Vector<uint32>{ 8 }));
+}
@@ -0,0 +1,213 @@
+#include "TestFramework.h"
+
+#include <random>
+#include <thread>
+
+#include "Engine/DescriptorSlots.h"
+
+namespace
+{
+    // Spawned directly rather than through ParallelFor, which runs serially on a single core machine
+    template<class Func>
+    void RunThreads(uint32 threadCount, Func&& func)
+    {
+        Vector<std::thread> threads;
+        for (uint32 t = 0; t < threadCount; ++t)
+            threads.emplace_back(func, t);
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+}
+
+TEST(DescriptorSlots, FreeListExclusiveOwnership)
+{
+    static constexpr uint32 s_Capacity = 4096;
+    static constexpr uint32 s_ThreadCount = 16;
+    DescriptorFreeList freeList;
+    freeList.Reset(s_Capacity);
+
+    // Holds the thread that owns each slot plus one, 0 while free. A slot handed to two threads at once shows up as
+    // a non-zero previous owner
+    std::unique_ptr<std::atomic<uint32>[]> owners(new std::atomic<uint32>[s_Capacity]);
+    for (uint32 i = 0; i < s_Capacity; ++i)
+        owners[i] = 0;
+
+    std::atomic<uint32> errors{ 0 };
+    RunThreads(s_ThreadCount, [&](uint32 thread)
+    {
+        std::mt19937 random(thread);
+        Vector<uint32> held;
+        for (uint32 operation = 0; operation < 100000; ++operation)
+        {
+            if (held.size() < 200 && (held.empty() || random() % 2))
+            {
+                // 16 threads hold at most 3200 slots, so the list never runs dry
+                const uint32 slot = freeList.Allocate();
+                if (slot >= s_Capacity || owners[slot].exchange(thread + 1) != 0)
+                {
+                    ++errors;
+                    continue;
+                }
+                held.push_back(slot);
+            }
+            else
+            {
+                const size_t pick = random() % held.size();
+                const uint32 slot = held[pick];
+                held[pick] = held.back();
+                held.pop_back();
+                errors += owners[slot].exchange(0) != thread + 1;
+                freeList.Free(slot);
+            }
+        }
+        for (uint32 slot : held)
+        {
+            owners[slot] = 0;
+            freeList.Free(slot);
+        }
+    });
+    CHECK(errors == 0);
+    CHECK(freeList.GetAllocatedCount() == 0);
+
+    // Every slot comes back exactly once after the contention
+    Vector<uint8> seen(s_Capacity);
+    bool unique = true;
+    for (uint32 i = 0; i < s_Capacity; ++i)
+    {
+        const uint32 slot = freeList.Allocate();
+        unique &= slot < s_Capacity && seen[slot]++ == 0;
+    }
+    CHECK(unique);
+    CHECK(freeList.Allocate() == DescriptorFreeList::s_InvalidIndex);
+}
+
+TEST(DescriptorSlots, DeferredFreeWaitsForFence)
+{
+    static constexpr uint32 s_Capacity = 64;
+    static constexpr uint32 s_ThreadCount = 4;
+    DescriptorFreeList freeList;
+    freeList.Reset(s_Capacity);
+    for (uint32 i = 0; i < s_Capacity; ++i)
+        freeList.Allocate();
+
+    // Frame 1 frees the even slots from several threads, frame 2 the odd ones
+    RunThreads(s_ThreadCount, [&](uint32 thread)
+    {
+        for (uint32 slot = thread * 2; slot < s_Capacity; slot += s_ThreadCount * 2)
+            freeList.FreeDeferred(slot);
+    });
+    CHECK(freeList.Allocate() == DescriptorFreeList::s_InvalidIndex);
+    freeList.FinishFrame(1);
+    for (uint32 slot = 1; slot < s_Capacity; slot += 2)
+        freeList.FreeDeferred(slot);
+    freeList.FinishFrame(2);
+
+    // Nothing comes back before its frame completes
+    freeList.Reclaim(0);
+    CHECK(freeList.Allocate() == DescriptorFreeList::s_InvalidIndex);
+    CHECK(freeList.GetAllocatedCount() == s_Capacity);
+
+    freeList.Reclaim(1);
+    CHECK(freeList.GetAllocatedCount() == s_Capacity / 2);
+    bool even = true;
+    for (uint32 i = 0; i < s_Capacity / 2; ++i)
+        even &= freeList.Allocate() % 2 == 0;
+    CHECK(even);
+    CHECK(freeList.Allocate() == DescriptorFreeList::s_InvalidIndex);
+
+    freeList.Reclaim(2);
+    CHECK(freeList.GetAllocatedCount() == s_Capacity / 2);
+    bool odd = true;
+    for (uint32 i = 0; i < s_Capacity / 2; ++i)
+        odd &= freeList.Allocate() % 2 == 1;
+    CHECK(odd);
+
+    // A frame with no frees and a reset drop nothing they should not
+    freeList.FreeDeferred(3);
+    freeList.FinishFrame(3);
+    freeList.FinishFrame(4);
+    freeList.Reclaim(4);
+    CHECK(freeList.Allocate() == 3);
+    freeList.FreeDeferred(3);
+    freeList.Reset(s_Capacity);
+    freeList.FinishFrame(5);
+    freeList.Reclaim(5);
+    CHECK(freeList.GetAllocatedCount() == 0);
+
+    bool threw = false;
+    try
+    {
+        freeList.FreeDeferred(s_Capacity);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(DescriptorSlots, RingRangesDoNotOverlap)
+{
+    static constexpr uint32 s_Capacity = 1000;
+    static constexpr uint32 s_ThreadCount = 8;
+    static constexpr uint64 s_FramesInFlight = 2;
+    DescriptorRing ring;
+    ring.Reset(s_Capacity);
+
+    // Fence value of the frame that holds each slot, 0 when never used. A range may only reuse slots of frames the
+    // fake GPU completed
+    std::unique_ptr<std::atomic<uint64>[]> owners(new std::atomic<uint64>[s_Capacity]);
+    for (uint32 i = 0; i < s_Capacity; ++i)
+        owners[i] = 0;
+
+    std::atomic<uint32> errors{ 0 };
+    std::atomic<uint64> allocated{ 0 };
+    uint64 fenceValue = 0;
+    uint64 completed = 0;
+    for (uint32 frame = 0; frame < 500; ++frame)
+    {
+        const uint64 current = fenceValue + 1;
+        RunThreads(s_ThreadCount, [&](uint32 thread)
+        {
+            for (uint32 k = 0; k < 10; ++k)
+            {
+                const uint32 count = 1 + (thread * 7 + k + frame) % 8;
+                const uint32 start = ring.Allocate(count);
+                if (start == DescriptorRing::s_InvalidIndex)
+                    continue;
+
+                if (start + count > s_Capacity)
+                {
+                    ++errors;
+                    continue;
+                }
+                for (uint32 i = start; i < start + count; ++i)
+                {
+                    const uint64 previous = owners[i].exchange(current);
+                    errors += previous > completed;
+                }
+                allocated += count;
+            }
+        });
+
+        ring.FinishFrame(++fenceValue);
+        completed = fenceValue > s_FramesInFlight ? fenceValue - s_FramesInFlight : 0;
+        ring.Reclaim(completed);
+        errors += ring.GetUsedCount() > s_Capacity;
+    }
+    printf("    %llu slots allocated\n", static_cast<unsigned long long>(allocated.load()));
+    CHECK(errors == 0);
+
+    ring.Reclaim(fenceValue);
+    CHECK(ring.GetUsedCount() == 0);
+    CHECK(ring.Allocate(s_Capacity + 1) == DescriptorRing::s_InvalidIndex);
+    CHECK(ring.Allocate(0) == DescriptorRing::s_InvalidIndex);
+}
+
+TEST(DescriptorSlots, Benchmark)
+{
+    const DescriptorContentionReport report = RunDescriptorContentionBenchmark(4, 20000);
+    printf("    %.1f M lock-free ops/s, %.1f M locked ops/s, %.1f M transient allocations/s\n",
+        report.PersistentOperationsPerSecond * 1e-6, report.LockedOperationsPerSecond * 1e-6, report.TransientAllocationsPerSecond * 1e-6);
+    CHECK(report.FailedAllocations == 0);
+}
@@ -0,0 +1,219 @@
+#include "TestFramework.h"
+
+#include <array>
+#include <cfloat>
+
+#include "Engine/FastMath.h"
+
+namespace
+{
+    constexpr uint32 s_SweepCount = 1000000;
+
+    // Spacing of floats at |reference|, denormals share the smallest one
+    double Ulp(double reference)
+    {
+        const float f = static_cast<float>(std::fabs(reference));
+        if (f < FLT_MIN)
+            return std::ldexp(1.0, -149);
+        return double(std::nextafter(f, std::numeric_limits<float>::infinity())) - f;
+    }
+
+    // Max error in ULPs over an even sweep of [lo, hi]. With minScale the ULP is taken of max(|reference|, minScale),
+    // which the header uses for the large argument ranges of sin and cos
+    template<class Fast, class Reference>
+    double MaxUlpError(Fast fast, Reference reference, float lo, float hi, double minScale = 0.0)
+    {
+        double maxError = 0.0;
+        for (uint32 i = 0; i <= s_SweepCount; ++i)
+        {
+            const float x = static_cast<float>(lo + (double(hi) - lo) * i / s_SweepCount);
+            const double expected = reference(double(x));
+            const float result = fast(x);
+            if (std::isinf(expected) && result == expected)
+                continue;
+            const double error = std::fabs(result - expected) / Ulp(std::max(std::fabs(expected), minScale));
+            maxError = std::max(maxError, error);
+        }
+        return maxError;
+    }
+
+    // The header's error table, printed so a failing bound shows the measured value
+    bool WithinUlp(const char* name, double measured, double bound)
+    {
+        printf("    %-28s %6.2f ULP (bound %g)\n", name, measured, bound);
+        return measured <= bound;
+    }
+}
+
+TEST(FastMath, SinCosAccuracy)
+{
+    auto sin = [](float x) { return FastSin(x); };
+    auto cos = [](float x) { return FastCos(x); };
+    auto stdSin = [](double x) { return std::sin(x); };
+    auto stdCos = [](double x) { return std::cos(x); };
+
+    CHECK(WithinUlp("FastSin |x| <= pi", MaxUlpError(sin, stdSin, -PI, PI), 1.5));
+    CHECK(WithinUlp("FastCos |x| <= 1.5", MaxUlpError(cos, stdCos, -1.5f, 1.5f), 1.5));
+    CHECK(WithinUlp("FastSin |x| <= 8192, scale 0.5", MaxUlpError(sin, stdSin, -8192.0f, 8192.0f, 0.5), 1.6));
+    CHECK(WithinUlp("FastCos |x| <= 8192, scale 0.5", MaxUlpError(cos, stdCos, -8192.0f, 8192.0f, 0.5), 1.6));
+}
+
+TEST(FastMath, AtanAccuracy)
+{
+    auto atan = [](float x) { return FastAtan(x); };
+    auto stdAtan = [](double x) { return std::atan(x); };
+
+    CHECK(WithinUlp("FastAtan |x| <= 100", MaxUlpError(atan, stdAtan, -100.0f, 100.0f), 2.7));
+    CHECK(WithinUlp("FastAtan |x| <= 1e30", MaxUlpError(atan, stdAtan, -1e30f, 1e30f), 2.7));
+}
+
+TEST(FastMath, ExpLogAccuracy)
+{
+    auto exp = [](float x) { return FastExp(x); };
+    auto log = [](float x) { return FastLog(x); };
+    auto stdExp = [](double x) { return std::exp(x); };
+    auto stdLog = [](double x) { return std::log(x); };
+
+    CHECK(WithinUlp("FastExp [-87.3, 88.7]", MaxUlpError(exp, stdExp, -87.3f, 88.7f), 1.0));
+    CHECK(WithinUlp("FastLog [0.01, 10]", MaxUlpError(log, stdLog, 0.01f, 10.0f), 1.0));
+    CHECK(WithinUlp("FastLog [1e-30, 1e30]", MaxUlpError(log, stdLog, 1e-30f, 1e30f), 1.0));
+
+    // Documented limits
+    CHECK(FastExp(-100.0f) == 0.0f);
+    CHECK(FastExp(100.0f) == std::numeric_limits<float>::infinity());
+    CHECK(FastLog(0.0f) == -std::numeric_limits<float>::infinity());
+    CHECK(FastLog(-0.0f) == -std::numeric_limits<float>::infinity());
+    CHECK(FastLog(std::numeric_limits<float>::infinity()) == std::numeric_limits<float>::infinity());
+    CHECK(std::isnan(FastLog(-1.0f)));
+    CHECK(std::isnan(FastLog(-std::numeric_limits<float>::infinity())));
+    CHECK(std::isnan(FastLog(std::numeric_limits<float>::quiet_NaN())));
+    CHECK(std::abs(FastLog(std::numeric_limits<float>::max()) - 88.7228391f) < 1e-5f);
+}
+
+TEST(FastMath, PowAccuracy)
+{
+    // Max error for |y * log(x)| up to 6, 16 and the float limits, results that FastExp flushes to zero are skipped
+    double maxError[3] = {};
+    for (float y : { -6.0f, -2.0f, -0.5f, 0.3f, 0.7f, 1.3f, 2.5f, 4.0f, 7.0f, 13.0f })
+    {
+        for (uint32 i = 0; i <= s_SweepCount; ++i)
+        {
+            const float x = static_cast<float>(std::exp(-40.0 + 80.0 * i / s_SweepCount));
+            const double expected = std::pow(double(x), double(y));
+            if (expected > FLT_MAX || expected < 1e-37)
+                continue;
+
+            const double magnitude = std::fabs(y * std::log(double(x)));
+            const double error = std::fabs(FastPow(x, y) - expected) / Ulp(expected);
+            for (uint32 range = 0; range < 3; ++range)
+            {
+                if (magnitude <= (range == 0 ? 6.0 : range == 1 ? 16.0 : 89.0))
+                    maxError[range] = std::max(maxError[range], error);
+            }
+        }
+    }
+    CHECK(WithinUlp("FastPow |y log x| <= 6", maxError[0], 10.0));
+    CHECK(WithinUlp("FastPow |y log x| <= 16", maxError[1], 25.0));
+    CHECK(WithinUlp("FastPow float range", maxError[2], 145.0));
+    CHECK(FastPow(0.0f, 2.0f) == 0.0f);
+}
+
+TEST(FastMath, BatchMatchesScalar)
+{
+    static constexpr size_t s_Count = 1 << 16;
+    Vector<float> x(s_Count), positive(s_Count), y(s_Count, 1.7f), out(s_Count);
+    for (size_t i = 0; i < s_Count; ++i)
+    {
+        x[i] = -50.0f + 100.0f * float(i) / s_Count;
+        positive[i] = 1e-3f + 50.0f * float(i) / s_Count;
+    }
+
+    // Equal up to FMA contraction, SSE has no FMA
+    auto close = [](float a, float b, double ulps = 4.0) { return std::fabs(a - b) <= ulps * Ulp(std::max(std::fabs(b), 1e-6f)); };
+    auto checkUnary = [&](void (*batch)(Span<const float>, Span<float>), float (*scalar)(float), const Vector<float>& input)
+    {
+        batch(input, out);
+        bool equal = true;
+        for (size_t i = 0; i < s_Count; ++i)
+            equal &= close(out[i], scalar(input[i]));
+        return equal;
+    };
+
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2, SimdLevel::Avx512 })
+    {
+        SetMaxSimdLevel(level);
+        CHECK(checkUnary(FastSinN, [](float v) { return FastSin(v); }, x));
+        CHECK(checkUnary(FastCosN, [](float v) { return FastCos(v); }, x));
+        CHECK(checkUnary(FastAtanN, [](float v) { return FastAtan(v); }, x));
+        CHECK(checkUnary(FastExpN, [](float v) { return FastExp(v); }, x));
+        CHECK(checkUnary(FastLogN, [](float v) { return FastLog(v); }, positive));
+
+        // The limits of FastLog in every lane position
+        const float inf = std::numeric_limits<float>::infinity();
+        Vector<float> special(s_Count);
+        for (size_t i = 0; i < s_Count; ++i)
+            special[i] = std::array{ inf, 0.0f, -1.0f, std::numeric_limits<float>::quiet_NaN(), 2.0f }[i % 5];
+        FastLogN(special, out);
+        bool limits = true;
+        for (size_t i = 0; i < s_Count; ++i)
+            limits &= i % 5 == 0 ? out[i] == inf : i % 5 == 1 ? out[i] == -inf : i % 5 == 4 ? close(out[i], 0.693147181f) : std::isnan(out[i]);
+        CHECK(limits);
+
+        FastPowN(positive, y, out);
+        bool equal = true;
+        for (size_t i = 0; i < s_Count; ++i)
+            equal &= close(out[i], FastPow(positive[i], y[i]), 16.0);
+        CHECK(equal);
+    }
+    SetMaxSimdLevel(previousCap);
+}
+
+TEST(FastMath, BaseTypesRouting)
+{
+    // ThorTests runs this with THOR_FAST_MATH as configured, ThorFastMathTests always with it defined
+#ifdef THOR_FAST_MATH
+    auto sin = [](float x) { return FastSin(x); };
+    auto cos = [](float x) { return FastCos(x); };
+    auto atan = [](float x) { return FastAtan(x); };
+    auto exp = [](float x) { return FastExp(x); };
+    auto log = [](float x) { return FastLog(x); };
+    auto pow = [](float x, float y) { return FastPow(x, y); };
+    printf("    BaseTypes routes through FastMath\n");
+#else
+    auto sin = [](float x) { return std::sin(x); };
+    auto cos = [](float x) { return std::cos(x); };
+    auto atan = [](float x) { return std::atan(x); };
+    auto exp = [](float x) { return std::exp(x); };
+    auto log = [](float x) { return std::log(x); };
+    auto pow = [](float x, float y) { return std::pow(x, y); };
+    printf("    BaseTypes routes through <cmath>\n");
+#endif
+
+    bool matches = true;
+    for (int32 i = -1000; i <= 1000; ++i)
+    {
+        const float x = i * 0.01f;
+        const float positive = std::abs(x) + 0.001f;
+        matches &= Sin(x) == sin(x) && Cos(x) == cos(x) && Atan(x) == atan(x) && Exp(x) == exp(x);
+        matches &= Log(positive) == log(positive) && Pow(positive, 1.5f) == pow(positive, 1.5f);
+    }
+    CHECK(matches);
+
+    // Outside the domain of FastPow the routed Pow still agrees with std::pow
+    CHECK(Pow(0.0f, 0.0f) == 1.0f && Pow(2.0f, 0.0f) == 1.0f && Pow(-3.0f, 0.0f) == 1.0f);
+    CHECK(Pow(-2.0f, 2.0f) == 4.0f && Pow(-2.0f, 3.0f) == -8.0f && Pow(-0.5f, -2.0f) == 4.0f);
+    CHECK(Pow(0.0f, 2.0f) == 0.0f && Pow(0.0f, -1.0f) == std::numeric_limits<float>::infinity());
+    CHECK(std::isnan(Pow(-2.0f, 0.5f)));
+}
+
+TEST(FastMath, Benchmark)
+{
+    const FastMathBenchmarkReport report = RunFastMathBenchmark(1 << 18, 10);
+    for (const FastMathBenchmarkReport::Function& function : report.Functions)
+    {
+        printf("    %-5s std %7.1f M/s, fast %7.1f M/s (%s)\n", function.Name, function.StdValuesPerSecond * 1e-6,
+            function.FastValuesPerSecond * 1e-6, GetSimdLevelName(report.Level));
+        CHECK(function.StdValuesPerSecond > 0.0 && function.FastValuesPerSecond > 0.0);
+    }
+}
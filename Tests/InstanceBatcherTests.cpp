@@ -0,0 +1,199 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include "Engine/InstanceBatcher.h"
+#include "Graphics/Mesh.h"
+
+namespace
+{
+    const Mesh* MakeMesh(uint32 index)
+    {
+        return reinterpret_cast<const Mesh*>(uintptr_t(index + 1) * 16);
+    }
+
+    // The instance's position in the input is kept in Padding[0] to check the packing order
+    ObjectData MakeInstance(uint32 index, uint32 materialIndex)
+    {
+        ObjectData instance{};
+        instance.MaterialIndex = materialIndex;
+        instance.Padding[0] = index;
+        return instance;
+    }
+
+    struct Input
+    {
+        Vector<const Mesh*> Meshes;
+        Vector<VertexFormat> Formats;
+        Vector<ObjectData> Instances;
+
+        void Add(uint32 mesh, VertexFormat format, uint32 materialIndex)
+        {
+            Instances.push_back(MakeInstance(static_cast<uint32>(Instances.size()), materialIndex));
+            Meshes.push_back(MakeMesh(mesh));
+            Formats.push_back(format);
+        }
+    };
+}
+
+TEST(InstanceBatcher, GroupsByMeshAndMaterial)
+{
+    std::mt19937 random(3);
+    bool matches = true;
+    for (uint32 round = 0; round < 100; ++round)
+    {
+        // The material lives on the mesh, mesh m uses material m % 5
+        const uint32 meshCount = 1 + random() % 40;
+        Input input;
+        const uint32 count = random() % 2000;
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const uint32 mesh = random() % meshCount;
+            input.Add(mesh, VertexFormat::Float32, mesh % 5);
+        }
+
+        InstanceBatcher batcher;
+        batcher.Build(input.Meshes, input.Formats, input.Instances);
+
+        // Brute force: every instance is in the batch of its mesh, each mesh has one batch
+        HashMap<const Mesh*, uint32> batchOfMesh;
+        uint32 covered = 0;
+        for (uint32 b = 0; b < batcher.GetBatches().size(); ++b)
+        {
+            const InstanceBatch& batch = batcher.GetBatches()[b];
+            matches &= batchOfMesh.emplace(batch.Mesh, b).second && batch.InstanceCount > 0;
+            for (uint32 i = batch.FirstInstance; i < batch.FirstInstance + batch.InstanceCount; ++i)
+            {
+                const ObjectData& instance = batcher.GetInstances()[i];
+                matches &= input.Meshes[instance.Padding[0]] == batch.Mesh;
+                matches &= instance.MaterialIndex == input.Instances[instance.Padding[0]].MaterialIndex;
+            }
+            covered += batch.InstanceCount;
+        }
+        matches &= covered == count && batcher.GetInstances().size() == count;
+
+        uint32 largest = 0;
+        for (const InstanceBatch& batch : batcher.GetBatches())
+            largest = std::max(largest, batch.InstanceCount);
+        const InstanceBatchStats& stats = batcher.GetStats();
+        matches &= stats.Objects == count && stats.Batches == batchOfMesh.size() && stats.LargestBatch == largest;
+        matches &= stats.Formats == (count > 0 ? 1u : 0u);
+    }
+    CHECK(matches);
+}
+
+TEST(InstanceBatcher, InstanceOrderAndOffsets)
+{
+    Input input;
+    const uint32 meshes[] = { 2, 0, 2, 1, 0, 2, 1 };
+    for (uint32 mesh : meshes)
+        input.Add(mesh, VertexFormat::Float32, mesh);
+
+    InstanceBatcher batcher;
+    batcher.Build(input.Meshes, input.Formats, input.Instances);
+
+    // Batches in the order of their first instance, contiguous, the instances of each in input order
+    const Vector<InstanceBatch>& batches = batcher.GetBatches();
+    CHECK(batches.size() == 3);
+    CHECK(batches[0].Mesh == MakeMesh(2) && batches[0].FirstInstance == 0 && batches[0].InstanceCount == 3);
+    CHECK(batches[1].Mesh == MakeMesh(0) && batches[1].FirstInstance == 3 && batches[1].InstanceCount == 2);
+    CHECK(batches[2].Mesh == MakeMesh(1) && batches[2].FirstInstance == 5 && batches[2].InstanceCount == 2);
+
+    Vector<uint32> order;
+    for (const ObjectData& instance : batcher.GetInstances())
+        order.push_back(instance.Padding[0]);
+    CHECK((order == Vector<uint32>{ 0, 2, 5, 1, 4, 3, 6 }));
+
+    // A rebuild starts over
+    Input single;
+    single.Add(4, VertexFormat::Float32, 0);
+    batcher.Build(single.Meshes, single.Formats, single.Instances);
+    CHECK(batcher.GetBatches().size() == 1 && batcher.GetInstances().size() == 1);
+    CHECK(batcher.GetBatches()[0].FirstInstance == 0 && batcher.GetBatches()[0].InstanceCount == 1);
+}
+
+TEST(InstanceBatcher, NoInstances)
+{
+    InstanceBatcher batcher;
+    Input input;
+    input.Add(0, VertexFormat::Float32, 0);
+    batcher.Build(input.Meshes, input.Formats, input.Instances);
+
+    batcher.Build({}, {}, {});
+    CHECK(batcher.GetBatches().empty());
+    CHECK(batcher.GetInstances().empty());
+    const InstanceBatchStats& stats = batcher.GetStats();
+    CHECK(stats.Objects == 0 && stats.Batches == 0 && stats.LargestBatch == 0 && stats.Formats == 0);
+}
+
+TEST(InstanceBatcher, MixedVertexFormats)
+{
+    Input input;
+    input.Add(0, VertexFormat::Quantized16, 0);
+    input.Add(1, VertexFormat::Float32, 1);
+    input.Add(2, VertexFormat::Quantized16, 2);
+    input.Add(3, VertexFormat::Quantized8, 3);
+    input.Add(1, VertexFormat::Float32, 1);
+    input.Add(0, VertexFormat::Quantized16, 0);
+    input.Add(4, VertexFormat::Float32, 4);
+
+    InstanceBatcher batcher;
+    batcher.Build(input.Meshes, input.Formats, input.Instances);
+
+    // Formats in order of first appearance, each bound once, batches of a format in order of first appearance
+    const Vector<InstanceBatch>& batches = batcher.GetBatches();
+    Vector<const Mesh*> meshOrder;
+    Vector<VertexFormat> formatOrder;
+    for (const InstanceBatch& batch : batches)
+    {
+        meshOrder.push_back(batch.Mesh);
+        formatOrder.push_back(batch.Format);
+    }
+    CHECK((meshOrder == Vector<const Mesh*>{ MakeMesh(0), MakeMesh(2), MakeMesh(1), MakeMesh(4), MakeMesh(3) }));
+    CHECK((formatOrder == Vector<VertexFormat>{ VertexFormat::Quantized16, VertexFormat::Quantized16, VertexFormat::Float32,
+        VertexFormat::Float32, VertexFormat::Quantized8 }));
+    CHECK(batcher.GetStats().Formats == 3);
+
+    // Offsets follow the batch order
+    uint32 next = 0;
+    bool contiguous = true;
+    for (const InstanceBatch& batch : batches)
+    {
+        contiguous &= batch.FirstInstance == next;
+        next += batch.InstanceCount;
+    }
+    CHECK(contiguous && next == input.Instances.size());
+
+    Vector<uint32> order;
+    for (const ObjectData& instance : batcher.GetInstances())
+        order.push_back(instance.Padding[0]);
+    CHECK((order == Vector<uint32>{ 0, 5, 2, 1, 4, 6, 3 }));
+}
+
+TEST(InstanceBatcher, InvalidInput)
+{
+    auto throws = [](const Input& input)
+    {
+        InstanceBatcher batcher;
+        try
+        {
+            batcher.Build(input.Meshes, input.Formats, input.Instances);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        return false;
+    };
+
+    // A mesh has one vertex format
+    Input conflicting;
+    conflicting.Add(0, VertexFormat::Float32, 0);
+    conflicting.Add(0, VertexFormat::Quantized8, 0);
+    CHECK(throws(conflicting));
+
+    Input missing;
+    missing.Add(0, VertexFormat::Float32, 0);
+    missing.Formats.clear();
+    CHECK(throws(missing));
+}
@@ -0,0 +1,122 @@
+#include "TestFramework.h"
+
+#include <cmath>
+
+#include "Engine/LodSelection.h"
+
+namespace
+{
+    // Levels without meshes, only the errors matter for the selection
+    Vector<LodLevel> MakeLevels(std::initializer_list<float> errors)
+    {
+        Vector<LodLevel> levels;
+        uint32 triangles = 4096;
+        for (float error : errors)
+        {
+            levels.push_back(LodLevel{ nullptr, error, triangles });
+            triangles /= 2;
+        }
+        return levels;
+    }
+}
+
+TEST(LodSelection, ProjectedError)
+{
+    // A 90 degree vertical FOV maps one unit at distance one to half the viewport height
+    Camera camera;
+    camera.SetPerspective(90.0f, 1.0f, 0.5f, 100.0f);
+    const float fovY = camera.GetFovY();
+    const float focalLength = 1080.0f / (2.0f * std::tan(fovY * 0.5f));
+    CHECK(std::abs(ProjectLodError(camera, 1080.0f, 1.0f, 1.0f) - focalLength) < 1e-2f);
+
+    // Inversely proportional to distance, linear in the error and the viewport height
+    CHECK(std::abs(ProjectLodError(camera, 1080.0f, 1.0f, 10.0f) - focalLength / 10.0f) < 1e-3f);
+    CHECK(std::abs(ProjectLodError(camera, 1080.0f, 0.25f, 10.0f) - focalLength / 40.0f) < 1e-3f);
+    CHECK(std::abs(ProjectLodError(camera, 540.0f, 1.0f, 10.0f) - focalLength / 20.0f) < 1e-3f);
+
+    // Distances inside the near plane, including inside the bounding sphere, clamp to it
+    CHECK(ProjectLodError(camera, 1080.0f, 1.0f, 0.1f) == ProjectLodError(camera, 1080.0f, 1.0f, 0.5f));
+    CHECK(ProjectLodError(camera, 1080.0f, 1.0f, -3.0f) == ProjectLodError(camera, 1080.0f, 1.0f, 0.5f));
+}
+
+TEST(LodSelection, Thresholds)
+{
+    const Vector<LodLevel> levels = MakeLevels({ 0.0f, 0.01f, 0.04f, 0.16f });
+    LodSelectionSettings settings;
+    settings.MaxPixelError = 1.0f;
+    settings.Hysteresis = 0.25f;
+
+    // From the finest level, the coarsest level at or below 0.75 pixels
+    CHECK(SelectLodLevel(levels, 0, 1000.0f, settings) == 0);
+    CHECK(SelectLodLevel(levels, 0, 75.0f, settings) == 1);
+    CHECK(SelectLodLevel(levels, 0, 76.0f, settings) == 0);
+    CHECK(SelectLodLevel(levels, 0, 18.75f, settings) == 2);
+    CHECK(SelectLodLevel(levels, 0, 1.0f, settings) == 3);
+
+    // From the coarsest level, the coarsest level at or below one pixel
+    CHECK(SelectLodLevel(levels, 3, 6.25f, settings) == 3);
+    CHECK(SelectLodLevel(levels, 3, 6.5f, settings) == 2);
+    CHECK(SelectLodLevel(levels, 3, 100.0f, settings) == 1);
+    CHECK(SelectLodLevel(levels, 3, 101.0f, settings) == 0);
+
+    // Zero hysteresis uses the one threshold both ways, full hysteresis never coarsens
+    settings.Hysteresis = 0.0f;
+    CHECK(SelectLodLevel(levels, 0, 100.0f, settings) == 1);
+    settings.Hysteresis = 1.0f;
+    CHECK(SelectLodLevel(levels, 0, 0.001f, settings) == 0);
+    CHECK(SelectLodLevel(levels, 2, 0.001f, settings) == 2);
+
+    // Out of range levels clamp to the coarsest, empty sets pick 0
+    settings.Hysteresis = 0.25f;
+    CHECK(SelectLodLevel(levels, 99, 6.25f, settings) == 3);
+    CHECK(SelectLodLevel(Span<const LodLevel>{}, 2, 1.0f, settings) == 0);
+}
+
+TEST(LodSelection, HysteresisStopsThrashing)
+{
+    // Walking away and back through every switching distance changes the level once per crossing, and jitter around
+    // a switching distance does not change it at all
+    const Vector<LodLevel> levels = MakeLevels({ 0.0f, 0.01f, 0.04f, 0.16f });
+    const LodSelectionSettings settings;
+
+    uint32 level = 0, changes = 0;
+    auto step = [&](float pixelsPerUnit)
+    {
+        const uint32 next = SelectLodLevel(levels, level, pixelsPerUnit, settings);
+        changes += next != level;
+        level = next;
+    };
+
+    for (float pixelsPerUnit = 200.0f; pixelsPerUnit > 1.0f; pixelsPerUnit *= 0.95f)
+        step(pixelsPerUnit);
+    CHECK(level == 3 && changes == 3);
+    for (float pixelsPerUnit = 1.0f; pixelsPerUnit < 200.0f; pixelsPerUnit *= 1.05f)
+        step(pixelsPerUnit);
+    CHECK(level == 0 && changes == 6);
+
+    // Switched to level 1 at 75 pixels, jitter between 70 and 95 keeps it there
+    level = 0;
+    step(74.0f);
+    changes = 0;
+    for (uint32 i = 0; i < 100; ++i)
+        step(i % 2 ? 70.0f : 95.0f);
+    CHECK(level == 1 && changes == 0);
+}
+
+TEST(LodSelection, FallsBackToResidentLevels)
+{
+    // Levels 0 and 3 uploaded, 1 and 2 still pending
+    const bool resident[] = { true, false, false, true };
+    auto isResident = [&](uint32 level) { return resident[level]; };
+
+    CHECK(FindResidentLevel(4, 0, isResident) == 0);
+    CHECK(FindResidentLevel(4, 3, isResident) == 3);
+    // Coarser first
+    CHECK(FindResidentLevel(4, 1, isResident) == 3);
+    CHECK(FindResidentLevel(4, 2, isResident) == 3);
+    // Then finer when no coarser level is there
+    CHECK(FindResidentLevel(3, 2, isResident) == 0);
+    // Nothing resident keeps the selection, the draw skips it
+    CHECK(FindResidentLevel(4, 2, [](uint32) { return false; }) == 2);
+    CHECK(FindResidentLevel(0, 0, isResident) == 0);
+}
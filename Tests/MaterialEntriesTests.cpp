@@ -0,0 +1,133 @@
+#include "TestFramework.h"
+
+#include "Graphics/MaterialEntries.h"
+
+namespace
+{
+    ID3D12Resource* MakeTexture(uint32 index)
+    {
+        return reinterpret_cast<ID3D12Resource*>(uintptr_t(index + 1) * 16);
+    }
+
+    // Hands out slots from 100 on like a descriptor allocator would, counting the calls
+    struct SlotAllocator
+    {
+        uint32 NextSlot = 100;
+        uint32 Calls = 0;
+
+        uint32 operator()(ID3D12Resource*)
+        {
+            ++Calls;
+            return NextSlot++;
+        }
+    };
+
+    MaterialKey MakeMaterial(float albedo, ID3D12Resource* albedoMap = nullptr, ID3D12Resource* normalMap = nullptr)
+    {
+        MaterialKey material;
+        material.Albedo = float3{ albedo, 0.5f, 0.25f };
+        material.Maps[0] = albedoMap;
+        material.Maps[1] = normalMap;
+        return material;
+    }
+}
+
+TEST(MaterialEntries, EqualMaterialsShareAnEntry)
+{
+    MaterialEntries entries;
+    entries.Reset(16);
+    SlotAllocator slots;
+
+    CHECK(entries.Add(MaterialKey{}, slots) == 0);
+    CHECK(entries.Add(MakeMaterial(1.0f), slots) == 1);
+    CHECK(entries.Add(MakeMaterial(1.0f), slots) == 1);
+    CHECK(entries.Add(MakeMaterial(2.0f), slots) == 2);
+    CHECK(entries.Add(MaterialKey{}, slots) == 0);
+
+    MaterialKey rougher = MakeMaterial(1.0f);
+    rougher.Roughness = 0.9f;
+    CHECK(entries.Add(rougher, slots) == 3);
+
+    CHECK(entries.GetCount() == 4);
+    CHECK(slots.Calls == 0);
+    CHECK(entries.GetEntry(1).Albedo.x == 1.0f && entries.GetEntry(1).Albedo.y == 0.5f && entries.GetEntry(1).Albedo.z == 0.25f);
+    CHECK(entries.GetEntry(3).Roughness == 0.9f);
+}
+
+TEST(MaterialEntries, MaterialsWithoutMapsUseTheNoTextureSentinel)
+{
+    MaterialEntries entries;
+    entries.Reset(4);
+    SlotAllocator slots;
+
+    const MaterialData& entry = entries.GetEntry(entries.Add(MakeMaterial(1.0f), slots));
+    CHECK(entry.AlbedoMap == MaterialData::s_NoTexture);
+    CHECK(entry.NormalMap == MaterialData::s_NoTexture);
+    CHECK(entry.MetallicMap == MaterialData::s_NoTexture);
+    CHECK(entry.RoughnessMap == MaterialData::s_NoTexture);
+    CHECK(entry.Padding[0] == 0 && entry.Padding[1] == 0 && entry.Padding[2] == 0);
+    CHECK(entries.GetTextureCount() == 0);
+}
+
+TEST(MaterialEntries, TexturesGetOneSlotEach)
+{
+    MaterialEntries entries;
+    entries.Reset(16);
+    SlotAllocator slots;
+
+    const uint32 a = entries.Add(MakeMaterial(1.0f, MakeTexture(0)), slots);
+    const uint32 b = entries.Add(MakeMaterial(1.0f, MakeTexture(1)), slots);
+    CHECK(a != b);
+    CHECK(entries.GetEntry(a).AlbedoMap == 100);
+    CHECK(entries.GetEntry(b).AlbedoMap == 101);
+
+    // A texture already seen keeps its slot, in another map or another material
+    CHECK(entries.Add(MakeMaterial(1.0f, MakeTexture(0)), slots) == a);
+    const uint32 c = entries.Add(MakeMaterial(2.0f, MakeTexture(1), MakeTexture(0)), slots);
+    CHECK(entries.GetEntry(c).AlbedoMap == 101 && entries.GetEntry(c).NormalMap == 100);
+
+    // A new texture used by two maps of one material
+    const uint32 d = entries.Add(MakeMaterial(3.0f, MakeTexture(2), MakeTexture(2)), slots);
+    CHECK(entries.GetEntry(d).AlbedoMap == 102 && entries.GetEntry(d).NormalMap == 102);
+    CHECK(entries.GetEntry(d).MetallicMap == MaterialData::s_NoTexture);
+
+    CHECK(slots.Calls == 3);
+    CHECK(entries.GetTextureCount() == 3);
+    CHECK(entries.GetCount() == 4);
+}
+
+TEST(MaterialEntries, FullTableThrowsBeforeTakingSlots)
+{
+    MaterialEntries entries;
+    entries.Reset(2);
+    SlotAllocator slots;
+
+    CHECK(entries.Add(MakeMaterial(1.0f), slots) == 0);
+    CHECK(entries.Add(MakeMaterial(2.0f, MakeTexture(0)), slots) == 1);
+    CHECK(slots.Calls == 1);
+
+    // Existing entries are still found once the table is full
+    CHECK(entries.Add(MakeMaterial(2.0f, MakeTexture(0)), slots) == 1);
+
+    for (const MaterialKey& material : { MakeMaterial(3.0f), MakeMaterial(1.0f, MakeTexture(1)) })
+    {
+        bool threw = false;
+        try
+        {
+            entries.Add(material, slots);
+        }
+        catch (const std::runtime_error&)
+        {
+            threw = true;
+        }
+        CHECK(threw);
+    }
+    CHECK(slots.Calls == 1);
+    CHECK(entries.GetTextureCount() == 1);
+    CHECK(entries.GetCount() == 2);
+
+    entries.Reset(1);
+    CHECK(entries.GetCount() == 0 && entries.GetTextureCount() == 0);
+    CHECK(entries.Add(MakeMaterial(2.0f, MakeTexture(0)), slots) == 0);
+    CHECK(entries.GetEntry(0).AlbedoMap == 101);
+}
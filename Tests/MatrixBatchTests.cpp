@@ -0,0 +1,128 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <random>
+
+#include "Engine/MatrixBatch.h"
+
+namespace
+{
+    float4x4 MakeMatrix(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+        float4x4 m;
+        for (uint32 row = 0; row < 4; ++row)
+            for (uint32 col = 0; col < 4; ++col)
+                m(row, col) = value(random);
+        return m;
+    }
+
+    float4x4 Reference(const float4x4& a, const float4x4& b)
+    {
+        float4x4 result;
+        XMStoreFloat4x4(&result, XMMatrixMultiply(XMLoadFloat4x4(&a), XMLoadFloat4x4(&b)));
+        return result;
+    }
+
+    // The affine 4x3 as a 4x4 with the last column (0, 0, 0, 1)
+    float4x4 Expand(const float4x3& m)
+    {
+        return float4x4{
+            m._11, m._12, m._13, 0.0f,
+            m._21, m._22, m._23, 0.0f,
+            m._31, m._32, m._33, 0.0f,
+            m._41, m._42, m._43, 1.0f };
+    }
+
+    // FMA and the summation order differ between kernels, entries are sums of four products of at most 4
+    template<class M>
+    bool IsClose(const M& actual, const float4x4& expected, uint32 columns)
+    {
+        for (uint32 row = 0; row < 4; ++row)
+        {
+            for (uint32 col = 0; col < columns; ++col)
+            {
+                if (!(std::abs(actual(row, col) - expected(row, col)) <= 2e-5f))
+                    return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST(MatrixBatch, MatchesXMMatrixMultiply)
+{
+    std::mt19937 random(5);
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    bool matches = true;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2, SimdLevel::Avx512 })
+    {
+        SetMaxSimdLevel(level);
+
+        // Empty, single, odd and large batches, each kernel takes one matrix per iteration so there is no block tail
+        for (size_t count : { size_t(0), size_t(1), size_t(2), size_t(7), size_t(1001) })
+        {
+            Vector<float4x4> a(count), b(count);
+            for (size_t i = 0; i < count; ++i)
+            {
+                a[i] = MakeMatrix(random);
+                b[i] = MakeMatrix(random);
+            }
+            const float4x4 single = MakeMatrix(random);
+            float4x3 affine;
+            for (uint32 row = 0; row < 4; ++row)
+                for (uint32 col = 0; col < 3; ++col)
+                    affine(row, col) = single(row, col);
+
+            Vector<float4x4> batchTimesOne(count), oneTimesBatch(count), pairwise(count);
+            Vector<float4x3> batchTimesAffine(count);
+            MultiplyMatrices(a, single, batchTimesOne);
+            MultiplyMatrices(single, b, oneTimesBatch);
+            MultiplyMatrices(a, b, pairwise);
+            MultiplyMatrices(a, affine, batchTimesAffine);
+            for (size_t i = 0; i < count; ++i)
+            {
+                matches &= IsClose(batchTimesOne[i], Reference(a[i], single), 4);
+                matches &= IsClose(oneTimesBatch[i], Reference(single, b[i]), 4);
+                matches &= IsClose(pairwise[i], Reference(a[i], b[i]), 4);
+                matches &= IsClose(batchTimesAffine[i], Reference(a[i], Expand(affine)), 3);
+            }
+
+            // In place, the output aliasing an input
+            Vector<float4x4> inPlace = a;
+            MultiplyMatrices(inPlace, b, inPlace);
+            for (size_t i = 0; i < count; ++i)
+                matches &= IsClose(inPlace[i], Reference(a[i], b[i]), 4);
+            inPlace = b;
+            MultiplyMatrices(single, inPlace, inPlace);
+            for (size_t i = 0; i < count; ++i)
+                matches &= IsClose(inPlace[i], Reference(single, b[i]), 4);
+        }
+    }
+    SetMaxSimdLevel(previousCap);
+    CHECK(matches);
+
+    Vector<float4x4> three(3), two(2);
+    bool threw = false;
+    try
+    {
+        MultiplyMatrices(three, float4x4{}, two);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(MatrixBatch, Benchmark)
+{
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    const MatrixBatchBenchmarkReport report = RunMatrixBatchBenchmark(10000, 20);
+    printf("    %u matrices at %s: scalar %.1f, SSE %.1f, AVX2 %.1f M/s, %.2fx\n", report.MatrixCount,
+        GetSimdLevelName(report.Level), report.ScalarMatricesPerSecond * 1e-6, report.SseMatricesPerSecond * 1e-6,
+        report.Avx2MatricesPerSecond * 1e-6, report.Speedup);
+    CHECK(report.MatrixCount == 10000);
+    CHECK(report.ScalarMatricesPerSecond > 0.0 && report.SseMatricesPerSecond > 0.0 && report.Speedup > 0.0);
+    CHECK(GetMaxSimdLevel() == previousCap);
+}
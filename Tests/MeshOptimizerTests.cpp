@@ -0,0 +1,250 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/MeshOptimizer.h"
+
+namespace
+{
+    // Triangles rotated to start at their smallest index, which keeps the winding, then sorted
+    Vector<std::array<uint32, 3>> SortedTriangles(Span<const uint32> indices)
+    {
+        Vector<std::array<uint32, 3>> triangles(indices.size() / 3);
+        for (size_t t = 0; t < triangles.size(); ++t)
+        {
+            std::array<uint32, 3>& triangle = triangles[t];
+            triangle = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        }
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    // size x size quads of a regular grid with the triangles in random order
+    Vector<uint32> MakeShuffledGrid(uint32 size, std::mt19937& random)
+    {
+        Vector<std::array<uint32, 3>> triangles;
+        for (uint32 y = 0; y < size; ++y)
+        {
+            for (uint32 x = 0; x < size; ++x)
+            {
+                const uint32 corner = y * (size + 1) + x;
+                triangles.push_back({ corner, corner + size + 1, corner + 1 });
+                triangles.push_back({ corner + 1, corner + size + 1, corner + size + 2 });
+            }
+        }
+        std::shuffle(triangles.begin(), triangles.end(), random);
+
+        Vector<uint32> indices;
+        for (const std::array<uint32, 3>& triangle : triangles)
+            indices.insert(indices.end(), triangle.begin(), triangle.end());
+        return indices;
+    }
+
+    bool IsClose(const MeshVertex& a, const MeshVertex& b, const WeldOptions& options)
+    {
+        auto close = [](float x, float y, float epsilon) { return std::fabs(x - y) <= epsilon; };
+        return close(a.Position.x, b.Position.x, options.PositionEpsilon) && close(a.Position.y, b.Position.y, options.PositionEpsilon)
+            && close(a.Position.z, b.Position.z, options.PositionEpsilon) && close(a.Normal.x, b.Normal.x, options.NormalEpsilon)
+            && close(a.Normal.y, b.Normal.y, options.NormalEpsilon) && close(a.Normal.z, b.Normal.z, options.NormalEpsilon)
+            && close(a.Uv.x, b.Uv.x, options.UvEpsilon) && close(a.Uv.y, b.Uv.y, options.UvEpsilon);
+    }
+
+    // Every vertex lies within tolerance of the first vertex of its group, and no two groups would have matched: a
+    // new group only starts when no earlier one is close
+    bool IsValidWeld(Span<const MeshVertex> vertices, Span<const uint32> remap, size_t uniqueCount, const WeldOptions& options)
+    {
+        Vector<uint32> representatives;
+        for (uint32 i = 0; i < vertices.size(); ++i)
+        {
+            if (remap[i] > representatives.size())
+                return false;
+            if (remap[i] == representatives.size())
+            {
+                for (uint32 representative : representatives)
+                {
+                    if (IsClose(vertices[representative], vertices[i], options))
+                        return false;
+                }
+                representatives.push_back(i);
+            }
+            else if (!IsClose(vertices[representatives[remap[i]]], vertices[i], options))
+            {
+                return false;
+            }
+        }
+        return representatives.size() == uniqueCount;
+    }
+}
+
+TEST(MeshOptimizer, VertexCacheLowersAcmr)
+{
+    // A lone triangle misses on every vertex
+    const uint32 triangle[] = { 0, 1, 2 };
+    const VertexCacheStats single = AnalyzeVertexCache(triangle, 3);
+    CHECK(single.Acmr == 3.0f && single.Atvr == 1.0f && single.CacheSize == s_DefaultVertexCacheSize);
+
+    std::mt19937 random(11);
+    const uint32 gridSize = 64;
+    const size_t vertexCount = size_t(gridSize + 1) * (gridSize + 1);
+    const Vector<uint32> indices = MakeShuffledGrid(gridSize, random);
+
+    // Random order misses on nearly every corner. Tipsify gets a regular grid near the 0.5 optimum once the cache
+    // holds a couple of rows of the fan, and near one miss per triangle with a small cache
+    bool kept = true;
+    bool lowered = AnalyzeVertexCache(indices, vertexCount).Acmr > 2.0f;
+    for (uint32 cacheSize : { 8u, 16u, 32u })
+    {
+        Vector<uint32> optimized(indices.size());
+        OptimizeVertexCache(indices, vertexCount, optimized, cacheSize);
+        kept &= SortedTriangles(optimized) == SortedTriangles(indices);
+        lowered &= AnalyzeVertexCache(optimized, vertexCount, cacheSize).Acmr < (cacheSize >= 16 ? 0.65f : 1.05f);
+
+        // In place gives the same order
+        Vector<uint32> inPlace = indices;
+        OptimizeVertexCache(inPlace, vertexCount, inPlace, cacheSize);
+        kept &= inPlace == optimized;
+    }
+    CHECK(kept);
+    CHECK(lowered);
+
+    // Per submesh through the template, keeping the 16-bit indices and the ranges. Each hemisphere is shuffled on its own
+    MeshTemplate sphere = CreateSphereMesh(1.0f, 32, 32);
+    Vector<uint32> sphereIndices = sphere.CopyIndices();
+    const size_t half = sphereIndices.size() / 6 * 3;
+    std::array<uint32, 3>* sphereTriangles = reinterpret_cast<std::array<uint32, 3>*>(sphereIndices.data());
+    std::shuffle(sphereTriangles, sphereTriangles + half / 3, random);
+    std::shuffle(sphereTriangles + half / 3, sphereTriangles + sphereIndices.size() / 3, random);
+    sphere.ReorderIndices(sphereIndices);
+    const Submesh submeshes[] = { { 0, uint32(half), 0 }, { uint32(half), uint32(sphereIndices.size() - half), 0 } };
+    sphere.SetSubmeshes(submeshes);
+
+    const VertexCacheReport report = OptimizeVertexCache(sphere);
+    const Vector<uint32> after = sphere.CopyIndices();
+    CHECK(report.After.Acmr < report.Before.Acmr && report.After.Acmr < 1.0f);
+    CHECK(sphere.GetIndexFormat() == IndexFormat::UInt16 && sphere.GetSubmeshes().size() == 2 && sphere.GetSubmeshes()[1].IndexOffset == half);
+    CHECK(SortedTriangles(Span<const uint32>(after.data(), half)) == SortedTriangles(Span<const uint32>(sphereIndices.data(), half)));
+    CHECK(SortedTriangles(after) == SortedTriangles(sphereIndices));
+}
+
+TEST(MeshOptimizer, OverdrawDrawsOuterShellFirst)
+{
+    // A small sphere inside a large one, the inner one drawn first and hidden behind the outer from every view
+    const MeshTemplate inner = CreateSphereMesh(0.5f, 24, 24);
+    const MeshTemplate outer = CreateSphereMesh(1.0f, 24, 24);
+    Vector<MeshVertex> vertices = inner.GetVertices();
+    vertices.insert(vertices.end(), outer.GetVertices().begin(), outer.GetVertices().end());
+    Vector<uint32> indices = inner.CopyIndices();
+    for (uint32 index : outer.CopyIndices())
+        indices.push_back(index + static_cast<uint32>(inner.GetVertexCount()));
+    MeshTemplate shells(vertices, indices);
+    OptimizeVertexCache(shells);
+    const Vector<uint32> tipsified = shells.CopyIndices();
+
+    const OverdrawReport report = OptimizeOverdraw(shells);
+    const Vector<uint32> after = shells.CopyIndices();
+    CHECK(SortedTriangles(after) == SortedTriangles(tipsified));
+    CHECK(report.OverdrawBefore.Overdraw > 1.2f);
+    CHECK(report.OverdrawAfter.Overdraw < report.OverdrawBefore.Overdraw);
+    CHECK(report.OverdrawAfter.Overdraw < 1.1f);
+    // Clusters only break where the cache efficiency allows it
+    CHECK(report.CacheAfter.Acmr <= report.CacheBefore.Acmr * s_DefaultOverdrawThreshold + 0.05f);
+    CHECK(report.OverdrawAfter.PixelsCovered == report.OverdrawBefore.PixelsCovered);
+
+    // The span version agrees with the template version
+    Vector<uint32> direct(tipsified.size());
+    OptimizeOverdraw(vertices, tipsified, direct);
+    CHECK(direct == after);
+}
+
+TEST(MeshOptimizer, WeldMatchesBruteForce)
+{
+    // Jittered copies of a small vertex set, welded at several tolerances
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> jitter(-1e-3f, 1e-3f);
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 12, 12);
+    Vector<MeshVertex> vertices;
+    for (uint32 copy = 0; copy < 4; ++copy)
+    {
+        for (MeshVertex vertex : sphere.GetVertices())
+        {
+            vertex.Position = vertex.Position + float3{ jitter(random), jitter(random), jitter(random) };
+            vertex.Normal = vertex.Normal + float3{ jitter(random), jitter(random), jitter(random) };
+            vertices.push_back(vertex);
+        }
+    }
+    std::shuffle(vertices.begin(), vertices.end(), random);
+
+    const WeldOptions settings[] = {
+        { 0.0f, 0.0f, 0.0f }, { 3e-3f, 3e-3f, 0.0f }, { 3e-3f, 3e-3f, 1.0f }, { 0.5f, 2.0f, 2.0f }, { 1e-4f, 0.0f, 0.0f } };
+    Vector<uint32> remap(vertices.size());
+    bool valid = true;
+    for (const WeldOptions& options : settings)
+    {
+        const size_t uniqueCount = WeldVertices(vertices, remap, options);
+        valid &= IsValidWeld(vertices, remap, uniqueCount, options);
+    }
+    CHECK(valid);
+
+    // The seam and pole duplicates only differ in UV
+    Vector<uint32> sphereRemap(sphere.GetVertexCount());
+    const size_t exact = WeldVertices(sphere.GetVertices(), sphereRemap);
+    const size_t seamless = WeldVertices(sphere.GetVertices(), sphereRemap, WeldOptions{ 1e-5f, 1e-5f, 2.0f });
+    CHECK(exact == sphere.GetVertexCount());
+    CHECK(seamless == 11 * 12 + 2);
+}
+
+TEST(MeshOptimizer, WeldWithoutPositionTolerance)
+{
+    // Only the normals have a tolerance, so positions must match exactly. Huge, tiny and non-finite coordinates
+    // used to overflow the cell coordinates of a 1e-12 cell
+    Vector<MeshVertex> vertices;
+    const float coordinates[] = { 0.0f, -0.0f, 1e-30f, 1.0f, 3e7f, -3e38f, 3e38f, INFINITY, NAN };
+    for (float coordinate : coordinates)
+    {
+        for (float tilt : { 0.0f, 0.01f, 0.5f })
+        {
+            MeshVertex vertex;
+            vertex.Position = { coordinate, 1.0f, -coordinate };
+            vertex.Normal = Normalize(float3{ tilt, 1.0f, 0.0f });
+            vertices.push_back(vertex);
+        }
+    }
+
+    WeldOptions options;
+    options.NormalEpsilon = 0.05f;
+    Vector<uint32> remap(vertices.size());
+    const size_t uniqueCount = WeldVertices(vertices, remap, options);
+
+    // The 0 and 0.01 tilts weld and 0 and -0 compare equal. Infinities and NaN differ from themselves, so never weld
+    CHECK(remap[0] == remap[1] && remap[0] != remap[2]);
+    CHECK(remap[3] == remap[0] && remap[5] == remap[2] && remap[6] != remap[0]);
+    CHECK(remap[9] == remap[10] && remap[12] == remap[13] && remap[15] == remap[16] && remap[18] == remap[19]);
+    CHECK(remap[21] != remap[22] && remap[24] != remap[25]);
+    CHECK(uniqueCount == 2 + 5 * 2 + 2 * 3);
+}
+
+TEST(MeshOptimizer, VertexFetchFirstUseOrder)
+{
+    const Vector<uint32> indices{ 4, 2, 0, 2, 4, 5 };
+    Vector<uint32> remap(7);
+    CHECK(OptimizeVertexFetchRemap(indices, 7, remap) == 4);
+    CHECK((remap == Vector<uint32>{ 2, ~0u, 1, ~0u, 0, 3, ~0u }));
+
+    // Welding and reordering keeps every triangle's corners
+    MeshTemplate sphere = CreateSphereMesh(1.0f, 16, 16);
+    const Vector<MeshVertex> before = sphere.GetVertices();
+    const Vector<uint32> beforeIndices = sphere.CopyIndices();
+    const VertexFetchReport report = WeldAndReorderVertices(sphere);
+    CHECK(report.After.Overfetch <= report.Before.Overfetch);
+
+    const Vector<uint32> afterIndices = sphere.CopyIndices();
+    bool kept = afterIndices.size() <= beforeIndices.size();
+    for (size_t i = 0; kept && i < afterIndices.size(); ++i)
+        kept &= sphere.GetVertices()[afterIndices[i]].Position.x == before[beforeIndices[i]].Position.x;
+    CHECK(kept);
+}
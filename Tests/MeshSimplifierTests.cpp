@@ -0,0 +1,277 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/MeshSimplifier.h"
+
+namespace
+{
+    struct TestMesh
+    {
+        Vector<MeshVertex> Vertices;
+        Vector<uint32> Indices;
+    };
+
+    // Torus without seams, every vertex shared. Three segments around the tube make the thinnest closed ring
+    TestMesh MakeTorus(uint32 majorSegments, uint32 minorSegments, float minorRadius)
+    {
+        TestMesh torus;
+        for (uint32 i = 0; i < majorSegments; ++i)
+        {
+            for (uint32 j = 0; j < minorSegments; ++j)
+            {
+                const float u = 2.0f * PI * i / majorSegments, w = 2.0f * PI * j / minorSegments;
+                MeshVertex vertex;
+                vertex.Position = { (1.0f + minorRadius * Cos(w)) * Cos(u), minorRadius * Sin(w), (1.0f + minorRadius * Cos(w)) * Sin(u) };
+                torus.Vertices.push_back(vertex);
+            }
+        }
+        for (uint32 i = 0; i < majorSegments; ++i)
+        {
+            for (uint32 j = 0; j < minorSegments; ++j)
+            {
+                const uint32 a = i * minorSegments + j, b = ((i + 1) % majorSegments) * minorSegments + j;
+                const uint32 c = ((i + 1) % majorSegments) * minorSegments + (j + 1) % minorSegments, d = i * minorSegments + (j + 1) % minorSegments;
+                torus.Indices.insert(torus.Indices.end(), { a, b, c, a, c, d });
+            }
+        }
+        return torus;
+    }
+
+    // Flat size x size grid of unit quads in the xy plane, an open mesh whose border is the square outline
+    TestMesh MakeGrid(uint32 size)
+    {
+        TestMesh grid;
+        for (uint32 y = 0; y <= size; ++y)
+        {
+            for (uint32 x = 0; x <= size; ++x)
+            {
+                MeshVertex vertex;
+                vertex.Position = { float(x), float(y), 0.0f };
+                vertex.Normal = { 0.0f, 0.0f, -1.0f };
+                grid.Vertices.push_back(vertex);
+            }
+        }
+        for (uint32 y = 0; y < size; ++y)
+        {
+            for (uint32 x = 0; x < size; ++x)
+            {
+                const uint32 corner = y * (size + 1) + x;
+                grid.Indices.insert(grid.Indices.end(), { corner, corner + size + 1, corner + 1, corner + 1, corner + size + 1, corner + size + 2 });
+            }
+        }
+        return grid;
+    }
+
+    uint64 EdgeKey(uint32 a, uint32 b)
+    {
+        return (uint64(a) << 32) | b;
+    }
+
+    // Edge uses over the wedges merged by bit-identical position, as the simplifier sees them
+    void CountEdges(Span<const MeshVertex> vertices, Span<const uint32> indices, HashMap<uint64, uint32>& directed, HashMap<uint64, uint32>& undirected)
+    {
+        Vector<uint32> group(vertices.size());
+        for (uint32 v = 0; v < vertices.size(); ++v)
+        {
+            group[v] = v;
+            for (uint32 w = 0; w < v; ++w)
+            {
+                if (std::memcmp(&vertices[v].Position, &vertices[w].Position, sizeof(float3)) == 0)
+                {
+                    group[v] = group[w];
+                    break;
+                }
+            }
+        }
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            for (size_t k = 0; k < 3; ++k)
+            {
+                const uint32 a = group[indices[t + k]], b = group[indices[t + (k + 1) % 3]];
+                directed[EdgeKey(a, b)]++;
+                undirected[EdgeKey(std::min(a, b), std::max(a, b))]++;
+            }
+        }
+    }
+
+    // Two-manifold with consistent winding: no edge has more than two triangles or runs the same way twice. Closed
+    // meshes have exactly two triangles on every edge
+    bool IsManifold(Span<const MeshVertex> vertices, Span<const uint32> indices, bool closed)
+    {
+        HashMap<uint64, uint32> directed, undirected;
+        CountEdges(vertices, indices, directed, undirected);
+        bool manifold = !indices.empty();
+        for (const auto& [edge, uses] : directed)
+            manifold &= uses == 1 && (edge >> 32) != uint32(edge);
+        for (const auto& [edge, uses] : undirected)
+            manifold &= closed ? uses == 2 : uses <= 2;
+        return manifold;
+    }
+
+    double SignedAreaXY(Span<const MeshVertex> vertices, Span<const uint32> indices)
+    {
+        double area = 0.0;
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            const float3& a = vertices[indices[t]].Position;
+            const float3& b = vertices[indices[t + 1]].Position;
+            const float3& c = vertices[indices[t + 2]].Position;
+            area += 0.5 * (double(b.x - a.x) * (c.y - a.y) - double(b.y - a.y) * (c.x - a.x));
+        }
+        return area;
+    }
+
+    bool IsGridBorder(const float3& p, uint32 size)
+    {
+        return p.x == 0.0f || p.y == 0.0f || p.x == float(size) || p.y == float(size);
+    }
+}
+
+TEST(MeshSimplifier, ReachesTargetTriangleCount)
+{
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 32, 32);
+    const Vector<uint32> indices = sphere.CopyIndices();
+    const size_t sourceTriangles = indices.size() / 3;
+
+    bool reached = true, bounded = true;
+    float previousError = 0.0f;
+    for (float ratio : { 0.75f, 0.5f, 0.25f, 0.1f })
+    {
+        SimplifyOptions options;
+        options.TargetRatio = ratio;
+        options.MaxError = 10.0f;
+        const SimplifyResult result = SimplifyMesh(sphere.GetVertices(), indices, options);
+        const size_t target = size_t(ratio * sourceTriangles);
+
+        // Interior collapses remove two triangles, so the count lands on the target or one below
+        reached &= result.Indices.size() / 3 <= target && result.Indices.size() / 3 + 2 > target;
+        reached &= IsManifold(sphere.GetVertices(), result.Indices, false);
+        // The bounding radius is half the diagonal of the unit sphere's box
+        bounded &= result.Error >= previousError && std::abs(result.AbsoluteError - result.Error * std::sqrt(3.0f)) < 1e-5f;
+        previousError = result.Error;
+    }
+    CHECK(reached);
+    CHECK(bounded);
+
+    // A tight error budget stops above the target, within the budget
+    SimplifyOptions tight;
+    tight.TargetRatio = 0.1f;
+    tight.MaxError = 0.01f;
+    const SimplifyResult limited = SimplifyMesh(sphere.GetVertices(), indices, tight);
+    CHECK(limited.Indices.size() / 3 > size_t(0.1f * sourceTriangles) && limited.Indices.size() < indices.size());
+    CHECK(limited.Error <= 0.01f);
+
+    // Ratio one only drops the pole triangles whose corners share a position
+    SimplifyOptions keep;
+    keep.TargetRatio = 1.0f;
+    const SimplifyResult kept = SimplifyMesh(sphere.GetVertices(), indices, keep);
+    CHECK(kept.Indices.size() < indices.size() && kept.Indices.size() >= indices.size() - 2 * 32 * 3 && kept.Error == 0.0f);
+}
+
+TEST(MeshSimplifier, LinkConditionKeepsManifold)
+{
+    // Collapsing around a three-segment tube or across the hole would pinch the surface into non-manifold edges.
+    // The torus cannot drop below the smallest triangulation of its genus
+    bool manifold = true;
+    for (uint32 minorSegments : { 3u, 4u })
+    {
+        for (float minorRadius : { 0.2f, 0.6f })
+        {
+            const TestMesh torus = MakeTorus(16, minorSegments, minorRadius);
+            manifold &= IsManifold(torus.Vertices, torus.Indices, true);
+            for (float ratio : { 0.5f, 0.2f, 0.0f })
+            {
+                SimplifyOptions options;
+                options.TargetRatio = ratio;
+                options.MaxError = 100.0f;
+                const SimplifyResult result = SimplifyMesh(torus.Vertices, torus.Indices, options);
+                manifold &= IsManifold(torus.Vertices, result.Indices, true) && result.Indices.size() / 3 >= 14;
+            }
+        }
+    }
+    CHECK(manifold);
+
+    // Same for the sphere all the way down. Its seam positions differ in the last bits, so it is open along the seam
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 16, 16);
+    SimplifyOptions options;
+    options.TargetRatio = 0.0f;
+    options.MaxError = 100.0f;
+    const SimplifyResult result = SimplifyMesh(sphere.GetVertices(), sphere.CopyIndices(), options);
+    CHECK(IsManifold(sphere.GetVertices(), result.Indices, false));
+}
+
+TEST(MeshSimplifier, BordersStayInPlace)
+{
+    const uint32 size = 16;
+    const TestMesh grid = MakeGrid(size);
+    const double area = SignedAreaXY(grid.Vertices, grid.Indices);
+
+    // Free borders slide along themselves: the outline, and with it the covered area, is unchanged
+    SimplifyOptions options;
+    options.TargetRatio = 0.1f;
+    options.MaxError = 0.1f;
+    const SimplifyResult free = SimplifyMesh(grid.Vertices, grid.Indices, options);
+    CHECK(free.Indices.size() / 3 < grid.Indices.size() / 3 / 4);
+    CHECK(std::abs(SignedAreaXY(grid.Vertices, free.Indices) - area) < 1e-3);
+
+    HashMap<uint64, uint32> directed, undirected;
+    CountEdges(grid.Vertices, free.Indices, directed, undirected);
+    bool onOutline = true;
+    for (const auto& [edge, uses] : undirected)
+    {
+        if (uses == 1)
+            onOutline &= IsGridBorder(grid.Vertices[edge >> 32].Position, size) && IsGridBorder(grid.Vertices[uint32(edge)].Position, size);
+        onOutline &= uses <= 2;
+    }
+    CHECK(onOutline);
+
+    // Locked borders keep every border vertex
+    options.LockBorders = true;
+    const SimplifyResult locked = SimplifyMesh(grid.Vertices, grid.Indices, options);
+    Vector<uint8> used(grid.Vertices.size(), 0);
+    for (uint32 index : locked.Indices)
+        used[index] = 1;
+    bool allKept = true;
+    for (uint32 v = 0; v < grid.Vertices.size(); ++v)
+        allKept &= !IsGridBorder(grid.Vertices[v].Position, size) || used[v];
+    CHECK(allKept);
+    CHECK(locked.Indices.size() < grid.Indices.size() && locked.Indices.size() > free.Indices.size());
+    CHECK(std::abs(SignedAreaXY(grid.Vertices, locked.Indices) - area) < 1e-3);
+}
+
+TEST(MeshSimplifier, LodChain)
+{
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 24, 24);
+    const float ratios[] = { 1.0f, 0.5f, 0.25f, 0.1f };
+    const Vector<MeshLod> chain = BuildLodChain(sphere, ratios, 10.0f);
+    CHECK(chain.size() == 4);
+
+    bool descending = true;
+    for (size_t i = 0; i < chain.size(); ++i)
+    {
+        descending &= chain[i].Ratio <= ratios[i] + 1e-3f && chain[i].Mesh.GetIndexCount() > 0;
+        if (i > 0)
+        {
+            descending &= chain[i].Mesh.GetIndexCount() < chain[i - 1].Mesh.GetIndexCount();
+            descending &= chain[i].Mesh.GetVertexCount() <= chain[i - 1].Mesh.GetVertexCount();
+            descending &= chain[i].Error >= chain[i - 1].Error;
+        }
+    }
+    CHECK(descending);
+
+    bool threw = false;
+    try
+    {
+        const uint32 indices[] = { 0, 1, 1000 };
+        SimplifyMesh(sphere.GetVertices(), indices);
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
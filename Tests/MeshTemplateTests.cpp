@@ -0,0 +1,161 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include "Graphics/Mesh.h"
+
+namespace
+{
+    // Vertex v sits at x = v, so a vertex can be traced back through duplication
+    Vector<MeshVertex> MakeVertices(uint32 count)
+    {
+        Vector<MeshVertex> vertices(count);
+        for (uint32 v = 0; v < count; ++v)
+            vertices[v].Position = { float(v), 0.0f, 0.0f };
+        return vertices;
+    }
+
+    // Source vertex of every index, through the submesh ranges when the mesh is split
+    Vector<uint32> ResolveIndices(const MeshTemplate& mesh)
+    {
+        const Vector<uint32> indices = mesh.CopyIndices();
+        Vector<Submesh> submeshes = mesh.GetSubmeshes();
+        if (submeshes.empty())
+            submeshes.push_back(Submesh{ 0, static_cast<uint32>(indices.size()), 0 });
+
+        Vector<uint32> resolved;
+        for (const Submesh& submesh : submeshes)
+        {
+            for (uint32 i = submesh.IndexOffset; i < submesh.IndexOffset + submesh.IndexCount; ++i)
+                resolved.push_back(static_cast<uint32>(mesh.GetVertices()[submesh.BaseVertex + indices[i]].Position.x));
+        }
+        return resolved;
+    }
+
+    // Every submesh addresses at most 65536 vertices of its own, without overlapping the others
+    bool SubmeshesAreDisjoint(const MeshTemplate& mesh)
+    {
+        const Vector<uint32> indices = mesh.CopyIndices();
+        int64 nextBase = 0;
+        for (const Submesh& submesh : mesh.GetSubmeshes())
+        {
+            if (submesh.BaseVertex != nextBase)
+                return false;
+            uint32 maxIndex = 0;
+            for (uint32 i = submesh.IndexOffset; i < submesh.IndexOffset + submesh.IndexCount; ++i)
+                maxIndex = std::max(maxIndex, indices[i]);
+            nextBase += maxIndex + 1;
+        }
+        return nextBase == int64(mesh.GetVertexCount());
+    }
+}
+
+TEST(MeshTemplate, SelectsIndexFormat)
+{
+    CHECK(SelectIndexFormat(Vector<uint32>{}) == IndexFormat::UInt16);
+    CHECK(SelectIndexFormat(Vector<uint32>{ 0, 65535, 1 }) == IndexFormat::UInt16);
+    CHECK(SelectIndexFormat(Vector<uint32>{ 0, 65536, 1 }) == IndexFormat::UInt32);
+
+    // Exactly 65536 vertices still fit 16-bit indices
+    const Vector<uint32> indices{ 0, 1, 65535 };
+    MeshTemplate mesh(MakeVertices(65536), indices);
+    CHECK(mesh.GetIndexFormat() == IndexFormat::UInt16);
+    CHECK(mesh.CopyIndices() == indices);
+    mesh.SplitInto16BitSubmeshes();
+    CHECK(mesh.GetSubmeshes().empty() && mesh.GetVertexCount() == 65536);
+
+    bool threw = false;
+    try
+    {
+        NarrowIndices(Vector<uint32>{ 65536 });
+    }
+    catch (const std::out_of_range&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(MeshTemplate, SplitsAtTheExactBoundary)
+{
+    // 21845 separate triangles use vertices [0, 65535), the next one adds vertex 65535 only and fills the first chunk
+    // to exactly 65536 vertices. The triangle after it references 65535 again, which moves to the second chunk
+    Vector<uint32> indices;
+    for (uint32 v = 0; v < 65535; ++v)
+        indices.push_back(v);
+    const Vector<uint32> tail{ 65533, 65534, 65535, 65535, 65536, 65537, 65537, 65536, 65538 };
+    indices.insert(indices.end(), tail.begin(), tail.end());
+
+    MeshTemplate mesh(MakeVertices(65539), indices);
+    CHECK(mesh.GetIndexFormat() == IndexFormat::UInt32);
+    mesh.SplitInto16BitSubmeshes();
+
+    CHECK(mesh.GetIndexFormat() == IndexFormat::UInt16);
+    const Vector<Submesh>& submeshes = mesh.GetSubmeshes();
+    CHECK(submeshes.size() == 2);
+    CHECK(submeshes[0].IndexOffset == 0 && submeshes[0].IndexCount == 65538 && submeshes[0].BaseVertex == 0);
+    CHECK(submeshes[1].IndexOffset == 65538 && submeshes[1].IndexCount == 6 && submeshes[1].BaseVertex == 65536);
+
+    // Vertex 65535 is duplicated, the second chunk's indices are remapped onto its own vertices in first-use order
+    CHECK(mesh.GetVertexCount() == 65540);
+    CHECK(mesh.GetVertices()[65535].Position.x == 65535.0f && mesh.GetVertices()[65536].Position.x == 65535.0f);
+    const Vector<uint32> split = mesh.CopyIndices();
+    CHECK(split[65537] == 65535);
+    const Vector<uint32> secondChunk(split.begin() + 65538, split.end());
+    CHECK((secondChunk == Vector<uint32>{ 0, 1, 2, 2, 1, 3 }));
+
+    CHECK(ResolveIndices(mesh) == indices);
+    CHECK(SubmeshesAreDisjoint(mesh));
+}
+
+TEST(MeshTemplate, SplitKeepsEveryTriangle)
+{
+    // A strip of shared-vertex triangles in shuffled order, so many chunks reuse vertices of earlier ones
+    std::mt19937 random(11);
+    const uint32 vertexCount = 200000;
+    Vector<uint32> triangles;
+    for (uint32 v = 0; v + 2 < vertexCount; ++v)
+        triangles.push_back(v);
+    std::shuffle(triangles.begin(), triangles.end(), random);
+
+    Vector<uint32> indices;
+    for (uint32 first : triangles)
+    {
+        // Every other triangle is far away in the vertex order too
+        const uint32 far = random() % vertexCount;
+        indices.insert(indices.end(), { first, first + 1, first % 2 ? far : first + 2 });
+    }
+
+    MeshTemplate mesh(MakeVertices(vertexCount), indices);
+    mesh.SplitInto16BitSubmeshes();
+
+    CHECK(mesh.GetIndexFormat() == IndexFormat::UInt16);
+    CHECK(mesh.GetSubmeshes().size() > 3);
+    CHECK(mesh.GetVertexCount() > vertexCount);
+    CHECK(ResolveIndices(mesh) == indices);
+    CHECK(SubmeshesAreDisjoint(mesh));
+
+    // A chunk holds each source vertex once
+    bool unique = true;
+    for (const Submesh& submesh : mesh.GetSubmeshes())
+    {
+        const uint32 end = submesh.IndexOffset + submesh.IndexCount;
+        uint32 chunkVertices = 0;
+        for (const Submesh& other : mesh.GetSubmeshes())
+        {
+            if (other.BaseVertex > submesh.BaseVertex)
+            {
+                chunkVertices = other.BaseVertex - submesh.BaseVertex;
+                break;
+            }
+        }
+        if (chunkVertices == 0)
+            chunkVertices = static_cast<uint32>(mesh.GetVertexCount() - submesh.BaseVertex);
+
+        HashMap<float, uint32> seen;
+        for (uint32 v = 0; v < chunkVertices; ++v)
+            unique &= seen.emplace(mesh.GetVertices()[submesh.BaseVertex + v].Position.x, v).second;
+        unique &= end <= mesh.GetIndexCount() && chunkVertices <= s_MaxVerticesPer16BitIndex;
+    }
+    CHECK(unique);
+}
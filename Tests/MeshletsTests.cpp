@@ -0,0 +1,177 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/MeshOptimizer.h"
+#include "Graphics/Meshlets.h"
+
+namespace
+{
+    // Triangles rotated to start at their smallest index, which keeps the winding, then sorted
+    Vector<std::array<uint32, 3>> SortedTriangles(Vector<std::array<uint32, 3>> triangles)
+    {
+        for (std::array<uint32, 3>& triangle : triangles)
+            std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        std::sort(triangles.begin(), triangles.end());
+        return triangles;
+    }
+
+    Vector<std::array<uint32, 3>> ToTriangles(Span<const uint32> indices)
+    {
+        Vector<std::array<uint32, 3>> triangles(indices.size() / 3);
+        for (size_t t = 0; t < triangles.size(); ++t)
+            triangles[t] = { indices[t * 3], indices[t * 3 + 1], indices[t * 3 + 2] };
+        return triangles;
+    }
+
+    // Every meshlet within the limits, its ranges packed one after the other, no vertex twice and every primitive index
+    // local. Returns the triangles the meshlets draw, in mesh vertex indices
+    bool IsValid(const MeshletData& data, const MeshletLimits& limits, Vector<std::array<uint32, 3>>& triangles)
+    {
+        bool valid = data.Bounds.size() == data.Meshlets.size();
+        uint32 vertexOffset = 0, triangleOffset = 0;
+        for (const Meshlet& meshlet : data.Meshlets)
+        {
+            valid &= meshlet.VertexCount >= 1 && meshlet.VertexCount <= limits.MaxVertices;
+            valid &= meshlet.TriangleCount >= 1 && meshlet.TriangleCount <= limits.MaxTriangles;
+            valid &= meshlet.VertexOffset == vertexOffset && meshlet.TriangleOffset == triangleOffset;
+            vertexOffset += meshlet.VertexCount;
+            triangleOffset += meshlet.TriangleCount;
+            if (!valid || vertexOffset > data.VertexIndices.size() || size_t(triangleOffset) * 3 > data.PrimitiveIndices.size())
+                return false;
+
+            Vector<uint32> local(data.VertexIndices.begin() + meshlet.VertexOffset, data.VertexIndices.begin() + vertexOffset);
+            std::sort(local.begin(), local.end());
+            valid &= std::adjacent_find(local.begin(), local.end()) == local.end();
+
+            for (uint32 t = meshlet.TriangleOffset; t < triangleOffset; ++t)
+            {
+                std::array<uint32, 3> triangle;
+                for (uint32 k = 0; k < 3; ++k)
+                {
+                    const uint8 primitive = data.PrimitiveIndices[size_t(t) * 3 + k];
+                    valid &= primitive < meshlet.VertexCount;
+                    triangle[k] = data.VertexIndices[meshlet.VertexOffset + std::min<uint32>(primitive, meshlet.VertexCount - 1)];
+                }
+                triangles.push_back(triangle);
+            }
+        }
+        return valid && vertexOffset == data.VertexIndices.size() && size_t(triangleOffset) * 3 == data.PrimitiveIndices.size();
+    }
+
+    // The bounding sphere holds every vertex of its meshlet
+    bool BoundsContainVertices(Span<const MeshVertex> vertices, const MeshletData& data)
+    {
+        bool contained = true;
+        for (size_t m = 0; m < data.Meshlets.size(); ++m)
+        {
+            const Meshlet& meshlet = data.Meshlets[m];
+            const MeshletBounds& bounds = data.Bounds[m];
+            for (uint32 i = meshlet.VertexOffset; i < meshlet.VertexOffset + meshlet.VertexCount; ++i)
+                contained &= Length(vertices[data.VertexIndices[i]].Position - bounds.Center) <= bounds.Radius * 1.0001f + 1e-6f;
+        }
+        return contained;
+    }
+}
+
+TEST(Meshlets, LimitsAndCoverage)
+{
+    // A cache-optimized sphere, and a soup of random triangles over few shared vertices, some of them degenerate
+    MeshTemplate sphere = CreateSphereMesh(1.0f, 48, 48);
+    OptimizeVertexCache(sphere);
+    const Vector<uint32> sphereIndices = sphere.CopyIndices();
+
+    std::mt19937 random(19);
+    std::uniform_real_distribution<float> position(-1.0f, 1.0f);
+    Vector<MeshVertex> soupVertices(300);
+    for (MeshVertex& vertex : soupVertices)
+        vertex.Position = float3{ position(random), position(random), position(random) };
+    Vector<uint32> soupIndices;
+    for (uint32 t = 0; t < 2000; ++t)
+    {
+        const uint32 a = random() % 300;
+        soupIndices.insert(soupIndices.end(), { a, (a + 1 + random() % 299) % 300, (a + 1 + random() % 150) % 300 });
+    }
+
+    const MeshletLimits limits[] = { {}, { 3, 1 }, { 4, 2 }, { 32, 64 }, { 256, 512 }, { 128, 16 } };
+    bool valid = true, covered = true, bounded = true;
+    for (const MeshletLimits& limit : limits)
+    {
+        for (const auto& [vertices, indices] : { std::pair{ Span<const MeshVertex>(sphere.GetVertices()), Span<const uint32>(sphereIndices) },
+                 std::pair{ Span<const MeshVertex>(soupVertices), Span<const uint32>(soupIndices) } })
+        {
+            const MeshletData data = BuildMeshlets(vertices, indices, limit);
+            Vector<std::array<uint32, 3>> triangles;
+            valid &= IsValid(data, limit, triangles);
+            covered &= SortedTriangles(triangles) == SortedTriangles(ToTriangles(indices));
+            bounded &= BoundsContainVertices(vertices, data);
+        }
+    }
+    CHECK(valid);
+    CHECK(covered);
+    CHECK(bounded);
+
+    // The defaults pack a connected mesh well, the vertex limit is the one that binds
+    const MeshletStats stats = AnalyzeMeshlets(BuildMeshlets(sphere));
+    CHECK(stats.MeshletCount > 0 && stats.VertexFill > 0.9f && stats.TriangleFill > 0.5f);
+
+    // Nothing to build
+    const MeshletData empty = BuildMeshlets(Span<const MeshVertex>{}, Span<const uint32>{});
+    CHECK(empty.Meshlets.empty() && empty.VertexIndices.empty() && empty.PrimitiveIndices.empty());
+}
+
+TEST(Meshlets, SubmeshesReferToTemplateVertices)
+{
+    // Two spheres in one vertex buffer, the second drawn through BaseVertex
+    const MeshTemplate small = CreateSphereMesh(0.5f, 12, 12);
+    const MeshTemplate large = CreateSphereMesh(2.0f, 20, 20);
+    Vector<MeshVertex> vertices = small.GetVertices();
+    vertices.insert(vertices.end(), large.GetVertices().begin(), large.GetVertices().end());
+    Vector<uint32> indices = small.CopyIndices();
+    const Vector<uint32> largeIndices = large.CopyIndices();
+    indices.insert(indices.end(), largeIndices.begin(), largeIndices.end());
+
+    MeshTemplate combined(vertices, indices);
+    const Submesh submeshes[] = {
+        { 0, uint32(small.GetIndexCount()), 0 },
+        { uint32(small.GetIndexCount()), uint32(large.GetIndexCount()), int32(small.GetVertexCount()) } };
+    combined.SetSubmeshes(submeshes);
+
+    Vector<uint32> absolute = small.CopyIndices();
+    for (uint32 index : largeIndices)
+        absolute.push_back(index + uint32(small.GetVertexCount()));
+
+    const MeshletLimits limits;
+    const MeshletData data = BuildMeshlets(combined, limits);
+    Vector<std::array<uint32, 3>> triangles;
+    CHECK(IsValid(data, limits, triangles));
+    CHECK(SortedTriangles(triangles) == SortedTriangles(ToTriangles(absolute)));
+    CHECK(BoundsContainVertices(vertices, data));
+}
+
+TEST(Meshlets, InvalidInput)
+{
+    const MeshTemplate cube = CreateCubeMesh();
+    const Vector<uint32> indices = cube.CopyIndices();
+    auto throws = [&](const MeshletLimits& limits, Span<const uint32> list)
+    {
+        try
+        {
+            BuildMeshlets(cube.GetVertices(), list, limits);
+        }
+        catch (const std::logic_error&)
+        {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws(MeshletLimits{ 2, 124 }, indices));
+    CHECK(throws(MeshletLimits{ 257, 124 }, indices));
+    CHECK(throws(MeshletLimits{ 64, 0 }, indices));
+    CHECK(throws(MeshletLimits{}, Span<const uint32>(indices.data(), 4)));
+    const uint32 outOfRange[] = { 0, 1, 100 };
+    CHECK(throws(MeshletLimits{}, outOfRange));
+}
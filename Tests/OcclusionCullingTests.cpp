@@ -0,0 +1,83 @@
+#include "TestFramework.h"
+
+#include "Engine/Camera.h"
+#include "Engine/OcclusionCulling.h"
+#include "Graphics/HelperFunctions.h"
+
+namespace
+{
+    float4x4 MakeWorld(const float3& scale, const float3& translation)
+    {
+        return float4x4{
+            scale.x, 0.0f, 0.0f, 0.0f,
+            0.0f, scale.y, 0.0f, 0.0f,
+            0.0f, 0.0f, scale.z, 0.0f,
+            translation.x, translation.y, translation.z, 1.0f };
+    }
+
+    bool IsBoxOccluded(const OcclusionCuller& culler, const float3& center, float halfSize)
+    {
+        const float3 extent{ halfSize, halfSize, halfSize };
+        return culler.IsOccluded(center - extent, center + extent);
+    }
+}
+
+TEST(OcclusionCulling, WallHidesWhatIsBehindIt)
+{
+    // Camera at the origin looking down +z at a 2x2 wall 5 units away, which covers the middle of the view
+    Camera camera;
+    camera.SetPosition(float3{ 0.0f, 0.0f, 0.0f });
+    camera.SetPerspective(90.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    float4x4 viewProjection;
+    XMStoreFloat4x4(&viewProjection, camera.GetViewProjectionMatrix());
+
+    const MeshTemplate wall = CreateCubeMesh(1.0f);
+    OcclusionCuller culler;
+    culler.BeginFrame(viewProjection);
+    culler.RenderOccluders();
+    CHECK(!IsBoxOccluded(culler, float3{ 0.0f, 0.0f, 20.0f }, 0.5f));
+
+    culler.BeginFrame(viewProjection);
+    culler.AddOccluder(wall, MakeWorld(float3{ 2.0f, 2.0f, 0.5f }, float3{ 0.0f, 0.0f, 5.0f }));
+    culler.RenderOccluders();
+    CHECK(culler.GetRasterStats().OccluderCount == 1 && culler.GetRasterStats().TrianglesRasterized > 0);
+
+    // Behind the wall, in front of it, beside it on screen, straddling its edge and crossing the near plane
+    CHECK(IsBoxOccluded(culler, float3{ 0.0f, 0.0f, 20.0f }, 0.5f));
+    CHECK(IsBoxOccluded(culler, float3{ 0.5f, -0.5f, 12.0f }, 0.5f));
+    CHECK(!IsBoxOccluded(culler, float3{ 0.0f, 0.0f, 3.0f }, 0.5f));
+    CHECK(!IsBoxOccluded(culler, float3{ 6.0f, 0.0f, 20.0f }, 0.5f));
+    CHECK(!IsBoxOccluded(culler, float3{ 2.0f, 0.0f, 10.0f }, 1.0f));
+    CHECK(!IsBoxOccluded(culler, float3{ 0.0f, 0.0f, 0.0f }, 0.5f));
+    // Projected far past the range of uint32 right after the near plane
+    CHECK(!culler.IsOccluded(float3{ -1e8f, -1e8f, 0.15f }, float3{ 1e8f, 1e8f, 0.25f }));
+    CHECK(!culler.IsOccluded(float3{ 1e8f, 1e8f, 0.15f }, float3{ 2e8f, 2e8f, 0.25f }));
+
+    // The sphere test agrees with the box test
+    Float4Stream spheres(3);
+    const Float4SoA view = spheres.View();
+    const float4 values[] = { { 0.0f, 0.0f, 20.0f, 0.5f }, { 0.0f, 0.0f, 3.0f, 0.5f }, { 6.0f, 0.0f, 20.0f, 0.5f } };
+    for (uint32 i = 0; i < 3; ++i)
+    {
+        view.X[i] = values[i].x;
+        view.Y[i] = values[i].y;
+        view.Z[i] = values[i].z;
+        view.W[i] = values[i].w;
+    }
+    const uint32 candidates[] = { 0, 1, 2 };
+    Vector<uint32> visible;
+    const OcclusionTestStats stats = culler.CullSpheres(spheres.View(), candidates, visible);
+    CHECK(stats.Tested == 3 && stats.Occluded == 1);
+    CHECK((visible == Vector<uint32>{ 1, 2 }));
+}
+
+TEST(OcclusionCulling, Benchmark)
+{
+    const OcclusionBenchmarkReport report = RunOcclusionBenchmark(20);
+    printf("    raster %.3f ms, test %.3f ms, %zu of %zu triangles rasterized, %.0f%% of %zu occludees rejected\n",
+        report.AverageRasterMilliseconds, report.AverageTestMilliseconds, report.Raster.TrianglesRasterized,
+        report.Raster.TrianglesSubmitted, report.Test.RejectionRate * 100.0f, report.Test.Tested);
+    CHECK(report.Iterations == 20);
+    CHECK(report.Raster.OccluderCount == 4 && report.Raster.TrianglesRasterized > 0);
+    CHECK(report.Test.Tested > 0 && report.Test.Occluded > 0 && report.Test.Occluded < report.Test.Tested);
+}
@@ -0,0 +1,142 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "Engine/Parallel.h"
+
+namespace
+{
+    // Runs the pool with 7 threads however many cores the machine has, restoring the hardware count afterwards
+    struct ForcedWorkerCount
+    {
+        static constexpr uint32 s_WorkerCount = 8;
+
+        ForcedWorkerCount() { SetWorkerCount(s_WorkerCount); }
+        ~ForcedWorkerCount() { SetWorkerCount(0); }
+    };
+}
+
+TEST(Parallel, VisitsEveryIndexOnce)
+{
+    ForcedWorkerCount workers;
+    for (size_t count : { size_t(1), size_t(7), size_t(1000), size_t(100000) })
+    {
+        Vector<std::atomic<uint32>> visits(count);
+        ParallelFor(count, [&](size_t i) { visits[i].fetch_add(1, std::memory_order_relaxed); });
+
+        bool once = true;
+        for (const std::atomic<uint32>& visit : visits)
+            once &= visit.load() == 1;
+        CHECK(once);
+    }
+}
+
+TEST(Parallel, RethrowsFirstException)
+{
+    ForcedWorkerCount workers;
+    std::atomic<uint32> calls{ 0 };
+    bool threw = false;
+    try
+    {
+        ParallelFor(10000, [&](size_t i)
+        {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            if (i == 100)
+                throw std::runtime_error("item 100");
+        });
+    }
+    catch (const std::runtime_error& e)
+    {
+        threw = String(e.what()) == "item 100";
+    }
+    CHECK(threw);
+    CHECK(calls.load() < 10000);
+
+    // The pool is still usable afterwards
+    std::atomic<size_t> sum{ 0 };
+    ParallelFor(1000, [&](size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+    CHECK(sum.load() == 999 * 1000 / 2);
+}
+
+TEST(Parallel, NestedCallsRunInline)
+{
+    ForcedWorkerCount workers;
+    std::atomic<size_t> sum{ 0 };
+    ParallelFor(64, [&](size_t outer)
+    {
+        ParallelFor(64, [&](size_t inner) { sum.fetch_add(outer * 64 + inner, std::memory_order_relaxed); });
+    });
+    CHECK(sum.load() == 4095 * 4096 / 2);
+}
+
+TEST(Parallel, ConcurrentCallers)
+{
+    ForcedWorkerCount workers;
+    // Jobs from several threads take turns on the pool
+    static constexpr uint32 s_CallerCount = 8;
+    Vector<size_t> sums(s_CallerCount, 0);
+    Vector<std::thread> callers;
+    for (uint32 c = 0; c < s_CallerCount; ++c)
+    {
+        callers.emplace_back([&sums, c]()
+        {
+            for (uint32 round = 0; round < 200; ++round)
+            {
+                std::atomic<size_t> sum{ 0 };
+                ParallelFor(256, [&](size_t i) { sum.fetch_add(i + c, std::memory_order_relaxed); });
+                sums[c] += sum.load();
+            }
+        });
+    }
+    for (std::thread& caller : callers)
+        caller.join();
+
+    bool correct = true;
+    for (uint32 c = 0; c < s_CallerCount; ++c)
+        correct &= sums[c] == 200 * (255 * 256 / 2 + 256 * size_t(c));
+    CHECK(correct);
+}
+
+TEST(Parallel, ManySmallCalls)
+{
+    ForcedWorkerCount workers;
+    // Per-frame use: small jobs back to back must not pay for thread creation
+    static constexpr uint32 s_CallCount = 20000;
+    std::atomic<size_t> sum{ 0 };
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32 call = 0; call < s_CallCount; ++call)
+        ParallelFor(16, [&](size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+    const double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    printf("    %.2f us per call on %u workers\n", microseconds / s_CallCount, GetWorkerCount());
+    CHECK(sum.load() == size_t(s_CallCount) * 120);
+}
+
+TEST(Parallel, WorkerCountOverride)
+{
+    {
+        ForcedWorkerCount workers;
+        CHECK(GetWorkerCount() == ForcedWorkerCount::s_WorkerCount);
+
+        // Items long enough that the pool threads join in before the caller is done with them all
+        std::mutex mutex;
+        Vector<std::thread::id> threads;
+        ParallelFor(64, [&](size_t)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard lock(mutex);
+            if (std::find(threads.begin(), threads.end(), std::this_thread::get_id()) == threads.end())
+                threads.push_back(std::this_thread::get_id());
+        });
+        CHECK(threads.size() > 1 && threads.size() <= ForcedWorkerCount::s_WorkerCount);
+    }
+
+    CHECK(GetWorkerCount() == std::max(1u, std::thread::hardware_concurrency()));
+
+    // Shrinks the pool back, down to no threads on a single core machine
+    std::atomic<size_t> sum{ 0 };
+    ParallelFor(1000, [&](size_t i) { sum.fetch_add(i, std::memory_order_relaxed); });
+    CHECK(sum.load() == 999 * 1000 / 2);
+}
@@ -0,0 +1,149 @@
+#include "TestFramework.h"
+
+#include <cmath>
+
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/PrimitiveTables.h"
+
+namespace
+{
+    // Forcing constant evaluation: a generator or BaseTypes function that stops being constexpr fails to compile here
+    static constexpr auto s_Cube = MakeCubeTable(2.0f);
+    static constexpr auto s_Plane = MakePlaneTable<2, 3>(2.0f, 4.0f);
+    static constexpr auto s_Sphere = MakeSphereTable<4, 8>(2.0f);
+
+    // The compile-time Sin/Cos/Sqrt run in double precision, their float results are within a few ulp of <cmath>
+    constexpr float s_Tolerance = 1e-6f;
+
+    constexpr bool IsNear(float a, float b, float tolerance = s_Tolerance)
+    {
+        return (a > b ? a - b : b - a) <= tolerance;
+    }
+
+    constexpr bool IsNear(const float3& a, const float3& b)
+    {
+        return IsNear(a.x, b.x) && IsNear(a.y, b.y) && IsNear(a.z, b.z);
+    }
+
+    template<class Table>
+    constexpr bool IndicesInRange(const Table& table)
+    {
+        for (auto index : table.Indices)
+        {
+            if (index >= table.Vertices.size())
+                return false;
+        }
+        return true;
+    }
+
+    template<class Table>
+    constexpr bool NormalsAreUnit(const Table& table)
+    {
+        for (const MeshVertex& vertex : table.Vertices)
+        {
+            if (!IsNear(Dot(vertex.Normal, vertex.Normal), 1.0f))
+                return false;
+        }
+        return true;
+    }
+
+    template<class Table>
+    constexpr bool PositionsOnSphere(const Table& table, float radius)
+    {
+        for (const MeshVertex& vertex : table.Vertices)
+        {
+            if (!IsNear(Length(vertex.Position), radius, 4.0f * s_Tolerance))
+                return false;
+        }
+        return true;
+    }
+}
+
+// ---------- Cube ------------
+static_assert(s_Cube.Vertices.size() == 24 && s_Cube.Indices.size() == 36);
+static_assert(std::is_same_v<std::remove_cvref_t<decltype(s_Cube.Indices[0])>, uint16>);
+static_assert(IsNear(s_Cube.Vertices[0].Position, float3{ -1.0f, -1.0f, 1.0f }));
+static_assert(IsNear(s_Cube.Vertices[0].Normal, float3{ 0.0f, 0.0f, 1.0f }));
+static_assert(s_Cube.Vertices[0].Uv.x == 0.0f && s_Cube.Vertices[0].Uv.y == 1.0f);
+static_assert(IsNear(s_Cube.Vertices[8].Position, float3{ -1.0f, 1.0f, -1.0f }));
+static_assert(IsNear(s_Cube.Vertices[8].Normal, float3{ 0.0f, 1.0f, 0.0f }));
+static_assert(IsNear(s_Cube.Vertices[23].Normal, float3{ -1.0f, 0.0f, 0.0f }));
+static_assert(s_Cube.Indices[0] == 0 && s_Cube.Indices[1] == 1 && s_Cube.Indices[2] == 2);
+static_assert(s_Cube.Indices[3] == 2 && s_Cube.Indices[4] == 3 && s_Cube.Indices[5] == 0);
+static_assert(s_Cube.Indices[6] == 4 && s_Cube.Indices[35] == 20);
+static_assert(IndicesInRange(s_Cube) && NormalsAreUnit(s_Cube));
+
+// ---------- Plane ------------
+static_assert(s_Plane.Vertices.size() == 12 && s_Plane.Indices.size() == 36);
+static_assert(IsNear(s_Plane.Vertices[0].Position, float3{ -1.0f, 0.0f, -2.0f }));
+static_assert(IsNear(s_Plane.Vertices[11].Position, float3{ 1.0f, 0.0f, 2.0f }));
+static_assert(IsNear(s_Plane.Vertices[5].Normal, float3{ 0.0f, 1.0f, 0.0f }));
+static_assert(s_Plane.Vertices[0].Uv.x == 0.0f && s_Plane.Vertices[0].Uv.y == 1.0f);
+static_assert(s_Plane.Vertices[11].Uv.x == 1.0f && s_Plane.Vertices[11].Uv.y == 0.0f);
+static_assert(s_Plane.Indices[0] == 0 && s_Plane.Indices[1] == 3 && s_Plane.Indices[2] == 1);
+static_assert(s_Plane.Indices[3] == 1 && s_Plane.Indices[4] == 3 && s_Plane.Indices[5] == 4);
+static_assert(s_Plane.Indices[35] == 11);
+static_assert(IndicesInRange(s_Plane) && NormalsAreUnit(s_Plane));
+
+// ---------- Sphere ------------
+static_assert(s_Sphere.Vertices.size() == 45 && s_Sphere.Indices.size() == 192);
+static_assert(IsNear(s_Sphere.Vertices[0].Position, float3{ 0.0f, 2.0f, 0.0f }));
+static_assert(IsNear(s_Sphere.Vertices[0].Normal, float3{ 0.0f, 1.0f, 0.0f }));
+// Equator (latitude 2 of 4) at longitudes 0 and 2 of 8
+static_assert(IsNear(s_Sphere.Vertices[2 * 9 + 0].Position, float3{ 2.0f, 0.0f, 0.0f }));
+static_assert(IsNear(s_Sphere.Vertices[2 * 9 + 2].Position, float3{ 0.0f, 0.0f, 2.0f }));
+static_assert(IsNear(s_Sphere.Vertices[2 * 9 + 2].Normal, float3{ 0.0f, 0.0f, 1.0f }));
+static_assert(IsNear(s_Sphere.Vertices[44].Position, float3{ 0.0f, -2.0f, 0.0f }));
+static_assert(s_Sphere.Indices[0] == 0 && s_Sphere.Indices[1] == 1 && s_Sphere.Indices[2] == 9);
+static_assert(s_Sphere.Indices[3] == 9 && s_Sphere.Indices[4] == 1 && s_Sphere.Indices[5] == 10);
+static_assert(IndicesInRange(s_Sphere) && NormalsAreUnit(s_Sphere) && PositionsOnSphere(s_Sphere, 2.0f));
+
+// ---------- BaseTypes compile-time math ------------
+static_assert(ConstexprSqrt(4.0f) == 2.0f && ConstexprSqrt(0.0f) == 0.0f && ConstexprSqrt(1.0f) == 1.0f);
+static_assert(ConstexprSin(0.0f) == 0.0f && ConstexprCos(0.0f) == 1.0f);
+static_assert(IsNear(ConstexprSin(HALF_PI), 1.0f) && IsNear(ConstexprCos(PI), -1.0f));
+static_assert(Sqrt(9.0f) == 3.0f && IsNear(Sin(PI), 0.0f) && IsNear(Cos(HALF_PI), 0.0f));
+static_assert(IsNear(Length(Normalize(float3{ 3.0f, 4.0f, 12.0f })), 1.0f));
+
+TEST(PrimitiveTables, ConstexprMathMatchesCmath)
+{
+    // A sweep over several turns in both directions covers the range reduction of Sin/Cos
+    bool matches = true;
+    for (int32 i = -2000; i <= 2000; ++i)
+    {
+        const float x = i * 0.01f;
+        matches &= std::abs(ConstexprSin(x) - std::sin(x)) <= s_Tolerance;
+        matches &= std::abs(ConstexprCos(x) - std::cos(x)) <= s_Tolerance;
+    }
+    for (int32 i = 0; i <= 4000; ++i)
+    {
+        // Relative, up to 1e6
+        const float x = std::pow(10.0f, i * 0.0015f) - 1.0f;
+        matches &= std::abs(ConstexprSqrt(x) - std::sqrt(x)) <= s_Tolerance * std::max(1.0f, std::sqrt(x));
+    }
+    CHECK(matches);
+    CHECK(std::isnan(ConstexprSqrt(-1.0f)));
+    CHECK(ConstexprSqrt(std::numeric_limits<float>::infinity()) == std::numeric_limits<float>::infinity());
+}
+
+TEST(PrimitiveTables, MatchRuntimeGenerators)
+{
+    const MeshTemplate cube = CreateCubeMesh(2.0f);
+    const MeshTemplate sphere = CreateSphereMesh(2.0f, 4, 8);
+    CHECK(cube.GetVertexCount() == s_Cube.Vertices.size() && cube.GetIndexCount() == s_Cube.Indices.size());
+    CHECK(sphere.GetVertexCount() == s_Sphere.Vertices.size() && sphere.GetIndexCount() == s_Sphere.Indices.size());
+
+    bool matches = true;
+    for (size_t i = 0; i < s_Cube.Vertices.size(); ++i)
+        matches &= IsNear(cube.GetVertices()[i].Position, s_Cube.Vertices[i].Position);
+    for (size_t i = 0; i < s_Cube.Indices.size(); ++i)
+        matches &= cube.GetIndex(i) == s_Cube.Indices[i];
+    for (size_t i = 0; i < s_Sphere.Vertices.size(); ++i)
+    {
+        matches &= IsNear(sphere.GetVertices()[i].Position, s_Sphere.Vertices[i].Position);
+        matches &= IsNear(sphere.GetVertices()[i].Normal, s_Sphere.Vertices[i].Normal);
+    }
+    for (size_t i = 0; i < s_Sphere.Indices.size(); ++i)
+        matches &= sphere.GetIndex(i) == s_Sphere.Indices[i];
+    CHECK(matches);
+}
@@ -0,0 +1,81 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Engine/RadixSort.h"
+
+namespace
+{
+    // Values number the items in input order, so a stable sort leaves them ascending within equal keys
+    Vector<RadixSortItem> MakeItems(size_t count, std::mt19937_64& random, uint64 keyMask)
+    {
+        Vector<RadixSortItem> items(count);
+        for (size_t i = 0; i < count; ++i)
+            items[i] = RadixSortItem{ random() & keyMask, static_cast<uint32>(i) };
+        return items;
+    }
+
+    bool MatchesStableSort(const Vector<RadixSortItem>& input, size_t parallelThreshold)
+    {
+        Vector<RadixSortItem> expected = input;
+        std::stable_sort(expected.begin(), expected.end(), [](const RadixSortItem& a, const RadixSortItem& b) { return a.Key < b.Key; });
+
+        Vector<RadixSortItem> items = input;
+        Vector<RadixSortItem> scratch;
+        RadixSort(items, scratch, parallelThreshold);
+        return std::equal(items.begin(), items.end(), expected.begin(), expected.end(),
+            [](const RadixSortItem& a, const RadixSortItem& b) { return a.Key == b.Key && a.Value == b.Value; });
+    }
+}
+
+TEST(RadixSort, MatchesStableSort)
+{
+    std::mt19937_64 random(3);
+    bool matches = true;
+
+    // Few distinct keys for many ties, keys that only differ in the low or high bytes, full 64-bit keys
+    const uint64 keyMasks[] = { 0x7ull, 0xFFFFull, 0xFF00000000000000ull, 0x8000'0000'0000'00FFull, ~0ull };
+    for (uint64 keyMask : keyMasks)
+    {
+        for (size_t count : { size_t(1), size_t(2), size_t(255), size_t(1000), size_t(70000) })
+        {
+            const Vector<RadixSortItem> input = MakeItems(count, random, keyMask);
+            matches &= MatchesStableSort(input, 65536);
+            // Chunked histograms and scatter, on machines with more than one worker
+            matches &= MatchesStableSort(input, 1);
+        }
+    }
+    CHECK(matches);
+
+    // Already sorted and reversed
+    Vector<RadixSortItem> ascending(5000);
+    for (uint32 i = 0; i < ascending.size(); ++i)
+        ascending[i] = RadixSortItem{ uint64(i) << 20, i };
+    Vector<RadixSortItem> descending(ascending.rbegin(), ascending.rend());
+    CHECK(MatchesStableSort(ascending, 65536));
+    CHECK(MatchesStableSort(descending, 1));
+}
+
+TEST(RadixSort, EmptyAndEqualKeys)
+{
+    Vector<RadixSortItem> items;
+    Vector<RadixSortItem> scratch(4);
+    RadixSort(items, scratch);
+    CHECK(items.empty() && scratch.empty());
+
+    // Every pass is skipped and the order is kept
+    items.resize(100000);
+    for (uint32 i = 0; i < items.size(); ++i)
+        items[i] = RadixSortItem{ 0xDEADBEEF'CAFEF00Dull, i };
+    RadixSort(items, scratch, 1);
+    bool kept = scratch.size() == items.size();
+    for (uint32 i = 0; i < items.size(); ++i)
+        kept &= items[i].Key == 0xDEADBEEF'CAFEF00Dull && items[i].Value == i;
+    CHECK(kept);
+
+    // The extremes of the key range
+    items = { { ~0ull, 0 }, { 0, 1 }, { 1ull << 63, 2 }, { ~0ull, 3 }, { 0, 4 } };
+    RadixSort(items, scratch);
+    CHECK(items[0].Value == 1 && items[1].Value == 4 && items[2].Value == 2 && items[3].Value == 0 && items[4].Value == 3);
+}
@@ -0,0 +1,193 @@
+#include "TestFramework.h"
+
+#include <cfloat>
+#include <random>
+
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/StaticBatching.h"
+
+namespace
+{
+    Aabb GetWorldBounds(const StaticMeshInstance& instance)
+    {
+        const float3x4 world = ComposeAffine(instance.Transform);
+        Aabb bounds{ { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+        for (const MeshVertex& vertex : instance.Mesh->GetVertices())
+        {
+            const float3 position = world * float4{ vertex.Position.x, vertex.Position.y, vertex.Position.z, 1.0f };
+            bounds = Union(bounds, Aabb{ position, position });
+        }
+        return bounds;
+    }
+
+    bool IsNear(const float3& a, const float3& b)
+    {
+        return std::abs(a.x - b.x) < 1e-4f && std::abs(a.y - b.y) < 1e-4f && std::abs(a.z - b.z) < 1e-4f;
+    }
+
+    // Side of the face normals against the vertex normals: 1 when every triangle agrees on front, -1 when every one
+    // agrees on back, 0 when they disagree. Degenerate triangles at the sphere poles are skipped
+    int32 GetWindingSide(const MeshTemplate& mesh)
+    {
+        const Vector<uint32> indices = mesh.CopyIndices();
+        const Vector<MeshVertex>& vertices = mesh.GetVertices();
+        uint32 front = 0, back = 0;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3)
+        {
+            const MeshVertex& a = vertices[indices[i]];
+            const MeshVertex& b = vertices[indices[i + 1]];
+            const MeshVertex& c = vertices[indices[i + 2]];
+            const float3 face = Cross(b.Position - a.Position, c.Position - a.Position);
+            if (Dot(face, face) < 1e-12f)
+                continue;
+            const float side = Dot(face, a.Normal + b.Normal + c.Normal);
+            front += side > 0.0f;
+            back += side < 0.0f;
+        }
+        return back == 0 && front > 0 ? 1 : front == 0 && back > 0 ? -1 : 0;
+    }
+}
+
+TEST(StaticBatching, MergedBounds)
+{
+    const MeshTemplate cube = CreateCubeMesh(1.0f);
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 8, 8);
+
+    // Random instances in one cell away from the cell borders, the batch bounds must be the union of their world bounds
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    Vector<StaticMeshInstance> instances(50);
+    Aabb expected{ { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+    for (uint32 i = 0; i < instances.size(); ++i)
+    {
+        StaticMeshInstance& instance = instances[i];
+        instance.Mesh = i % 2 ? &cube : &sphere;
+        instance.Transform.Translation = float3{ 20.0f, 20.0f, 20.0f } + float3{ unit(random), unit(random), unit(random) } * 10.0f;
+        instance.Transform.Rotation = QuaternionFromEuler(float3{ unit(random), unit(random), unit(random) } * 3.0f);
+        instance.Transform.Scale = float3{ 1.5f + unit(random), 1.5f + unit(random), 1.5f + unit(random) };
+        expected = Union(expected, GetWorldBounds(instance));
+    }
+
+    Vector<StaticBatch> batches;
+    StaticBatchSettings settings;
+    settings.CellSize = 1000.0f;
+    const StaticBatchReport report = BuildStaticBatches(instances, batches, settings);
+
+    CHECK(batches.size() == 1 && report.Batches == 1);
+    CHECK(report.Instances == 50 && report.DrawsBefore == 50 && report.DrawsAfter == 1);
+    CHECK(batches[0].InstanceCount == 50);
+    CHECK(batches[0].Mesh.GetVertexCount() == 25 * (cube.GetVertexCount() + sphere.GetVertexCount()));
+    CHECK(batches[0].Mesh.GetIndexCount() == 25 * (cube.GetIndexCount() + sphere.GetIndexCount()));
+    CHECK(IsNear(batches[0].Bounds.Min, expected.Min) && IsNear(batches[0].Bounds.Max, expected.Max));
+    CHECK(report.SourceBytes > 0 && report.BatchedBytes > report.SourceBytes);
+
+    // Instances in separate cells get their own batch and bounds
+    settings.CellSize = 4.0f;
+    BuildStaticBatches(instances, batches, settings);
+    bool contained = true;
+    uint32 covered = 0;
+    for (const StaticBatch& batch : batches)
+    {
+        const Aabb& b = batch.Bounds;
+        contained &= b.Min.x <= b.Max.x && b.Min.y <= b.Max.y && b.Min.z <= b.Max.z;
+        contained &= b.Min.x >= expected.Min.x - 1e-4f && b.Max.x <= expected.Max.x + 1e-4f;
+        covered += batch.InstanceCount;
+    }
+    CHECK(batches.size() > 1 && contained && covered == 50);
+}
+
+TEST(StaticBatching, NegativeScaleKeepsWinding)
+{
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 8, 8);
+    const int32 side = GetWindingSide(sphere);
+    CHECK(side != 0);
+
+    // One, two and three mirrored axes, rotated, each in a cell of its own
+    const float3 scales[] = {
+        { 1.0f, 1.0f, 1.0f }, { -1.0f, 1.0f, 1.0f }, { 2.0f, -0.5f, 1.0f }, { -1.0f, -1.0f, 1.0f }, { -1.0f, -2.0f, -1.0f } };
+    Vector<StaticMeshInstance> instances;
+    for (uint32 i = 0; i < std::size(scales); ++i)
+    {
+        StaticMeshInstance& instance = instances.emplace_back();
+        instance.Mesh = &sphere;
+        instance.Transform.Translation = float3{ 100.0f * float(i), 0.0f, 0.0f };
+        instance.Transform.Rotation = QuaternionFromEuler(float3{ 0.3f * float(i), 1.1f, -0.7f });
+        instance.Transform.Scale = scales[i];
+    }
+
+    Vector<StaticBatch> batches;
+    BuildStaticBatches(instances, batches);
+    CHECK(batches.size() == std::size(scales));
+
+    bool kept = true;
+    for (const StaticBatch& batch : batches)
+        kept &= GetWindingSide(batch.Mesh) == side;
+    CHECK(kept);
+}
+
+TEST(StaticBatching, SplitsInto16BitChunks)
+{
+    // 100 spheres of 65 * 65 vertices in one cell, 15 of them fit under the 16-bit limit
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 64, 64);
+    Vector<StaticMeshInstance> instances(100);
+    for (uint32 i = 0; i < instances.size(); ++i)
+    {
+        instances[i].Mesh = &sphere;
+        instances[i].Transform.Translation = float3{ float(i % 10), float(i / 10), 0.0f } * 0.5f;
+    }
+
+    Vector<StaticBatch> batches;
+    StaticBatchSettings settings;
+    settings.CellSize = 100.0f;
+    BuildStaticBatches(instances, batches, settings);
+
+    const uint32 perBatch = s_MaxVerticesPer16BitIndex / static_cast<uint32>(sphere.GetVertexCount());
+    bool fits = true;
+    size_t vertices = 0, indices = 0;
+    uint32 covered = 0;
+    for (const StaticBatch& batch : batches)
+    {
+        fits &= batch.Mesh.GetVertexCount() <= s_MaxVerticesPer16BitIndex;
+        fits &= batch.Mesh.GetIndexFormat() == IndexFormat::UInt16 && batch.Mesh.GetSubmeshes().empty();
+        fits &= batch.InstanceCount <= perBatch;
+        vertices += batch.Mesh.GetVertexCount();
+        indices += batch.Mesh.GetIndexCount();
+        covered += batch.InstanceCount;
+    }
+    CHECK(fits);
+    CHECK(batches.size() == (instances.size() + perBatch - 1) / perBatch);
+    CHECK(covered == 100 && vertices == 100 * sphere.GetVertexCount() && indices == 100 * sphere.GetIndexCount());
+
+    // A lower cap splits earlier
+    settings.MaxBatchVertices = static_cast<uint32>(sphere.GetVertexCount()) * 3;
+    BuildStaticBatches(instances, batches, settings);
+    CHECK(batches.size() == 34);
+
+    bool threw = false;
+    try
+    {
+        settings.CellSize = 0.0f;
+        BuildStaticBatches(instances, batches, settings);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(StaticBatching, Benchmark)
+{
+    // The MeshTest layout at the cell sizes of the original measurement, plus the dense sphere
+    const std::pair<uint32, float> scenes[] = { { 16, 5.0f }, { 16, 10.0f }, { 16, 25.0f }, { 64, 10.0f } };
+    bool fewerDraws = true;
+    for (const auto& [segments, cellSize] : scenes)
+    {
+        const StaticBatchReport report = RunStaticBatchingBenchmark(segments, cellSize);
+        printf("    %ux%u spheres, cell %.0f: %u -> %u draws, %.2f MB -> %.2f MB, %.1f ms\n", segments, segments, cellSize,
+            report.DrawsBefore, report.DrawsAfter, report.SourceBytes / double(1 << 20), report.BatchedBytes / double(1 << 20),
+            report.BuildMilliseconds);
+        fewerDraws &= report.DrawsAfter < report.DrawsBefore && report.Instances == report.DrawsBefore;
+    }
+    CHECK(fewerDraws);
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstdio>
+
+#include "Engine/BaseTypes.h"
+
+// Minimal test registry for the ThorTests executable. TEST(Suite, Name) defines a test case, CHECK records a failure
+// with its location and lets the case continue
+namespace Test
+{
+    struct Case
+    {
+        const char* Suite = "";
+        const char* Name = "";
+        void (*Func)() = nullptr;
+    };
+
+    Vector<Case>& GetCases();
+    void ReportFailure(const char* file, int line, const char* expression);
+
+    struct Registrar
+    {
+        Registrar(const char* suite, const char* name, void (*func)()) { GetCases().push_back(Case{ suite, name, func }); }
+    };
+}
+
+#define TEST(suite, name) \
+    static void suite##_##name(); \
+    static const Test::Registrar s_##suite##_##name##_Registrar(#suite, #name, suite##_##name); \
+    static void suite##_##name()
+
+#define CHECK(expression) \
+    do { if (!(expression)) Test::ReportFailure(__FILE__, __LINE__, #expression); } while (false)
@@ -0,0 +1,58 @@
+#include "TestFramework.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+    uint32 s_FailureCount = 0;
+}
+
+Vector<Test::Case>& Test::GetCases()
+{
+    static Vector<Case> s_Cases;
+    return s_Cases;
+}
+
+void Test::ReportFailure(const char* file, int line, const char* expression)
+{
+    printf("    %s(%d): CHECK(%s) failed\n", file, line, expression);
+    ++s_FailureCount;
+}
+
+// Runs every test, or only the suites named on the command line. Returns the number of failed tests
+int main(int argc, char** argv)
+{
+    uint32 failedCases = 0;
+    uint32 runCases = 0;
+    for (const Test::Case& testCase : Test::GetCases())
+    {
+        bool selected = argc <= 1;
+        for (int i = 1; i < argc; ++i)
+            selected |= strcmp(argv[i], testCase.Suite) == 0;
+        if (!selected)
+            continue;
+
+        const uint32 failuresBefore = s_FailureCount;
+        const auto start = std::chrono::steady_clock::now();
+        printf("[ RUN  ] %s.%s\n", testCase.Suite, testCase.Name);
+        try
+        {
+            testCase.Func();
+        }
+        catch (const std::exception& e)
+        {
+            printf("    Unexpected exception: %s\n", e.what());
+            ++s_FailureCount;
+        }
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        const bool passed = s_FailureCount == failuresBefore;
+        printf("[ %s ] %s.%s (%.0f ms)\n", passed ? " OK " : "FAIL", testCase.Suite, testCase.Name, milliseconds);
+        failedCases += passed ? 0 : 1;
+        ++runCases;
+    }
+
+    printf("%u of %u tests passed\n", runCases - failedCases, runCases);
+    return static_cast<int>(failedCases);
+}
@@ -0,0 +1,128 @@
+#include "TestFramework.h"
+
+#include <map>
+#include <random>
+
+#include "Engine/TlsfAllocator.h"
+
+namespace
+{
+    struct Live
+    {
+        uint64 Size;
+        uint32 Handle;
+    };
+
+    // The reference is an interval map of the live allocations keyed by offset, a new one must not touch its neighbours
+    bool OverlapsLive(const std::map<uint64, Live>& live, uint64 offset, uint64 size)
+    {
+        const auto next = live.lower_bound(offset);
+        if (next != live.end() && next->first < offset + size)
+            return true;
+        if (next != live.begin())
+        {
+            const auto previous = std::prev(next);
+            if (previous->first + previous->second.Size > offset)
+                return true;
+        }
+        return false;
+    }
+}
+
+TEST(TlsfAllocator, MatchesReferenceIntervalMap)
+{
+    uint32 errors = 0;
+    uint64 failedAllocations = 0;
+    for (uint32 seed = 1; seed <= 20; ++seed)
+    {
+        std::mt19937 random(seed);
+        // Odd capacities and both 64 KB and 1000 byte granularity
+        const uint64 capacity = (random() % 1000 + 1) * (seed % 2 ? 65536ull : 1000ull) + seed;
+        TlsfAllocator allocator(capacity);
+        std::map<uint64, Live> live;
+        uint64 used = 0;
+
+        for (uint32 operation = 0; operation < 200000; ++operation)
+        {
+            if (live.empty() || random() % 2)
+            {
+                // Mostly small requests, an eighth up to the whole capacity
+                const uint64 size = 1 + random() % (random() % 8 == 0 ? capacity : 5000);
+                const uint64 alignment = 1ull << (random() % 17);
+                const TlsfAllocation allocation = allocator.Allocate(size, alignment);
+                if (!allocation.IsValid())
+                {
+                    ++failedAllocations;
+                    continue;
+                }
+
+                errors += allocation.Offset % alignment != 0;
+                errors += allocation.Offset + size > capacity;
+                errors += OverlapsLive(live, allocation.Offset, size);
+                errors += allocator.GetAllocationSize(allocation.Handle) != size;
+                live[allocation.Offset] = Live{ size, allocation.Handle };
+                used += size;
+            }
+            else
+            {
+                auto it = live.begin();
+                std::advance(it, random() % std::min<size_t>(live.size(), 64));
+                allocator.Free(it->second.Handle);
+                used -= it->second.Size;
+                live.erase(it);
+            }
+            errors += allocator.GetUsedBytes() != used;
+
+            if (operation % 997 == 0)
+            {
+                const TlsfStats stats = allocator.GetStats();
+                errors += stats.FreeBytes != capacity - used || stats.AllocationCount != live.size();
+                errors += stats.LargestFreeBlock > stats.FreeBytes;
+
+                // The largest free block must really be allocatable
+                if (stats.LargestFreeBlock)
+                {
+                    const TlsfAllocation largest = allocator.Allocate(stats.LargestFreeBlock, 1);
+                    errors += !largest.IsValid();
+                    if (largest.IsValid())
+                        allocator.Free(largest.Handle);
+                }
+            }
+        }
+
+        // Everything merges back into a single block
+        for (const auto& [offset, allocation] : live)
+            allocator.Free(allocation.Handle);
+        const TlsfStats stats = allocator.GetStats();
+        errors += stats.FreeBlockCount != 1 || stats.LargestFreeBlock != capacity || !allocator.IsEmpty();
+
+        const TlsfAllocation whole = allocator.Allocate(capacity, 1);
+        errors += !whole.IsValid() || whole.Offset != 0;
+
+        // Double free
+        allocator.Free(whole.Handle);
+        try
+        {
+            allocator.Free(whole.Handle);
+            ++errors;
+        }
+        catch (const std::invalid_argument&)
+        {
+        }
+    }
+    printf("    %llu failed allocations\n", static_cast<unsigned long long>(failedAllocations));
+    CHECK(errors == 0);
+
+    // A default constructed allocator has nothing to hand out
+    TlsfAllocator empty;
+    CHECK(!empty.Allocate(1).IsValid() && empty.IsEmpty() && empty.GetStats().LargestFreeBlock == 0);
+}
+
+TEST(TlsfAllocator, Benchmark)
+{
+    const TlsfBenchmarkReport report = RunTlsfBenchmark(200000);
+    printf("    allocate %.1f ns mean, free %.1f ns mean, peak fragmentation %.3f\n", report.MeanAllocateNanoseconds,
+        report.MeanFreeNanoseconds, report.PeakFragmentation);
+    CHECK(report.Allocations + report.Frees == 200000);
+    CHECK(report.FailedAllocations == 0);
+}
@@ -0,0 +1,212 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <random>
+
+#include "Engine/Transform.h"
+
+namespace
+{
+    constexpr uint32 s_TransformCount = 10000;
+
+    float3x3 Multiply(const float3x3& a, const float3x3& b)
+    {
+        float3x3 result{};
+        for (uint32 i = 0; i < 3; ++i)
+            for (uint32 j = 0; j < 3; ++j)
+                for (uint32 k = 0; k < 3; ++k)
+                    result.m[i][j] += a.m[i][k] * b.m[k][j];
+        return result;
+    }
+
+    // Row-vector rotations, composed like XMMatrixRotationRollPitchYaw
+    float3x3 RotationX(double a) { const float c = float(std::cos(a)), s = float(std::sin(a)); return float3x3{ 1, 0, 0, 0, c, s, 0, -s, c }; }
+    float3x3 RotationY(double a) { const float c = float(std::cos(a)), s = float(std::sin(a)); return float3x3{ c, 0, -s, 0, 1, 0, s, 0, c }; }
+    float3x3 RotationZ(double a) { const float c = float(std::cos(a)), s = float(std::sin(a)); return float3x3{ c, s, 0, -s, c, 0, 0, 0, 1 }; }
+
+    float3x3 RollPitchYaw(const float3& euler)
+    {
+        return Multiply(Multiply(RotationZ(euler.z), RotationX(euler.x)), RotationY(euler.y));
+    }
+
+    // General 3x3 inverse by cofactors, in double
+    float3x3 Inverse(const float3x3& m)
+    {
+        const double det = double(m._11) * (double(m._22) * m._33 - double(m._23) * m._32)
+            - double(m._12) * (double(m._21) * m._33 - double(m._23) * m._31)
+            + double(m._13) * (double(m._21) * m._32 - double(m._22) * m._31);
+        return float3x3{
+            float((double(m._22) * m._33 - double(m._23) * m._32) / det),
+            float((double(m._13) * m._32 - double(m._12) * m._33) / det),
+            float((double(m._12) * m._23 - double(m._13) * m._22) / det),
+            float((double(m._23) * m._31 - double(m._21) * m._33) / det),
+            float((double(m._11) * m._33 - double(m._13) * m._31) / det),
+            float((double(m._13) * m._21 - double(m._11) * m._23) / det),
+            float((double(m._21) * m._32 - double(m._22) * m._31) / det),
+            float((double(m._12) * m._31 - double(m._11) * m._32) / det),
+            float((double(m._11) * m._22 - double(m._12) * m._21) / det)
+        };
+    }
+
+    float3 RowMultiply(const float3& v, const float3x3& m)
+    {
+        return float3{
+            v.x * m._11 + v.y * m._21 + v.z * m._31,
+            v.x * m._12 + v.y * m._22 + v.z * m._32,
+            v.x * m._13 + v.y * m._23 + v.z * m._33
+        };
+    }
+
+    struct RandomTransforms
+    {
+        Vector<float3> Eulers;
+        Vector<Transform> Transforms;
+    };
+
+    RandomTransforms MakeRandomTransforms(uint32 seed)
+    {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> scale(0.2f, 3.0f);
+
+        RandomTransforms result;
+        for (uint32 i = 0; i < s_TransformCount; ++i)
+        {
+            const float3 euler{ value(random), value(random), value(random) };
+            Transform transform;
+            transform.Translation = float3{ value(random), value(random), value(random) };
+            transform.Rotation = QuaternionFromEuler(euler);
+            transform.Scale = float3{ scale(random), scale(random), scale(random) };
+            result.Eulers.push_back(euler);
+            result.Transforms.push_back(transform);
+        }
+        return result;
+    }
+}
+
+TEST(Transform, ComposeMatchesMatrixProduct)
+{
+    const RandomTransforms random = MakeRandomTransforms(3);
+    double worldError = 0.0;
+    double normalError = 0.0;
+    for (uint32 i = 0; i < s_TransformCount; ++i)
+    {
+        const Transform& transform = random.Transforms[i];
+        float4x4 world, normal;
+        ComposeTransform(transform, world, normal);
+
+        // World is (S * R) with the translation row, stored transposed. Normal is (S * R)^-1
+        const float3x3 rotation = RollPitchYaw(random.Eulers[i]);
+        float3x3 scaledRotation;
+        for (uint32 r = 0; r < 3; ++r)
+            for (uint32 c = 0; c < 3; ++c)
+                scaledRotation.m[r][c] = (&transform.Scale.x)[r] * rotation.m[r][c];
+        const float3x3 inverse = Inverse(scaledRotation);
+
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            for (uint32 c = 0; c < 3; ++c)
+            {
+                worldError = std::max(worldError, double(std::fabs(world.m[c][r] - scaledRotation.m[r][c])));
+                normalError = std::max(normalError, std::fabs(normal.m[r][c] - inverse.m[r][c]) / (1.0 + std::fabs(inverse.m[r][c])));
+            }
+            worldError = std::max(worldError, double(std::fabs(world.m[r][3] - (&transform.Translation.x)[r])));
+        }
+        CHECK(world._41 == 0.0f && world._42 == 0.0f && world._43 == 0.0f && world._44 == 1.0f);
+    }
+    printf("    world %.2g, normal %.2g (relative)\n", worldError, normalError);
+    CHECK(worldError < 1e-5);
+    CHECK(normalError < 1e-5);
+}
+
+TEST(Transform, BatchMatchesSingle)
+{
+    const RandomTransforms random = MakeRandomTransforms(4);
+    Vector<float4x4> worlds(s_TransformCount), normals(s_TransformCount);
+    ComposeTransforms(random.Transforms, worlds, normals);
+
+    bool equal = true;
+    for (uint32 i = 0; i < s_TransformCount; ++i)
+    {
+        float4x4 world, normal;
+        ComposeTransform(random.Transforms[i], world, normal);
+        equal &= memcmp(&world, &worlds[i], sizeof(float4x4)) == 0 && memcmp(&normal, &normals[i], sizeof(float4x4)) == 0;
+
+        const float3x4 affine = ComposeAffine(random.Transforms[i]);
+        const float3x3 normal3 = ComputeNormalMatrix(random.Transforms[i]);
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            for (uint32 c = 0; c < 3; ++c)
+                equal &= affine.m[r][c] == world.m[r][c] && normal3.m[r][c] == normal.m[r][c];
+            equal &= affine.m[r][3] == world.m[r][3];
+        }
+    }
+    CHECK(equal);
+
+    bool threw = false;
+    try
+    {
+        ComposeTransforms(random.Transforms, Span<float4x4>(worlds).first(1), normals);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(Transform, QuaternionOperations)
+{
+    const RandomTransforms random = MakeRandomTransforms(5);
+    std::mt19937 generator(6);
+    std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+
+    // Yaw and roll lose precision within a few milliradians of the gimbal poles
+    double eulerError = 0.0;
+    double poleEulerError = 0.0;
+    double rotateError = 0.0;
+    for (uint32 i = 0; i < s_TransformCount; ++i)
+    {
+        const float4& q = random.Transforms[i].Rotation;
+        const float3x3 rotation = RollPitchYaw(random.Eulers[i]);
+
+        // Euler round trip gives the same rotation, the angles may differ
+        const float3 euler = QuaternionToEuler(q);
+        const float3x3 back = RollPitchYaw(euler);
+        const float3x3 matrix = QuaternionToMatrix(q);
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            for (uint32 c = 0; c < 3; ++c)
+            {
+                const double error = std::fabs(back.m[r][c] - rotation.m[r][c]);
+                double& maxError = std::cos(euler.x) > 0.01f ? eulerError : poleEulerError;
+                maxError = std::max(maxError, error);
+                rotateError = std::max(rotateError, double(std::fabs(matrix.m[r][c] - rotation.m[r][c])));
+            }
+        }
+
+        const float3 v{ value(generator), value(generator), value(generator) };
+        rotateError = std::max(rotateError, double(Length(QuaternionRotate(q, v) - RowMultiply(v, rotation))) / 10.0);
+
+        // Multiply applies its first argument first
+        const float4 second = QuaternionFromEuler(float3{ value(generator), value(generator), value(generator) });
+        const float3 sequential = QuaternionRotate(second, QuaternionRotate(q, v));
+        rotateError = std::max(rotateError, double(Length(QuaternionRotate(QuaternionMultiply(q, second), v) - sequential)) / 10.0);
+
+        const float4 axisAngle = QuaternionFromAxisAngle(float3{ 0.0f, 0.0f, 2.0f }, random.Eulers[i].z);
+        const float3x3 rollOnly = RotationZ(random.Eulers[i].z);
+        rotateError = std::max(rotateError, double(Length(QuaternionRotate(axisAngle, v) - RowMultiply(v, rollOnly))) / 10.0);
+    }
+    printf("    euler round trip %.2g (%.2g near the poles), rotation %.2g\n", eulerError, poleEulerError, rotateError);
+    CHECK(eulerError < 5e-5);
+    CHECK(poleEulerError < 1e-3);
+    CHECK(rotateError < 1e-5);
+}
+
+TEST(Transform, Benchmark)
+{
+    const TransformBenchmarkReport report = RunTransformBenchmark(10000, 20);
+    printf("    matrix %.1f M/s, composed %.1f M/s (%.2fx)\n", report.MatrixTransformsPerSecond * 1e-6,
+        report.ComposedTransformsPerSecond * 1e-6, report.Speedup);
+    CHECK(report.MatrixTransformsPerSecond > 0.0 && report.ComposedTransformsPerSecond > 0.0);
+}
@@ -0,0 +1,220 @@
+#include "TestFramework.h"
+
+#include <algorithm>
+#include <random>
+
+#include "Engine/CpuFeatures.h"
+#include "Graphics/HelperFunctions.h"
+#include "Graphics/TriangleBvh.h"
+
+namespace
+{
+    struct Soup
+    {
+        Vector<MeshVertex> Vertices;
+        Vector<uint32> Indices;
+    };
+
+    // Small random triangles in a box, plus a sphere so rays see both overlapping and closed geometry
+    Soup MakeSoup(std::mt19937& random, uint32 triangleCount)
+    {
+        Soup soup;
+        std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        for (uint32 t = 0; t < triangleCount; ++t)
+        {
+            const float3 center{ position(random), position(random), position(random) };
+            for (uint32 corner = 0; corner < 3; ++corner)
+            {
+                MeshVertex vertex;
+                vertex.Position = center + float3{ offset(random), offset(random), offset(random) };
+                soup.Indices.push_back(static_cast<uint32>(soup.Vertices.size()));
+                soup.Vertices.push_back(vertex);
+            }
+        }
+
+        const MeshTemplate sphere = CreateSphereMesh(4.0f, 24, 24);
+        const uint32 first = static_cast<uint32>(soup.Vertices.size());
+        soup.Vertices.insert(soup.Vertices.end(), sphere.GetVertices().begin(), sphere.GetVertices().end());
+        for (uint32 index : sphere.CopyIndices())
+            soup.Indices.push_back(first + index);
+        return soup;
+    }
+
+    struct ReferenceHit
+    {
+        BvhHit Hit;
+        float EdgeMargin = 1.0f;     // Smallest barycentric weight of the hit, near 0 float rounding can flip it
+    };
+
+    // Double-sided Moller-Trumbore against one triangle
+    ReferenceHit IntersectTriangle(const Soup& soup, uint32 t, const BvhRay& ray)
+    {
+        const float3 v0 = soup.Vertices[soup.Indices[t * 3]].Position;
+        const float3 edge1 = soup.Vertices[soup.Indices[t * 3 + 1]].Position - v0;
+        const float3 edge2 = soup.Vertices[soup.Indices[t * 3 + 2]].Position - v0;
+        const float3 p = Cross(ray.Direction, edge2);
+        const float det = Dot(edge1, p);
+        if (det == 0.0f)
+            return {};
+        const float3 s = ray.Origin - v0;
+        const float u = Dot(s, p) / det;
+        const float3 q = Cross(s, edge1);
+        const float v = Dot(ray.Direction, q) / det;
+        const float distance = Dot(edge2, q) / det;
+        if (u < 0.0f || v < 0.0f || u + v > 1.0f || distance < 0.0f || distance >= ray.MaxDistance)
+            return {};
+        return ReferenceHit{ BvhHit{ distance, t, u, v }, std::min({ u, v, 1.0f - u - v }) };
+    }
+
+    ReferenceHit IntersectBruteForce(const Soup& soup, const BvhRay& ray)
+    {
+        ReferenceHit closest;
+        for (uint32 t = 0; t < soup.Indices.size() / 3; ++t)
+        {
+            const ReferenceHit hit = IntersectTriangle(soup, t, ray);
+            if (hit.Hit.Distance < closest.Hit.Distance)
+                closest = hit;
+        }
+        return closest;
+    }
+
+    // A miss on both, or the same closest distance with a triangle that really is hit there. Overlapping triangles
+    // may report either one, and rays grazing an edge may hit or miss
+    bool Agrees(const Soup& soup, const BvhRay& ray, const BvhHit& hit, const ReferenceHit& reference)
+    {
+        if (hit.IsHit() != reference.Hit.IsHit())
+            return reference.EdgeMargin < 1e-4f || std::min({ hit.U, hit.V, 1.0f - hit.U - hit.V }) < 1e-4f;
+        if (!hit.IsHit())
+            return true;
+
+        const float tolerance = 1e-4f * std::max(1.0f, reference.Hit.Distance);
+        const ReferenceHit reported = IntersectTriangle(soup, hit.Triangle, ray);
+        return std::abs(hit.Distance - reference.Hit.Distance) <= tolerance
+            && reported.Hit.IsHit() && std::abs(hit.Distance - reported.Hit.Distance) <= tolerance;
+    }
+
+    Vector<BvhRay> MakeRays(std::mt19937& random, uint32 count)
+    {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        Vector<BvhRay> rays(count);
+        for (uint32 r = 0; r < count; ++r)
+        {
+            // Half the rays start outside and aim through the volume, the rest start inside in any direction. Every
+            // fourth ray is short, so the max distance clips hits
+            BvhRay& ray = rays[r];
+            ray.Origin = float3{ unit(random), unit(random), unit(random) } * (r % 2 ? 25.0f : 8.0f);
+            ray.Direction = r % 2 ? float3{ unit(random), unit(random), unit(random) } * 5.0f - ray.Origin
+                                  : float3{ unit(random), unit(random), unit(random) };
+            if (r % 4 == 3)
+                ray.MaxDistance = 0.2f;
+        }
+        // An axis-aligned ray exercises the infinite inverse direction
+        rays[0] = BvhRay{ float3{ 0.3f, -0.2f, -30.0f }, float3{ 0.0f, 0.0f, 1.0f } };
+        return rays;
+    }
+
+    template<uint32 Width>
+    uint32 CountMismatches(const TriangleBvh<Width>& bvh, const Soup& soup, const Vector<BvhRay>& rays)
+    {
+        Vector<BvhHit> packetHits(rays.size());
+        bvh.IntersectPackets(rays, packetHits);
+
+        uint32 mismatches = 0;
+        for (size_t r = 0; r < rays.size(); ++r)
+        {
+            const ReferenceHit reference = IntersectBruteForce(soup, rays[r]);
+            const BvhHit hit = bvh.Intersect(rays[r]);
+            mismatches += !Agrees(soup, rays[r], hit, reference) || !Agrees(soup, rays[r], packetHits[r], reference);
+            mismatches += bvh.IsOccluded(rays[r]) != hit.IsHit();
+        }
+        return mismatches;
+    }
+}
+
+TEST(TriangleBvh, MatchesBruteForce)
+{
+    std::mt19937 random(21);
+    const Soup soup = MakeSoup(random, 3000);
+    const Vector<BvhRay> rays = MakeRays(random, 1003);
+
+    TriangleBvhSettings parallel;
+    parallel.ParallelThreshold = 512;
+    parallel.MaxLeafTriangles = 8;
+
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    uint32 mismatches = 0;
+    bool consistent = true;
+    for (const TriangleBvhSettings& settings : { TriangleBvhSettings{}, parallel })
+    {
+        const TriangleBvh4 bvh4(soup.Vertices, soup.Indices, settings);
+        const TriangleBvh8 bvh8(soup.Vertices, soup.Indices, settings);
+        consistent &= bvh4.GetTriangleCount() == soup.Indices.size() / 3 && bvh8.GetTriangleCount() == soup.Indices.size() / 3;
+        consistent &= bvh8.GetNodeCount() <= bvh4.GetNodeCount() && bvh8.GetDepth() <= bvh4.GetDepth();
+        for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2, SimdLevel::Avx512 })
+        {
+            SetMaxSimdLevel(level);
+            mismatches += CountMismatches(bvh4, soup, rays) + CountMismatches(bvh8, soup, rays);
+        }
+    }
+    SetMaxSimdLevel(previousCap);
+    CHECK(consistent);
+    CHECK(mismatches == 0);
+
+    // An empty tree misses everything
+    const TriangleBvh8 empty(Span<const MeshVertex>{}, Span<const uint32>{});
+    CHECK(!empty.Intersect(rays[0]).IsHit() && !empty.IsOccluded(rays[0]));
+}
+
+TEST(TriangleBvh, QueryOverlapMatchesBruteForce)
+{
+    std::mt19937 random(23);
+    const Soup soup = MakeSoup(random, 2000);
+    const TriangleBvh8 bvh(soup.Vertices, soup.Indices);
+
+    const float3 padding{ 1e-3f, 1e-3f, 1e-3f };
+    std::uniform_real_distribution<float> position(-12.0f, 12.0f);
+    std::uniform_real_distribution<float> size(0.1f, 6.0f);
+    bool matches = true;
+    for (uint32 query = 0; query < 100; ++query)
+    {
+        const float3 min{ position(random), position(random), position(random) };
+        const Aabb bounds{ min, min + float3{ size(random), size(random), size(random) } };
+        Vector<uint32> triangles;
+        bvh.QueryOverlap(bounds, triangles);
+        std::sort(triangles.begin(), triangles.end());
+        matches &= std::adjacent_find(triangles.begin(), triangles.end()) == triangles.end();
+
+        // Every triangle with a corner inside must be found, and every one found must touch a slightly larger box
+        const Aabb grown{ bounds.Min - padding, bounds.Max + padding };
+        for (uint32 t = 0; t < soup.Indices.size() / 3; ++t)
+        {
+            Aabb triangleBounds{ soup.Vertices[soup.Indices[t * 3]].Position, soup.Vertices[soup.Indices[t * 3]].Position };
+            bool cornerInside = false;
+            for (uint32 corner = 0; corner < 3; ++corner)
+            {
+                const float3& p = soup.Vertices[soup.Indices[t * 3 + corner]].Position;
+                triangleBounds = Union(triangleBounds, Aabb{ p, p });
+                cornerInside |= Contains(bounds, Aabb{ p, p });
+            }
+            const bool found = std::binary_search(triangles.begin(), triangles.end(), t);
+            matches &= !cornerInside || found;
+            matches &= !found || Overlaps(triangleBounds, grown);
+        }
+    }
+    CHECK(matches);
+}
+
+TEST(TriangleBvh, Benchmark)
+{
+    const MeshTemplate sphere = CreateSphereMesh(1.0f, 64, 64);
+    const TriangleBvhBenchmarkReport report = RunTriangleBvhBenchmark(sphere, 64);
+    printf("    %zu triangles: build %.2f / %.2f ms (BVH4 / BVH8), %.1f MTris/s, %zu / %zu bytes\n", report.TriangleCount,
+        report.Build4Milliseconds, report.Build8Milliseconds, report.BuildMTrianglesPerSecond, report.Memory4Bytes, report.Memory8Bytes);
+    printf("    single %.2f / %.2f MRays/s, packets %.2f / %.2f MRays/s, incoherent %.2f MRays/s, %.0f%% hits\n",
+        report.Trace4MRaysPerSecond, report.Trace8MRaysPerSecond, report.Packet4MRaysPerSecond, report.Packet8MRaysPerSecond,
+        report.IncoherentTrace8MRaysPerSecond, report.HitRatio * 100.0f);
+    CHECK(report.TriangleCount == sphere.GetIndexCount() / 3);
+    CHECK(report.HitRatio > 0.0f && report.HitRatio < 1.0f);
+    CHECK(report.Memory4Bytes > 0 && report.Memory8Bytes > 0);
+}
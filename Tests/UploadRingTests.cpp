@@ -0,0 +1,177 @@
+#include "TestFramework.h"
+
+#include <random>
+
+#include "Engine/UploadRing.h"
+
+namespace
+{
+    // Byte-level model of the ring: every byte remembers the fence of the frame that consumed it, padding included.
+    // An allocation consumes bytes from the head, first up to the aligned offset or the end of the ring, and only
+    // succeeds when none of them is still in flight
+    class ReferenceRing
+    {
+    public:
+        static constexpr uint64 s_Free = ~0ull;
+        static constexpr uint64 s_Open = ~0ull - 1;    // Consumed by the frame being recorded
+
+        explicit ReferenceRing(uint64 capacity) : m_Owners(capacity, s_Free) {}
+
+        uint64 Allocate(uint64 size, uint64 alignment)
+        {
+            const uint64 capacity = m_Owners.size();
+            const uint64 aligned = AlignUp(m_Head, alignment);
+            const uint64 start = aligned + size > capacity ? 0 : aligned;
+            const uint64 padding = start == 0 && m_Head != 0 ? capacity - m_Head : start - m_Head;
+            if (padding + size > capacity)
+                return UploadRing::s_InvalidOffset;
+
+            for (uint64 i = 0; i < padding + size; ++i)
+            {
+                if (m_Owners[(m_Head + i) % capacity] != s_Free)
+                    return UploadRing::s_InvalidOffset;
+            }
+            for (uint64 i = 0; i < padding + size; ++i)
+                m_Owners[(m_Head + i) % capacity] = s_Open;
+            m_Head = (start + size) % capacity;
+            return start;
+        }
+
+        void FinishFrame(uint64 fenceValue)
+        {
+            std::replace(m_Owners.begin(), m_Owners.end(), s_Open, fenceValue);
+        }
+
+        void Reclaim(uint64 completedFenceValue)
+        {
+            for (uint64& owner : m_Owners)
+            {
+                if (owner != s_Open && owner <= completedFenceValue)
+                    owner = s_Free;
+            }
+        }
+
+        uint64 GetUsedBytes() const
+        {
+            return static_cast<uint64>(std::count_if(m_Owners.begin(), m_Owners.end(), [](uint64 owner) { return owner != s_Free; }));
+        }
+
+    private:
+        Vector<uint64> m_Owners;
+        uint64 m_Head = 0;
+    };
+
+    bool Overlaps(uint64 a, uint64 aSize, uint64 b, uint64 bSize)
+    {
+        return a < b + bSize && b < a + aSize;
+    }
+}
+
+TEST(UploadRing, MatchesReferenceModel)
+{
+    std::mt19937 random(7);
+    uint32 mismatches = 0;
+    uint32 overlaps = 0;
+    uint64 allocations = 0;
+    for (uint32 configuration = 0; configuration < 200; ++configuration)
+    {
+        const uint64 capacity = 256 * (1 + random() % 64);
+        const uint32 maxSize = 1 + random() % 1024;
+        const uint32 framesInFlight = random() % 4;
+        UploadRing ring(capacity);
+        ReferenceRing reference(capacity);
+
+        struct Live
+        {
+            uint64 Offset;
+            uint64 Size;
+            uint64 FenceValue;
+        };
+        Vector<Live> live;
+        uint64 fenceValue = 0;
+        for (uint32 frame = 0; frame < 300; ++frame)
+        {
+            const uint32 count = random() % 8;
+            for (uint32 a = 0; a < count; ++a)
+            {
+                const uint64 alignment = 1ull << (random() % 9);
+                const uint64 size = 1 + random() % maxSize;
+                const uint64 offset = ring.Allocate(size, alignment);
+                mismatches += offset != reference.Allocate(size, alignment);
+                if (offset == UploadRing::s_InvalidOffset)
+                    continue;
+
+                ++allocations;
+                mismatches += offset % alignment != 0 || offset + size > capacity;
+                for (const Live& other : live)
+                    overlaps += Overlaps(offset, size, other.Offset, other.Size);
+                live.push_back(Live{ offset, size, ~0ull });
+            }
+
+            ++fenceValue;
+            for (Live& allocation : live)
+                allocation.FenceValue = std::min(allocation.FenceValue, fenceValue);
+            ring.FinishFrame(fenceValue);
+            reference.FinishFrame(fenceValue);
+
+            // The fake GPU trails by framesInFlight frames
+            const uint64 completed = fenceValue > framesInFlight ? fenceValue - framesInFlight : 0;
+            ring.Reclaim(completed);
+            reference.Reclaim(completed);
+            std::erase_if(live, [&](const Live& allocation) { return allocation.FenceValue <= completed; });
+
+            mismatches += ring.GetUsedBytes() != reference.GetUsedBytes();
+        }
+
+        ring.Reclaim(fenceValue);
+        mismatches += ring.GetUsedBytes() != 0 || ring.GetPendingFrameCount() != 0;
+    }
+    printf("    %llu allocations\n", static_cast<unsigned long long>(allocations));
+    CHECK(mismatches == 0);
+    CHECK(overlaps == 0);
+}
+
+TEST(UploadRing, InvalidRequests)
+{
+    UploadRing empty;
+    CHECK(empty.Allocate(16, 16) == UploadRing::s_InvalidOffset);
+    CHECK(empty.Allocate(0, 1) == UploadRing::s_InvalidOffset);
+
+    UploadRing ring(1024);
+    CHECK(ring.Allocate(0, 16) == UploadRing::s_InvalidOffset);
+    CHECK(ring.Allocate(1025, 1) == UploadRing::s_InvalidOffset);
+    CHECK(ring.Allocate(1024, 256) == 0);
+    CHECK(ring.Allocate(1, 1) == UploadRing::s_InvalidOffset);
+
+    ring.FinishFrame(2);
+    bool threw = false;
+    try
+    {
+        ring.FinishFrame(1);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+
+    threw = false;
+    try
+    {
+        UploadRing zero(0);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(UploadRing, Benchmark)
+{
+    const UploadRingBenchmarkReport report = RunUploadRingBenchmark(100, 10000, 2);
+    printf("    %.0f M allocations/s, %.2f GB/s with copy, %u stalls\n", report.AllocationsPerSecond * 1e-6,
+        report.UploadGigabytesPerSecond, report.Stalls);
+    CHECK(report.Allocations == 100 * 10000);
+    CHECK(report.Stalls == 0);
+}
@@ -0,0 +1,274 @@
+#include "TestFramework.h"
+
+#include <cstring>
+#include <map>
+#include <random>
+
+#include "Engine/UploadScheduler.h"
+
+namespace
+{
+    // Applies the copies to CPU-side destination buffers, keyed by UploadDestination::Resource
+    class Recorder : public UploadCommandRecorder
+    {
+    public:
+        struct Copy
+        {
+            void* Resource;
+            uint64 DestinationOffset;
+            uint64 StagingOffset;
+            uint64 Size;
+        };
+
+        Recorder(const Vector<uint8>& staging, std::map<void*, Vector<uint8>>& destinations)
+            : m_Staging(staging), m_Destinations(destinations)
+        {
+        }
+
+        void CopyBuffer(const UploadDestination& destination, uint64 destinationOffset, uint64 stagingOffset, uint64 size) final
+        {
+            Vector<uint8>& target = m_Destinations[destination.Resource];
+            if (stagingOffset + size > m_Staging.size() || destinationOffset + size > target.size())
+                throw std::out_of_range("Copy outside the staging or destination buffer");
+
+            memcpy(target.data() + destinationOffset, m_Staging.data() + stagingOffset, size);
+            Copies.push_back(Copy{ destination.Resource, destinationOffset, stagingOffset, size });
+        }
+
+        void FinishRequest(const UploadDestination& destination) final
+        {
+            Finished.push_back(destination.Resource);
+        }
+
+        Vector<Copy> Copies;
+        Vector<void*> Finished;
+
+    private:
+        const Vector<uint8>& m_Staging;
+        std::map<void*, Vector<uint8>>& m_Destinations;
+    };
+
+    void* MakeResource(uint32 index)
+    {
+        return reinterpret_cast<void*>(uintptr_t(index + 1) * 16);
+    }
+}
+
+TEST(UploadScheduler, FifoWithinBudget)
+{
+    static constexpr uint64 s_Capacity = 1 << 16;
+    static constexpr uint64 s_Budget = 20000;
+    UploadScheduler scheduler(s_Capacity, s_Budget);
+    Vector<uint8> staging(s_Capacity);
+    std::map<void*, Vector<uint8>> destinations;
+    std::map<void*, Vector<uint8>> expected;
+    Recorder recorder(staging, destinations);
+
+    std::mt19937 random(1);
+    Vector<void*> order;
+    Vector<uint64> tickets;
+    for (uint32 i = 0; i < 200; ++i)
+    {
+        // Some larger than the budget and the staging ring, split over several frames
+        Vector<uint8> data(1 + random() % 50000);
+        for (uint8& byte : data)
+            byte = static_cast<uint8>(random());
+
+        void* resource = MakeResource(i);
+        destinations[resource] = Vector<uint8>(data.size());
+        tickets.push_back(scheduler.Enqueue(UploadDestination{ resource, 0 }, 0, data.data(), data.size()));
+        expected[resource] = std::move(data);
+        order.push_back(resource);
+    }
+
+    uint64 fenceValue = 0;
+    uint32 frames = 0;
+    bool withinBudget = true;
+    bool ticketsInOrder = true;
+    while (!scheduler.IsIdle() && frames < 10000)
+    {
+        const uint64 recordedBefore = scheduler.GetRecordedTicket();
+        const UploadFlushStats stats = scheduler.Flush(staging.data(), recorder);
+        withinBudget &= stats.Bytes <= s_Budget && stats.PendingBytes == scheduler.GetPendingBytes();
+        ticketsInOrder &= scheduler.GetRecordedTicket() >= recordedBefore;
+
+        // The GPU trails by two frames
+        scheduler.FinishFrame(++fenceValue);
+        if (fenceValue >= 2)
+            scheduler.Reclaim(fenceValue - 2);
+        ++frames;
+    }
+
+    CHECK(scheduler.IsIdle());
+    CHECK(withinBudget);
+    CHECK(ticketsInOrder);
+    CHECK(recorder.Finished == order);
+    CHECK(destinations == expected);
+    CHECK(scheduler.GetRecordedTicket() == tickets.back());
+    CHECK(scheduler.GetPendingBytes() == 0);
+}
+
+TEST(UploadScheduler, SplitsLargeRequests)
+{
+    // Chunks are limited by the budget and by half the staging ring
+    UploadScheduler scheduler(4096, 1500);
+    Vector<uint8> staging(4096);
+    std::map<void*, Vector<uint8>> destinations;
+    Recorder recorder(staging, destinations);
+
+    Vector<uint8> data(5000, 7);
+    destinations[MakeResource(0)] = Vector<uint8>(data.size());
+    const uint64 ticket = scheduler.Enqueue(UploadDestination{ MakeResource(0), 0 }, 0, data.data(), data.size());
+
+    Vector<uint64> pending;
+    uint64 fenceValue = 0;
+    while (!scheduler.IsIdle())
+    {
+        const UploadFlushStats stats = scheduler.Flush(staging.data(), recorder);
+        CHECK(stats.Copies == 1);
+        pending.push_back(stats.PendingBytes);
+        CHECK((scheduler.GetRecordedTicket() == ticket) == scheduler.IsIdle());
+        scheduler.FinishFrame(++fenceValue);
+        scheduler.Reclaim(fenceValue);
+    }
+    CHECK((pending == Vector<uint64>{ 3500, 2000, 500, 0 }));
+    CHECK(destinations[MakeResource(0)] == data);
+
+    // Copies are contiguous in the destination
+    uint64 next = 0;
+    for (const Recorder::Copy& copy : recorder.Copies)
+    {
+        CHECK(copy.DestinationOffset == next);
+        next += copy.Size;
+    }
+    CHECK(next == data.size());
+}
+
+TEST(UploadScheduler, StopsWhenStagingIsFull)
+{
+    UploadScheduler scheduler(1024, 1 << 20);
+    Vector<uint8> staging(1024);
+    std::map<void*, Vector<uint8>> destinations;
+    Recorder recorder(staging, destinations);
+
+    Vector<uint8> data(400, 1);
+    for (uint32 i = 0; i < 4; ++i)
+    {
+        destinations[MakeResource(i)] = Vector<uint8>(data.size());
+        scheduler.Enqueue(UploadDestination{ MakeResource(i), 0 }, 0, data.data(), data.size());
+    }
+
+    // Two requests fit, the third would overwrite staging memory the GPU has not read yet
+    UploadFlushStats stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(stats.StagingFull);
+    CHECK(stats.FinishedRequests == 2 && stats.Bytes == 800 && stats.PendingBytes == 800);
+    scheduler.FinishFrame(1);
+
+    // Nothing was reclaimed, so the next frame copies nothing
+    stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(stats.StagingFull && stats.Copies == 0);
+    scheduler.FinishFrame(2);
+
+    scheduler.Reclaim(2);
+    stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(!stats.StagingFull && stats.FinishedRequests == 2);
+    CHECK(scheduler.IsIdle());
+}
+
+TEST(UploadScheduler, EmptyAndCancelledRequests)
+{
+    UploadScheduler scheduler(1024, 256);
+    Vector<uint8> staging(1024);
+    std::map<void*, Vector<uint8>> destinations;
+    Recorder recorder(staging, destinations);
+
+    // A zero-byte request finishes without a copy
+    const uint64 empty = scheduler.Enqueue(UploadDestination{ MakeResource(0), 0 }, 0, nullptr, 0);
+    UploadFlushStats stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(stats.Copies == 0 && stats.FinishedRequests == 1);
+    CHECK(scheduler.GetRecordedTicket() == empty);
+
+    // A partly copied request and an untouched one are both handed back
+    Vector<uint8> data(600, 3);
+    destinations[MakeResource(1)] = Vector<uint8>(data.size());
+    destinations[MakeResource(2)] = Vector<uint8>(data.size());
+    scheduler.Enqueue(UploadDestination{ MakeResource(1), 1 }, 0, data.data(), data.size());
+    scheduler.Enqueue(UploadDestination{ MakeResource(2), 2 }, 0, data.data(), data.size());
+    scheduler.Flush(staging.data(), recorder);
+
+    const Vector<UploadDestination> cancelled = scheduler.CancelAll();
+    CHECK(cancelled.size() == 2 && cancelled[0].Resource == MakeResource(1) && cancelled[1].FinalState == 2);
+    CHECK(scheduler.IsIdle() && scheduler.GetPendingBytes() == 0);
+    CHECK(scheduler.GetRecordedTicket() == empty);
+
+    const size_t copies = recorder.Copies.size();
+    stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(stats.Copies == 0 && recorder.Copies.size() == copies);
+}
+
+TEST(UploadScheduler, CancelRange)
+{
+    UploadScheduler scheduler(1024, 256);
+    Vector<uint8> staging(1024);
+    std::map<void*, Vector<uint8>> destinations;
+    Recorder recorder(staging, destinations);
+
+    // Four 300-byte buffers packed into one resource, like small buffers sharing a page
+    void* page = MakeResource(0);
+    destinations[page] = Vector<uint8>(1200);
+    Vector<uint8> data(300, 5);
+    uint64 last = 0;
+    for (uint64 i = 0; i < 4; ++i)
+        last = scheduler.Enqueue(UploadDestination{ page, uint32(i) }, i * 300, data.data(), data.size());
+
+    // The first buffer is partly copied
+    UploadFlushStats stats = scheduler.Flush(staging.data(), recorder);
+    CHECK(stats.Bytes == 256 && stats.PendingBytes == 944);
+
+    // Freeing the first and third buffers drops only their requests
+    CHECK(scheduler.Cancel(MakeResource(1), 0, 1200).empty());
+    Vector<UploadDestination> cancelled = scheduler.Cancel(page, 0, 300);
+    CHECK(cancelled.size() == 1 && cancelled[0].FinalState == 0);
+    cancelled = scheduler.Cancel(page, 600, 300);
+    CHECK(cancelled.size() == 1 && cancelled[0].FinalState == 2);
+    CHECK(scheduler.GetPendingBytes() == 600);
+
+    uint64 fenceValue = 0;
+    while (!scheduler.IsIdle())
+    {
+        stats = scheduler.Flush(staging.data(), recorder);
+        scheduler.FinishFrame(++fenceValue);
+        scheduler.Reclaim(fenceValue);
+    }
+    CHECK(scheduler.GetRecordedTicket() == last);
+
+    // Nothing was copied into the freed ranges after the cancel
+    bool outside = true;
+    for (size_t i = 1; i < recorder.Copies.size(); ++i)
+    {
+        const Recorder::Copy& copy = recorder.Copies[i];
+        outside &= copy.DestinationOffset >= 300 && (copy.DestinationOffset >= 900 || copy.DestinationOffset + copy.Size <= 600);
+    }
+    CHECK(outside);
+    CHECK(recorder.Finished.size() == 2);
+}
+
+TEST(UploadScheduler, InvalidConfiguration)
+{
+    auto throws = [](uint64 capacity, uint64 budget)
+    {
+        try
+        {
+            UploadScheduler scheduler(capacity, budget);
+        }
+        catch (const std::invalid_argument&)
+        {
+            return true;
+        }
+        return false;
+    };
+    CHECK(throws(1024, 0));
+    CHECK(throws(1000, 256));
+    CHECK(throws(16, 256));
+    CHECK(!throws(32, 256));
+}
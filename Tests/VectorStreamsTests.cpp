@@ -0,0 +1,308 @@
+#include "TestFramework.h"
+
+#include <cmath>
+#include <random>
+#include <utility>
+
+#include "Engine/VectorStreams.h"
+#include "Graphics/Mesh.h"
+
+namespace
+{
+    constexpr SimdLevel s_Levels[] = { SimdLevel::Scalar, SimdLevel::Sse, SimdLevel::Avx2, SimdLevel::Avx512 };
+
+    // Counts that leave a tail after the 4, 8 and 16 wide blocks
+    constexpr size_t s_Counts[] = { 0, 1, 3, 5, 7, 9, 15, 17, 31, 33, 1001 };
+
+    void Fill(std::mt19937& random, Span<float> values)
+    {
+        std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+        for (float& v : values)
+            v = value(random);
+    }
+
+    Float3Stream MakeStream3(std::mt19937& random, size_t count)
+    {
+        Float3Stream stream(count);
+        const Float3SoA v = stream.View();
+        Fill(random, v.X);
+        Fill(random, v.Y);
+        Fill(random, v.Z);
+        return stream;
+    }
+
+    Float4Stream MakeStream4(std::mt19937& random, size_t count)
+    {
+        Float4Stream stream(count);
+        const Float4SoA v = stream.View();
+        Fill(random, v.X);
+        Fill(random, v.Y);
+        Fill(random, v.Z);
+        Fill(random, v.W);
+        return stream;
+    }
+
+    float4x4 MakeMatrix(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+        float4x4 m;
+        for (uint32 row = 0; row < 4; ++row)
+            for (uint32 col = 0; col < 4; ++col)
+                m(row, col) = value(random);
+        return m;
+    }
+
+    // FMA and the reciprocal square root differ from the double reference, magnitudes stay below ~50
+    bool IsClose(float actual, double expected)
+    {
+        return std::abs(double(actual) - expected) <= 1e-4 * std::max(1.0, std::abs(expected));
+    }
+
+    // Runs check once per SIMD level cap and count, restoring the previous cap
+    template<class F>
+    bool ForEachLevelAndCount(F&& check)
+    {
+        const SimdLevel previousCap = GetMaxSimdLevel();
+        bool matches = true;
+        for (SimdLevel level : s_Levels)
+        {
+            SetMaxSimdLevel(level);
+            for (size_t count : s_Counts)
+                matches &= check(count);
+        }
+        SetMaxSimdLevel(previousCap);
+        return matches;
+    }
+}
+
+TEST(VectorStreams, TransformMatchesScalar)
+{
+    std::mt19937 random(11);
+    CHECK(ForEachLevelAndCount([&](size_t count)
+    {
+        const Float3Stream in = MakeStream3(random, count);
+        const float4x4 m = MakeMatrix(random);
+        Float3Stream points(count), normals(count);
+        Float4Stream clip(count);
+        TransformPoints(m, in.View(), points.View());
+        TransformPoints(m, in.View(), clip.View());
+        TransformNormals(m, in.View(), normals.View());
+
+        const ConstFloat3SoA v = in.View();
+        const ConstFloat3SoA p = points.View();
+        const ConstFloat4SoA c = clip.View();
+        const ConstFloat3SoA n = normals.View();
+        bool matches = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            double point[4], normal[4];
+            for (uint32 col = 0; col < 4; ++col)
+            {
+                normal[col] = double(v.X[i]) * m(0, col) + double(v.Y[i]) * m(1, col) + double(v.Z[i]) * m(2, col);
+                point[col] = normal[col] + m(3, col);
+            }
+            matches &= IsClose(p.X[i], point[0]) && IsClose(p.Y[i], point[1]) && IsClose(p.Z[i], point[2]);
+            matches &= IsClose(c.X[i], point[0]) && IsClose(c.Y[i], point[1]) && IsClose(c.Z[i], point[2]) && IsClose(c.W[i], point[3]);
+            matches &= IsClose(n.X[i], normal[0]) && IsClose(n.Y[i], normal[1]) && IsClose(n.Z[i], normal[2]);
+        }
+
+        // In place
+        Float3Stream inPlace = in;
+        TransformPoints(m, inPlace.View(), inPlace.View());
+        const ConstFloat3SoA q = std::as_const(inPlace).View();
+        for (size_t i = 0; i < count; ++i)
+            matches &= q.X[i] == p.X[i] && q.Y[i] == p.Y[i] && q.Z[i] == p.Z[i];
+        return matches;
+    }));
+}
+
+TEST(VectorStreams, NormalizeMatchesScalar)
+{
+    std::mt19937 random(12);
+    CHECK(ForEachLevelAndCount([&](size_t count)
+    {
+        Float3Stream in3 = MakeStream3(random, count);
+        Float4Stream in4 = MakeStream4(random, count);
+        // Zero vectors pass through unchanged
+        if (count > 2)
+        {
+            const Float3SoA v3 = in3.View();
+            const Float4SoA v4 = in4.View();
+            v3.X[2] = v3.Y[2] = v3.Z[2] = 0.0f;
+            v4.X[2] = v4.Y[2] = v4.Z[2] = v4.W[2] = 0.0f;
+        }
+
+        Float3Stream out3(count);
+        Float4Stream out4(count);
+        NormalizeN(std::as_const(in3).View(), out3.View());
+        NormalizeN(std::as_const(in4).View(), out4.View());
+
+        const ConstFloat3SoA a = std::as_const(in3).View();
+        const ConstFloat4SoA b = std::as_const(in4).View();
+        const ConstFloat3SoA r3 = std::as_const(out3).View();
+        const ConstFloat4SoA r4 = std::as_const(out4).View();
+        bool matches = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double length3 = std::sqrt(double(a.X[i]) * a.X[i] + double(a.Y[i]) * a.Y[i] + double(a.Z[i]) * a.Z[i]);
+            const double scale3 = length3 > 0.0 ? 1.0 / length3 : 1.0;
+            matches &= IsClose(r3.X[i], a.X[i] * scale3) && IsClose(r3.Y[i], a.Y[i] * scale3) && IsClose(r3.Z[i], a.Z[i] * scale3);
+
+            const double length4 = std::sqrt(double(b.X[i]) * b.X[i] + double(b.Y[i]) * b.Y[i] + double(b.Z[i]) * b.Z[i] + double(b.W[i]) * b.W[i]);
+            const double scale4 = length4 > 0.0 ? 1.0 / length4 : 1.0;
+            matches &= IsClose(r4.X[i], b.X[i] * scale4) && IsClose(r4.Y[i], b.Y[i] * scale4);
+            matches &= IsClose(r4.Z[i], b.Z[i] * scale4) && IsClose(r4.W[i], b.W[i] * scale4);
+        }
+        return matches;
+    }));
+}
+
+TEST(VectorStreams, DotCrossLerpMatchScalar)
+{
+    std::mt19937 random(13);
+    CHECK(ForEachLevelAndCount([&](size_t count)
+    {
+        const Float3Stream a3 = MakeStream3(random, count), b3 = MakeStream3(random, count);
+        const Float4Stream a4 = MakeStream4(random, count), b4 = MakeStream4(random, count);
+        const float t = 0.3f;
+
+        Vector<float> dot3(count), dot4(count);
+        Float3Stream cross(count), lerp3(count);
+        Float4Stream lerp4(count);
+        DotN(a3.View(), b3.View(), dot3);
+        DotN(a4.View(), b4.View(), dot4);
+        CrossN(a3.View(), b3.View(), cross.View());
+        LerpN(a3.View(), b3.View(), t, lerp3.View());
+        LerpN(a4.View(), b4.View(), t, lerp4.View());
+
+        const ConstFloat3SoA a = a3.View(), b = b3.View();
+        const ConstFloat4SoA c = a4.View(), d = b4.View();
+        const ConstFloat3SoA x = std::as_const(cross).View(), l3 = std::as_const(lerp3).View();
+        const ConstFloat4SoA l4 = std::as_const(lerp4).View();
+        bool matches = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches &= IsClose(dot3[i], double(a.X[i]) * b.X[i] + double(a.Y[i]) * b.Y[i] + double(a.Z[i]) * b.Z[i]);
+            matches &= IsClose(dot4[i], double(c.X[i]) * d.X[i] + double(c.Y[i]) * d.Y[i] + double(c.Z[i]) * d.Z[i] + double(c.W[i]) * d.W[i]);
+
+            matches &= IsClose(x.X[i], double(a.Y[i]) * b.Z[i] - double(a.Z[i]) * b.Y[i]);
+            matches &= IsClose(x.Y[i], double(a.Z[i]) * b.X[i] - double(a.X[i]) * b.Z[i]);
+            matches &= IsClose(x.Z[i], double(a.X[i]) * b.Y[i] - double(a.Y[i]) * b.X[i]);
+
+            auto lerp = [t](float from, float to) { return double(from) + (double(to) - from) * t; };
+            matches &= IsClose(l3.X[i], lerp(a.X[i], b.X[i])) && IsClose(l3.Y[i], lerp(a.Y[i], b.Y[i])) && IsClose(l3.Z[i], lerp(a.Z[i], b.Z[i]));
+            matches &= IsClose(l4.X[i], lerp(c.X[i], d.X[i])) && IsClose(l4.Y[i], lerp(c.Y[i], d.Y[i]));
+            matches &= IsClose(l4.Z[i], lerp(c.Z[i], d.Z[i])) && IsClose(l4.W[i], lerp(c.W[i], d.W[i]));
+        }
+        return matches;
+    }));
+}
+
+TEST(VectorStreams, InterleaveRoundTrips)
+{
+    std::mt19937 random(14);
+    CHECK(ForEachLevelAndCount([&](size_t count)
+    {
+        std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+        Vector<float3> aos3(count);
+        Vector<float4> aos4(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            aos3[i] = float3{ value(random), value(random), value(random) };
+            aos4[i] = float4{ value(random), value(random), value(random), value(random) };
+        }
+
+        // Swizzles move bits, so everything compares exactly
+        Float3Stream soa3(count);
+        Float4Stream soa4(count);
+        Deinterleave(Span<const float3>(aos3), soa3.View());
+        Deinterleave(Span<const float4>(aos4), soa4.View());
+
+        const ConstFloat3SoA s3 = std::as_const(soa3).View();
+        const ConstFloat4SoA s4 = std::as_const(soa4).View();
+        bool matches = true;
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches &= s3.X[i] == aos3[i].x && s3.Y[i] == aos3[i].y && s3.Z[i] == aos3[i].z;
+            matches &= s4.X[i] == aos4[i].x && s4.Y[i] == aos4[i].y && s4.Z[i] == aos4[i].z && s4.W[i] == aos4[i].w;
+        }
+
+        Vector<float3> back3(count);
+        Vector<float4> back4(count);
+        Interleave(s3, Span<float3>(back3));
+        Interleave(s4, Span<float4>(back4));
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches &= back3[i].x == aos3[i].x && back3[i].y == aos3[i].y && back3[i].z == aos3[i].z;
+            matches &= back4[i].x == aos4[i].x && back4[i].y == aos4[i].y && back4[i].z == aos4[i].z && back4[i].w == aos4[i].w;
+        }
+        return matches;
+    }));
+}
+
+TEST(VectorStreams, StridedRoundTripsMeshVertexPositions)
+{
+    std::mt19937 random(15);
+    CHECK(ForEachLevelAndCount([&](size_t count)
+    {
+        std::uniform_real_distribution<float> value(-4.0f, 4.0f);
+        Vector<MeshVertex> vertices(count);
+        for (MeshVertex& vertex : vertices)
+        {
+            vertex.Position = float3{ value(random), value(random), value(random) };
+            vertex.Normal = float3{ value(random), value(random), value(random) };
+            vertex.Uv = float2{ value(random), value(random) };
+        }
+        const Vector<MeshVertex> original = vertices;
+
+        Float3Stream positions(count);
+        if (count > 0)
+            DeinterleaveStrided(&vertices[0].Position, sizeof(MeshVertex), positions.View());
+        const Float3SoA p = positions.View();
+        bool matches = true;
+        for (size_t i = 0; i < count; ++i)
+            matches &= p.X[i] == original[i].Position.x && p.Y[i] == original[i].Position.y && p.Z[i] == original[i].Position.z;
+
+        // Write back translated positions, the normals and uvs in between stay untouched
+        for (size_t i = 0; i < count; ++i)
+            p.X[i] += 1.0f;
+        if (count > 0)
+            InterleaveStrided(p, &vertices[0].Position, sizeof(MeshVertex));
+        for (size_t i = 0; i < count; ++i)
+        {
+            matches &= vertices[i].Position.x == original[i].Position.x + 1.0f;
+            matches &= vertices[i].Position.y == original[i].Position.y && vertices[i].Position.z == original[i].Position.z;
+            matches &= vertices[i].Normal.x == original[i].Normal.x && vertices[i].Normal.y == original[i].Normal.y;
+            matches &= vertices[i].Normal.z == original[i].Normal.z;
+            matches &= vertices[i].Uv.x == original[i].Uv.x && vertices[i].Uv.y == original[i].Uv.y;
+        }
+        return matches;
+    }));
+}
+
+TEST(VectorStreams, RejectsMismatchedLengths)
+{
+    Float3Stream three(3), two(2);
+    bool threw = false;
+    try
+    {
+        TransformPoints(float4x4{}, three.View(), two.View());
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    CHECK(threw);
+}
+
+TEST(VectorStreams, Benchmark)
+{
+    const SimdLevel previousCap = GetMaxSimdLevel();
+    const VectorStreamsBenchmarkReport report = RunVectorStreamsBenchmark(1 << 20, 10);
+    printf("    %u points at %s: memcpy %.1f, scalar %.1f, SSE %.1f, AVX2 %.1f, AVX-512 %.1f GB/s\n", report.PointCount,
+        GetSimdLevelName(report.Level), report.CopyBytesPerSecond * 1e-9, report.ScalarBytesPerSecond * 1e-9,
+        report.SseBytesPerSecond * 1e-9, report.Avx2BytesPerSecond * 1e-9, report.Avx512BytesPerSecond * 1e-9);
+    CHECK(report.PointCount == 1 << 20);
+    CHECK(report.CopyBytesPerSecond > 0.0 && report.ScalarBytesPerSecond > 0.0 && report.SseBytesPerSecond > 0.0);
+    CHECK(GetMaxSimdLevel() == previousCap);
+}
@@ -0,0 +1,173 @@
+#include "TestFramework.h"
+
+#include <bit>
+#include <random>
+
+#include "Graphics/PrimitiveTables.h"
+#include "Graphics/VertexCompression.h"
+
+namespace
+{
+    // Exact value of a binary16 pattern, NaN for every NaN pattern
+    double HalfValue(uint16 half)
+    {
+        const int32 exponent = (half >> 10) & 0x1f;
+        const int32 mantissa = half & 0x3ff;
+        const double sign = (half & 0x8000) ? -1.0 : 1.0;
+        if (exponent == 0x1f)
+            return mantissa ? std::numeric_limits<double>::quiet_NaN() : sign * std::numeric_limits<double>::infinity();
+        if (exponent == 0)
+            return sign * std::ldexp(double(mantissa), -24);
+        return sign * std::ldexp(double(1024 + mantissa), exponent - 25);
+    }
+
+    Vector<MeshVertex> MakeRandomVertices(uint32 count, uint32 seed)
+    {
+        std::mt19937 random(seed);
+        std::normal_distribution<float> normal;
+        std::uniform_real_distribution<float> value(-5.0f, 5.0f);
+        std::uniform_real_distribution<float> uv(-1.0f, 1.0f);
+
+        Vector<MeshVertex> vertices(count);
+        for (MeshVertex& vertex : vertices)
+        {
+            vertex.Position = float3{ value(random), value(random), value(random) };
+            vertex.Normal = Normalize(float3{ normal(random), normal(random), normal(random) });
+            vertex.Uv = float2{ uv(random), uv(random) };
+        }
+        return vertices;
+    }
+
+    // Half the UNORM16 step on each axis of the bounds
+    float MaxPositionQuantizationError(Span<const MeshVertex> vertices)
+    {
+        float3 lo = vertices[0].Position, hi = vertices[0].Position;
+        for (const MeshVertex& vertex : vertices)
+        {
+            lo = float3{ std::min(lo.x, vertex.Position.x), std::min(lo.y, vertex.Position.y), std::min(lo.z, vertex.Position.z) };
+            hi = float3{ std::max(hi.x, vertex.Position.x), std::max(hi.y, vertex.Position.y), std::max(hi.z, vertex.Position.z) };
+        }
+        return Length(hi - lo) * 0.5f / 65535.0f;
+    }
+}
+
+TEST(VertexCompression, HalfConversion)
+{
+    // Every half converts exactly and survives the round trip
+    bool exact = true;
+    for (uint32 bits = 0; bits < 0x10000; ++bits)
+    {
+        const uint16 half = static_cast<uint16>(bits);
+        const double expected = HalfValue(half);
+        const float value = HalfToFloat(half);
+        if (std::isnan(expected))
+        {
+            exact &= std::isnan(value) && std::isnan(HalfToFloat(FloatToHalf(value)));
+            continue;
+        }
+        exact &= double(value) == expected && FloatToHalf(value) == half;
+    }
+    CHECK(exact);
+
+    // Ties between neighbouring halves go to the even one, anything past a tie to the nearest
+    bool rounded = true;
+    for (uint32 bits = 0; bits < 0x7bff; ++bits)
+    {
+        const uint16 half = static_cast<uint16>(bits);
+        const float tie = float((HalfValue(half) + HalfValue(half + 1)) * 0.5);
+        const uint16 even = (half & 1) ? half + 1 : half;
+        rounded &= FloatToHalf(tie) == even && FloatToHalf(-tie) == (even | 0x8000);
+        rounded &= FloatToHalf(std::nextafter(tie, 0.0f)) == half;
+        rounded &= FloatToHalf(std::nextafter(tie, 1e30f)) == half + 1;
+    }
+    CHECK(rounded);
+
+    CHECK(FloatToHalf(65520.0f) == 0x7c00);
+    CHECK(FloatToHalf(1e-9f) == 0);
+    CHECK(FloatToHalf(-std::numeric_limits<float>::infinity()) == 0xfc00);
+}
+
+TEST(VertexCompression, OctahedralNormals)
+{
+    const Vector<MeshVertex> vertices = MakeRandomVertices(100000, 2);
+    double maxError = 0.0;
+    for (const MeshVertex& vertex : vertices)
+    {
+        const float2 encoded = OctEncode(vertex.Normal);
+        maxError = std::max(maxError, double(Length(OctDecode(encoded) - vertex.Normal)));
+        CHECK(std::fabs(encoded.x) <= 1.0f && std::fabs(encoded.y) <= 1.0f);
+    }
+    CHECK(maxError < 1e-5);
+
+    // Axes and the folded lower hemisphere
+    for (const float3& axis : { float3{ 1, 0, 0 }, float3{ 0, -1, 0 }, float3{ 0, 0, 1 }, float3{ 0, 0, -1 } })
+        CHECK(Length(OctDecode(OctEncode(axis)) - axis) < 1e-6f);
+}
+
+TEST(VertexCompression, RoundTrip)
+{
+    const auto sphere = MakeSphereTable<64, 64>(3.0f);
+    const Vector<MeshVertex> random = MakeRandomVertices(100000, 1);
+
+    struct Bounds
+    {
+        VertexFormat Format;
+        uint32 Stride;
+        float MaxNormalDegrees;
+    };
+    for (const Bounds& bounds : { Bounds{ VertexFormat::Float32, 32, 0.001f }, Bounds{ VertexFormat::Quantized16, 16, 0.01f },
+        Bounds{ VertexFormat::Quantized8, 12, 0.7f } })
+    {
+        for (Span<const MeshVertex> vertices : { Span<const MeshVertex>(sphere.Vertices), Span<const MeshVertex>(random) })
+        {
+            const CompressedVertices compressed = CompressVertices(vertices, bounds.Format);
+            const VertexCompressionError error = MeasureCompressionError(vertices, compressed);
+            printf("    format %u, %zu vertices: position %.2g, normal %.3g deg, uv %.2g\n", uint32(bounds.Format),
+                vertices.size(), error.MaxPositionError, error.MaxNormalError, error.MaxUvError);
+
+            CHECK(compressed.Stride == bounds.Stride && compressed.Stride == GetVertexStride(bounds.Format));
+            CHECK(compressed.VertexCount == vertices.size());
+            CHECK(error.CompressedBytes == size_t(bounds.Stride) * vertices.size());
+            CHECK(error.MaxNormalError <= bounds.MaxNormalDegrees);
+            if (bounds.Format == VertexFormat::Float32)
+            {
+                CHECK(error.MaxPositionError == 0.0f && error.MaxUvError == 0.0f);
+                continue;
+            }
+
+            // Small slack for the float dequantization. Half UVs in [-1, 1] are off by half an ULP at most
+            CHECK(error.MaxPositionError <= MaxPositionQuantizationError(vertices) * 1.01f);
+            CHECK(error.MaxUvError <= 0.5f / 2048.0f);
+        }
+    }
+}
+
+TEST(VertexCompression, DequantizationFold)
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> value(-2.0f, 2.0f);
+
+    double maxError = 0.0;
+    for (uint32 i = 0; i < 1000; ++i)
+    {
+        const float4x4 world{
+            value(random), value(random), value(random), value(random),
+            value(random), value(random), value(random), value(random),
+            value(random), value(random), value(random), value(random),
+            0.0f, 0.0f, 0.0f, 1.0f };
+        const PositionDequantization dequantization{ { value(random), value(random), value(random) },
+            { value(random), value(random), value(random) } };
+        const float4x4 folded = ApplyDequantization(world, dequantization);
+
+        // The folded matrix applied to the UNORM position equals the world matrix applied to the dequantized one
+        const float3 unorm{ 0.3f, 0.7f, 0.1f };
+        const float3 position = dequantization.Offset + unorm * dequantization.Scale;
+        for (uint32 r = 0; r < 3; ++r)
+        {
+            const float expected = world.m[r][0] * position.x + world.m[r][1] * position.y + world.m[r][2] * position.z + world.m[r][3];
+            const float actual = folded.m[r][0] * unorm.x + folded.m[r][1] * unorm.y + folded.m[r][2] * unorm.z + folded.m[r][3];
+            maxError = std::max(maxError, double(std::fabs(expected - actual)));
+        }
+    }
+    CHECK(maxError < 1e-5);
+}